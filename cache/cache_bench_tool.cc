@@ -4,6 +4,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #ifdef GFLAGS
+#include <algorithm>
 #include <cinttypes>
 #include <cstdio>
 #include <limits>
@@ -42,6 +43,10 @@ DEFINE_double(resident_ratio, 0.25,
               "Ratio of keys fitting in cache to keyspace.");
 DEFINE_uint64(ops_per_thread, 2000000U, "Number of operations per thread.");
 DEFINE_uint32(value_bytes, 8 * KiB, "Size of each value added.");
+DEFINE_double(value_compressibility, 0.0,
+              "Fraction of each value filled with a repeated pattern, so that "
+              "values are compressible (e.g. for a compressed secondary "
+              "cache). 0 means random, incompressible values.");
 
 DEFINE_uint32(skew, 5, "Degree of skew in key selection");
 DEFINE_bool(populate_cache, true, "Populate cache before operations");
@@ -53,6 +58,11 @@ DEFINE_uint32(insert_percent, 2,
               "Ratio of insert to total workload (expressed as a percentage)");
 DEFINE_uint32(lookup_percent, 10,
               "Ratio of lookup to total workload (expressed as a percentage)");
+DEFINE_uint32(scan_percent, 0,
+              "Ratio of scans to total workload (expressed as a percentage). "
+              "A scan looks up and inserts -scan_length keys that are never "
+              "accessed again, like a full table scan through the cache.");
+DEFINE_uint32(scan_length, 1000, "Number of keys accessed by each scan.");
 DEFINE_uint32(erase_percent, 1,
               "Ratio of erase to total workload (expressed as a percentage)");
 DEFINE_bool(gather_stats, false,
@@ -72,6 +82,9 @@ static class std::shared_ptr<ROCKSDB_NAMESPACE::SecondaryCache> secondary_cache;
 #endif  // ROCKSDB_LITE
 
 DEFINE_bool(use_clock_cache, false, "");
+DEFINE_bool(use_tinylfu_admission, false,
+            "Use TinyLFU admission in the LRU cache "
+            "(LRUCacheOptions::use_tinylfu_admission).");
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -125,6 +138,9 @@ struct ThreadState {
   SharedState* shared;
   HistogramImpl latency_ns_hist;
   uint64_t duration_us = 0;
+  uint64_t lookups = 0;
+  uint64_t hits = 0;
+  uint64_t next_scan_key = 0;
 
   ThreadState(uint32_t index, SharedState* _shared)
       : tid(index), rnd(1000 + index), shared(_shared) {}
@@ -148,6 +164,10 @@ struct KeyGen {
         key -= max_key;
       }
     }
+    return Get(key);
+  }
+
+  Slice Get(uint64_t key) {
     // Variable size and alignment
     size_t off = key % 8;
     key_data[0] = char{42};
@@ -163,9 +183,16 @@ struct KeyGen {
 char* createValue(Random64& rnd) {
   char* rv = new char[FLAGS_value_bytes];
   // Fill with some filler data, and take some CPU time
-  for (uint32_t i = 0; i < FLAGS_value_bytes; i += 8) {
+  uint32_t random_bytes = static_cast<uint32_t>(
+      FLAGS_value_bytes * (1.0 - std::min(1.0, FLAGS_value_compressibility)));
+  random_bytes &= ~uint32_t{7};
+  uint32_t i = 0;
+  for (; i < random_bytes; i += 8) {
     EncodeFixed64(rv + i, rnd.Next());
   }
+  for (; i < FLAGS_value_bytes; ++i) {
+    rv[i] = static_cast<char>('a' + i % 4);
+  }
   return rv;
 }
 
@@ -210,8 +237,10 @@ class CacheBench {
                           kHundredthUint64 * FLAGS_lookup_percent),
         erase_threshold_(lookup_threshold_ +
                          kHundredthUint64 * FLAGS_erase_percent),
+        scan_threshold_(erase_threshold_ +
+                        kHundredthUint64 * FLAGS_scan_percent),
         skewed_(FLAGS_skewed) {
-    if (erase_threshold_ != 100U * kHundredthUint64) {
+    if (scan_threshold_ != 100U * kHundredthUint64) {
       fprintf(stderr, "Percentages must add to 100.\n");
       exit(1);
     }
@@ -231,6 +260,7 @@ class CacheBench {
       }
     } else {
       LRUCacheOptions opts(FLAGS_cache_size, FLAGS_num_shard_bits, false, 0.5);
+      opts.use_tinylfu_admission = FLAGS_use_tinylfu_admission;
 #ifndef ROCKSDB_LITE
       if (!FLAGS_secondary_cache_uri.empty()) {
         Status s = SecondaryCache::CreateFromString(
@@ -324,6 +354,17 @@ class CacheBench {
     }
     printf("%s", combined.ToString().c_str());
 
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    for (uint32_t i = 0; i < FLAGS_threads; i++) {
+      lookups += threads[i]->lookups;
+      hits += threads[i]->hits;
+    }
+    if (lookups > 0) {
+      printf("\nLookup hit rate: %.2f%% (%" PRIu64 " / %" PRIu64 ")\n",
+             100.0 * hits / lookups, hits, lookups);
+    }
+
     if (FLAGS_gather_stats) {
       printf("\nGather stats latency (us):\n");
       printf("%s", stats_hist.ToString().c_str());
@@ -342,6 +383,7 @@ class CacheBench {
   const uint64_t insert_threshold_;
   const uint64_t lookup_threshold_;
   const uint64_t erase_threshold_;
+  const uint64_t scan_threshold_;
   const bool skewed_;
   int max_log_;
 
@@ -469,7 +511,9 @@ class CacheBench {
         // do lookup
         handle = cache_->Lookup(key, &helper2, create_cb, Cache::Priority::LOW,
                                 true);
+        thread->lookups++;
         if (handle) {
+          thread->hits++;
           // do something with the data
           result += NPHash64(static_cast<char*>(cache_->Value(handle)),
                              FLAGS_value_bytes);
@@ -494,7 +538,9 @@ class CacheBench {
         // do lookup
         handle = cache_->Lookup(key, &helper2, create_cb, Cache::Priority::LOW,
                                 true);
+        thread->lookups++;
         if (handle) {
+          thread->hits++;
           // do something with the data
           result += NPHash64(static_cast<char*>(cache_->Value(handle)),
                              FLAGS_value_bytes);
@@ -502,6 +548,24 @@ class CacheBench {
       } else if (random_op < erase_threshold_) {
         // do erase
         cache_->Erase(key);
+      } else if (random_op < scan_threshold_) {
+        if (handle) {
+          cache_->Release(handle);
+          handle = nullptr;
+        }
+        // do scan, over keys beyond max_key_ that are unique to this thread
+        for (uint32_t j = 0; j < FLAGS_scan_length; j++) {
+          Slice scan_key = gen.Get(max_key_ + (uint64_t{thread->tid} << 40) +
+                                   thread->next_scan_key++);
+          Cache::Handle* scan_handle = cache_->Lookup(
+              scan_key, &helper2, create_cb, Cache::Priority::LOW, true);
+          if (scan_handle) {
+            cache_->Release(scan_handle);
+          } else {
+            cache_->Insert(scan_key, createValue(thread->rnd), &helper2,
+                           FLAGS_value_bytes);
+          }
+        }
       } else {
         // Should be extremely unlikely (noop)
         assert(random_op >= kHundredthUint64 * 100U);
@@ -535,6 +599,15 @@ class CacheBench {
     printf("Insert percentage   : %u%%\n", FLAGS_insert_percent);
     printf("Lookup percentage   : %u%%\n", FLAGS_lookup_percent);
     printf("Erase percentage    : %u%%\n", FLAGS_erase_percent);
+    printf("Scan percentage     : %u%% (length %u)\n", FLAGS_scan_percent,
+           FLAGS_scan_length);
+    printf("TinyLFU admission   : %d\n", int{FLAGS_use_tinylfu_admission});
+    printf("Value compressible  : %g\n", FLAGS_value_compressibility);
+#ifndef ROCKSDB_LITE
+    if (!FLAGS_secondary_cache_uri.empty()) {
+      printf("Secondary cache     : %s\n", FLAGS_secondary_cache_uri.c_str());
+    }
+#endif  // ROCKSDB_LITE
     std::ostringstream stats;
     if (FLAGS_gather_stats) {
       stats << "enabled (" << FLAGS_gather_stats_sleep_ms << "ms, "
@@ -18,6 +18,7 @@
 #include "cache/lru_cache.h"
 #include "test_util/testharness.h"
 #include "util/coding.h"
+#include "util/random.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -831,6 +832,122 @@ TEST_P(CacheTest, GetChargeAndDeleter) {
   cache_->Release(h1);
 }
 
+TEST_P(CacheTest, ManyKeysWithErases) {
+  // A single shard, so that its hash table grows several times and erases
+  // hit long probe sequences.
+  const int kNumKeys = 5000;
+  cache_ = NewCache(2 * kNumKeys, 0, false);
+  for (int i = 0; i < kNumKeys; i++) {
+    Insert(i, i + 1);
+  }
+  for (int i = 0; i < kNumKeys; i += 3) {
+    Erase(i);
+  }
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(i % 3 == 0 ? -1 : i + 1, Lookup(i)) << i;
+  }
+  // Re-insert with new values, overwriting the remaining entries.
+  for (int i = 0; i < kNumKeys; i++) {
+    Insert(i, i + 2);
+  }
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(i + 2, Lookup(i)) << i;
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumKeys), cache_->GetUsage());
+}
+
+TEST_P(CacheTest, ConcurrentLookups) {
+  std::shared_ptr<Cache> cache = NewCache(kCacheSize, 0, false);
+  // Deleter is not thread-safe, and readers may release the last reference.
+  auto insert = [&cache](int key) {
+    ASSERT_OK(cache->Insert(EncodeKey(key), EncodeValue(key + 1), 1,
+                            dumbDeleter));
+  };
+  const int kNumHotKeys = 100;
+  for (int i = 0; i < kNumHotKeys; i++) {
+    insert(i);
+  }
+  std::atomic<bool> stop{false};
+  std::atomic<int> num_errors{0};
+  std::vector<port::Thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&]() {
+      while (!stop.load()) {
+        for (int i = 0; i < kNumHotKeys; i++) {
+          // A lookup racing with modifications may miss, but must never
+          // return the value of another key.
+          int value = Lookup(cache, i);
+          if (value != i + 1 && value != -1) {
+            num_errors.fetch_add(1);
+          }
+        }
+      }
+    });
+  }
+  // Churn through other keys, growing the table and shifting entries on
+  // erase, while the hot keys are being read.
+  for (int i = kNumHotKeys; i < kNumHotKeys + 20000; i++) {
+    insert(i);
+    cache->Erase(EncodeKey(i));
+  }
+  stop.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(0, num_errors.load());
+  for (int i = 0; i < kNumHotKeys; i++) {
+    ASSERT_EQ(i + 1, Lookup(cache, i));
+  }
+}
+
+namespace {
+std::atomic<int> num_live_values{0};
+
+void CountedDeleter(const Slice& /*key*/, void* value) {
+  delete static_cast<std::string*>(value);
+  num_live_values.fetch_sub(1);
+}
+}  // namespace
+
+TEST_P(CacheTest, ConcurrentReleaseWithForceErase) {
+  // A small single shard, so that handles are evicted and re-used for other
+  // keys all the time while they are being looked up and released.
+  std::shared_ptr<Cache> cache = NewCache(32, 0, false);
+  const int kNumKeys = 200;
+  std::atomic<int> num_errors{0};
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      for (int i = 0; i < 20000; i++) {
+        const std::string key = EncodeKey(rnd.Uniform(kNumKeys));
+        Cache::Handle* handle = cache->Lookup(key);
+        if (handle == nullptr) {
+          num_live_values.fetch_add(1);
+          Status s = cache->Insert(key, new std::string(key), 1,
+                                   &CountedDeleter, &handle);
+          if (!s.ok()) {
+            num_errors.fetch_add(1);
+            continue;
+          }
+        }
+        if (*static_cast<std::string*>(cache->Value(handle)) != key) {
+          num_errors.fetch_add(1);
+        }
+        cache->Release(handle, rnd.OneIn(2) /* force_erase */);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, num_errors.load());
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+  // Every value is deleted exactly once
+  cache.reset();
+  ASSERT_EQ(0, num_live_values.load());
+}
+
 #ifdef SUPPORT_CLOCK_CACHE
 std::shared_ptr<Cache> (*new_clock_cache_func)(
     size_t, int, bool, CacheMetadataChargePolicy) = NewClockCache;
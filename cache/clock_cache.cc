@@ -27,13 +27,8 @@ std::shared_ptr<Cache> NewClockCache(
 #include <assert.h>
 #include <atomic>
 #include <deque>
-
-// "tbb/concurrent_hash_map.h" requires RTTI if exception is enabled.
-// Disable it so users can chooose to disable RTTI.
-#ifndef ROCKSDB_USE_RTTI
-#define TBB_USE_EXCEPTIONS 0
-#endif
-#include "tbb/concurrent_hash_map.h"
+#include <memory>
+#include <vector>
 
 #include "cache/sharded_cache.h"
 #include "port/malloc.h"
@@ -61,9 +56,11 @@ namespace {
 // to be re-use. This is to avoid memory dealocation, which is hard to deal
 // with in concurrent environment.
 //
-// The cache also maintains a concurrent hash map for lookup. Any concurrent
-// hash map implementation should do the work. We currently use
-// tbb::concurrent_hash_map because it supports concurrent erase.
+// The cache also maintains a hash map for lookup. It is an open-addressing
+// table with linear probing (ClockHashTable below), which can be read without
+// locking while it is being modified. Since a handle found in the table may
+// be evicted and re-used for another key at any time, readers take a
+// reference on the handle first and only then verify its key.
 //
 // Each cache handle has the following flags and counters, which are squeeze
 // in an atomic interger, to make sure the handle always be in a consistent
@@ -135,7 +132,7 @@ namespace {
 //    recycle bin:   | 1 | 5 |
 //                   +---+---+
 //
-// A global mutex guards the circular list, the head, and the recycle bin.
+// A per-shard mutex guards the circular list, the head, and the recycle bin.
 // We additionally require that modifying the hash map needs to hold the mutex.
 // As such, Modifying the cache (such as Insert() and Erase()) require to
 // hold the mutex. Lookup() only access the hash map and the flags associated
@@ -179,7 +176,9 @@ struct CacheHandle {
   void* value;
   size_t charge;
   Cache::DeleterFn deleter;
-  uint32_t hash;
+  // Atomic since lock-free lookups read it to skip handles of other keys
+  // while the handle may be re-used concurrently.
+  std::atomic<uint32_t> hash;
 
   // Addition to "charge" to get "total charge" under metadata policy.
   uint32_t meta_charge;
@@ -227,25 +226,158 @@ struct CacheHandle {
   inline size_t GetTotalCharge() { return charge + meta_charge; }
 };
 
-// Key of hash map. We store hash value with the key for convenience.
-struct CacheKey {
-  Slice key;
-  uint32_t hash_value;
+// Hash map from keys to in-cache handles, using open addressing with linear
+// probing on the upper bits of the hash (the lower bits select the shard).
+//
+// Modifications have to hold the shard mutex. Lookups through Find() take no
+// lock. A lock-free reader may miss an entry while another entry is being
+// erased and the entries behind it are shifted back, which is acceptable for
+// a cache. Handles are never freed before the shard, so following a stale
+// pointer is safe, but the reader has to verify the handle after taking a
+// reference on it. Slot arrays replaced on growth are retired rather than
+// freed, for the same reason. Since the table only grows, the retired arrays
+// together are smaller than the current one.
+class ClockHashTable {
+ public:
+  ClockHashTable() { Resize(kInitialLengthBits); }
+
+  // Lock-free lookup. Calls `match` on the handles whose hash equals `hash`
+  // until it returns true, and returns that handle, or nullptr if none
+  // matches.
+  template <typename MatchFn>
+  CacheHandle* Find(uint32_t hash, const MatchFn& match) const {
+    const Slots* slots = current_.load(std::memory_order_acquire);
+    const uint32_t mask = (uint32_t{1} << slots->length_bits) - 1;
+    uint32_t i = Home(hash, slots->length_bits);
+    for (uint32_t probes = 0; probes <= mask; ++probes, i = (i + 1) & mask) {
+      CacheHandle* handle = slots->slots[i].load(std::memory_order_acquire);
+      if (handle == nullptr) {
+        break;
+      }
+      if (handle->hash.load(std::memory_order_relaxed) == hash &&
+          match(handle)) {
+        return handle;
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns the handle of `key`. Has to hold the shard mutex.
+  CacheHandle* Lookup(const Slice& key, uint32_t hash) const {
+    return Find(hash, [&key](CacheHandle* h) { return h->key == key; });
+  }
+
+  // Adds a handle whose key is not in the table yet. Has to hold the shard
+  // mutex.
+  void Insert(CacheHandle* handle) {
+    Slots* slots = current_.load(std::memory_order_relaxed);
+    if ((elems_ + 1) * 2 > (size_t{1} << slots->length_bits)) {
+      Resize(slots->length_bits + 1);
+      slots = current_.load(std::memory_order_relaxed);
+    }
+    InsertInto(slots, handle);
+    ++elems_;
+  }
+
+  // Removes the handle from the table. Returns false if it is not in the
+  // table. Has to hold the shard mutex.
+  bool Remove(CacheHandle* handle) {
+    Slots* slots = current_.load(std::memory_order_relaxed);
+    const uint32_t mask = (uint32_t{1} << slots->length_bits) - 1;
+    uint32_t i = Home(handle->hash.load(std::memory_order_relaxed),
+                      slots->length_bits);
+    for (;; i = (i + 1) & mask) {
+      CacheHandle* h = slots->slots[i].load(std::memory_order_relaxed);
+      if (h == nullptr) {
+        return false;
+      }
+      if (h == handle) {
+        break;
+      }
+    }
+    // Shift back the following entries of the cluster which would otherwise
+    // no longer be reachable from their home slot.
+    for (uint32_t j = (i + 1) & mask;; j = (j + 1) & mask) {
+      CacheHandle* h = slots->slots[j].load(std::memory_order_relaxed);
+      if (h == nullptr) {
+        break;
+      }
+      uint32_t home =
+          Home(h->hash.load(std::memory_order_relaxed), slots->length_bits);
+      // Move h into the hole at i unless its home lies cyclically in (i, j].
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        slots->slots[i].store(h, std::memory_order_release);
+        i = j;
+      }
+    }
+    slots->slots[i].store(nullptr, std::memory_order_release);
+    --elems_;
+    return true;
+  }
+
+  // Removes all handles. Has to hold the shard mutex.
+  void Clear() {
+    Slots* slots = current_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < (size_t{1} << slots->length_bits); ++i) {
+      slots->slots[i].store(nullptr, std::memory_order_release);
+    }
+    elems_ = 0;
+  }
 
-  CacheKey() = default;
+ private:
+  static const int kInitialLengthBits = 4;
+  // The upper hash bits index the table, so more slots would not help.
+  static const int kMaxLengthBits = 31;
+
+  struct Slots {
+    explicit Slots(int bits)
+        : length_bits(bits),
+          slots(new std::atomic<CacheHandle*>[size_t{1} << bits]) {
+      for (size_t i = 0; i < (size_t{1} << bits); ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
 
-  CacheKey(const Slice& k, uint32_t h) {
-    key = k;
-    hash_value = h;
+    const int length_bits;
+    std::unique_ptr<std::atomic<CacheHandle*>[]> slots;
+  };
+
+  static uint32_t Home(uint32_t hash, int length_bits) {
+    return hash >> (32 - length_bits);
   }
 
-  static bool equal(const CacheKey& a, const CacheKey& b) {
-    return a.hash_value == b.hash_value && a.key == b.key;
+  static void InsertInto(Slots* slots, CacheHandle* handle) {
+    const uint32_t mask = (uint32_t{1} << slots->length_bits) - 1;
+    uint32_t i = Home(handle->hash.load(std::memory_order_relaxed),
+                      slots->length_bits);
+    while (slots->slots[i].load(std::memory_order_relaxed) != nullptr) {
+      i = (i + 1) & mask;
+    }
+    slots->slots[i].store(handle, std::memory_order_release);
   }
 
-  static size_t hash(const CacheKey& a) {
-    return static_cast<size_t>(a.hash_value);
+  void Resize(int length_bits) {
+    if (length_bits > kMaxLengthBits) {
+      return;
+    }
+    std::unique_ptr<Slots> new_slots(new Slots(length_bits));
+    Slots* old_slots = current_.load(std::memory_order_relaxed);
+    if (old_slots != nullptr) {
+      for (size_t i = 0; i < (size_t{1} << old_slots->length_bits); ++i) {
+        CacheHandle* h = old_slots->slots[i].load(std::memory_order_relaxed);
+        if (h != nullptr) {
+          InsertInto(new_slots.get(), h);
+        }
+      }
+    }
+    current_.store(new_slots.get(), std::memory_order_release);
+    all_slots_.push_back(std::move(new_slots));
   }
+
+  std::atomic<Slots*> current_{nullptr};
+  // The current slot array and all retired ones.
+  std::vector<std::unique_ptr<Slots>> all_slots_;
+  size_t elems_ = 0;
 };
 
 struct CleanupContext {
@@ -259,9 +391,6 @@ struct CleanupContext {
 // A cache shard which maintains its own CLOCK cache.
 class ClockCacheShard final : public CacheShard {
  public:
-  // Hash map type.
-  using HashTable = tbb::concurrent_hash_map<CacheKey, CacheHandle*, CacheKey>;
-
   ClockCacheShard();
   ~ClockCacheShard() override;
 
@@ -398,8 +527,8 @@ class ClockCacheShard final : public CacheShard {
   // Whether allow insert into cache if cache is full.
   std::atomic<bool> strict_capacity_limit_;
 
-  // Hash table (tbb::concurrent_hash_map) for lookup.
-  HashTable table_;
+  // Hash table for lookup.
+  ClockHashTable table_;
 };
 
 ClockCacheShard::ClockCacheShard()
@@ -558,8 +687,7 @@ bool ClockCacheShard::TryEvict(CacheHandle* handle, CleanupContext* context) {
   uint32_t flags = kInCacheBit;
   if (handle->flags.compare_exchange_strong(flags, 0, std::memory_order_acquire,
                                             std::memory_order_relaxed)) {
-    bool erased __attribute__((__unused__)) =
-        table_.erase(CacheKey(handle->key, handle->hash));
+    bool erased __attribute__((__unused__)) = table_.Remove(handle);
     assert(erased);
     RecycleHandle(handle, context);
     return true;
@@ -639,30 +767,29 @@ CacheHandle* ClockCacheShard::Insert(
   }
   // Fill handle.
   handle->key = key;
-  handle->hash = hash;
+  handle->hash.store(hash, std::memory_order_relaxed);
   handle->value = value;
   handle->charge = charge;
   handle->meta_charge = meta_charge;
   handle->deleter = deleter;
   uint32_t flags = hold_reference ? kInCacheBit + kOneRef : kInCacheBit;
 
-  // TODO investigate+fix suspected race condition:
-  // [thread 1] Lookup starts, up to Ref()
-  // [thread 2] Erase/evict the entry just looked up
-  // [thread 1] Ref() the handle, even though it's in the recycle bin
-  // [thread 2] Insert with recycling that handle
-  // Here we obliterate the other thread's Ref
-  // Possible fix: never blindly overwrite the flags, but only make
-  // relative updates (fetch_add, etc).
-  handle->flags.store(flags, std::memory_order_relaxed);
-  HashTable::accessor accessor;
-  if (table_.find(accessor, CacheKey(key, hash))) {
+  // Overwriting the flags cannot drop a reference taken by a concurrent
+  // Lookup(): a handle is only recycled once it is out of cache with no
+  // references, i.e. its flags are 0, and Ref() never adds a reference to a
+  // handle out of cache. A Lookup() that took its reference after the handle
+  // was re-used sees the new key and drops the reference.
+  //
+  // Use release semantics so that lock-free lookups which reference the
+  // handle see the fields filled above.
+  handle->flags.store(flags, std::memory_order_release);
+  CacheHandle* existing_handle = table_.Lookup(key, hash);
+  if (existing_handle != nullptr) {
     *overwritten = true;
-    CacheHandle* existing_handle = accessor->second;
-    table_.erase(accessor);
+    table_.Remove(existing_handle);
     UnsetInCache(existing_handle, context);
   }
-  table_.insert(HashTable::value_type(CacheKey(key, hash), handle));
+  table_.Insert(handle);
   if (hold_reference) {
     pinned_usage_.fetch_add(total_charge, std::memory_order_relaxed);
   }
@@ -676,7 +803,6 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
                                Cache::Handle** out_handle,
                                Cache::Priority /*priority*/) {
   CleanupContext context;
-  HashTable::accessor accessor;
   char* key_data = new char[key.size()];
   memcpy(key_data, key.data(), key.size());
   Slice key_copy(key_data, key.size());
@@ -700,37 +826,42 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
 }
 
 Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash) {
-  HashTable::const_accessor accessor;
-  if (!table_.find(accessor, CacheKey(key, hash))) {
-    return nullptr;
-  }
-  CacheHandle* handle = accessor->second;
-  accessor.release();
-  // Ref() could fail if another thread sneak in and evict/erase the cache
-  // entry before we are able to hold reference.
-  if (!Ref(reinterpret_cast<Cache::Handle*>(handle))) {
-    return nullptr;
-  }
-  // Double check the key since the handle may now representing another key
-  // if other threads sneak in, evict/erase the entry and re-used the handle
-  // for another cache entry.
-  if (hash != handle->hash || key != handle->key) {
-    CleanupContext context;
-    Unref(handle, false, &context);
-    // It is possible Unref() delete the entry, so we need to cleanup.
-    Cleanup(context);
-    return nullptr;
-  }
+  CacheHandle* handle = table_.Find(hash, [&](CacheHandle* h) {
+    // Ref() could fail if another thread sneak in and evict/erase the cache
+    // entry before we are able to hold reference.
+    if (!Ref(reinterpret_cast<Cache::Handle*>(h))) {
+      return false;
+    }
+    // Double check the key since the handle may now representing another key
+    // if other threads sneak in, evict/erase the entry and re-used the handle
+    // for another cache entry.
+    if (hash != h->hash.load(std::memory_order_relaxed) || key != h->key) {
+      CleanupContext context;
+      Unref(h, false, &context);
+      // It is possible Unref() delete the entry, so we need to cleanup.
+      Cleanup(context);
+      return false;
+    }
+    return true;
+  });
   return reinterpret_cast<Cache::Handle*>(handle);
 }
 
 bool ClockCacheShard::Release(Cache::Handle* h, bool force_erase) {
   CleanupContext context;
   CacheHandle* handle = reinterpret_cast<CacheHandle*>(h);
-  bool erased = Unref(handle, true, &context);
-  if (force_erase && !erased) {
-    erased = EraseAndConfirm(handle->key, handle->hash, &context);
+  if (force_erase) {
+    // Erase the entry while the reference is held: once it is released, the
+    // handle, along with its key, may be recycled by another thread.
+    MutexLock l(&mutex_);
+    if (table_.Lookup(handle->key,
+                      handle->hash.load(std::memory_order_relaxed)) ==
+        handle) {
+      table_.Remove(handle);
+      UnsetInCache(handle, &context);
+    }
   }
+  bool erased = Unref(handle, true, &context);
   Cleanup(context);
   return erased;
 }
@@ -744,11 +875,10 @@ void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
 bool ClockCacheShard::EraseAndConfirm(const Slice& key, uint32_t hash,
                                       CleanupContext* context) {
   MutexLock l(&mutex_);
-  HashTable::accessor accessor;
   bool erased = false;
-  if (table_.find(accessor, CacheKey(key, hash))) {
-    CacheHandle* handle = accessor->second;
-    table_.erase(accessor);
+  CacheHandle* handle = table_.Lookup(key, hash);
+  if (handle != nullptr) {
+    table_.Remove(handle);
     erased = UnsetInCache(handle, context);
   }
   return erased;
@@ -758,7 +888,7 @@ void ClockCacheShard::EraseUnRefEntries() {
   CleanupContext context;
   {
     MutexLock l(&mutex_);
-    table_.clear();
+    table_.Clear();
     for (auto& handle : list_) {
       UnsetInCache(&handle, &context);
     }
@@ -801,7 +931,8 @@ class ClockCache final : public ShardedCache {
   }
 
   uint32_t GetHash(Handle* handle) const override {
-    return reinterpret_cast<const CacheHandle*>(handle)->hash;
+    return reinterpret_cast<const CacheHandle*>(handle)->hash.load(
+        std::memory_order_relaxed);
   }
 
   DeleterFn GetDeleter(Handle* handle) const override {
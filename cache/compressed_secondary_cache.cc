@@ -0,0 +1,203 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/compressed_secondary_cache.h"
+
+#include <memory>
+
+#include "memory/memory_allocator.h"
+#include "util/compression.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+void DeletionCallback(const Slice& /*key*/, void* obj) {
+  delete reinterpret_cast<CacheAllocationPtr*>(obj);
+}
+
+}  // namespace
+
+CompressedSecondaryCache::CompressedSecondaryCache(
+    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+    double high_pri_pool_ratio,
+    std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
+    CacheMetadataChargePolicy metadata_charge_policy,
+    CompressionType compression_type, uint32_t compress_format_version)
+    : cache_options_(capacity, num_shard_bits, strict_capacity_limit,
+                     high_pri_pool_ratio, memory_allocator, use_adaptive_mutex,
+                     metadata_charge_policy, compression_type,
+                     compress_format_version) {
+  cache_ = NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
+                       high_pri_pool_ratio, memory_allocator,
+                       use_adaptive_mutex, metadata_charge_policy);
+}
+
+CompressedSecondaryCache::~CompressedSecondaryCache() { cache_.reset(); }
+
+CompressedSecondaryCacheResultHandle::~CompressedSecondaryCacheResultHandle() {
+  if (lru_handle_ != nullptr) {
+    // The block was never promoted, so it stays in the secondary cache
+    cache_->Release(lru_handle_, /* erase_if_last_ref */ false);
+  }
+}
+
+void CompressedSecondaryCacheResultHandle::Wait() {
+  if (lru_handle_ == nullptr) {
+    return;
+  }
+
+  CacheAllocationPtr* ptr =
+      reinterpret_cast<CacheAllocationPtr*>(cache_->Value(lru_handle_));
+  // The first byte is the compression type actually used for the entry.
+  char* data = ptr->get();
+  const size_t size = cache_->GetCharge(lru_handle_);
+  assert(size > 0);
+  CompressionType type = static_cast<CompressionType>(data[0]);
+
+  void* value = nullptr;
+  size_t charge = 0;
+  Status s;
+  if (type == kNoCompression) {
+    s = create_cb_(data + 1, size - 1, &value, &charge);
+  } else {
+    UncompressionContext uncompression_context(type);
+    UncompressionInfo uncompression_info(uncompression_context,
+                                         UncompressionDict::GetEmptyDict(),
+                                         type);
+
+    size_t uncompressed_size = 0;
+    CacheAllocationPtr uncompressed =
+        UncompressData(uncompression_info, data + 1, size - 1,
+                       &uncompressed_size, compress_format_version_,
+                       memory_allocator_);
+    if (!uncompressed) {
+      s = Status::Corruption("Failed to uncompress a cached block");
+    } else {
+      s = create_cb_(uncompressed.get(), uncompressed_size, &value, &charge);
+    }
+  }
+
+  // The block is promoted to the primary cache, or dropped if it cannot be,
+  // so it does not need to stay here.
+  cache_->Release(lru_handle_, /* erase_if_last_ref */ true);
+  lru_handle_ = nullptr;
+  if (s.ok()) {
+    value_ = value;
+    size_ = charge;
+  }
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
+    const Slice& key, const Cache::CreateCallback& create_cb, bool wait) {
+  std::unique_ptr<SecondaryCacheResultHandle> handle;
+  Cache::Handle* lru_handle = cache_->Lookup(key);
+  if (lru_handle == nullptr) {
+    return handle;
+  }
+
+  handle.reset(new CompressedSecondaryCacheResultHandle(
+      cache_.get(), lru_handle, create_cb,
+      cache_options_.compress_format_version,
+      cache_options_.memory_allocator.get()));
+  if (wait) {
+    handle->Wait();
+    if (handle->Value() == nullptr) {
+      handle.reset();
+    }
+  }
+  return handle;
+}
+
+void CompressedSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  for (SecondaryCacheResultHandle* handle : handles) {
+    handle->Wait();
+  }
+}
+
+Status CompressedSecondaryCache::Insert(const Slice& key, void* value,
+                                        const Cache::CacheItemHelper* helper) {
+  size_t size = (*helper->size_cb)(value);
+  CacheAllocationPtr ptr =
+      AllocateBlock(size, cache_options_.memory_allocator.get());
+
+  Status s = (*helper->saveto_cb)(value, 0, size, ptr.get());
+  if (!s.ok()) {
+    return s;
+  }
+  Slice val(ptr.get(), size);
+
+  std::string compressed_val;
+  CompressionType type = cache_options_.compression_type;
+  if (type != kNoCompression) {
+    CompressionOptions compression_opts;
+    CompressionContext compression_context(type);
+    uint64_t sample_for_compression = 0;
+    CompressionInfo compression_info(
+        compression_opts, compression_context, CompressionDict::GetEmptyDict(),
+        type, sample_for_compression);
+    // Keep the block uncompressed if it does not compress well, as a block
+    // based table would.
+    if (!CompressData(val, compression_info,
+                      cache_options_.compress_format_version,
+                      &compressed_val) ||
+        compressed_val.size() >= size - (size / 8u)) {
+      type = kNoCompression;
+    } else {
+      val = Slice(compressed_val);
+    }
+  }
+
+  CacheAllocationPtr buf =
+      AllocateBlock(val.size() + 1, cache_options_.memory_allocator.get());
+  buf.get()[0] = static_cast<char>(type);
+  memcpy(buf.get() + 1, val.data(), val.size());
+  CacheAllocationPtr* obj = new CacheAllocationPtr(std::move(buf));
+  return cache_->Insert(key, obj, val.size() + 1, DeletionCallback);
+}
+
+void CompressedSecondaryCache::Erase(const Slice& key) { cache_->Erase(key); }
+
+std::string CompressedSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(20000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  ret.append(cache_->GetPrintableOptions());
+  snprintf(buffer, kBufferSize, "    compression_type : %s\n",
+           CompressionTypeToString(cache_options_.compression_type).c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
+           cache_options_.compress_format_version);
+  ret.append(buffer);
+  return ret;
+}
+
+std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
+    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+    double high_pri_pool_ratio,
+    std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
+    CacheMetadataChargePolicy metadata_charge_policy,
+    CompressionType compression_type, uint32_t compress_format_version) {
+  return std::make_shared<CompressedSecondaryCache>(
+      capacity, num_shard_bits, strict_capacity_limit, high_pri_pool_ratio,
+      memory_allocator, use_adaptive_mutex, metadata_charge_policy,
+      compression_type, compress_format_version);
+}
+
+std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
+    const CompressedSecondaryCacheOptions& opts) {
+  // The secondary_cache is disabled for this LRUCache instance.
+  assert(opts.secondary_cache == nullptr);
+  return NewCompressedSecondaryCache(
+      opts.capacity, opts.num_shard_bits, opts.strict_capacity_limit,
+      opts.high_pri_pool_ratio, opts.memory_allocator, opts.use_adaptive_mutex,
+      opts.metadata_charge_policy, opts.compression_type,
+      opts.compress_format_version);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
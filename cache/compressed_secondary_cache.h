@@ -0,0 +1,121 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+
+#include "cache/lru_cache.h"
+#include "memory/memory_allocator.h"
+#include "rocksdb/secondary_cache.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "util/compression.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The result of a lookup in a CompressedSecondaryCache. It holds the entry
+// of the compressed block until Wait() decompresses it and creates the
+// object.
+class CompressedSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
+ public:
+  CompressedSecondaryCacheResultHandle(Cache* cache, Cache::Handle* lru_handle,
+                                       const Cache::CreateCallback& create_cb,
+                                       uint32_t compress_format_version,
+                                       MemoryAllocator* memory_allocator)
+      : cache_(cache),
+        lru_handle_(lru_handle),
+        create_cb_(create_cb),
+        compress_format_version_(compress_format_version),
+        memory_allocator_(memory_allocator) {}
+  virtual ~CompressedSecondaryCacheResultHandle() override;
+
+  CompressedSecondaryCacheResultHandle(
+      const CompressedSecondaryCacheResultHandle&) = delete;
+  CompressedSecondaryCacheResultHandle& operator=(
+      const CompressedSecondaryCacheResultHandle&) = delete;
+
+  bool IsReady() override { return lru_handle_ == nullptr; }
+
+  // Decompresses the block and creates the object, then drops the entry
+  // from the secondary cache, as the block is promoted to the primary cache.
+  void Wait() override;
+
+  void* Value() override {
+    assert(IsReady());
+    return value_;
+  }
+
+  size_t Size() override {
+    assert(IsReady());
+    return size_;
+  }
+
+ private:
+  Cache* const cache_;
+  // The entry of the compressed block, until the handle is ready
+  Cache::Handle* lru_handle_;
+  const Cache::CreateCallback create_cb_;
+  const uint32_t compress_format_version_;
+  MemoryAllocator* const memory_allocator_;
+  void* value_ = nullptr;
+  size_t size_ = 0;
+};
+
+// The CompressedSecondaryCache is a concrete implementation of
+// rocksdb::SecondaryCache.
+//
+// Users can also cast a pointer to it and call methods on
+// it directly, especially custom methods that may be added
+// in the future.  For example -
+// std::unique_ptr<rocksdb::SecondaryCache> cache =
+//      NewCompressedSecondaryCache(opts);
+// static_cast<CompressedSecondaryCache*>(cache.get())->Erase(key);
+//
+// Blocks demoted from the primary cache are serialized through the
+// CacheItemHelper callbacks, compressed and kept in an LRUCache whose
+// capacity accounts for the compressed size only. A successful lookup
+// decompresses the block and erases it, since the block is promoted back to
+// the primary cache. With wait=false, the decompression is left to Wait() or
+// WaitAll() on the returned handles, so that a caller looking up several
+// blocks does not decompress each before looking up the next.
+class CompressedSecondaryCache : public SecondaryCache {
+ public:
+  CompressedSecondaryCache(
+      size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+      double high_pri_pool_ratio,
+      std::shared_ptr<MemoryAllocator> memory_allocator = nullptr,
+      bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
+      CacheMetadataChargePolicy metadata_charge_policy =
+          kDefaultCacheMetadataChargePolicy,
+      CompressionType compression_type = CompressionType::kLZ4Compression,
+      uint32_t compress_format_version = 2);
+  virtual ~CompressedSecondaryCache() override;
+
+  const char* Name() const override { return "CompressedSecondaryCache"; }
+
+  Status Insert(const Slice& key, void* value,
+                const Cache::CacheItemHelper* helper) override;
+
+  // With wait=false, the handle returned for a cached block is not ready
+  // until Wait() or WaitAll() is called, and has a nullptr value then if the
+  // block could not be decompressed or created.
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CreateCallback& create_cb,
+      bool wait) override;
+
+  void Erase(const Slice& key) override;
+
+  // Decompresses the blocks of the handles in the calling thread
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  std::string GetPrintableOptions() const override;
+
+ private:
+  std::shared_ptr<Cache> cache_;
+  CompressedSecondaryCacheOptions cache_options_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
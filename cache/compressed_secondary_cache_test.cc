@@ -0,0 +1,401 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/compressed_secondary_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "rocksdb/convenience.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class CompressedSecondaryCacheTest : public testing::Test {
+ public:
+  CompressedSecondaryCacheTest() : fail_create_(false) {}
+  ~CompressedSecondaryCacheTest() {}
+
+ protected:
+  class TestItem {
+   public:
+    TestItem(const char* buf, size_t size) : buf_(new char[size]), size_(size) {
+      memcpy(buf_.get(), buf, size);
+    }
+    ~TestItem() {}
+
+    char* Buf() { return buf_.get(); }
+    size_t Size() { return size_; }
+    std::string ToString() { return std::string(Buf(), Size()); }
+
+   private:
+    std::unique_ptr<char[]> buf_;
+    size_t size_;
+  };
+
+  static size_t SizeCallback(void* obj) {
+    return reinterpret_cast<TestItem*>(obj)->Size();
+  }
+
+  static Status SaveToCallback(void* from_obj, size_t from_offset,
+                               size_t length, void* out) {
+    TestItem* item = reinterpret_cast<TestItem*>(from_obj);
+    const char* buf = item->Buf();
+    EXPECT_EQ(length, item->Size());
+    EXPECT_EQ(from_offset, 0);
+    memcpy(out, buf, length);
+    return Status::OK();
+  }
+
+  static void DeletionCallback(const Slice& /*key*/, void* obj) {
+    delete reinterpret_cast<TestItem*>(obj);
+    obj = nullptr;
+  }
+
+  static Cache::CacheItemHelper helper_;
+
+  static Status SaveToCallbackFail(void* /*obj*/, size_t /*offset*/,
+                                   size_t /*size*/, void* /*out*/) {
+    return Status::NotSupported();
+  }
+
+  static Cache::CacheItemHelper helper_fail_;
+
+  Cache::CreateCallback test_item_creator = [&](void* buf, size_t size,
+                                                void** out_obj,
+                                                size_t* charge) -> Status {
+    if (fail_create_) {
+      return Status::NotSupported();
+    }
+    *out_obj = reinterpret_cast<void*>(new TestItem((char*)buf, size));
+    *charge = size;
+    return Status::OK();
+  };
+
+  void SetFailCreate(bool fail) { fail_create_ = fail; }
+
+  // Half random, half repeated data, so that LZ4 can compress it.
+  static std::string CompressibleString(Random* rnd, size_t len) {
+    std::string str = rnd->RandomString(static_cast<int>(len / 2));
+    str.append(len - str.size(), 'a');
+    return str;
+  }
+
+  void BasicTest(bool sec_cache_is_compressed) {
+    CompressedSecondaryCacheOptions opts;
+    opts.capacity = 2048;
+    opts.num_shard_bits = 0;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    if (sec_cache_is_compressed) {
+      if (!LZ4_Supported()) {
+        ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+        opts.compression_type = CompressionType::kNoCompression;
+      }
+    } else {
+      opts.compression_type = CompressionType::kNoCompression;
+    }
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+
+    // Lookup a non-existent key.
+    std::unique_ptr<SecondaryCacheResultHandle> handle0 =
+        sec_cache->Lookup("k0", test_item_creator, true);
+    ASSERT_EQ(handle0, nullptr);
+
+    Random rnd(301);
+    std::string str1 = CompressibleString(&rnd, 1000);
+    TestItem item1(str1.data(), str1.length());
+    ASSERT_OK(sec_cache->Insert("k1", &item1,
+                                &CompressedSecondaryCacheTest::helper_));
+
+    std::unique_ptr<SecondaryCacheResultHandle> handle1 =
+        sec_cache->Lookup("k1", test_item_creator, true);
+    ASSERT_NE(handle1, nullptr);
+    ASSERT_TRUE(handle1->IsReady());
+    std::unique_ptr<TestItem> val1 =
+        std::unique_ptr<TestItem>(static_cast<TestItem*>(handle1->Value()));
+    ASSERT_NE(val1, nullptr);
+    ASSERT_EQ(val1->ToString(), str1);
+    ASSERT_EQ(handle1->Size(), str1.size());
+
+    // The entry was promoted by the lookup, so it is no longer here.
+    std::unique_ptr<SecondaryCacheResultHandle> handle1_1 =
+        sec_cache->Lookup("k1", test_item_creator, true);
+    ASSERT_EQ(handle1_1, nullptr);
+
+    // An incompressible value is stored as is.
+    std::string str2 = rnd.RandomString(1000);
+    TestItem item2(str2.data(), str2.length());
+    ASSERT_OK(sec_cache->Insert("k2", &item2,
+                                &CompressedSecondaryCacheTest::helper_));
+    std::unique_ptr<SecondaryCacheResultHandle> handle2 =
+        sec_cache->Lookup("k2", test_item_creator, true);
+    ASSERT_NE(handle2, nullptr);
+    std::unique_ptr<TestItem> val2 =
+        std::unique_ptr<TestItem>(static_cast<TestItem*>(handle2->Value()));
+    ASSERT_NE(val2, nullptr);
+    ASSERT_EQ(val2->ToString(), str2);
+
+    sec_cache->Erase("k2");
+    sec_cache.reset();
+  }
+
+ private:
+  bool fail_create_;
+};
+
+Cache::CacheItemHelper CompressedSecondaryCacheTest::helper_(
+    CompressedSecondaryCacheTest::SizeCallback,
+    CompressedSecondaryCacheTest::SaveToCallback,
+    CompressedSecondaryCacheTest::DeletionCallback);
+
+Cache::CacheItemHelper CompressedSecondaryCacheTest::helper_fail_(
+    CompressedSecondaryCacheTest::SizeCallback,
+    CompressedSecondaryCacheTest::SaveToCallbackFail,
+    CompressedSecondaryCacheTest::DeletionCallback);
+
+TEST_F(CompressedSecondaryCacheTest, BasicTestWithNoCompression) {
+  BasicTest(false);
+}
+
+TEST_F(CompressedSecondaryCacheTest, BasicTestWithCompression) {
+  BasicTest(true);
+}
+
+TEST_F(CompressedSecondaryCacheTest, CompressedCapacity) {
+  if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+    return;
+  }
+  // Each value is 1000 bytes uncompressed but much smaller compressed, so
+  // all of them fit into a secondary cache of 2048 bytes.
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(
+      2048, 0, true, 0.5, nullptr, kDefaultToAdaptiveMutex,
+      kDontChargeCacheMetadata, CompressionType::kLZ4Compression);
+  Random rnd(301);
+  std::vector<std::string> strs;
+  for (int i = 0; i < 4; i++) {
+    strs.push_back(CompressibleString(&rnd, 1000));
+    TestItem item(strs.back().data(), strs.back().length());
+    ASSERT_OK(sec_cache->Insert("k" + std::to_string(i), &item,
+                                &CompressedSecondaryCacheTest::helper_));
+  }
+  for (int i = 0; i < 4; i++) {
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup("k" + std::to_string(i), test_item_creator, true);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_EQ(val->ToString(), strs[i]);
+  }
+}
+
+TEST_F(CompressedSecondaryCacheTest, FailsTest) {
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(
+      1100, 0, true, 0.5, nullptr, kDefaultToAdaptiveMutex,
+      kDontChargeCacheMetadata, CompressionType::kNoCompression);
+  Random rnd(301);
+
+  std::string str1 = rnd.RandomString(1000);
+  TestItem item1(str1.data(), str1.length());
+  ASSERT_OK(sec_cache->Insert("k1", &item1,
+                              &CompressedSecondaryCacheTest::helper_));
+
+  // The second entry does not fit along with the first, so the first is
+  // evicted.
+  std::string str2 = rnd.RandomString(200);
+  TestItem item2(str2.data(), str2.length());
+  ASSERT_OK(sec_cache->Insert("k2", &item2,
+                              &CompressedSecondaryCacheTest::helper_));
+  std::unique_ptr<SecondaryCacheResultHandle> handle1 =
+      sec_cache->Lookup("k1", test_item_creator, true);
+  ASSERT_EQ(handle1, nullptr);
+
+  // Serialization failures are returned to the caller.
+  ASSERT_NOK(sec_cache->Insert("k3", &item2,
+                               &CompressedSecondaryCacheTest::helper_fail_));
+
+  // A failing create callback is a miss, and drops the entry.
+  SetFailCreate(true);
+  std::unique_ptr<SecondaryCacheResultHandle> handle2 =
+      sec_cache->Lookup("k2", test_item_creator, true);
+  ASSERT_EQ(handle2, nullptr);
+  SetFailCreate(false);
+  handle2 = sec_cache->Lookup("k2", test_item_creator, true);
+  ASSERT_EQ(handle2, nullptr);
+}
+
+TEST_F(CompressedSecondaryCacheTest, DeferredLookup) {
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 4096;
+  opts.num_shard_bits = 0;
+  opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  if (!LZ4_Supported()) {
+    opts.compression_type = CompressionType::kNoCompression;
+  }
+  std::shared_ptr<SecondaryCache> sec_cache =
+      NewCompressedSecondaryCache(opts);
+
+  Random rnd(301);
+  std::string str1 = CompressibleString(&rnd, 1000);
+  TestItem item1(str1.data(), str1.length());
+  ASSERT_OK(sec_cache->Insert("k1", &item1,
+                              &CompressedSecondaryCacheTest::helper_));
+  std::string str2 = CompressibleString(&rnd, 1000);
+  TestItem item2(str2.data(), str2.length());
+  ASSERT_OK(sec_cache->Insert("k2", &item2,
+                              &CompressedSecondaryCacheTest::helper_));
+
+  // The blocks are only decompressed by WaitAll().
+  std::unique_ptr<SecondaryCacheResultHandle> handle1 =
+      sec_cache->Lookup("k1", test_item_creator, false);
+  std::unique_ptr<SecondaryCacheResultHandle> handle2 =
+      sec_cache->Lookup("k2", test_item_creator, false);
+  ASSERT_NE(handle1, nullptr);
+  ASSERT_NE(handle2, nullptr);
+  ASSERT_FALSE(handle1->IsReady());
+  ASSERT_FALSE(handle2->IsReady());
+  sec_cache->WaitAll({handle1.get(), handle2.get()});
+  ASSERT_TRUE(handle1->IsReady());
+  ASSERT_TRUE(handle2->IsReady());
+  std::unique_ptr<TestItem> val1 =
+      std::unique_ptr<TestItem>(static_cast<TestItem*>(handle1->Value()));
+  ASSERT_NE(val1, nullptr);
+  ASSERT_EQ(val1->ToString(), str1);
+  std::unique_ptr<TestItem> val2 =
+      std::unique_ptr<TestItem>(static_cast<TestItem*>(handle2->Value()));
+  ASSERT_NE(val2, nullptr);
+  ASSERT_EQ(val2->ToString(), str2);
+  ASSERT_EQ(sec_cache->Lookup("k1", test_item_creator, true), nullptr);
+
+  // A handle dropped before it is ready leaves the block in the cache.
+  std::string str3 = CompressibleString(&rnd, 1000);
+  TestItem item3(str3.data(), str3.length());
+  ASSERT_OK(sec_cache->Insert("k3", &item3,
+                              &CompressedSecondaryCacheTest::helper_));
+  std::unique_ptr<SecondaryCacheResultHandle> handle3 =
+      sec_cache->Lookup("k3", test_item_creator, false);
+  ASSERT_NE(handle3, nullptr);
+  handle3.reset();
+
+  // A failing create callback leaves a ready handle without a value.
+  SetFailCreate(true);
+  handle3 = sec_cache->Lookup("k3", test_item_creator, false);
+  ASSERT_NE(handle3, nullptr);
+  handle3->Wait();
+  ASSERT_TRUE(handle3->IsReady());
+  ASSERT_EQ(handle3->Value(), nullptr);
+  SetFailCreate(false);
+}
+
+TEST_F(CompressedSecondaryCacheTest, BasicTestWithLRUCache) {
+  CompressedSecondaryCacheOptions secondary_cache_opts;
+  secondary_cache_opts.capacity = 2048;
+  secondary_cache_opts.num_shard_bits = 0;
+  secondary_cache_opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  if (!LZ4_Supported()) {
+    secondary_cache_opts.compression_type = CompressionType::kNoCompression;
+  }
+  std::shared_ptr<SecondaryCache> secondary_cache =
+      NewCompressedSecondaryCache(secondary_cache_opts);
+  LRUCacheOptions lru_cache_opts(1024, 0, false, 0.5, nullptr,
+                                 kDefaultToAdaptiveMutex,
+                                 kDontChargeCacheMetadata);
+  lru_cache_opts.secondary_cache = secondary_cache;
+  std::shared_ptr<Cache> cache = NewLRUCache(lru_cache_opts);
+
+  Random rnd(301);
+  std::string str1 = CompressibleString(&rnd, 1000);
+  TestItem* item1 = new TestItem(str1.data(), str1.length());
+  ASSERT_OK(cache->Insert("k1", item1, &CompressedSecondaryCacheTest::helper_,
+                          str1.length()));
+  std::string str2 = CompressibleString(&rnd, 1000);
+  TestItem* item2 = new TestItem(str2.data(), str2.length());
+  // k1 should be demoted to the secondary cache.
+  ASSERT_OK(cache->Insert("k2", item2, &CompressedSecondaryCacheTest::helper_,
+                          str2.length()));
+
+  Cache::Handle* handle;
+  handle = cache->Lookup("k2", &CompressedSecondaryCacheTest::helper_,
+                         test_item_creator, Cache::Priority::LOW, true);
+  ASSERT_NE(handle, nullptr);
+  cache->Release(handle);
+  // This lookup should promote k1 and demote k2.
+  handle = cache->Lookup("k1", &CompressedSecondaryCacheTest::helper_,
+                         test_item_creator, Cache::Priority::LOW, true);
+  ASSERT_NE(handle, nullptr);
+  TestItem* val1 = static_cast<TestItem*>(cache->Value(handle));
+  ASSERT_EQ(val1->ToString(), str1);
+  cache->Release(handle);
+  handle = cache->Lookup("k2", &CompressedSecondaryCacheTest::helper_,
+                         test_item_creator, Cache::Priority::LOW, true);
+  ASSERT_NE(handle, nullptr);
+  TestItem* val2 = static_cast<TestItem*>(cache->Value(handle));
+  ASSERT_EQ(val2->ToString(), str2);
+  cache->Release(handle);
+
+  // k3 is demoted by the insertion of k4, and promoted by WaitAll().
+  std::string str3 = CompressibleString(&rnd, 1000);
+  TestItem* item3 = new TestItem(str3.data(), str3.length());
+  ASSERT_OK(cache->Insert("k3", item3, &CompressedSecondaryCacheTest::helper_,
+                          str3.length()));
+  std::string str4 = CompressibleString(&rnd, 1000);
+  TestItem* item4 = new TestItem(str4.data(), str4.length());
+  ASSERT_OK(cache->Insert("k4", item4, &CompressedSecondaryCacheTest::helper_,
+                          str4.length()));
+  handle = cache->Lookup("k3", &CompressedSecondaryCacheTest::helper_,
+                         test_item_creator, Cache::Priority::LOW, false);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_FALSE(cache->IsReady(handle));
+  std::vector<Cache::Handle*> handles = {handle};
+  cache->WaitAll(handles);
+  ASSERT_TRUE(cache->IsReady(handle));
+  TestItem* val3 = static_cast<TestItem*>(cache->Value(handle));
+  ASSERT_EQ(val3->ToString(), str3);
+  cache->Release(handle);
+
+  cache.reset();
+  secondary_cache.reset();
+}
+
+#ifndef ROCKSDB_LITE
+TEST_F(CompressedSecondaryCacheTest, CreateFromString) {
+  std::shared_ptr<SecondaryCache> sec_cache;
+  ASSERT_OK(SecondaryCache::CreateFromString(
+      ConfigOptions(),
+      "compressed_secondary_cache://capacity=2048;num_shard_bits=0;"
+      "compression_type=kNoCompression;compress_format_version=2",
+      &sec_cache));
+  ASSERT_NE(sec_cache, nullptr);
+  ASSERT_STREQ(sec_cache->Name(), "CompressedSecondaryCache");
+  std::string printable = sec_cache->GetPrintableOptions();
+  ASSERT_NE(printable.find("compression_type : NoCompression"),
+            std::string::npos);
+  ASSERT_NE(printable.find("compress_format_version : 2"), std::string::npos);
+
+  Random rnd(301);
+  std::string str1 = rnd.RandomString(1000);
+  TestItem item1(str1.data(), str1.length());
+  ASSERT_OK(sec_cache->Insert("k1", &item1,
+                              &CompressedSecondaryCacheTest::helper_));
+  std::unique_ptr<SecondaryCacheResultHandle> handle1 =
+      sec_cache->Lookup("k1", test_item_creator, true);
+  ASSERT_NE(handle1, nullptr);
+  std::unique_ptr<TestItem> val1(static_cast<TestItem*>(handle1->Value()));
+  ASSERT_EQ(val1->ToString(), str1);
+
+  ASSERT_NOK(SecondaryCache::CreateFromString(
+      ConfigOptions(), "compressed_secondary_cache://no_such_option=1",
+      &sec_cache));
+}
+#endif  // ROCKSDB_LITE
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
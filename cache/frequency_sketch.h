@@ -0,0 +1,105 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A count-min sketch estimating how often each key hash was seen recently,
+// used by the TinyLFU admission policy of LRUCache. Each of the kDepth rows
+// holds small saturating counters indexed by an independent multiply-shift
+// hash of the key hash, and the estimate is the minimum over the rows.
+//
+// To favor recent popularity, all counters are halved once the number of
+// increments reaches a multiple of the row width ("aging"), so keys that are
+// no longer accessed lose their advantage over newly popular ones.
+//
+// Not thread safe; LRUCacheShard only uses it under its mutex.
+class FrequencySketch {
+ public:
+  // The row width is the smallest power of two that is at least
+  // `expected_entries`, within [kMinWidth, kMaxWidth].
+  explicit FrequencySketch(size_t expected_entries) {
+    width_bits_ = 0;
+    while ((size_t{1} << width_bits_) < expected_entries &&
+           (size_t{1} << width_bits_) < kMaxWidth) {
+      ++width_bits_;
+    }
+    while ((size_t{1} << width_bits_) < kMinWidth) {
+      ++width_bits_;
+    }
+    counters_.reset(new uint8_t[kDepth << width_bits_]());
+    sample_size_ = kSampleFactor << width_bits_;
+    additions_ = 0;
+  }
+
+  // Record one access of the key with the given hash.
+  void Increment(uint32_t hash) {
+    bool added = false;
+    for (int i = 0; i < kDepth; ++i) {
+      uint8_t& counter = counters_[Index(hash, i)];
+      if (counter < kMaxCount) {
+        ++counter;
+        added = true;
+      }
+    }
+    if (added && ++additions_ >= sample_size_) {
+      Age();
+    }
+  }
+
+  // Approximate number of recent accesses of the key with the given hash,
+  // never less than the true (aged) count, up to kMaxCount.
+  uint32_t Estimate(uint32_t hash) const {
+    uint32_t estimate = kMaxCount;
+    for (int i = 0; i < kDepth; ++i) {
+      estimate = std::min(estimate, uint32_t{counters_[Index(hash, i)]});
+    }
+    return estimate;
+  }
+
+  size_t ApproximateMemoryUsage() const {
+    return size_t{kDepth} << width_bits_;
+  }
+
+  static constexpr int kDepth = 4;
+  static constexpr uint8_t kMaxCount = 15;
+  static constexpr size_t kMinWidth = 1024;
+  static constexpr size_t kMaxWidth = size_t{1} << 22;
+  static constexpr size_t kSampleFactor = 10;
+
+ private:
+  size_t Index(uint32_t hash, int row) const {
+    // Multiply-shift hashing with a different odd multiplier per row. The
+    // top bits of the product depend on all bits of the key hash, including
+    // the ones that are the same for all keys of a shard.
+    static constexpr uint64_t kMultipliers[kDepth] = {
+        0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+        0xD6E8FEB86659FD93ULL};
+    uint64_t h = (uint64_t{hash} + 1) * kMultipliers[row];
+    return (static_cast<size_t>(row) << width_bits_) +
+           static_cast<size_t>(h >> (64 - width_bits_));
+  }
+
+  void Age() {
+    for (size_t i = 0; i < (size_t{kDepth} << width_bits_); ++i) {
+      counters_[i] >>= 1;
+    }
+    additions_ /= 2;
+  }
+
+  std::unique_ptr<uint8_t[]> counters_;
+  int width_bits_;
+  size_t sample_size_;
+  size_t additions_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
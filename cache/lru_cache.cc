@@ -19,6 +19,12 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// Expected average charge of an entry, used to size the TinyLFU frequency
+// sketch. This is the default block size of block-based tables.
+constexpr size_t kTinyLFUEntryChargeEstimate = 4 * 1024;
+}  // namespace
+
 LRUHandleTable::LRUHandleTable(int max_upper_hash_bits)
     : length_bits_(/* historical starting size*/ 4),
       list_(new LRUHandle* [size_t{1} << length_bits_] {}),
@@ -112,15 +118,19 @@ LRUCacheShard::LRUCacheShard(
     size_t capacity, bool strict_capacity_limit, double high_pri_pool_ratio,
     bool use_adaptive_mutex, CacheMetadataChargePolicy metadata_charge_policy,
     int max_upper_hash_bits,
-    const std::shared_ptr<SecondaryCache>& secondary_cache)
+    const std::shared_ptr<SecondaryCache>& secondary_cache,
+    bool use_tinylfu_admission, double tinylfu_window_ratio)
     : capacity_(0),
       high_pri_pool_usage_(0),
       strict_capacity_limit_(strict_capacity_limit),
       high_pri_pool_ratio_(high_pri_pool_ratio),
       high_pri_pool_capacity_(0),
+      tinylfu_window_ratio_(tinylfu_window_ratio),
+      window_capacity_(0),
       table_(max_upper_hash_bits),
       usage_(0),
       lru_usage_(0),
+      window_usage_(0),
       mutex_(use_adaptive_mutex),
       secondary_cache_(secondary_cache) {
   set_metadata_charge_policy(metadata_charge_policy);
@@ -128,6 +138,13 @@ LRUCacheShard::LRUCacheShard(
   lru_.next = &lru_;
   lru_.prev = &lru_;
   lru_low_pri_ = &lru_;
+  window_.next = &window_;
+  window_.prev = &window_;
+  if (use_tinylfu_admission) {
+    // The sketch is sized for the initial capacity, assuming entries about
+    // the size of a typical data block, and is not resized by SetCapacity.
+    sketch_.reset(new FrequencySketch(capacity / kTinyLFUEntryChargeEstimate));
+  }
   SetCapacity(capacity);
 }
 
@@ -135,8 +152,8 @@ void LRUCacheShard::EraseUnRefEntries() {
   autovector<LRUHandle*> last_reference_list;
   {
     MutexLock l(&mutex_);
-    while (lru_.next != &lru_) {
-      LRUHandle* old = lru_.next;
+    while (lru_.next != &lru_ || window_.next != &window_) {
+      LRUHandle* old = lru_.next != &lru_ ? lru_.next : window_.next;
       // LRU list contains only elements which can be evicted
       assert(old->InCache() && !old->HasRefs());
       LRU_Remove(old);
@@ -204,6 +221,10 @@ size_t LRUCacheShard::TEST_GetLRUSize() {
     lru_size++;
     lru_handle = lru_handle->next;
   }
+  for (lru_handle = window_.next; lru_handle != &window_;
+       lru_handle = lru_handle->next) {
+    lru_size++;
+  }
   return lru_size;
 }
 
@@ -215,6 +236,17 @@ double LRUCacheShard::GetHighPriPoolRatio() {
 void LRUCacheShard::LRU_Remove(LRUHandle* e) {
   assert(e->next != nullptr);
   assert(e->prev != nullptr);
+  if (e->InWindow()) {
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+    e->prev = e->next = nullptr;
+    size_t total_charge = e->CalcTotalCharge(metadata_charge_policy_);
+    assert(lru_usage_ >= total_charge);
+    lru_usage_ -= total_charge;
+    assert(window_usage_ >= total_charge);
+    window_usage_ -= total_charge;
+    return;
+  }
   if (lru_low_pri_ == e) {
     lru_low_pri_ = e->prev;
   }
@@ -234,6 +266,17 @@ void LRUCacheShard::LRU_Insert(LRUHandle* e) {
   assert(e->next == nullptr);
   assert(e->prev == nullptr);
   size_t total_charge = e->CalcTotalCharge(metadata_charge_policy_);
+  if (e->InWindow()) {
+    // Insert "e" to head of the admission window.
+    e->next = &window_;
+    e->prev = window_.prev;
+    e->prev->next = e;
+    e->next->prev = e;
+    window_usage_ += total_charge;
+    lru_usage_ += total_charge;
+    MaintainWindowSize();
+    return;
+  }
   if (high_pri_pool_ratio_ > 0 && (e->IsHighPri() || e->HasHit())) {
     // Inset "e" to head of LRU list.
     e->next = &lru_;
@@ -269,10 +312,45 @@ void LRUCacheShard::MaintainPoolSize() {
   }
 }
 
+void LRUCacheShard::MaintainWindowSize() {
+  while (window_usage_ > window_capacity_ && usage_ <= capacity_ &&
+         window_.next != window_.prev) {
+    // Admit the oldest entry of the window while there is room for it.
+    LRUHandle* e = window_.next;
+    LRU_Remove(e);
+    e->SetInWindow(false);
+    LRU_Insert(e);
+  }
+}
+
+LRUHandle* LRUCacheShard::ChooseVictim() {
+  if (window_.next == &window_) {
+    return lru_.next;
+  }
+  LRUHandle* candidate = window_.next;
+  if (lru_.next == &lru_) {
+    return candidate;
+  }
+  if (window_usage_ < window_capacity_) {
+    return lru_.next;
+  }
+  LRUHandle* victim = lru_.next;
+  assert(sketch_ != nullptr);
+  if (sketch_->Estimate(candidate->hash) > sketch_->Estimate(victim->hash)) {
+    // Admit the candidate in place of the victim.
+    LRU_Remove(candidate);
+    candidate->SetInWindow(false);
+    LRU_Insert(candidate);
+    return victim;
+  }
+  return candidate;
+}
+
 void LRUCacheShard::EvictFromLRU(size_t charge,
                                  autovector<LRUHandle*>* deleted) {
-  while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
-    LRUHandle* old = lru_.next;
+  while ((usage_ + charge) > capacity_ &&
+         (lru_.next != &lru_ || window_.next != &window_)) {
+    LRUHandle* old = ChooseVictim();
     // LRU list contains only elements which can be evicted
     assert(old->InCache() && !old->HasRefs());
     LRU_Remove(old);
@@ -291,6 +369,7 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
     MutexLock l(&mutex_);
     capacity_ = capacity;
     high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
+    window_capacity_ = static_cast<size_t>(capacity_ * tinylfu_window_ratio_);
     EvictFromLRU(0, &last_reference_list);
   }
 
@@ -320,6 +399,15 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, Cache::Handle** handle,
   {
     MutexLock l(&mutex_);
 
+    if (sketch_ != nullptr) {
+      sketch_->Increment(e->hash);
+      // New low-pri entries have to go through the admission window.
+      // Promoted entries were admitted before they were demoted.
+      if (!e->IsHighPri() && !e->IsPromoted()) {
+        e->SetInWindow(true);
+      }
+    }
+
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty
     EvictFromLRU(total_charge, &last_reference_list);
@@ -423,6 +511,9 @@ Cache::Handle* LRUCacheShard::Lookup(
   LRUHandle* e = nullptr;
   {
     MutexLock l(&mutex_);
+    if (sketch_ != nullptr) {
+      sketch_->Increment(hash);
+    }
     e = table_.Lookup(key, hash);
     if (e != nullptr) {
       assert(e->InCache());
@@ -519,7 +610,8 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
       // The item is still in cache, and nobody else holds a reference to it
       if (usage_ > capacity_ || force_erase) {
         // The LRU list must be empty since the cache is full
-        assert(lru_.next == &lru_ || force_erase);
+        assert((lru_.next == &lru_ && window_.next == &window_) ||
+               force_erase);
         // Take this opportunity and remove the item
         table_.Remove(e->key(), e->hash);
         e->SetInCache(false);
@@ -637,8 +729,13 @@ std::string LRUCacheShard::GetPrintableOptions() const {
   char buffer[kBufferSize];
   {
     MutexLock l(&mutex_);
-    snprintf(buffer, kBufferSize, "    high_pri_pool_ratio: %.3lf\n",
-             high_pri_pool_ratio_);
+    int len = snprintf(buffer, kBufferSize,
+                       "    high_pri_pool_ratio: %.3lf\n",
+                       high_pri_pool_ratio_);
+    snprintf(buffer + len, kBufferSize - len,
+             "    use_tinylfu_admission: %d\n"
+             "    tinylfu_window_ratio: %.3lf\n",
+             sketch_ != nullptr, tinylfu_window_ratio_);
   }
   return std::string(buffer);
 }
@@ -648,7 +745,8 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
                    std::shared_ptr<MemoryAllocator> allocator,
                    bool use_adaptive_mutex,
                    CacheMetadataChargePolicy metadata_charge_policy,
-                   const std::shared_ptr<SecondaryCache>& secondary_cache)
+                   const std::shared_ptr<SecondaryCache>& secondary_cache,
+                   bool use_tinylfu_admission, double tinylfu_window_ratio)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
                    std::move(allocator)) {
   num_shards_ = 1 << num_shard_bits;
@@ -659,7 +757,8 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
     new (&shards_[i]) LRUCacheShard(
         per_shard, strict_capacity_limit, high_pri_pool_ratio,
         use_adaptive_mutex, metadata_charge_policy,
-        /* max_upper_hash_bits */ 32 - num_shard_bits, secondary_cache);
+        /* max_upper_hash_bits */ 32 - num_shard_bits, secondary_cache,
+        use_tinylfu_admission, tinylfu_window_ratio);
   }
   secondary_cache_ = secondary_cache;
 }
@@ -762,7 +861,8 @@ std::shared_ptr<Cache> NewLRUCache(
     double high_pri_pool_ratio,
     std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
     CacheMetadataChargePolicy metadata_charge_policy,
-    const std::shared_ptr<SecondaryCache>& secondary_cache) {
+    const std::shared_ptr<SecondaryCache>& secondary_cache,
+    bool use_tinylfu_admission, double tinylfu_window_ratio) {
   if (num_shard_bits >= 20) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
@@ -770,13 +870,17 @@ std::shared_ptr<Cache> NewLRUCache(
     // invalid high_pri_pool_ratio
     return nullptr;
   }
+  if (tinylfu_window_ratio < 0.0 || tinylfu_window_ratio > 1.0) {
+    // invalid tinylfu_window_ratio
+    return nullptr;
+  }
   if (num_shard_bits < 0) {
     num_shard_bits = GetDefaultCacheShardBits(capacity);
   }
   return std::make_shared<LRUCache>(
       capacity, num_shard_bits, strict_capacity_limit, high_pri_pool_ratio,
       std::move(memory_allocator), use_adaptive_mutex, metadata_charge_policy,
-      secondary_cache);
+      secondary_cache, use_tinylfu_admission, tinylfu_window_ratio);
 }
 
 std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
@@ -784,7 +888,8 @@ std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
       cache_opts.capacity, cache_opts.num_shard_bits,
       cache_opts.strict_capacity_limit, cache_opts.high_pri_pool_ratio,
       cache_opts.memory_allocator, cache_opts.use_adaptive_mutex,
-      cache_opts.metadata_charge_policy, cache_opts.secondary_cache);
+      cache_opts.metadata_charge_policy, cache_opts.secondary_cache,
+      cache_opts.use_tinylfu_admission, cache_opts.tinylfu_window_ratio);
 }
 
 std::shared_ptr<Cache> NewLRUCache(
@@ -794,6 +899,8 @@ std::shared_ptr<Cache> NewLRUCache(
     CacheMetadataChargePolicy metadata_charge_policy) {
   return NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
                      high_pri_pool_ratio, memory_allocator, use_adaptive_mutex,
-                     metadata_charge_policy, nullptr);
+                     metadata_charge_policy, nullptr,
+                     /* use_tinylfu_admission */ false,
+                     /* tinylfu_window_ratio */ 0.01);
 }
 }  // namespace ROCKSDB_NAMESPACE
@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/malloc.h"
@@ -87,6 +88,9 @@ struct LRUHandle {
     IS_PENDING = (1 << 5),
     // Has the item been promoted from a lower tier
     IS_PROMOTED = (1 << 6),
+    // Whether this entry has not been admitted past the TinyLFU admission
+    // window yet.
+    IN_WINDOW = (1 << 7),
   };
 
   uint8_t flags;
@@ -130,6 +134,7 @@ struct LRUHandle {
   }
   bool IsPending() const { return flags & IS_PENDING; }
   bool IsPromoted() const { return flags & IS_PROMOTED; }
+  bool InWindow() const { return flags & IN_WINDOW; }
 
   void SetInCache(bool in_cache) {
     if (in_cache) {
@@ -184,6 +189,14 @@ struct LRUHandle {
     }
   }
 
+  void SetInWindow(bool in_window) {
+    if (in_window) {
+      flags |= IN_WINDOW;
+    } else {
+      flags &= ~IN_WINDOW;
+    }
+  }
+
   void Free() {
     assert(refs == 0);
 #ifdef __SANITIZE_THREAD__
@@ -286,7 +299,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
                 double high_pri_pool_ratio, bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits,
-                const std::shared_ptr<SecondaryCache>& secondary_cache);
+                const std::shared_ptr<SecondaryCache>& secondary_cache,
+                bool use_tinylfu_admission = false,
+                double tinylfu_window_ratio = 0.01);
   virtual ~LRUCacheShard() override = default;
 
   // Separate from constructor so caller can easily make an array of LRUCache
@@ -382,12 +397,23 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
 
+  // With TinyLFU admission, move the oldest entries of an overflowing
+  // admission window to the LRU list, as long as the cache is not full.
+  void MaintainWindowSize();
+
+  // Return the next entry to evict. With TinyLFU admission, when the
+  // admission window is full, its oldest entry competes with the LRU victim
+  // using the frequency sketch: the winner stays in (or is admitted into) the
+  // LRU list and the loser is returned.
+  LRUHandle* ChooseVictim();
+
   // Overflow the last entry in high-pri pool to low-pri pool until size of
   // high-pri pool is no larger than the size specify by high_pri_pool_pct.
   void MaintainPoolSize();
 
-  // Free some space following strict LRU policy until enough space
-  // to hold (usage_ + charge) is freed or the lru list is empty
+  // Free some space following strict LRU policy (subject to TinyLFU
+  // admission, if enabled) until enough space to hold (usage_ + charge) is
+  // freed or the lru list and admission window are empty
   // This function is not thread safe - it needs to be executed while
   // holding the mutex_
   void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted);
@@ -416,6 +442,19 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Pointer to head of low-pri pool in LRU list.
   LRUHandle* lru_low_pri_;
 
+  // Frequency sketch for TinyLFU admission, or nullptr if it is disabled.
+  std::unique_ptr<FrequencySketch> sketch_;
+
+  // Ratio of capacity used by the TinyLFU admission window.
+  double tinylfu_window_ratio_;
+
+  // Admission window size, equals to capacity * tinylfu_window_ratio.
+  size_t window_capacity_;
+
+  // Dummy head of the TinyLFU admission window, a list like lru_ holding
+  // unreferenced low-pri entries that have not been admitted to lru_ yet.
+  LRUHandle window_;
+
   // ------------^^^^^^^^^^^^^-----------
   // Not frequently modified data members
   // ------------------------------------
@@ -432,9 +471,13 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Memory size for entries residing in the cache
   size_t usage_;
 
-  // Memory size for entries residing only in the LRU list
+  // Memory size for entries residing only in the LRU list (including the
+  // admission window)
   size_t lru_usage_;
 
+  // Memory size for entries residing in the admission window
+  size_t window_usage_;
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
@@ -455,7 +498,9 @@ class LRUCache
            bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
            CacheMetadataChargePolicy metadata_charge_policy =
                kDontChargeCacheMetadata,
-           const std::shared_ptr<SecondaryCache>& secondary_cache = nullptr);
+           const std::shared_ptr<SecondaryCache>& secondary_cache = nullptr,
+           bool use_tinylfu_admission = false,
+           double tinylfu_window_ratio = 0.01);
   virtual ~LRUCache();
   virtual const char* Name() const override { return "LRUCache"; }
   virtual CacheShard* GetShard(uint32_t shard) override;
@@ -204,6 +204,75 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"e", "f", "g", "Z", "d"}, 2);
 }
 
+TEST_F(LRUCacheTest, FrequencySketch) {
+  FrequencySketch sketch(/*expected_entries=*/100);
+  ASSERT_EQ(sketch.ApproximateMemoryUsage(),
+            FrequencySketch::kDepth * FrequencySketch::kMinWidth);
+  for (int i = 0; i < 5; i++) {
+    sketch.Increment(1);
+  }
+  sketch.Increment(2);
+  ASSERT_GE(sketch.Estimate(1), 5);
+  ASSERT_GE(sketch.Estimate(2), 1);
+  ASSERT_LT(sketch.Estimate(2), sketch.Estimate(1));
+  for (int i = 0; i < 100; i++) {
+    sketch.Increment(1);
+  }
+  // Counters saturate.
+  ASSERT_EQ(sketch.Estimate(1), FrequencySketch::kMaxCount);
+}
+
+TEST_F(LRUCacheTest, TinyLFUAdmissionResistsScan) {
+  for (bool use_tinylfu_admission : {false, true}) {
+    LRUCacheOptions opts(10 /*capacity*/, 0 /*num_shard_bits*/,
+                         false /*strict_capacity_limit*/,
+                         0.0 /*high_pri_pool_ratio*/, nullptr,
+                         kDefaultToAdaptiveMutex, kDontChargeCacheMetadata);
+    opts.use_tinylfu_admission = use_tinylfu_admission;
+    opts.tinylfu_window_ratio = 0.2;
+    std::shared_ptr<Cache> cache = NewLRUCache(opts);
+
+    // A frequently read working set that fits in the cache.
+    const int kNumHotKeys = 8;
+    for (int i = 0; i < kNumHotKeys; i++) {
+      ASSERT_OK(cache->Insert("h" + std::to_string(i), nullptr, 1, nullptr));
+    }
+    for (int round = 0; round < 4; round++) {
+      for (int i = 0; i < kNumHotKeys; i++) {
+        Cache::Handle* handle = cache->Lookup("h" + std::to_string(i));
+        ASSERT_NE(handle, nullptr);
+        cache->Release(handle);
+      }
+    }
+
+    // A scan inserts many blocks that are never read again.
+    for (int i = 0; i < 100; i++) {
+      ASSERT_OK(cache->Insert("s" + std::to_string(i), nullptr, 1, nullptr));
+      ASSERT_LE(cache->GetUsage(), 10);
+    }
+
+    int num_hot_keys_left = 0;
+    for (int i = 0; i < kNumHotKeys; i++) {
+      Cache::Handle* handle = cache->Lookup("h" + std::to_string(i));
+      if (handle != nullptr) {
+        num_hot_keys_left++;
+        cache->Release(handle);
+      }
+    }
+    if (use_tinylfu_admission) {
+      ASSERT_EQ(num_hot_keys_left, kNumHotKeys);
+      ASSERT_NE(cache->GetPrintableOptions().find("use_tinylfu_admission: 1"),
+                std::string::npos);
+    } else {
+      ASSERT_EQ(num_hot_keys_left, 0);
+    }
+    // Everything is evictable, including the entries in the window.
+    ASSERT_EQ(cache->GetPinnedUsage(), 0);
+    cache->EraseUnRefEntries();
+    ASSERT_EQ(cache->GetUsage(), 0);
+  }
+}
+
 class TestSecondaryCache : public SecondaryCache {
  public:
   // Specifies what action to take on a lookup for a particular key
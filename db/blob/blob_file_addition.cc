@@ -28,6 +28,7 @@ enum BlobFileAddition::CustomFieldTags : uint32_t {
   kForwardIncompatibleMask = 1 << 6,
 
   // Add forward incompatible fields here
+  kRelocation,
 };
 
 void BlobFileAddition::EncodeTo(std::string* output) const {
@@ -42,6 +43,15 @@ void BlobFileAddition::EncodeTo(std::string* output) const {
   // fields will be ignored during decoding unless they're in the forward
   // incompatible range.
 
+  if (IsRelocated()) {
+    PutVarint32(output, kRelocation);
+
+    std::string relocation;
+    PutVarint64(&relocation, physical_blob_file_number_);
+    offset_map_.EncodeTo(&relocation);
+    PutLengthPrefixedSlice(output, relocation);
+  }
+
   TEST_SYNC_POINT_CALLBACK("BlobFileAddition::EncodeTo::CustomFields", output);
 
   PutVarint32(output, kEndMarker);
@@ -84,6 +94,23 @@ Status BlobFileAddition::DecodeFrom(Slice* input) {
       break;
     }
 
+    if (custom_field_tag == kRelocation) {
+      Slice relocation;
+      if (!GetLengthPrefixedSlice(input, &relocation) ||
+          !GetVarint64(&relocation, &physical_blob_file_number_) ||
+          physical_blob_file_number_ == kInvalidBlobFileNumber) {
+        return Status::Corruption(class_name,
+                                  "Error decoding physical blob file number");
+      }
+
+      const Status s = offset_map_.DecodeFrom(&relocation);
+      if (!s.ok()) {
+        return s;
+      }
+
+      continue;
+    }
+
     if (custom_field_tag & kForwardIncompatibleMask) {
       return Status::Corruption(
           class_name, "Forward incompatible custom field encountered");
@@ -122,7 +149,10 @@ bool operator==(const BlobFileAddition& lhs, const BlobFileAddition& rhs) {
          lhs.GetTotalBlobCount() == rhs.GetTotalBlobCount() &&
          lhs.GetTotalBlobBytes() == rhs.GetTotalBlobBytes() &&
          lhs.GetChecksumMethod() == rhs.GetChecksumMethod() &&
-         lhs.GetChecksumValue() == rhs.GetChecksumValue();
+         lhs.GetChecksumValue() == rhs.GetChecksumValue() &&
+         lhs.IsRelocated() == rhs.IsRelocated() &&
+         lhs.GetPhysicalBlobFileNumber() == rhs.GetPhysicalBlobFileNumber() &&
+         lhs.GetOffsetMap() == rhs.GetOffsetMap();
 }
 
 bool operator!=(const BlobFileAddition& lhs, const BlobFileAddition& rhs) {
@@ -138,6 +168,12 @@ std::ostream& operator<<(std::ostream& os,
      << " checksum_value: "
      << Slice(blob_file_addition.GetChecksumValue()).ToString(/* hex */ true);
 
+  if (blob_file_addition.IsRelocated()) {
+    os << " physical_blob_file_number: "
+       << blob_file_addition.GetPhysicalBlobFileNumber() << " offset_map: "
+       << blob_file_addition.GetOffsetMap();
+  }
+
   return os;
 }
 
@@ -150,6 +186,12 @@ JSONWriter& operator<<(JSONWriter& jw,
      << "ChecksumValue"
      << Slice(blob_file_addition.GetChecksumValue()).ToString(/* hex */ true);
 
+  if (blob_file_addition.IsRelocated()) {
+    jw << "PhysicalBlobFileNumber"
+       << blob_file_addition.GetPhysicalBlobFileNumber() << "OffsetMapRuns"
+       << blob_file_addition.GetOffsetMap().size();
+  }
+
   return jw;
 }
 
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "db/blob/blob_constants.h"
+#include "db/blob/blob_offset_map.h"
 #include "rocksdb/rocksdb_namespace.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -40,6 +41,27 @@ class BlobFileAddition {
   const std::string& GetChecksumMethod() const { return checksum_method_; }
   const std::string& GetChecksumValue() const { return checksum_value_; }
 
+  // A blob file whose live blobs were copied to another file by the blob
+  // garbage collection job keeps its number, which the blob indexes refer
+  // to, but is stored in the file with the physical blob file number, where
+  // the blobs are found through the offset map. The totals and the checksum
+  // are those of the physical file.
+  void SetRelocation(uint64_t physical_blob_file_number,
+                     BlobOffsetMap offset_map) {
+    assert(physical_blob_file_number != kInvalidBlobFileNumber);
+    assert(physical_blob_file_number != blob_file_number_);
+    physical_blob_file_number_ = physical_blob_file_number;
+    offset_map_ = std::move(offset_map);
+  }
+
+  bool IsRelocated() const {
+    return physical_blob_file_number_ != kInvalidBlobFileNumber;
+  }
+  uint64_t GetPhysicalBlobFileNumber() const {
+    return IsRelocated() ? physical_blob_file_number_ : blob_file_number_;
+  }
+  const BlobOffsetMap& GetOffsetMap() const { return offset_map_; }
+
   void EncodeTo(std::string* output) const;
   Status DecodeFrom(Slice* input);
 
@@ -54,6 +76,8 @@ class BlobFileAddition {
   uint64_t total_blob_bytes_ = 0;
   std::string checksum_method_;
   std::string checksum_value_;
+  uint64_t physical_blob_file_number_ = kInvalidBlobFileNumber;
+  BlobOffsetMap offset_map_;
 };
 
 bool operator==(const BlobFileAddition& lhs, const BlobFileAddition& rhs);
@@ -63,6 +63,30 @@ TEST_F(BlobFileAdditionTest, NonEmpty) {
   TestEncodeDecode(blob_file_addition);
 }
 
+TEST_F(BlobFileAdditionTest, Relocated) {
+  constexpr uint64_t blob_file_number = 123;
+  constexpr uint64_t physical_blob_file_number = 456;
+
+  BlobOffsetMap offset_map;
+  offset_map.AddRun(100, 40);
+  offset_map.AddRun(300, 90);
+
+  BlobFileAddition blob_file_addition(blob_file_number, 2, 200, "CRC32B",
+                                      "\x6d\xbd\xf2\x3a");
+  ASSERT_FALSE(blob_file_addition.IsRelocated());
+  ASSERT_EQ(blob_file_addition.GetPhysicalBlobFileNumber(), blob_file_number);
+
+  blob_file_addition.SetRelocation(physical_blob_file_number, offset_map);
+
+  ASSERT_TRUE(blob_file_addition.IsRelocated());
+  ASSERT_EQ(blob_file_addition.GetBlobFileNumber(), blob_file_number);
+  ASSERT_EQ(blob_file_addition.GetPhysicalBlobFileNumber(),
+            physical_blob_file_number);
+  ASSERT_EQ(blob_file_addition.GetOffsetMap(), offset_map);
+
+  TestEncodeDecode(blob_file_addition);
+}
+
 TEST_F(BlobFileAdditionTest, DecodeErrors) {
   std::string str;
   Slice slice(str);
@@ -171,7 +195,7 @@ TEST_F(BlobFileAdditionTest, ForwardIncompatibleCustomField) {
       "BlobFileAddition::EncodeTo::CustomFields", [&](void* arg) {
         std::string* output = static_cast<std::string*>(arg);
 
-        constexpr uint32_t forward_incompatible_tag = (1 << 6) + 1;
+        constexpr uint32_t forward_incompatible_tag = (1 << 6) + 2;
         PutVarint32(output, forward_incompatible_tag);
 
         PutLengthPrefixedSlice(output, "foobar");
@@ -8,12 +8,15 @@
 #include <cassert>
 #include <memory>
 
+#include "cache/cache_entry_roles.h"
 #include "db/blob/blob_file_reader.h"
+#include "monitoring/statistics.h"
 #include "options/cf_options.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/slice.h"
 #include "test_util/sync_point.h"
 #include "trace_replay/io_tracer.h"
+#include "util/coding.h"
 #include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -30,10 +33,14 @@ BlobFileCache::BlobFileCache(Cache* cache,
       file_options_(file_options),
       column_family_id_(column_family_id),
       blob_file_read_hist_(blob_file_read_hist),
-      io_tracer_(io_tracer) {
+      io_tracer_(io_tracer),
+      blob_cache_(immutable_options->blob_cache.get()) {
   assert(cache_);
   assert(immutable_options_);
   assert(file_options_);
+  if (blob_cache_) {
+    PutVarint64(&blob_cache_key_prefix_, blob_cache_->NewId());
+  }
 }
 
 Status BlobFileCache::GetBlobFileReader(
@@ -99,4 +106,76 @@ Status BlobFileCache::GetBlobFileReader(
   return Status::OK();
 }
 
+Slice BlobFileCache::GetBlobCacheKey(uint64_t blob_file_number,
+                                     uint64_t offset, std::string* buf) const {
+  assert(buf);
+  buf->assign(blob_cache_key_prefix_);
+  PutVarint64(buf, blob_file_number);
+  PutVarint64(buf, offset);
+  return Slice(*buf);
+}
+
+namespace {
+void ReleaseBlobCacheHandle(void* arg1, void* arg2) {
+  Cache* const blob_cache = static_cast<Cache*>(arg1);
+  Cache::Handle* const handle = static_cast<Cache::Handle*>(arg2);
+  blob_cache->Release(handle);
+}
+}  // namespace
+
+bool BlobFileCache::LookupBlob(uint64_t blob_file_number, uint64_t offset,
+                               PinnableSlice* value) const {
+  assert(value);
+
+  if (!blob_cache_) {
+    return false;
+  }
+
+  Statistics* const statistics = immutable_options_->stats;
+
+  std::string buf;
+  const Slice key = GetBlobCacheKey(blob_file_number, offset, &buf);
+  Cache::Handle* const handle = blob_cache_->Lookup(key, statistics);
+  if (!handle) {
+    RecordTick(statistics, BLOB_DB_CACHE_MISS);
+    return false;
+  }
+
+  const std::string* const blob =
+      static_cast<const std::string*>(blob_cache_->Value(handle));
+  RecordTick(statistics, BLOB_DB_CACHE_HIT);
+  RecordTick(statistics, BLOB_DB_CACHE_BYTES_READ, blob->size());
+
+  // The value stays pinned in the cache until value is reset
+  value->Reset();
+  value->PinSlice(*blob, &ReleaseBlobCacheHandle, blob_cache_, handle);
+
+  return true;
+}
+
+void BlobFileCache::InsertBlob(uint64_t blob_file_number, uint64_t offset,
+                               const Slice& value) const {
+  if (!blob_cache_) {
+    return;
+  }
+
+  Statistics* const statistics = immutable_options_->stats;
+
+  std::string buf;
+  const Slice key = GetBlobCacheKey(blob_file_number, offset, &buf);
+  std::unique_ptr<std::string> blob(new std::string(value.ToString()));
+  const size_t charge = blob->size();
+  const Status s = blob_cache_->Insert(
+      key, blob.get(), charge,
+      GetCacheEntryDeleterForRole<std::string, CacheEntryRole::kBlobValue>());
+  if (!s.ok()) {
+    RecordTick(statistics, BLOB_DB_CACHE_ADD_FAILURES);
+    return;
+  }
+
+  blob.release();
+  RecordTick(statistics, BLOB_DB_CACHE_ADD);
+  RecordTick(statistics, BLOB_DB_CACHE_BYTES_WRITE, charge);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cinttypes>
+#include <string>
 
 #include "cache/cache_helpers.h"
 #include "rocksdb/rocksdb_namespace.h"
@@ -20,6 +21,7 @@ class HistogramImpl;
 class Status;
 class BlobFileReader;
 class Slice;
+class PinnableSlice;
 class IOTracer;
 
 class BlobFileCache {
@@ -35,7 +37,25 @@ class BlobFileCache {
   Status GetBlobFileReader(uint64_t blob_file_number,
                            CacheHandleGuard<BlobFileReader>* blob_file_reader);
 
+  // Looks up the uncompressed value of the blob at the given offset of the
+  // given blob file in the blob cache of the column family. On a hit, pins
+  // the cached value in value and returns true. Returns false if the blob is
+  // not cached or the column family has no blob cache.
+  bool LookupBlob(uint64_t blob_file_number, uint64_t offset,
+                  PinnableSlice* value) const;
+
+  // Adds a copy of the uncompressed value of the blob at the given offset of
+  // the given blob file to the blob cache, if any.
+  void InsertBlob(uint64_t blob_file_number, uint64_t offset,
+                  const Slice& value) const;
+
+  bool HasBlobCache() const { return blob_cache_ != nullptr; }
+
  private:
+  // Returns the blob cache key of a blob, stored in buf
+  Slice GetBlobCacheKey(uint64_t blob_file_number, uint64_t offset,
+                        std::string* buf) const;
+
   Cache* cache_;
   // Note: mutex_ below is used to guard against multiple threads racing to open
   // the same file.
@@ -45,6 +65,11 @@ class BlobFileCache {
   uint32_t column_family_id_;
   HistogramImpl* blob_file_read_hist_;
   std::shared_ptr<IOTracer> io_tracer_;
+  // Cache of uncompressed blob values, or nullptr if disabled
+  Cache* blob_cache_;
+  // Distinguishes the blobs of this column family from the other entries of
+  // a shared blob cache
+  std::string blob_cache_key_prefix_;
 
   static constexpr size_t kNumberOfMutexStripes = 1 << 7;
 };
@@ -32,6 +32,12 @@ std::ostream& operator<<(std::ostream& os,
      << " checksum_value: "
      << Slice(shared_meta.GetChecksumValue()).ToString(/* hex */ true);
 
+  if (shared_meta.IsRelocated()) {
+    os << " physical_blob_file_number: "
+       << shared_meta.GetPhysicalBlobFileNumber() << " offset_map: { "
+       << shared_meta.GetOffsetMap() << " }";
+  }
+
   return os;
 }
 
@@ -11,6 +11,7 @@
 #include <string>
 #include <unordered_set>
 
+#include "db/blob/blob_offset_map.h"
 #include "rocksdb/rocksdb_namespace.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -21,6 +22,9 @@ namespace ROCKSDB_NAMESPACE {
 // file (shared across all versions that include the blob file in question);
 // hence, the type is neither copyable nor movable. A blob file can be marked
 // obsolete when the corresponding SharedBlobFileMetaData object is destroyed.
+// If the blob garbage collection job relocated the blob file (see
+// BlobGarbageCollectionJob), its blobs are stored in a different physical file
+// and their offsets are translated using an offset map.
 
 class SharedBlobFileMetaData {
  public:
@@ -45,6 +49,22 @@ class SharedBlobFileMetaData {
         deleter);
   }
 
+  template <typename Deleter>
+  static std::shared_ptr<SharedBlobFileMetaData> Create(
+      uint64_t blob_file_number, uint64_t total_blob_count,
+      uint64_t total_blob_bytes, std::string checksum_method,
+      std::string checksum_value, uint64_t physical_blob_file_number,
+      BlobOffsetMap offset_map, Deleter deleter) {
+    std::shared_ptr<SharedBlobFileMetaData> shared_meta(
+        new SharedBlobFileMetaData(blob_file_number, total_blob_count,
+                                   total_blob_bytes, std::move(checksum_method),
+                                   std::move(checksum_value)),
+        deleter);
+    shared_meta->physical_blob_file_number_ = physical_blob_file_number;
+    shared_meta->offset_map_ = std::move(offset_map);
+    return shared_meta;
+  }
+
   SharedBlobFileMetaData(const SharedBlobFileMetaData&) = delete;
   SharedBlobFileMetaData& operator=(const SharedBlobFileMetaData&) = delete;
 
@@ -58,6 +78,17 @@ class SharedBlobFileMetaData {
   const std::string& GetChecksumMethod() const { return checksum_method_; }
   const std::string& GetChecksumValue() const { return checksum_value_; }
 
+  bool IsRelocated() const { return physical_blob_file_number_ != 0; }
+  // The number of the file the blobs are stored in
+  uint64_t GetPhysicalBlobFileNumber() const {
+    return IsRelocated() ? physical_blob_file_number_ : blob_file_number_;
+  }
+  const BlobOffsetMap& GetOffsetMap() const { return offset_map_; }
+  // The offset in the physical file of the blob at offset
+  uint64_t GetPhysicalOffset(uint64_t offset) const {
+    return IsRelocated() ? offset_map_.Translate(offset) : offset;
+  }
+
   std::string DebugString() const;
 
  private:
@@ -77,6 +108,8 @@ class SharedBlobFileMetaData {
   uint64_t total_blob_bytes_;
   std::string checksum_method_;
   std::string checksum_value_;
+  uint64_t physical_blob_file_number_ = 0;
+  BlobOffsetMap offset_map_;
 };
 
 std::ostream& operator<<(std::ostream& os,
@@ -139,6 +172,19 @@ class BlobFileMetaData {
     return shared_meta_->GetChecksumValue();
   }
 
+  bool IsRelocated() const {
+    assert(shared_meta_);
+    return shared_meta_->IsRelocated();
+  }
+  uint64_t GetPhysicalBlobFileNumber() const {
+    assert(shared_meta_);
+    return shared_meta_->GetPhysicalBlobFileNumber();
+  }
+  uint64_t GetPhysicalOffset(uint64_t offset) const {
+    assert(shared_meta_);
+    return shared_meta_->GetPhysicalOffset(offset);
+  }
+
   const LinkedSsts& GetLinkedSsts() const { return linked_ssts_; }
 
   uint64_t GetGarbageBlobCount() const { return garbage_blob_count_; }
@@ -5,11 +5,14 @@
 
 #include "db/blob/blob_file_reader.h"
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 
 #include "db/blob/blob_log_format.h"
+#include "file/async_read_ring.h"
 #include "file/filename.h"
+#include "monitoring/iostats_context_imp.h"
 #include "monitoring/statistics.h"
 #include "options/cf_options.h"
 #include "rocksdb/file_system.h"
@@ -18,7 +21,9 @@
 #include "test_util/sync_point.h"
 #include "util/compression.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
+#include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -357,116 +362,253 @@ void BlobFileReader::MultiGetBlob(
     const autovector<uint64_t>& offsets,
     const autovector<uint64_t>& value_sizes, autovector<Status*>& statuses,
     autovector<PinnableSlice*>& values, uint64_t* bytes_read) const {
-  const size_t num_blobs = user_keys.size();
-  assert(num_blobs > 0);
-  assert(num_blobs == offsets.size());
-  assert(num_blobs == value_sizes.size());
-  assert(num_blobs == statuses.size());
-  assert(num_blobs == values.size());
-
-#ifndef NDEBUG
-  for (size_t i = 0; i < offsets.size() - 1; ++i) {
-    assert(offsets[i] <= offsets[i + 1]);
-  }
-#endif  // !NDEBUG
-
-  std::vector<FSReadRequest> read_reqs(num_blobs);
-  autovector<uint64_t> adjustments;
-  uint64_t total_len = 0;
-  for (size_t i = 0; i < num_blobs; ++i) {
-    const size_t key_size = user_keys[i].get().size();
-    assert(IsValidBlobOffset(offsets[i], key_size, value_sizes[i], file_size_));
-    const uint64_t adjustment =
-        read_options.verify_checksums
-            ? BlobLogRecord::CalculateAdjustmentForRecordHeader(key_size)
-            : 0;
-    assert(offsets[i] >= adjustment);
-    adjustments.push_back(adjustment);
-    read_reqs[i].offset = offsets[i] - adjustment;
-    read_reqs[i].len = value_sizes[i] + adjustment;
-    total_len += read_reqs[i].len;
-  }
-
-  RecordTick(statistics_, BLOB_DB_BLOB_FILE_BYTES_READ, total_len);
+  std::vector<MultiGetRequest> requests(1);
+  MultiGetRequest& request = requests.front();
+  request.reader = this;
+  request.user_keys = user_keys;
+  request.offsets = offsets;
+  request.value_sizes = value_sizes;
+  request.statuses = statuses;
+  request.values = values;
+  MultiGetBlob(read_options, requests, bytes_read);
+}
 
-  Buffer buf;
-  AlignedBuf aligned_buf;
+void BlobFileReader::MultiGetBlob(const ReadOptions& read_options,
+                                  const std::vector<MultiGetRequest>& requests,
+                                  uint64_t* bytes_read) {
+  // The coalesced reads of a file, and for each blob, the read containing its
+  // record and the offset of the record
+  struct FileReads {
+    std::vector<FSReadRequest> read_reqs;
+    autovector<size_t> blob_reads;
+    autovector<uint64_t> record_offsets;
+    autovector<uint64_t> adjustments;
+    Buffer buf;
+    AlignedBuf aligned_buf;
+  };
+
+  std::vector<FileReads> file_reads(requests.size());
+  bool async_io = true;
+  for (size_t f = 0; f < requests.size(); ++f) {
+    const MultiGetRequest& request = requests[f];
+    const BlobFileReader* const reader = request.reader;
+    FileReads& reads = file_reads[f];
+    const size_t num_blobs = request.user_keys.size();
+    assert(reader);
+    assert(num_blobs > 0);
+    assert(num_blobs == request.offsets.size());
+    assert(num_blobs == request.value_sizes.size());
+    assert(num_blobs == request.statuses.size());
+    assert(num_blobs == request.values.size());
+
+    uint64_t read_end = 0;
+    for (size_t i = 0; i < num_blobs; ++i) {
+      const size_t key_size = request.user_keys[i].get().size();
+      const uint64_t offset = request.offsets[i];
+      assert(i == 0 || request.offsets[i - 1] <= offset);
+      assert(IsValidBlobOffset(offset, key_size, request.value_sizes[i],
+                               reader->file_size_));
+      const uint64_t adjustment =
+          read_options.verify_checksums
+              ? BlobLogRecord::CalculateAdjustmentForRecordHeader(key_size)
+              : 0;
+      assert(offset >= adjustment);
+      const uint64_t record_offset = offset - adjustment;
+      if (reads.read_reqs.empty() ||
+          record_offset > read_end + kMaxCoalescedReadGap) {
+        reads.read_reqs.emplace_back();
+        reads.read_reqs.back().offset = record_offset;
+      }
+      FSReadRequest& req = reads.read_reqs.back();
+      read_end = std::max(read_end, offset + request.value_sizes[i]);
+      req.len = static_cast<size_t>(read_end - req.offset);
+      reads.blob_reads.push_back(reads.read_reqs.size() - 1);
+      reads.record_offsets.push_back(record_offset);
+      reads.adjustments.push_back(adjustment);
+    }
 
-  Status s;
-  bool direct_io = file_reader_->use_direct_io();
-  if (direct_io) {
-    for (size_t i = 0; i < read_reqs.size(); ++i) {
-      read_reqs[i].scratch = nullptr;
+    uint64_t total_len = 0;
+    for (const auto& req : reads.read_reqs) {
+      total_len += req.len;
     }
-  } else {
-    buf.reset(new char[total_len]);
-    std::ptrdiff_t pos = 0;
-    for (size_t i = 0; i < read_reqs.size(); ++i) {
-      read_reqs[i].scratch = buf.get() + pos;
-      pos += read_reqs[i].len;
+    RecordTick(reader->statistics_, BLOB_DB_BLOB_FILE_BYTES_READ, total_len);
+
+    if (!reader->file_reader_->file()->IsAsyncReadSupported()) {
+      async_io = false;
+    }
+    if (reader->file_reader_->use_direct_io() && !async_io) {
+      for (auto& req : reads.read_reqs) {
+        req.scratch = nullptr;
+      }
+    } else {
+      // With direct I/O, AsyncRead() copies the data from its aligned buffer
+      reads.buf.reset(new char[total_len]);
+      char* scratch = reads.buf.get();
+      for (auto& req : reads.read_reqs) {
+        req.scratch = scratch;
+        scratch += req.len;
+      }
     }
   }
-  TEST_SYNC_POINT("BlobFileReader::MultiGetBlob:ReadFromFile");
-  s = file_reader_->MultiRead(IOOptions(), read_reqs.data(), read_reqs.size(),
-                              direct_io ? &aligned_buf : nullptr);
-  if (!s.ok()) {
-    for (auto& req : read_reqs) {
-      req.status.PermitUncheckedError();
+
+  if (async_io) {
+    autovector<RandomAccessFileReader*> file_readers;
+    autovector<FSReadRequest*> reqs;
+    for (size_t f = 0; f < requests.size(); ++f) {
+      for (auto& req : file_reads[f].read_reqs) {
+        file_readers.push_back(requests[f].reader->file_reader_.get());
+        reqs.push_back(&req);
+      }
     }
-    for (size_t i = 0; i < num_blobs; ++i) {
-      assert(statuses[i]);
-      *statuses[i] = s;
+    IOStatus ring_status;
+    async_io = AsyncMultiRead(file_readers, reqs, &ring_status);
+    if (!ring_status.ok()) {
+      // Reads may still be in flight, so their buffers cannot be freed
+      for (auto& reads : file_reads) {
+        reads.buf.release();
+      }
+      ring_status.PermitUncheckedError();
     }
-    return;
   }
-
-  assert(s.ok());
-  for (size_t i = 0; i < num_blobs; ++i) {
-    auto& req = read_reqs[i];
-    assert(statuses[i]);
-    if (req.status.ok() && req.result.size() != req.len) {
-      req.status = IOStatus::Corruption("Failed to read data from blob file");
+  if (!async_io) {
+    for (size_t f = 0; f < requests.size(); ++f) {
+      const BlobFileReader* const reader = requests[f].reader;
+      FileReads& reads = file_reads[f];
+      TEST_SYNC_POINT_CALLBACK("BlobFileReader::MultiGetBlob:ReadFromFile",
+                               &reads.read_reqs);
+      const IOStatus s = reader->file_reader_->MultiRead(
+          IOOptions(), reads.read_reqs.data(), reads.read_reqs.size(),
+          reader->file_reader_->use_direct_io() ? &reads.aligned_buf
+                                                : nullptr);
+      if (!s.ok()) {
+        for (auto& req : reads.read_reqs) {
+          req.status.PermitUncheckedError();
+          req.status = s;
+        }
+      }
     }
-    *statuses[i] = req.status;
   }
 
-  if (read_options.verify_checksums) {
-    for (size_t i = 0; i < num_blobs; ++i) {
-      assert(statuses[i]);
-      if (!statuses[i]->ok()) {
+  uint64_t total_bytes = 0;
+  for (size_t f = 0; f < requests.size(); ++f) {
+    const MultiGetRequest& request = requests[f];
+    const BlobFileReader* const reader = request.reader;
+    const FileReads& reads = file_reads[f];
+    for (size_t i = 0; i < request.user_keys.size(); ++i) {
+      const FSReadRequest& req = reads.read_reqs[reads.blob_reads[i]];
+      Status* const status = request.statuses[i];
+      assert(status);
+      const uint64_t record_size =
+          reads.adjustments[i] + request.value_sizes[i];
+      const uint64_t pos = reads.record_offsets[i] - req.offset;
+      if (req.result.size() > pos) {
+        total_bytes += std::min(req.result.size() - pos, record_size);
+      }
+      if (!req.status.ok()) {
+        *status = req.status;
         continue;
       }
-      const Slice& record_slice = read_reqs[i].result;
-      s = VerifyBlob(record_slice, user_keys[i], value_sizes[i]);
-      if (!s.ok()) {
-        assert(statuses[i]);
-        *statuses[i] = s;
+      if (req.result.size() < pos + record_size) {
+        *status = Status::Corruption("Failed to read data from blob file");
+        continue;
+      }
+      const Slice record_slice(req.result.data() + pos,
+                               static_cast<size_t>(record_size));
+      if (read_options.verify_checksums) {
+        *status = VerifyBlob(record_slice, request.user_keys[i],
+                             request.value_sizes[i]);
+        if (!status->ok()) {
+          continue;
+        }
       }
+      const Slice value_slice(record_slice.data() + reads.adjustments[i],
+                              request.value_sizes[i]);
+      *status = UncompressBlobIfNeeded(value_slice, reader->compression_type_,
+                                       reader->clock_, reader->statistics_,
+                                       request.values[i]);
     }
   }
 
-  for (size_t i = 0; i < num_blobs; ++i) {
-    assert(statuses[i]);
-    if (!statuses[i]->ok()) {
-      continue;
-    }
-    const Slice& record_slice = read_reqs[i].result;
-    const Slice value_slice(record_slice.data() + adjustments[i],
-                            value_sizes[i]);
-    s = UncompressBlobIfNeeded(value_slice, compression_type_, clock_,
-                               statistics_, values[i]);
-    if (!s.ok()) {
-      *statuses[i] = s;
-    }
+  if (bytes_read) {
+    *bytes_read = total_bytes;
   }
+}
 
-  if (bytes_read) {
-    uint64_t total_bytes = 0;
-    for (const auto& req : read_reqs) {
-      total_bytes += req.result.size();
+namespace {
+// Maximum number of reads of a MultiGetBlob() in flight at a time
+constexpr size_t kMultiGetMaxReadsInFlight = 64;
+}  // namespace
+
+bool BlobFileReader::AsyncMultiRead(
+    const autovector<RandomAccessFileReader*>& file_readers,
+    const autovector<FSReadRequest*>& reqs, IOStatus* ring_status) {
+  assert(file_readers.size() == reqs.size());
+  assert(ring_status);
+  std::shared_ptr<AsyncReadRing> ring = AsyncReadRing::ForThisThread();
+  if (ring == nullptr) {
+    return false;
+  }
+  IOOptions opts;
+  opts.io_uring_option = ring->io_uring_options();
+
+  MutexLock l(ring->mutex());
+  for (size_t start = 0; start < reqs.size();
+       start += kMultiGetMaxReadsInFlight) {
+    const size_t end = std::min(reqs.size(), start + kMultiGetMaxReadsInFlight);
+    std::vector<std::unique_ptr<async_result>> reads(end - start);
+    size_t num_in_flight = 0;
+    for (size_t i = start; i < end; ++i) {
+      FSReadRequest* const req = reqs[i];
+      auto& read = reads[i - start];
+      read.reset(new async_result(file_readers[i]->AsyncRead(
+          opts, req->offset, req->len, &req->result, req->scratch,
+          nullptr /* aligned_buf */)));
+      if (!read->await_ready()) {
+        ++num_in_flight;
+        continue;
+      }
+      req->status = read->io_result();
+      read.reset();
+      if (!req->status.ok()) {
+        // The read could not be submitted, so read it synchronously
+        req->status.PermitUncheckedError();
+        req->status = file_readers[i]->Read(IOOptions(), req->offset, req->len,
+                                            &req->result, req->scratch,
+                                            nullptr /* aligned_buf */);
+      }
+    }
+
+    while (num_in_flight > 0) {
+      const IOStatus s = ring->Reap();
+      if (!s.ok()) {
+        // The reads in flight can no longer be tracked, so they are left
+        // to the kernel
+        *ring_status = s;
+        for (size_t j = 0; j < reads.size(); ++j) {
+          if (reads[j] != nullptr) {
+            reads[j].release();
+            reqs[start + j]->result = Slice();
+            reqs[start + j]->status = s;
+          }
+        }
+        for (size_t i = end; i < reqs.size(); ++i) {
+          reqs[i]->status = s;
+        }
+        return true;
+      }
+      // The completion may have belonged to another reader of the thread
+      for (size_t j = 0; j < reads.size(); ++j) {
+        auto& read = reads[j];
+        if (read == nullptr || !read->await_ready()) {
+          continue;
+        }
+        reqs[start + j]->status = read->io_result();
+        read.reset();
+        --num_in_flight;
+      }
     }
-    *bytes_read = total_bytes;
   }
+  return true;
 }
 
 Status BlobFileReader::VerifyBlob(const Slice& record_slice,
@@ -7,6 +7,7 @@
 
 #include <cinttypes>
 #include <memory>
+#include <vector>
 
 #include "file/random_access_file_reader.h"
 #include "rocksdb/compression_type.h"
@@ -52,6 +53,29 @@ class BlobFileReader {
       const autovector<uint64_t>& value_sizes, autovector<Status*>& statuses,
       autovector<PinnableSlice*>& values, uint64_t* bytes_read) const;
 
+  // The blobs to read from one blob file. offsets must be sorted in
+  // ascending order.
+  struct MultiGetRequest {
+    const BlobFileReader* reader = nullptr;
+    autovector<std::reference_wrapper<const Slice>> user_keys;
+    autovector<uint64_t> offsets;
+    autovector<uint64_t> value_sizes;
+    autovector<Status*> statuses;
+    autovector<PinnableSlice*> values;
+  };
+
+  // Reads the blobs of several blob files. The records of blobs that are at
+  // most kMaxCoalescedReadGap bytes apart in a file are read with one read.
+  // If the files support FSRandomAccessFile::AsyncRead(), the reads of all
+  // the files are submitted to io_uring at once with
+  // RandomAccessFileReader::AsyncRead(); otherwise each file is read with
+  // MultiRead().
+  static void MultiGetBlob(const ReadOptions& read_options,
+                           const std::vector<MultiGetRequest>& requests,
+                           uint64_t* bytes_read);
+
+  static constexpr uint64_t kMaxCoalescedReadGap = 4096;
+
   CompressionType GetCompressionType() const { return compression_type_; }
 
   uint64_t GetFileSize() const { return file_size_; }
@@ -86,6 +110,16 @@ class BlobFileReader {
   static Status VerifyBlob(const Slice& record_slice, const Slice& user_key,
                            uint64_t value_size);
 
+  // Reads `reqs[i]` with `file_readers[i]` for all i, with all the reads
+  // submitted to the io_uring of the thread (see AsyncReadRing) together.
+  // Returns false without reading anything if io_uring is not available.
+  // Sets `ring_status` to an error if the completions of the reads could not
+  // be reaped, in which case reads may still be in flight and their buffers
+  // must not be freed.
+  static bool AsyncMultiRead(
+      const autovector<RandomAccessFileReader*>& file_readers,
+      const autovector<FSReadRequest*>& reqs, IOStatus* ring_status);
+
   static Status UncompressBlobIfNeeded(const Slice& value_slice,
                                        CompressionType compression_type,
                                        SystemClock* clock,
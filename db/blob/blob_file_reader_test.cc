@@ -5,6 +5,7 @@
 
 #include "db/blob/blob_file_reader.h"
 
+#include <array>
 #include <cassert>
 #include <string>
 
@@ -394,6 +395,109 @@ TEST_F(BlobFileReaderTest, CreateReaderAndGetBlob) {
   }
 }
 
+TEST_F(BlobFileReaderTest, MultiGetBlobFromMultipleFiles) {
+  Options options;
+  options.env = mock_env_.get();
+  options.cf_paths.emplace_back(
+      test::PerThreadDBPath(mock_env_.get(),
+                            "BlobFileReaderTest_MultiGetBlobFromMultipleFiles"),
+      0);
+  options.enable_blob_files = true;
+
+  ImmutableOptions immutable_options(options);
+
+  constexpr uint32_t column_family_id = 1;
+  constexpr bool has_ttl = false;
+  constexpr ExpirationRange expiration_range;
+  constexpr size_t num_files = 2;
+  constexpr size_t num_blobs = 3;
+  const std::vector<std::string> key_strs = {"key1", "key2", "key3"};
+  // In the second file, the middle blob is too large for the blobs around
+  // it to be read together
+  const std::array<std::vector<std::string>, num_files> blob_strs = {
+      {{"blob1", "blob2", "blob3"},
+       {"blob4", std::string(2 * BlobFileReader::kMaxCoalescedReadGap, 'x'),
+        "blob6"}}};
+  const std::vector<Slice> keys = {key_strs[0], key_strs[1], key_strs[2]};
+
+  std::array<std::unique_ptr<BlobFileReader>, num_files> readers;
+  std::array<std::vector<uint64_t>, num_files> blob_offsets;
+  std::array<std::vector<uint64_t>, num_files> blob_sizes;
+  for (size_t f = 0; f < num_files; ++f) {
+    const uint64_t blob_file_number = f + 1;
+    const std::vector<Slice> blobs = {blob_strs[f][0], blob_strs[f][1],
+                                      blob_strs[f][2]};
+    blob_offsets[f].resize(num_blobs);
+    blob_sizes[f].resize(num_blobs);
+    WriteBlobFile(immutable_options, column_family_id, has_ttl,
+                  expiration_range, expiration_range, blob_file_number, keys,
+                  blobs, kNoCompression, blob_offsets[f], blob_sizes[f]);
+    ASSERT_OK(BlobFileReader::Create(
+        immutable_options, FileOptions(), column_family_id,
+        nullptr /* blob_file_read_hist */, blob_file_number,
+        nullptr /*IOTracer*/, &readers[f]));
+  }
+
+  // Read all the blobs of the first file and the first and last blob of the
+  // second one
+  std::array<std::array<Status, num_blobs>, num_files> statuses_buf;
+  std::array<std::array<PinnableSlice, num_blobs>, num_files> value_buf;
+  std::vector<BlobFileReader::MultiGetRequest> requests(num_files);
+  for (size_t f = 0; f < num_files; ++f) {
+    requests[f].reader = readers[f].get();
+    for (size_t i = 0; i < num_blobs; ++i) {
+      if (f == 1 && i == 1) {
+        continue;
+      }
+      requests[f].user_keys.emplace_back(std::cref(keys[i]));
+      requests[f].offsets.push_back(blob_offsets[f][i]);
+      requests[f].value_sizes.push_back(blob_sizes[f][i]);
+      requests[f].statuses.push_back(&statuses_buf[f][i]);
+      requests[f].values.push_back(&value_buf[f][i]);
+    }
+  }
+
+  std::vector<size_t> num_reads;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::MultiGetBlob:ReadFromFile", [&](void* arg) {
+        const auto* read_reqs = static_cast<std::vector<FSReadRequest>*>(arg);
+        num_reads.push_back(read_reqs->size());
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool verify_checksums : {false, true}) {
+    ReadOptions read_options;
+    read_options.verify_checksums = verify_checksums;
+    num_reads.clear();
+    uint64_t bytes_read = 0;
+    BlobFileReader::MultiGetBlob(read_options, requests, &bytes_read);
+
+    uint64_t total_size = 0;
+    for (size_t f = 0; f < num_files; ++f) {
+      for (size_t i = 0; i < num_blobs; ++i) {
+        if (f == 1 && i == 1) {
+          continue;
+        }
+        ASSERT_OK(statuses_buf[f][i]);
+        ASSERT_EQ(value_buf[f][i], blob_strs[f][i]);
+        value_buf[f][i].Reset();
+        total_size += blob_sizes[f][i];
+        if (verify_checksums) {
+          total_size +=
+              BlobLogRecord::CalculateAdjustmentForRecordHeader(keys[i].size());
+        }
+      }
+    }
+    // Only the bytes of the blobs count, not the gaps read between them
+    ASSERT_EQ(bytes_read, total_size);
+    // The adjacent blobs of the first file are read at once
+    ASSERT_EQ(num_reads, (std::vector<size_t>{1, 2}));
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(BlobFileReaderTest, Malformed) {
   // Write a blob file consisting of nothing but a header, and make sure we
   // detect the error when we open it for reading
@@ -0,0 +1,148 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_file_relocation.h"
+
+#include <ostream>
+#include <sstream>
+
+#include "logging/event_logger.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Tags for custom fields. Note that these get persisted in the manifest,
+// so existing tags should not be modified.
+enum BlobFileRelocation::CustomFieldTags : uint32_t {
+  kEndMarker,
+
+  // Add forward compatible fields here
+
+  /////////////////////////////////////////////////////////////////////
+
+  kForwardIncompatibleMask = 1 << 6,
+
+  // Add forward incompatible fields here
+};
+
+void BlobFileRelocation::EncodeTo(std::string* output) const {
+  relocated_file_.EncodeTo(output);
+  PutVarint64(output, removed_garbage_blob_count_);
+  PutVarint64(output, removed_garbage_blob_bytes_);
+
+  // Encode any custom fields here. The format to use is a Varint32 tag (see
+  // CustomFieldTags above) followed by a length prefixed slice. Unknown custom
+  // fields will be ignored during decoding unless they're in the forward
+  // incompatible range.
+
+  TEST_SYNC_POINT_CALLBACK("BlobFileRelocation::EncodeTo::CustomFields",
+                           output);
+
+  PutVarint32(output, kEndMarker);
+}
+
+Status BlobFileRelocation::DecodeFrom(Slice* input) {
+  constexpr char class_name[] = "BlobFileRelocation";
+
+  {
+    const Status s = relocated_file_.DecodeFrom(input);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  if (!relocated_file_.IsRelocated()) {
+    return Status::Corruption(class_name, "Missing physical blob file number");
+  }
+
+  if (!GetVarint64(input, &removed_garbage_blob_count_)) {
+    return Status::Corruption(class_name,
+                              "Error decoding removed garbage blob count");
+  }
+
+  if (!GetVarint64(input, &removed_garbage_blob_bytes_)) {
+    return Status::Corruption(class_name,
+                              "Error decoding removed garbage blob bytes");
+  }
+
+  while (true) {
+    uint32_t custom_field_tag = 0;
+    if (!GetVarint32(input, &custom_field_tag)) {
+      return Status::Corruption(class_name, "Error decoding custom field tag");
+    }
+
+    if (custom_field_tag == kEndMarker) {
+      break;
+    }
+
+    if (custom_field_tag & kForwardIncompatibleMask) {
+      return Status::Corruption(
+          class_name, "Forward incompatible custom field encountered");
+    }
+
+    Slice custom_field_value;
+    if (!GetLengthPrefixedSlice(input, &custom_field_value)) {
+      return Status::Corruption(class_name,
+                                "Error decoding custom field value");
+    }
+  }
+
+  return Status::OK();
+}
+
+std::string BlobFileRelocation::DebugString() const {
+  std::ostringstream oss;
+
+  oss << *this;
+
+  return oss.str();
+}
+
+std::string BlobFileRelocation::DebugJSON() const {
+  JSONWriter jw;
+
+  jw << *this;
+
+  jw.EndObject();
+
+  return jw.Get();
+}
+
+bool operator==(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs) {
+  return lhs.GetRelocatedFile() == rhs.GetRelocatedFile() &&
+         lhs.GetRemovedGarbageBlobCount() == rhs.GetRemovedGarbageBlobCount() &&
+         lhs.GetRemovedGarbageBlobBytes() == rhs.GetRemovedGarbageBlobBytes();
+}
+
+bool operator!=(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs) {
+  return !(lhs == rhs);
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const BlobFileRelocation& blob_file_relocation) {
+  os << blob_file_relocation.GetRelocatedFile()
+     << " removed_garbage_blob_count: "
+     << blob_file_relocation.GetRemovedGarbageBlobCount()
+     << " removed_garbage_blob_bytes: "
+     << blob_file_relocation.GetRemovedGarbageBlobBytes();
+
+  return os;
+}
+
+JSONWriter& operator<<(JSONWriter& jw,
+                       const BlobFileRelocation& blob_file_relocation) {
+  jw << blob_file_relocation.GetRelocatedFile()
+     << "RemovedGarbageBlobCount"
+     << blob_file_relocation.GetRemovedGarbageBlobCount()
+     << "RemovedGarbageBlobBytes"
+     << blob_file_relocation.GetRemovedGarbageBlobBytes();
+
+  return jw;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,75 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "db/blob/blob_file_addition.h"
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class JSONWriter;
+class Slice;
+class Status;
+
+// BlobFileRelocation records that the blob garbage collection job copied the
+// live blobs of an existing blob file to a new physical file. The relocated
+// file replaces the state of the blob file: it keeps its number and linked
+// table files, but gets the totals, checksum, physical file and offset map of
+// the relocated file. The garbage that was dropped by the copy is removed
+// from the garbage of the blob file; garbage added in the meantime, which
+// refers to blobs that were copied, is kept.
+class BlobFileRelocation {
+ public:
+  BlobFileRelocation() = default;
+
+  BlobFileRelocation(BlobFileAddition relocated_file,
+                     uint64_t removed_garbage_blob_count,
+                     uint64_t removed_garbage_blob_bytes)
+      : relocated_file_(std::move(relocated_file)),
+        removed_garbage_blob_count_(removed_garbage_blob_count),
+        removed_garbage_blob_bytes_(removed_garbage_blob_bytes) {
+    assert(relocated_file_.IsRelocated());
+  }
+
+  uint64_t GetBlobFileNumber() const {
+    return relocated_file_.GetBlobFileNumber();
+  }
+  const BlobFileAddition& GetRelocatedFile() const { return relocated_file_; }
+  uint64_t GetRemovedGarbageBlobCount() const {
+    return removed_garbage_blob_count_;
+  }
+  uint64_t GetRemovedGarbageBlobBytes() const {
+    return removed_garbage_blob_bytes_;
+  }
+
+  void EncodeTo(std::string* output) const;
+  Status DecodeFrom(Slice* input);
+
+  std::string DebugString() const;
+  std::string DebugJSON() const;
+
+ private:
+  enum CustomFieldTags : uint32_t;
+
+  BlobFileAddition relocated_file_;
+  uint64_t removed_garbage_blob_count_ = 0;
+  uint64_t removed_garbage_blob_bytes_ = 0;
+};
+
+bool operator==(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs);
+bool operator!=(const BlobFileRelocation& lhs, const BlobFileRelocation& rhs);
+
+std::ostream& operator<<(std::ostream& os,
+                         const BlobFileRelocation& blob_file_relocation);
+JSONWriter& operator<<(JSONWriter& jw,
+                       const BlobFileRelocation& blob_file_relocation);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,586 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_garbage_collection_job.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <unordered_map>
+
+#include "db/blob/blob_file_addition.h"
+#include "db/blob/blob_file_completion_callback.h"
+#include "db/blob/blob_file_meta.h"
+#include "db/blob/blob_file_reader.h"
+#include "db/blob/blob_file_relocation.h"
+#include "db/blob/blob_index.h"
+#include "db/blob/blob_log_format.h"
+#include "db/blob/blob_log_writer.h"
+#include "db/blob/blob_offset_map.h"
+#include "db/column_family.h"
+#include "db/dbformat.h"
+#include "db/table_cache.h"
+#include "db/version_set.h"
+#include "file/filename.h"
+#include "file/random_access_file_reader.h"
+#include "file/read_write_util.h"
+#include "file/writable_file_writer.h"
+#include "logging/logging.h"
+#include "monitoring/instrumented_mutex.h"
+#include "monitoring/statistics.h"
+#include "table/internal_iterator.h"
+#include "table/table_reader_caller.h"
+#include "test_util/sync_point.h"
+#include "trace_replay/io_tracer.h"
+#include "util/stop_watch.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+// Live records of a blob file at most this many bytes apart are read together
+constexpr uint64_t kMaxReadGap = BlobFileReader::kMaxCoalescedReadGap;
+// Reads do not get larger than this, unless a record does
+constexpr uint64_t kMaxReadSize = 1 << 20;
+
+bool IsGarbageCollectionCandidate(const BlobFileMetaData& meta,
+                                  double threshold) {
+  return meta.GetGarbageBlobCount() < meta.GetTotalBlobCount() &&
+         meta.GetGarbageBlobBytes() > 0 &&
+         static_cast<double>(meta.GetGarbageBlobBytes()) >=
+             threshold * static_cast<double>(meta.GetTotalBlobBytes());
+}
+
+Status ReadFromFile(const RandomAccessFileReader* file_reader,
+                    uint64_t read_offset, size_t read_size, Slice* slice,
+                    std::unique_ptr<char[]>* buf, AlignedBuf* aligned_buf) {
+  assert(file_reader);
+
+  Status s;
+
+  if (file_reader->use_direct_io()) {
+    constexpr char* scratch = nullptr;
+
+    s = file_reader->Read(IOOptions(), read_offset, read_size, slice, scratch,
+                          aligned_buf);
+  } else {
+    buf->reset(new char[read_size]);
+    constexpr AlignedBuf* aligned_scratch = nullptr;
+
+    s = file_reader->Read(IOOptions(), read_offset, read_size, slice,
+                          buf->get(), aligned_scratch);
+  }
+
+  if (!s.ok()) {
+    return s;
+  }
+
+  if (slice->size() != read_size) {
+    return Status::Corruption("Failed to read data from blob file");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+BlobGarbageCollectionJob::BlobGarbageCollectionJob(
+    int job_id, ColumnFamilyData* cfd, const FileOptions& file_options,
+    InstrumentedMutex* db_mutex, const std::atomic<bool>* shutting_down,
+    BlobFileCompletionCallback* blob_callback,
+    const std::shared_ptr<IOTracer>& io_tracer)
+    : job_id_(job_id),
+      cfd_(cfd),
+      file_options_(file_options),
+      db_mutex_(db_mutex),
+      shutting_down_(shutting_down),
+      blob_callback_(blob_callback),
+      io_tracer_(io_tracer) {
+  assert(cfd_);
+  assert(db_mutex_);
+  assert(shutting_down_);
+
+  edit_.SetColumnFamily(cfd_->GetID());
+}
+
+BlobGarbageCollectionJob::~BlobGarbageCollectionJob() {
+  if (version_) {
+    db_mutex_->AssertHeld();
+    version_->Unref();
+  }
+}
+
+bool BlobGarbageCollectionJob::NeedsGarbageCollection(
+    const VersionStorageInfo* vstorage, double threshold,
+    const std::unordered_set<uint64_t>& excluded) {
+  assert(vstorage);
+
+  if (threshold <= 0.0) {
+    return false;
+  }
+
+  for (const auto& pair : vstorage->GetBlobFiles()) {
+    const auto& meta = pair.second;
+    assert(meta);
+
+    if (excluded.find(pair.first) == excluded.end() &&
+        IsGarbageCollectionCandidate(*meta, threshold)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool BlobGarbageCollectionJob::Prepare(
+    const std::unordered_set<uint64_t>& excluded) {
+  db_mutex_->AssertHeld();
+  assert(!version_);
+
+  mutable_cf_options_ = *cfd_->GetLatestMutableCFOptions();
+  const double threshold =
+      mutable_cf_options_.blob_garbage_collection_job_threshold;
+
+  version_ = cfd_->current();
+  version_->Ref();
+
+  if (threshold <= 0.0) {
+    return false;
+  }
+
+  for (const auto& pair : version_->storage_info()->GetBlobFiles()) {
+    const auto& meta = pair.second;
+    assert(meta);
+
+    if (excluded.find(pair.first) == excluded.end() &&
+        IsGarbageCollectionCandidate(*meta, threshold)) {
+      candidates_.push_back({meta, meta->GetGarbageBlobCount(),
+                             meta->GetGarbageBlobBytes(),
+                             std::vector<LiveBlob>()});
+    }
+  }
+
+  return !candidates_.empty();
+}
+
+Status BlobGarbageCollectionJob::FindLiveBlobs() {
+  assert(!candidates_.empty());
+
+  std::unordered_map<uint64_t, size_t> candidate_indexes;
+  for (size_t i = 0; i < candidates_.size(); ++i) {
+    candidate_indexes.emplace(candidates_[i].meta->GetBlobFileNumber(), i);
+  }
+
+  ReadOptions read_options;
+  read_options.verify_checksums = true;
+  read_options.fill_cache = false;
+
+  const VersionStorageInfo* const vstorage = version_->storage_info();
+
+  // A table file is linked to the oldest blob file it references, and only
+  // references blob files numbered at least as that one. Candidates are
+  // ordered by blob file number, so the table files that may reference one
+  // are those linked to a blob file numbered at most as the last candidate.
+  // The linkage does not tell which of the later blob files a table file
+  // references, so those table files are all read in full. Their reads are
+  // charged to the rate limiter of the DB like compaction reads.
+  const uint64_t max_blob_file_number =
+      candidates_.back().meta->GetBlobFileNumber();
+
+  for (const auto& pair : vstorage->GetBlobFiles()) {
+    if (pair.first > max_blob_file_number) {
+      break;
+    }
+
+    const auto& blob_file_meta = pair.second;
+    assert(blob_file_meta);
+
+    for (uint64_t table_file_number : blob_file_meta->GetLinkedSsts()) {
+      if (shutting_down_->load(std::memory_order_acquire)) {
+        return Status::ShutdownInProgress();
+      }
+
+      const auto location = vstorage->GetFileLocation(table_file_number);
+      assert(location.IsValid());
+      if (!location.IsValid()) {
+        continue;
+      }
+
+      const int level = location.GetLevel();
+      const FileMetaData* const file =
+          vstorage->LevelFiles(level)[location.GetPosition()];
+      assert(file->oldest_blob_file_number == pair.first);
+
+      std::unique_ptr<InternalIterator> iter(cfd_->table_cache()->NewIterator(
+          read_options, file_options_, cfd_->internal_comparator(), *file,
+          /*range_del_agg=*/nullptr,
+          mutable_cf_options_.prefix_extractor.get(),
+          /*table_reader_ptr=*/nullptr, /*file_read_hist=*/nullptr,
+          TableReaderCaller::kCompaction, /*arena=*/nullptr,
+          /*skip_filters=*/false, level,
+          MaxFileSizeForL0MetaPin(mutable_cf_options_),
+          /*smallest_compaction_key=*/nullptr,
+          /*largest_compaction_key=*/nullptr,
+          /*allow_unprepared_value=*/false));
+
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        ParsedInternalKey ikey;
+        Status s = ParseInternalKey(iter->key(), &ikey,
+                                    /*log_err_key=*/false);
+        if (!s.ok()) {
+          return s;
+        }
+
+        if (ikey.type != kTypeBlobIndex) {
+          continue;
+        }
+
+        BlobIndex blob_index;
+        s = blob_index.DecodeFrom(iter->value());
+        if (!s.ok()) {
+          return s;
+        }
+
+        if (blob_index.IsInlined() || blob_index.HasTTL()) {
+          continue;
+        }
+
+        auto it = candidate_indexes.find(blob_index.file_number());
+        if (it == candidate_indexes.end()) {
+          continue;
+        }
+
+        candidates_[it->second].live_blobs.push_back(
+            {blob_index.offset(), ikey.user_key.size(), blob_index.size()});
+      }
+
+      if (!iter->status().ok()) {
+        return iter->status();
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+Status BlobGarbageCollectionJob::Run(
+    const std::function<uint64_t()>& new_file_number) {
+  assert(version_);
+  assert(!candidates_.empty());
+
+  const ImmutableOptions* const ioptions = cfd_->ioptions();
+  Statistics* const statistics = ioptions->stats;
+  StopWatch sw(ioptions->clock, statistics, BLOB_DB_GC_MICROS);
+
+  {
+    const Status s = FindLiveBlobs();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  for (auto& candidate : candidates_) {
+    if (shutting_down_->load(std::memory_order_acquire)) {
+      return Status::ShutdownInProgress();
+    }
+
+    const auto& meta = candidate.meta;
+    auto& live_blobs = candidate.live_blobs;
+
+    std::sort(live_blobs.begin(), live_blobs.end());
+
+    // The table files must reference exactly the blobs that are not garbage,
+    // once each
+    uint64_t live_blob_bytes = 0;
+    bool has_duplicates = false;
+    for (size_t i = 0; i < live_blobs.size(); ++i) {
+      const LiveBlob& blob = live_blobs[i];
+      live_blob_bytes += BlobLogRecord::kHeaderSize + blob.key_size +
+                         blob.value_size;
+      if (i > 0 && live_blobs[i - 1].offset == blob.offset) {
+        has_duplicates = true;
+      }
+    }
+
+    // A mismatch would not go away by retrying, so the blob file is not
+    // picked again. Other failures, e.g. I/O errors, leave it a candidate
+    // for the next job.
+    Status s;
+    if (has_duplicates ||
+        live_blobs.size() !=
+            meta->GetTotalBlobCount() - candidate.garbage_blob_count ||
+        live_blob_bytes !=
+            meta->GetTotalBlobBytes() - candidate.garbage_blob_bytes) {
+      s = Status::Corruption("Live blobs do not match the garbage");
+      failed_blob_files_.push_back(meta->GetBlobFileNumber());
+    } else {
+      s = RelocateBlobFile(candidate, new_file_number());
+      if (!s.ok()) {
+        has_failed_relocations_ = true;
+      }
+    }
+
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(ioptions->logger,
+                     "[%s] [JOB %d] Failed to garbage collect blob file "
+                     "#%" PRIu64 ": %s",
+                     cfd_->GetName().c_str(), job_id_,
+                     meta->GetBlobFileNumber(), s.ToString().c_str());
+      RecordTick(statistics, BLOB_DB_GC_FAILURES);
+    }
+
+    // Free the memory of the live blobs as we go
+    std::vector<LiveBlob>().swap(live_blobs);
+  }
+
+  return Status::OK();
+}
+
+Status BlobGarbageCollectionJob::RelocateBlobFile(
+    const Candidate& candidate, uint64_t physical_blob_file_number) {
+  const auto& meta = candidate.meta;
+  assert(meta);
+
+  const ImmutableOptions* const ioptions = cfd_->ioptions();
+  assert(!ioptions->cf_paths.empty());
+  const std::string& path = ioptions->cf_paths.front().path;
+  FileSystem* const fs = ioptions->fs.get();
+  Statistics* const statistics = ioptions->stats;
+  constexpr IODebugContext* dbg = nullptr;
+
+  // Open the file the blobs are currently stored in, and read its header
+  std::unique_ptr<RandomAccessFileReader> file_reader;
+  BlobLogHeader header;
+
+  {
+    const std::string source_path =
+        BlobFileName(path, meta->GetPhysicalBlobFileNumber());
+
+    std::unique_ptr<FSRandomAccessFile> file;
+    Status s = fs->NewRandomAccessFile(source_path, file_options_, &file, dbg);
+    if (!s.ok()) {
+      return s;
+    }
+
+    file_reader.reset(new RandomAccessFileReader(
+        std::move(file), source_path, ioptions->clock, io_tracer_, statistics,
+        BLOB_DB_BLOB_FILE_READ_MICROS, /*hist=*/nullptr,
+        ioptions->rate_limiter.get(), ioptions->listeners));
+
+    Slice header_slice;
+    std::unique_ptr<char[]> buf;
+    AlignedBuf aligned_buf;
+
+    s = ReadFromFile(file_reader.get(), 0, BlobLogHeader::kSize, &header_slice,
+                     &buf, &aligned_buf);
+    if (!s.ok()) {
+      return s;
+    }
+
+    s = header.DecodeFrom(header_slice);
+    if (!s.ok()) {
+      return s;
+    }
+
+    if (header.has_ttl) {
+      return Status::NotSupported("Blob files with TTL are not supported");
+    }
+  }
+
+  // Open the new file
+  const std::string blob_file_path =
+      BlobFileName(path, physical_blob_file_number);
+
+  if (blob_callback_) {
+    blob_callback_->OnBlobFileCreationStarted(
+        blob_file_path, cfd_->GetName(), job_id_,
+        BlobFileCreationReason::kGarbageCollection);
+  }
+
+  std::unique_ptr<BlobLogWriter> writer;
+
+  {
+    std::unique_ptr<FSWritableFile> file;
+    Status s = NewWritableFile(fs, blob_file_path, &file, file_options_);
+
+    TEST_SYNC_POINT_CALLBACK(
+        "BlobGarbageCollectionJob::RelocateBlobFile:NewWritableFile", &s);
+
+    if (!s.ok()) {
+      return s;
+    }
+
+    FileTypeSet tmp_set = ioptions->checksum_handoff_file_types;
+    std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
+        std::move(file), blob_file_path, file_options_, ioptions->clock,
+        io_tracer_, statistics, ioptions->listeners,
+        ioptions->file_checksum_gen_factory.get(),
+        tmp_set.Contains(FileType::kBlobFile), false));
+
+    constexpr bool do_flush = false;
+
+    writer.reset(new BlobLogWriter(std::move(file_writer), ioptions->clock,
+                                   statistics, physical_blob_file_number,
+                                   ioptions->use_fsync, do_flush));
+
+    BlobLogHeader new_header(header.column_family_id, header.compression,
+                             /*has_ttl=*/false, ExpirationRange());
+
+    s = writer->WriteHeader(new_header);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  // Copy the records of the live blobs, reading the records that are close
+  // to each other together
+  const auto& live_blobs = candidate.live_blobs;
+  BlobOffsetMap offset_map;
+  uint64_t blob_count = 0;
+  uint64_t blob_bytes = 0;
+  uint64_t prev_value_end = 0;
+
+  for (const LiveBlob& blob : live_blobs) {
+    if (meta->GetPhysicalOffset(blob.offset) <
+        BlobLogHeader::kSize +
+            BlobLogRecord::CalculateAdjustmentForRecordHeader(blob.key_size)) {
+      return Status::Corruption("Invalid blob offset");
+    }
+  }
+
+  for (size_t begin = 0; begin < live_blobs.size();) {
+    auto record_offset = [&](size_t i) {
+      const LiveBlob& blob = live_blobs[i];
+      return meta->GetPhysicalOffset(blob.offset) -
+             BlobLogRecord::CalculateAdjustmentForRecordHeader(blob.key_size);
+    };
+    auto record_end = [&](size_t i) {
+      const LiveBlob& blob = live_blobs[i];
+      return meta->GetPhysicalOffset(blob.offset) + blob.value_size;
+    };
+
+    const uint64_t read_offset = record_offset(begin);
+    uint64_t read_end = record_end(begin);
+    size_t end = begin + 1;
+    while (end < live_blobs.size() &&
+           record_offset(end) <= read_end + kMaxReadGap &&
+           record_end(end) - read_offset <= kMaxReadSize) {
+      read_end = record_end(end);
+      ++end;
+    }
+
+    Slice read_slice;
+    std::unique_ptr<char[]> buf;
+    AlignedBuf aligned_buf;
+
+    Status s = ReadFromFile(file_reader.get(), read_offset,
+                            static_cast<size_t>(read_end - read_offset),
+                            &read_slice, &buf, &aligned_buf);
+    if (!s.ok()) {
+      return s;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+      const LiveBlob& blob = live_blobs[i];
+      const char* const record_data =
+          read_slice.data() + (record_offset(i) - read_offset);
+
+      BlobLogRecord record;
+      s = record.DecodeHeaderFrom(
+          Slice(record_data, BlobLogRecord::kHeaderSize));
+      if (!s.ok()) {
+        return s;
+      }
+
+      if (record.key_size != blob.key_size ||
+          record.value_size != blob.value_size) {
+        return Status::Corruption("Blob record does not match blob index");
+      }
+
+      record.key = Slice(record_data + BlobLogRecord::kHeaderSize,
+                         record.key_size);
+      record.value = Slice(record.key.data() + record.key_size,
+                           record.value_size);
+
+      s = record.CheckBlobCRC();
+      if (!s.ok()) {
+        return s;
+      }
+
+      uint64_t key_offset = 0;
+      uint64_t new_offset = 0;
+      s = writer->AddRecord(record.key, record.value, &key_offset,
+                            &new_offset);
+      if (!s.ok()) {
+        return s;
+      }
+
+      // A new run starts unless the record followed the previous one in the
+      // original file
+      const uint64_t logical_record_offset =
+          blob.offset -
+          BlobLogRecord::CalculateAdjustmentForRecordHeader(blob.key_size);
+      if (blob_count == 0 || logical_record_offset != prev_value_end) {
+        offset_map.AddRun(blob.offset, new_offset);
+      }
+      prev_value_end = blob.offset + blob.value_size;
+
+      ++blob_count;
+      blob_bytes += record.record_size();
+    }
+
+    begin = end;
+  }
+
+  BlobLogFooter footer;
+  footer.blob_count = blob_count;
+
+  std::string checksum_method;
+  std::string checksum_value;
+
+  Status s = writer->AppendFooter(footer, &checksum_method, &checksum_value);
+
+  TEST_SYNC_POINT_CALLBACK(
+      "BlobGarbageCollectionJob::RelocateBlobFile:AppendFooter", &s);
+
+  if (blob_callback_) {
+    s = blob_callback_->OnBlobFileCompleted(
+        blob_file_path, cfd_->GetName(), job_id_, physical_blob_file_number,
+        BlobFileCreationReason::kGarbageCollection, s, checksum_value,
+        checksum_method, blob_count, blob_bytes);
+  }
+
+  if (!s.ok()) {
+    return s;
+  }
+
+  assert(blob_count ==
+         meta->GetTotalBlobCount() - candidate.garbage_blob_count);
+
+  BlobFileAddition relocated_file(meta->GetBlobFileNumber(), blob_count,
+                                  blob_bytes, std::move(checksum_method),
+                                  std::move(checksum_value));
+  relocated_file.SetRelocation(physical_blob_file_number,
+                               std::move(offset_map));
+
+  edit_.AddBlobFileRelocation(BlobFileRelocation(
+      std::move(relocated_file), candidate.garbage_blob_count,
+      candidate.garbage_blob_bytes));
+
+  RecordTick(statistics, BLOB_DB_GC_NUM_FILES);
+  RecordTick(statistics, BLOB_DB_GC_NUM_NEW_FILES);
+  RecordTick(statistics, BLOB_DB_GC_NUM_KEYS_RELOCATED, blob_count);
+  RecordTick(statistics, BLOB_DB_GC_BYTES_RELOCATED, blob_bytes);
+
+  ROCKS_LOG_INFO(ioptions->logger,
+                 "[%s] [JOB %d] Relocated the %" PRIu64 " live blobs (%" PRIu64
+                 " bytes) of blob file #%" PRIu64 " to #%" PRIu64,
+                 cfd_->GetName().c_str(), job_id_, blob_count, blob_bytes,
+                 meta->GetBlobFileNumber(), physical_blob_file_number);
+
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,135 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "db/version_edit.h"
+#include "options/cf_options.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/options.h"
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class BlobFileCompletionCallback;
+class BlobFileMetaData;
+class ColumnFamilyData;
+class InstrumentedMutex;
+class IOTracer;
+class Version;
+class VersionStorageInfo;
+
+// BlobGarbageCollectionJob garbage collects the blob files of a column family
+// whose ratio of garbage bytes exceeds
+// blob_garbage_collection_job_threshold, without rewriting any table file.
+// The live blobs of such a blob file, i.e. those referenced by the table
+// files of the current version, are found by scanning the table files that
+// may reference it, and are copied in order to a new blob file. The blob file
+// is then relocated to the new file by a BlobFileRelocation in the MANIFEST:
+// it keeps its number, and the offsets of the blob indexes referencing it are
+// translated using an offset map (see BlobOffsetMap). The original file
+// becomes obsolete once no version references it anymore.
+//
+// The blobs that become garbage while the job runs are accounted for by the
+// compactions that drop them, and remain garbage of the relocated file.
+class BlobGarbageCollectionJob {
+ public:
+  BlobGarbageCollectionJob(int job_id, ColumnFamilyData* cfd,
+                           const FileOptions& file_options,
+                           InstrumentedMutex* db_mutex,
+                           const std::atomic<bool>* shutting_down,
+                           BlobFileCompletionCallback* blob_callback,
+                           const std::shared_ptr<IOTracer>& io_tracer);
+
+  BlobGarbageCollectionJob(const BlobGarbageCollectionJob&) = delete;
+  BlobGarbageCollectionJob& operator=(const BlobGarbageCollectionJob&) =
+      delete;
+
+  // REQUIRES: db mutex held.
+  ~BlobGarbageCollectionJob();
+
+  // Returns whether the blob files of vstorage include one to garbage collect
+  // with the given threshold, excluding the blob files in excluded.
+  static bool NeedsGarbageCollection(
+      const VersionStorageInfo* vstorage, double threshold,
+      const std::unordered_set<uint64_t>& excluded);
+
+  // Picks the blob files to garbage collect from the current version, and
+  // returns whether there are any. REQUIRES: db mutex held.
+  bool Prepare(const std::unordered_set<uint64_t>& excluded);
+
+  // Relocates the live blobs of the picked blob files to new blob files,
+  // numbered using new_file_number. Blob files whose live blobs do not match
+  // their garbage are added to the failed blob files. The files written for
+  // the blob files that could not be relocated are left for the DB to
+  // delete. REQUIRES: db mutex not held.
+  Status Run(const std::function<uint64_t()>& new_file_number);
+
+  // The relocations to apply. Valid after Run().
+  VersionEdit* GetEdit() { return &edit_; }
+
+  const MutableCFOptions& GetMutableCFOptions() const {
+    return mutable_cf_options_;
+  }
+
+  // The blob files whose live blobs do not match their garbage, and should
+  // not be picked again
+  const std::vector<uint64_t>& GetFailedBlobFiles() const {
+    return failed_blob_files_;
+  }
+
+  // Whether the relocation of some blob files failed, e.g. because of an I/O
+  // error, leaving files written for them
+  bool HasFailedRelocations() const { return has_failed_relocations_; }
+
+ private:
+  // The location of a blob referenced by a table file
+  struct LiveBlob {
+    uint64_t offset;
+    uint64_t key_size;
+    uint64_t value_size;
+
+    bool operator<(const LiveBlob& other) const {
+      return offset < other.offset;
+    }
+  };
+
+  // A blob file to garbage collect, with its garbage when it was picked
+  struct Candidate {
+    std::shared_ptr<BlobFileMetaData> meta;
+    uint64_t garbage_blob_count;
+    uint64_t garbage_blob_bytes;
+    std::vector<LiveBlob> live_blobs;
+  };
+
+  Status FindLiveBlobs();
+  Status RelocateBlobFile(const Candidate& candidate,
+                          uint64_t physical_blob_file_number);
+
+  const int job_id_;
+  ColumnFamilyData* const cfd_;
+  const FileOptions file_options_;
+  InstrumentedMutex* const db_mutex_;
+  const std::atomic<bool>* const shutting_down_;
+  BlobFileCompletionCallback* const blob_callback_;
+  const std::shared_ptr<IOTracer> io_tracer_;
+
+  MutableCFOptions mutable_cf_options_;
+  Version* version_ = nullptr;
+  std::vector<Candidate> candidates_;
+
+  VersionEdit edit_;
+  std::vector<uint64_t> failed_blob_files_;
+  bool has_failed_relocations_ = false;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,92 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_offset_map.h"
+
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+#include <sstream>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+void BlobOffsetMap::AddRun(uint64_t offset, uint64_t new_offset) {
+  assert(runs_.empty() ||
+         (offset > runs_.back().first && new_offset > runs_.back().second));
+  runs_.emplace_back(offset, new_offset);
+}
+
+uint64_t BlobOffsetMap::Translate(uint64_t offset) const {
+  auto it = std::upper_bound(
+      runs_.begin(), runs_.end(), offset,
+      [](uint64_t o, const std::pair<uint64_t, uint64_t>& run) {
+        return o < run.first;
+      });
+  if (it == runs_.begin()) {
+    return 0;
+  }
+  --it;
+  return it->second + (offset - it->first);
+}
+
+void BlobOffsetMap::EncodeTo(std::string* output) const {
+  PutVarint64(output, runs_.size());
+  uint64_t prev_offset = 0;
+  uint64_t prev_new_offset = 0;
+  for (const auto& run : runs_) {
+    PutVarint64(output, run.first - prev_offset);
+    PutVarint64(output, run.second - prev_new_offset);
+    prev_offset = run.first;
+    prev_new_offset = run.second;
+  }
+}
+
+Status BlobOffsetMap::DecodeFrom(Slice* input) {
+  constexpr char class_name[] = "BlobOffsetMap";
+
+  uint64_t num_runs = 0;
+  if (!GetVarint64(input, &num_runs)) {
+    return Status::Corruption(class_name, "Error decoding number of runs");
+  }
+
+  runs_.clear();
+  uint64_t offset = 0;
+  uint64_t new_offset = 0;
+  for (uint64_t i = 0; i < num_runs; ++i) {
+    uint64_t offset_delta = 0;
+    uint64_t new_offset_delta = 0;
+    if (!GetVarint64(input, &offset_delta) ||
+        !GetVarint64(input, &new_offset_delta)) {
+      return Status::Corruption(class_name, "Error decoding run");
+    }
+    if (i > 0 && (offset_delta == 0 || new_offset_delta == 0)) {
+      return Status::Corruption(class_name, "Runs out of order");
+    }
+    offset += offset_delta;
+    new_offset += new_offset_delta;
+    runs_.emplace_back(offset, new_offset);
+  }
+
+  return Status::OK();
+}
+
+std::string BlobOffsetMap::DebugString() const {
+  std::ostringstream oss;
+
+  oss << *this;
+
+  return oss.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const BlobOffsetMap& offset_map) {
+  os << "runs: " << offset_map.size();
+  return os;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,65 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Slice;
+class Status;
+
+// BlobOffsetMap maps the offsets of the blobs of a blob file, as stored in
+// the blob indexes of the table files, to the offsets of the blobs in the
+// file the blob garbage collection job copied them to (see
+// BlobGarbageCollectionJob). The live blobs are copied in order and their
+// records are not changed, so the map is stored as runs of blobs whose
+// records were adjacent in the original file: the offset of a blob is
+// translated by the shift of the run it belongs to.
+class BlobOffsetMap {
+ public:
+  BlobOffsetMap() = default;
+
+  bool empty() const { return runs_.empty(); }
+  size_t size() const { return runs_.size(); }
+
+  // Starts a run at the blob at offset in the original file, copied to
+  // new_offset. Runs must be added in ascending order of both offsets.
+  void AddRun(uint64_t offset, uint64_t new_offset);
+
+  // Returns the offset in the new file of the blob at offset in the original
+  // file, or 0 (which is never a valid blob offset) if offset is before the
+  // first run. Offsets of blobs that were not copied are translated to
+  // offsets that fail the checks of the blob record.
+  uint64_t Translate(uint64_t offset) const;
+
+  void EncodeTo(std::string* output) const;
+  Status DecodeFrom(Slice* input);
+
+  std::string DebugString() const;
+
+  bool operator==(const BlobOffsetMap& other) const {
+    return runs_ == other.runs_;
+  }
+  bool operator!=(const BlobOffsetMap& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  // (offset in the original file, offset in the new file) of the first blob
+  // of each run
+  std::vector<std::pair<uint64_t, uint64_t>> runs_;
+};
+
+std::ostream& operator<<(std::ostream& os, const BlobOffsetMap& offset_map);
+
+}  // namespace ROCKSDB_NAMESPACE
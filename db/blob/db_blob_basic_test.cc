@@ -127,6 +127,153 @@ TEST_F(DBBlobBasicTest, MultiGetBlobs) {
   }
 }
 
+TEST_F(DBBlobBasicTest, GetBlobFromBlobCache) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.blob_cache = NewLRUCache(1 << 20);
+  options.statistics = CreateDBStatistics();
+
+  Reopen(options);
+
+  constexpr char key[] = "key";
+  constexpr char blob_value[] = "blob_value";
+
+  ASSERT_OK(Put(key, blob_value));
+
+  ASSERT_OK(Flush());
+
+  // Not cached if the read does not fill the cache
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+
+  {
+    PinnableSlice result;
+    ASSERT_OK(db_->Get(read_options, db_->DefaultColumnFamily(), key, &result));
+    ASSERT_EQ(result, blob_value);
+  }
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_MISS), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 0);
+
+  // Cached by the first read that fills the cache
+  read_options.fill_cache = true;
+
+  for (int i = 0; i < 2; ++i) {
+    PinnableSlice result;
+    ASSERT_OK(db_->Get(read_options, db_->DefaultColumnFamily(), key, &result));
+    ASSERT_EQ(result, blob_value);
+  }
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_MISS), 2);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_HIT), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_BYTES_WRITE),
+            sizeof(blob_value) - 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_BYTES_READ),
+            sizeof(blob_value) - 1);
+
+  // The cached blob can be read with no I/O allowed
+  read_options.read_tier = kBlockCacheTier;
+
+  {
+    PinnableSlice result;
+    ASSERT_OK(db_->Get(read_options, db_->DefaultColumnFamily(), key, &result));
+    ASSERT_EQ(result, blob_value);
+  }
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_HIT), 2);
+}
+
+TEST_F(DBBlobBasicTest, MultiGetBlobsFromBlobCache) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.blob_cache = NewLRUCache(1 << 20);
+  options.statistics = CreateDBStatistics();
+
+  Reopen(options);
+
+  constexpr size_t num_keys = 3;
+
+  constexpr char first_key[] = "first_key";
+  constexpr char first_value[] = "first_value";
+  constexpr char second_key[] = "second_key";
+  constexpr char second_value[] = "second_value";
+  constexpr char third_key[] = "third_key";
+  constexpr char third_value[] = "third_value";
+
+  ASSERT_OK(Put(first_key, first_value));
+  ASSERT_OK(Put(second_key, second_value));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put(third_key, third_value));
+  ASSERT_OK(Flush());
+
+  // Cache the second blob only
+  ASSERT_EQ(Get(second_key), second_value);
+
+  ReadOptions read_options;
+  read_options.read_tier = kBlockCacheTier;
+
+  std::array<Slice, num_keys> keys{{first_key, second_key, third_key}};
+
+  {
+    std::array<PinnableSlice, num_keys> values;
+    std::array<Status, num_keys> statuses;
+
+    db_->MultiGet(read_options, db_->DefaultColumnFamily(), num_keys, &keys[0],
+                  &values[0], &statuses[0]);
+
+    ASSERT_TRUE(statuses[0].IsIncomplete());
+
+    ASSERT_OK(statuses[1]);
+    ASSERT_EQ(values[1], second_value);
+
+    ASSERT_TRUE(statuses[2].IsIncomplete());
+  }
+
+  // Read all of them, which caches the other two
+  read_options.read_tier = kReadAllTier;
+
+  {
+    std::array<PinnableSlice, num_keys> values;
+    std::array<Status, num_keys> statuses;
+
+    db_->MultiGet(read_options, db_->DefaultColumnFamily(), num_keys, &keys[0],
+                  &values[0], &statuses[0]);
+
+    ASSERT_OK(statuses[0]);
+    ASSERT_EQ(values[0], first_value);
+
+    ASSERT_OK(statuses[1]);
+    ASSERT_EQ(values[1], second_value);
+
+    ASSERT_OK(statuses[2]);
+    ASSERT_EQ(values[2], third_value);
+  }
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_CACHE_ADD), 3);
+
+  read_options.read_tier = kBlockCacheTier;
+
+  {
+    std::array<PinnableSlice, num_keys> values;
+    std::array<Status, num_keys> statuses;
+
+    db_->MultiGet(read_options, db_->DefaultColumnFamily(), num_keys, &keys[0],
+                  &values[0], &statuses[0]);
+
+    ASSERT_OK(statuses[0]);
+    ASSERT_EQ(values[0], first_value);
+
+    ASSERT_OK(statuses[1]);
+    ASSERT_EQ(values[1], second_value);
+
+    ASSERT_OK(statuses[2]);
+    ASSERT_EQ(values[2], third_value);
+  }
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(DBBlobBasicTest, MultiGetWithDirectIO) {
   Options options = GetDefaultOptions();
@@ -952,6 +1099,14 @@ TEST_P(DBBlobBasicIOErrorMultiGetTest, MultipleBlobFiles) {
         fault_injection_env_->SetFilesystemActive(false,
                                                   Status::IOError(sync_point_));
       });
+  // The blob files are all opened before any of them is read, so the failure
+  // to open the second one must not fail the reads of the first one
+  if (sync_point_ != "BlobFileReader::MultiGetBlob:ReadFromFile") {
+    SyncPoint::GetInstance()->SetCallBack(
+        "BlobFileReader::MultiGetBlob:ReadFromFile", [this](void* /* arg */) {
+          fault_injection_env_->SetFilesystemActive(true);
+        });
+  }
   SyncPoint::GetInstance()->EnableProcessing();
 
   db_->MultiGet(ReadOptions(), db_->DefaultColumnFamily(), num_keys,
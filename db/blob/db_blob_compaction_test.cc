@@ -564,6 +564,288 @@ TEST_F(DBBlobCompactionTest, TrackGarbage) {
   }
 }
 
+TEST_F(DBBlobCompactionTest, GarbageCollectionJob) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.disable_auto_compactions = true;
+  options.blob_garbage_collection_job_threshold = 0.5;
+  options.statistics = CreateDBStatistics();
+
+  Reopen(options);
+
+  constexpr int num_keys = 10;
+
+  auto key = [](int i) { return "key" + std::to_string(i); };
+  std::vector<std::string> expected_values(num_keys);
+
+  for (int i = 0; i < num_keys; ++i) {
+    expected_values[i] = "first_value" + std::to_string(i);
+    ASSERT_OK(Put(key(i), expected_values[i]));
+  }
+  ASSERT_OK(Flush());
+
+  // Overwrite most of the keys, so that most of the first blob file becomes
+  // garbage once the table files are compacted
+  for (int i = 0; i < 6; ++i) {
+    expected_values[i] = "second_value" + std::to_string(i);
+    ASSERT_OK(Put(key(i), expected_values[i]));
+  }
+  ASSERT_OK(Flush());
+
+  auto get_blob_files = [&]() {
+    VersionSet* const versions = dbfull()->TEST_GetVersionSet();
+    assert(versions);
+    assert(versions->GetColumnFamilySet());
+
+    ColumnFamilyData* const cfd = versions->GetColumnFamilySet()->GetDefault();
+    assert(cfd);
+
+    return cfd->current()->storage_info()->GetBlobFiles();
+  };
+
+  const uint64_t first_blob_file_number = get_blob_files().begin()->first;
+
+  auto verify = [&]() {
+    std::vector<std::string> keys;
+    for (int i = 0; i < num_keys; ++i) {
+      ASSERT_EQ(Get(key(i)), expected_values[i]);
+      keys.push_back(key(i));
+    }
+
+    ASSERT_EQ(MultiGet(keys, /*snapshot=*/nullptr), expected_values);
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(iter->value(), expected_values[std::stoi(
+                                   iter->key().ToString().substr(3))]);
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(count, num_keys);
+  };
+
+  // The compaction leaves 4 live blobs out of 10 in the first blob file,
+  // which the job relocates to a new file
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  uint64_t first_physical_blob_file_number = 0;
+
+  {
+    const auto blob_files = get_blob_files();
+    ASSERT_EQ(blob_files.size(), 2);
+
+    const auto& meta = blob_files.begin()->second;
+    ASSERT_EQ(meta->GetBlobFileNumber(), first_blob_file_number);
+    ASSERT_TRUE(meta->IsRelocated());
+    ASSERT_EQ(meta->GetTotalBlobCount(), 4);
+    ASSERT_EQ(meta->GetGarbageBlobCount(), 0);
+    ASSERT_EQ(meta->GetGarbageBlobBytes(), 0);
+
+    first_physical_blob_file_number = meta->GetPhysicalBlobFileNumber();
+    ASSERT_GT(first_physical_blob_file_number, first_blob_file_number);
+  }
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_NUM_FILES), 1);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_NUM_KEYS_RELOCATED),
+            4);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_FAILURES), 0);
+
+  verify();
+
+  // Garbage collecting the relocated file again translates the offsets of
+  // the original file to the new one
+  for (int i = 6; i < 8; ++i) {
+    expected_values[i] = "third_value" + std::to_string(i);
+    ASSERT_OK(Put(key(i), expected_values[i]));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  {
+    const auto blob_files = get_blob_files();
+    const auto& meta = blob_files.begin()->second;
+    ASSERT_EQ(meta->GetBlobFileNumber(), first_blob_file_number);
+    ASSERT_TRUE(meta->IsRelocated());
+    ASSERT_EQ(meta->GetTotalBlobCount(), 2);
+    ASSERT_GT(meta->GetPhysicalBlobFileNumber(),
+              first_physical_blob_file_number);
+  }
+
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_NUM_FILES), 2);
+
+  verify();
+
+  // The relocations are recovered from the MANIFEST, and the files the blobs
+  // were copied from are gone
+  Reopen(options);
+
+  {
+    const auto blob_files = get_blob_files();
+    const auto& meta = blob_files.begin()->second;
+    ASSERT_EQ(meta->GetBlobFileNumber(), first_blob_file_number);
+    ASSERT_TRUE(meta->IsRelocated());
+    ASSERT_EQ(meta->GetTotalBlobCount(), 2);
+  }
+
+  verify();
+
+  ASSERT_TRUE(env_->FileExists(BlobFileName(dbname_, first_blob_file_number))
+                  .IsNotFound());
+  ASSERT_TRUE(
+      env_->FileExists(BlobFileName(dbname_, first_physical_blob_file_number))
+          .IsNotFound());
+}
+
+TEST_F(DBBlobCompactionTest, GarbageCollectionJobRetriesIOError) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.disable_auto_compactions = true;
+  options.blob_garbage_collection_job_threshold = 0.5;
+  options.statistics = CreateDBStatistics();
+
+  Reopen(options);
+
+  constexpr int num_keys = 10;
+
+  auto key = [](int i) { return "key" + std::to_string(i); };
+
+  for (int i = 0; i < num_keys; ++i) {
+    ASSERT_OK(Put(key(i), "first_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_OK(Put(key(i), "second_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+
+  auto get_first_blob_file = [&]() {
+    VersionSet* const versions = dbfull()->TEST_GetVersionSet();
+    assert(versions);
+    assert(versions->GetColumnFamilySet());
+
+    ColumnFamilyData* const cfd = versions->GetColumnFamilySet()->GetDefault();
+    assert(cfd);
+
+    return cfd->current()->storage_info()->GetBlobFiles().begin()->second;
+  };
+
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobGarbageCollectionJob::RelocateBlobFile:NewWritableFile",
+      [](void* arg) {
+        Status* const s = static_cast<Status*>(arg);
+        assert(s);
+
+        *s = Status::IOError();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_FALSE(get_first_blob_file()->IsRelocated());
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_FAILURES), 1);
+
+  // The I/O error does not keep the next job from picking the blob file
+  ASSERT_OK(Put(key(6), "second_value6"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  const auto meta = get_first_blob_file();
+  ASSERT_TRUE(meta->IsRelocated());
+  ASSERT_EQ(meta->GetTotalBlobCount(), 3);
+  ASSERT_EQ(options.statistics->getTickerCount(BLOB_DB_GC_NUM_FILES), 1);
+
+  for (int i = 6; i < num_keys; ++i) {
+    ASSERT_EQ(Get(key(i)), (i == 6 ? "second_value" : "first_value") +
+                               std::to_string(i));
+  }
+}
+
+TEST_F(DBBlobCompactionTest, GarbageCollectionJobBestEffortsRecovery) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.disable_auto_compactions = true;
+  options.blob_garbage_collection_job_threshold = 0.5;
+
+  Reopen(options);
+
+  constexpr int num_keys = 10;
+
+  auto key = [](int i) { return "key" + std::to_string(i); };
+  std::vector<std::string> expected_values(num_keys);
+
+  for (int i = 0; i < num_keys; ++i) {
+    expected_values[i] = "first_value" + std::to_string(i);
+    ASSERT_OK(Put(key(i), expected_values[i]));
+  }
+  ASSERT_OK(Flush());
+
+  for (int i = 0; i < 6; ++i) {
+    expected_values[i] = "second_value" + std::to_string(i);
+    ASSERT_OK(Put(key(i), expected_values[i]));
+  }
+  ASSERT_OK(Flush());
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  auto get_blob_files = [&]() {
+    VersionSet* const versions = dbfull()->TEST_GetVersionSet();
+    assert(versions);
+    assert(versions->GetColumnFamilySet());
+
+    ColumnFamilyData* const cfd = versions->GetColumnFamilySet()->GetDefault();
+    assert(cfd);
+
+    return cfd->current()->storage_info()->GetBlobFiles();
+  };
+
+  const uint64_t first_blob_file_number = get_blob_files().begin()->first;
+  ASSERT_TRUE(get_blob_files().begin()->second->IsRelocated());
+
+  // Reopening rolls the MANIFEST over, so the relocated blob file is written
+  // as a blob file addition of the new MANIFEST's snapshot, and its original
+  // file is deleted
+  Reopen(options);
+  ASSERT_TRUE(env_->FileExists(BlobFileName(dbname_, first_blob_file_number))
+                  .IsNotFound());
+
+  // Best-efforts recovery finds the blobs of that addition in the file they
+  // were relocated to, and recovers the full state
+  options.best_efforts_recovery = true;
+  Reopen(options);
+
+  {
+    const auto blob_files = get_blob_files();
+    ASSERT_EQ(blob_files.size(), 2);
+
+    const auto& meta = blob_files.begin()->second;
+    ASSERT_EQ(meta->GetBlobFileNumber(), first_blob_file_number);
+    ASSERT_TRUE(meta->IsRelocated());
+    ASSERT_EQ(meta->GetTotalBlobCount(), 4);
+  }
+
+  for (int i = 0; i < num_keys; ++i) {
+    ASSERT_EQ(Get(key(i)), expected_values[i]);
+  }
+}
+
 TEST_F(DBBlobCompactionTest, MergeBlobWithBase) {
   Options options = GetDefaultOptions();
   options.enable_blob_files = true;
@@ -19,6 +19,7 @@
 #include "db/blob/blob_file_cache.h"
 #include "db/compaction/compaction_picker.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_hybrid.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 #include "db/db_impl/db_impl.h"
@@ -243,6 +244,25 @@ ColumnFamilyOptions SanitizeOptions(const ImmutableDBOptions& db_options,
     result.num_levels = 3;
   }
 
+  if (result.compaction_style == kCompactionStyleHybrid) {
+    CompactionOptionsHybrid& hybrid = result.compaction_options_hybrid;
+    if (hybrid.num_tiered_levels < 0) {
+      hybrid.num_tiered_levels = 0;
+    }
+    if (hybrid.max_sorted_runs_per_level < 1) {
+      hybrid.max_sorted_runs_per_level = 1;
+    }
+    for (int& runs : hybrid.max_sorted_runs_per_tiered_level) {
+      if (runs < 1) {
+        runs = 1;
+      }
+    }
+    ClipToRange(&hybrid.num_leveled_levels, 1, 2);
+    // The level layout is fully determined by the hybrid options.
+    result.num_levels = hybrid.NumLevels();
+    result.level_compaction_dynamic_level_bytes = false;
+  }
+
   if (result.max_write_buffer_number < 2) {
     result.max_write_buffer_number = 2;
   }
@@ -543,6 +563,7 @@ ColumnFamilyData::ColumnFamilyData(
       column_family_set_(column_family_set),
       queued_for_flush_(false),
       queued_for_compaction_(false),
+      queued_for_superversion_reclaim_(false),
       prev_compaction_needed_bytes_(0),
       allow_2pc_(db_options.allow_2pc),
       last_memtable_id_(0),
@@ -588,6 +609,9 @@ ColumnFamilyData::ColumnFamilyData(
     } else if (ioptions_.compaction_style == kCompactionStyleFIFO) {
       compaction_picker_.reset(
           new FIFOCompactionPicker(ioptions_, &internal_comparator_));
+    } else if (ioptions_.compaction_style == kCompactionStyleHybrid) {
+      compaction_picker_.reset(
+          new HybridCompactionPicker(ioptions_, &internal_comparator_));
     } else if (ioptions_.compaction_style == kCompactionStyleNone) {
       compaction_picker_.reset(new NullCompactionPicker(
           ioptions_, &internal_comparator_));
@@ -684,14 +708,24 @@ bool ColumnFamilyData::UnrefAndTryDelete() {
     return true;
   }
 
-  if (old_refs == 2 && super_version_ != nullptr) {
-    // Only the super_version_ holds me
+  if (old_refs == 2 + static_cast<int>(retired_super_versions_.size()) &&
+      super_version_ != nullptr) {
+    // Only the super_version_ and the retired SuperVersions hold me
     SuperVersion* sv = super_version_;
     super_version_ = nullptr;
 
     // Release SuperVersion references kept in ThreadLocalPtr.
     local_sv_.reset();
 
+    autovector<SuperVersion*> retired = retired_super_versions_;
+    retired_super_versions_.clear();
+    for (SuperVersion* retired_sv : retired) {
+      if (retired_sv->Unref()) {
+        retired_sv->Cleanup();
+        delete retired_sv;
+      }
+    }
+
     if (sv->Unref()) {
       // Note: sv will delete this ColumnFamilyData during Cleanup()
       assert(sv->cfd == this);
@@ -1196,8 +1230,10 @@ SuperVersion* ColumnFamilyData::GetReferencedSuperVersion(DBImpl* db) {
 SuperVersion* ColumnFamilyData::GetThreadLocalSuperVersion(DBImpl* db) {
   // The SuperVersion is cached in thread local storage to avoid acquiring
   // mutex when SuperVersion does not change since the last use. When a new
-  // SuperVersion is installed, the compaction or flush thread cleans up
-  // cached SuperVersion in all existing thread local storage. To avoid
+  // SuperVersion is installed, the old one is retired (see
+  // InstallSuperVersion()) and the version number check below refreshes the
+  // cache. A background thread later cleans up the cached SuperVersion in
+  // all existing thread local storage, to reclaim the retired ones. To avoid
   // acquiring mutex for this operation, we use atomic Swap() on the thread
   // local pointer to guarantee exclusive access. If the thread local pointer
   // is being used while a new SuperVersion is installed, the cached
@@ -1263,10 +1299,12 @@ bool ColumnFamilyData::ReturnThreadLocalSuperVersion(SuperVersion* sv) {
 void ColumnFamilyData::InstallSuperVersion(
     SuperVersionContext* sv_context, InstrumentedMutex* db_mutex) {
   db_mutex->AssertHeld();
-  return InstallSuperVersion(sv_context, mutable_cf_options_);
+  if (InstallSuperVersion(sv_context, mutable_cf_options_)) {
+    ReclaimRetiredSuperVersions(sv_context);
+  }
 }
 
-void ColumnFamilyData::InstallSuperVersion(
+bool ColumnFamilyData::InstallSuperVersion(
     SuperVersionContext* sv_context,
     const MutableCFOptions& mutable_cf_options) {
   SuperVersion* new_superversion = sv_context->new_superversion.release();
@@ -1279,28 +1317,42 @@ void ColumnFamilyData::InstallSuperVersion(
   super_version_->write_stall_condition =
       RecalculateWriteStallConditions(mutable_cf_options);
 
-  if (old_superversion != nullptr) {
-    // Reset SuperVersions cached in thread local storage.
-    // This should be done before old_superversion->Unref(). That's to ensure
-    // that local_sv_ never holds the last reference to SuperVersion, since
-    // it has no means to safely do SuperVersion cleanup.
-    ResetThreadLocalSuperVersions();
+  if (old_superversion == nullptr) {
+    return false;
+  }
+  if (old_superversion->mutable_cf_options.write_buffer_size !=
+      mutable_cf_options.write_buffer_size) {
+    mem_->UpdateWriteBufferSize(mutable_cf_options.write_buffer_size);
+  }
+  if (old_superversion->write_stall_condition !=
+      new_superversion->write_stall_condition) {
+    sv_context->PushWriteStallNotification(
+        old_superversion->write_stall_condition,
+        new_superversion->write_stall_condition, GetName(), ioptions());
+  }
 
-    if (old_superversion->mutable_cf_options.write_buffer_size !=
-        mutable_cf_options.write_buffer_size) {
-      mem_->UpdateWriteBufferSize(mutable_cf_options.write_buffer_size);
-    }
-    if (old_superversion->write_stall_condition !=
-        new_superversion->write_stall_condition) {
-      sv_context->PushWriteStallNotification(
-          old_superversion->write_stall_condition,
-          new_superversion->write_stall_condition, GetName(), ioptions());
-    }
-    if (old_superversion->Unref()) {
-      old_superversion->Cleanup();
-      sv_context->superversions_to_free.push_back(old_superversion);
-    }
+  // Scraping the SuperVersions cached in thread local storage takes time
+  // linear in the number of threads, so it is not done here. The old
+  // SuperVersion is retired instead: readers notice the new version number
+  // and refresh their cache, and it stays referenced until it is reclaimed.
+  // Reclaiming is only urgent when the new SuperVersion no longer references
+  // everything the old one does, as when a flush or compaction result is
+  // installed. Otherwise, as when the memtable is switched, the retired
+  // SuperVersions pin nothing more than the new one.
+  retired_super_versions_.push_back(old_superversion);
+  return retired_super_versions_.size() >= kMaxRetiredSuperVersions ||
+         old_superversion->current != new_superversion->current ||
+         (old_superversion->mem != new_superversion->mem &&
+          !new_superversion->imm->Contains(old_superversion->mem)) ||
+         !old_superversion->imm->IsSubsetOf(*new_superversion->imm);
+}
+
+void ColumnFamilyData::TakeRetiredSuperVersions(
+    autovector<SuperVersion*>* retired) {
+  for (SuperVersion* sv : retired_super_versions_) {
+    retired->push_back(sv);
   }
+  retired_super_versions_.clear();
 }
 
 void ColumnFamilyData::ResetThreadLocalSuperVersions() {
@@ -1316,11 +1368,34 @@ void ColumnFamilyData::ResetThreadLocalSuperVersions() {
     was_last_ref = sv->Unref();
     // sv couldn't have been the last reference because
     // ResetThreadLocalSuperVersions() is called before
-    // unref'ing super_version_.
+    // unref'ing super_version_ or the retired SuperVersions.
     assert(!was_last_ref);
   }
 }
 
+void ColumnFamilyData::ReleaseSuperVersions(
+    const autovector<SuperVersion*>& svs, SuperVersionContext* sv_context) {
+  for (SuperVersion* sv : svs) {
+    if (sv->Unref()) {
+      sv->Cleanup();
+      sv_context->superversions_to_free.push_back(sv);
+    }
+  }
+}
+
+void ColumnFamilyData::ReclaimRetiredSuperVersions(
+    SuperVersionContext* sv_context) {
+  // Cleanup() unrefs this ColumnFamilyData, which counts the retired
+  // SuperVersions, so they are taken off the list first. The scrape must
+  // come after the take, so that local_sv_ never holds the last reference
+  // to a SuperVersion, since it has no means to safely do SuperVersion
+  // cleanup.
+  autovector<SuperVersion*> retired;
+  TakeRetiredSuperVersions(&retired);
+  ResetThreadLocalSuperVersions();
+  ReleaseSuperVersions(retired, sv_context);
+}
+
 Status ColumnFamilyData::ValidateOptions(
     const DBOptions& db_options, const ColumnFamilyOptions& cf_options) {
   Status s;
@@ -1340,6 +1415,12 @@ Status ColumnFamilyData::ValidateOptions(
     return s;
   }
 
+  if (cf_options.compaction_style == kCompactionStyleHybrid &&
+      db_options.allow_ingest_behind) {
+    return Status::NotSupported(
+        "Hybrid compaction style does not support allow_ingest_behind");
+  }
+
   if (cf_options.ttl > 0 && cf_options.ttl != kDefaultTtl) {
     if (!cf_options.table_factory->IsInstanceOf(
             TableFactory::kBlockBasedTableName())) {
@@ -1373,6 +1454,13 @@ Status ColumnFamilyData::ValidateOptions(
     }
   }
 
+  if (cf_options.blob_garbage_collection_job_threshold < 0.0 ||
+      cf_options.blob_garbage_collection_job_threshold > 1.0) {
+    return Status::InvalidArgument(
+        "The garbage ratio threshold for the blob garbage collection job "
+        "should be in the range [0.0, 1.0].");
+  }
+
   if (cf_options.compaction_style == kCompactionStyleFIFO &&
       db_options.max_open_files != -1 && cf_options.ttl > 0) {
     return Status::NotSupported(
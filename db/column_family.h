@@ -445,23 +445,50 @@ class ColumnFamilyData {
   uint64_t GetSuperVersionNumber() const {
     return super_version_number_.load();
   }
-  // will return a pointer to SuperVersion* if previous SuperVersion
-  // if its reference count is zero and needs deletion or nullptr if not
+  // Installs sv_context->new_superversion. The previous SuperVersion is
+  // retired: it stays referenced until the retired SuperVersions are
+  // reclaimed, since thread-local storage may still cache it. Returns true if
+  // they should be reclaimed soon, because they reference memtables or a
+  // version that the new SuperVersion does not, or there are
+  // kMaxRetiredSuperVersions of them.
   // As argument takes a pointer to allocated SuperVersion to enable
   // the clients to allocate SuperVersion outside of mutex.
   // IMPORTANT: Only call this from DBImpl::InstallSuperVersion()
-  void InstallSuperVersion(SuperVersionContext* sv_context,
+  bool InstallSuperVersion(SuperVersionContext* sv_context,
                            const MutableCFOptions& mutable_cf_options);
+  // Same, but reclaims the retired SuperVersions right away if needed
   void InstallSuperVersion(SuperVersionContext* sv_context,
                            InstrumentedMutex* db_mutex);
 
+  // Reclaiming the retired SuperVersions takes three steps, so that the
+  // scrape of thread-local storage, which takes time linear in the number of
+  // threads, can run without the DB mutex:
+  // 1. TakeRetiredSuperVersions(), with the DB mutex held
+  // 2. ResetThreadLocalSuperVersions(), with or without the DB mutex
+  // 3. ReleaseSuperVersions() on the taken ones, with the DB mutex held
+  // The SuperVersions to delete are added to sv_context->superversions_to_free
+  void TakeRetiredSuperVersions(autovector<SuperVersion*>* retired);
   void ResetThreadLocalSuperVersions();
+  static void ReleaseSuperVersions(const autovector<SuperVersion*>& svs,
+                                   SuperVersionContext* sv_context);
+  // All three steps, with the DB mutex held
+  void ReclaimRetiredSuperVersions(SuperVersionContext* sv_context);
+
+  // Number of retired SuperVersions above which InstallSuperVersion() asks
+  // for them to be reclaimed
+  static const size_t kMaxRetiredSuperVersions = 16;
 
   // Protected by DB mutex
   void set_queued_for_flush(bool value) { queued_for_flush_ = value; }
   void set_queued_for_compaction(bool value) { queued_for_compaction_ = value; }
   bool queued_for_flush() { return queued_for_flush_; }
   bool queued_for_compaction() { return queued_for_compaction_; }
+  void set_queued_for_superversion_reclaim(bool value) {
+    queued_for_superversion_reclaim_ = value;
+  }
+  bool queued_for_superversion_reclaim() {
+    return queued_for_superversion_reclaim_;
+  }
 
   enum class WriteStallCause {
     kNone,
@@ -564,6 +591,11 @@ class ColumnFamilyData {
   MemTableList imm_;
   SuperVersion* super_version_;
 
+  // SuperVersions replaced by InstallSuperVersion() since local_sv_ was last
+  // scraped. Thread-local storage may still cache them, so they are kept
+  // referenced until they are reclaimed. Protected by DB mutex.
+  autovector<SuperVersion*> retired_super_versions_;
+
   // An ordinal representing the current SuperVersion. Updated by
   // InstallSuperVersion(), i.e. incremented every time super_version_
   // changes.
@@ -601,6 +633,10 @@ class ColumnFamilyData {
   // DBImpl::compaction_queue_
   bool queued_for_compaction_;
 
+  // If true --> this ColumnFamily is currently present in
+  // DBImpl::superversion_reclaim_queue_
+  bool queued_for_superversion_reclaim_;
+
   uint64_t prev_compaction_needed_bytes_;
 
   // if the database was opened with 2pc enabled
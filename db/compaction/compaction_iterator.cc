@@ -60,7 +60,14 @@ CompactionIterator::CompactionIterator(
     const std::atomic<bool>* manual_compaction_canceled,
     const std::shared_ptr<Logger> info_log,
     const std::string* full_history_ts_low)
-    : input_(input, cmp,
+    : filter_batching_iter_(
+          compaction_filter && compaction_filter->SupportsFilterBatch()
+              ? new FilterBatchingIterWrapper(
+                    input, compaction_filter,
+                    compaction == nullptr ? 0 : compaction->level(),
+                    env->GetSystemClock().get(), report_detailed_time)
+              : nullptr),
+      input_(filter_batching_iter_ ? filter_batching_iter_.get() : input, cmp,
              !compaction || compaction->DoesInputReferenceBlobFiles()),
       cmp_(cmp),
       merge_helper_(merge_helper),
@@ -216,7 +223,26 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
        !compaction_filter_->IsStackedBlobDbInternalCompactionFilter())
           ? ikey_.user_key
           : key_;
-  {
+  if (filter_batching_iter_ != nullptr && ikey_.type == kTypeValue) {
+    // input_ is still positioned at the current entry.
+    assert(filter_batching_iter_->Valid());
+    assert(filter_batching_iter_->key().data() == input_.key().data());
+    iter_stats_.total_filter_time += filter_batching_iter_->ConsumeFilterTime();
+    switch (filter_batching_iter_->decision()) {
+      case CompactionFilter::Decision::kKeep:
+      case CompactionFilter::Decision::kRemove:
+        filter = filter_batching_iter_->decision();
+        break;
+      case CompactionFilter::Decision::kChangeValue:
+        filter = filter_batching_iter_->decision();
+        compaction_filter_value_ = filter_batching_iter_->new_value();
+        break;
+      default:
+        // Fall back to FilterV2() below.
+        break;
+    }
+  }
+  if (CompactionFilter::Decision::kUndetermined == filter) {
     StopWatchNano timer(clock_, report_detailed_time_);
     if (kTypeBlobIndex == ikey_.type) {
       blob_value_.Reset();
@@ -249,8 +275,13 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
         const Version* const version = compaction_->input_version();
         assert(version);
 
+        // Like the table reads of compactions, these do not fill the blob
+        // cache
+        ReadOptions read_options;
+        read_options.fill_cache = false;
+
         uint64_t bytes_read = 0;
-        s = version->GetBlob(ReadOptions(), ikey_.user_key, blob_index,
+        s = version->GetBlob(read_options, ikey_.user_key, blob_index,
                              &blob_value_, &bytes_read);
         if (!s.ok()) {
           status_ = s;
@@ -341,6 +372,70 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
   return !error;
 }
 
+void FilterBatchingIterWrapper::FillBatch() {
+  buf_.clear();
+  entries_.clear();
+  pos_ = 0;
+
+  // Copy the chunk first, since buf_ may be reallocated while growing.
+  std::vector<std::pair<size_t, size_t>> offsets;
+  while (inner_iter_->Valid() && entries_.size() < kMaxBatchEntries &&
+         buf_.size() < kMaxBatchBytes) {
+    const Slice key = inner_iter_->key();
+    const Slice value = inner_iter_->value();
+    offsets.emplace_back(buf_.size(), key.size());
+    buf_.append(key.data(), key.size());
+    offsets.emplace_back(buf_.size(), value.size());
+    buf_.append(value.data(), value.size());
+    entries_.push_back({Slice(), Slice(),
+                        CompactionFilter::Decision::kUndetermined,
+                        kNotInBatch});
+    inner_iter_->Next();
+  }
+
+  batch_keys_.clear();
+  batch_values_.clear();
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    Entry& entry = entries_[i];
+    entry.key = Slice(buf_.data() + offsets[2 * i].first,
+                      offsets[2 * i].second);
+    entry.value = Slice(buf_.data() + offsets[2 * i + 1].first,
+                        offsets[2 * i + 1].second);
+    ParsedInternalKey ikey;
+    // Corrupted keys are left to CompactionIterator to report.
+    if (ParseInternalKey(entry.key, &ikey, false /* log_err_key */).ok() &&
+        ikey.type == kTypeValue) {
+      entry.batch_index = batch_keys_.size();
+      batch_keys_.push_back(ikey.user_key);
+      batch_values_.push_back(entry.value);
+    }
+  }
+  if (batch_keys_.empty()) {
+    return;
+  }
+
+  decisions_.assign(batch_keys_.size(),
+                    CompactionFilter::Decision::kUndetermined);
+  if (new_values_.size() < batch_keys_.size()) {
+    new_values_.resize(batch_keys_.size());
+  }
+  for (size_t i = 0; i < batch_keys_.size(); ++i) {
+    new_values_[i].clear();
+  }
+  {
+    StopWatchNano timer(clock_, report_detailed_time_);
+    compaction_filter_->FilterBatch(level_, batch_keys_.size(),
+                                    batch_keys_.data(), batch_values_.data(),
+                                    decisions_.data(), new_values_.data());
+    filter_time_ += report_detailed_time_ ? timer.ElapsedNanos() : 0;
+  }
+  for (Entry& entry : entries_) {
+    if (entry.batch_index != kNotInBatch) {
+      entry.decision = decisions_[entry.batch_index];
+    }
+  }
+}
+
 void CompactionIterator::NextFromInput() {
   at_next_ = false;
   valid_ = false;
@@ -920,10 +1015,14 @@ void CompactionIterator::GarbageCollectBlobIfNeeded() {
     const Version* const version = compaction_->input_version();
     assert(version);
 
+    // The blob is relocated, so there is no point in caching it
+    ReadOptions read_options;
+    read_options.fill_cache = false;
+
     uint64_t bytes_read = 0;
 
     {
-      const Status s = version->GetBlob(ReadOptions(), user_key(), blob_index,
+      const Status s = version->GetBlob(read_options, user_key(), blob_index,
                                         &blob_value_, &bytes_read);
 
       if (!s.ok()) {
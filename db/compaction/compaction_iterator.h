@@ -69,6 +69,106 @@ class SequenceIterWrapper : public InternalIterator {
   bool need_count_entries_;
 };
 
+// A wrapper of internal iterator that reads ahead a chunk of entries and
+// evaluates the compaction filter on all plain values of the chunk with one
+// CompactionFilter::FilterBatch() call. The decision for the current entry is
+// then available through decision() and new_value(). Keys and values are
+// copied into the chunk buffer, so they are never pinned.
+class FilterBatchingIterWrapper : public InternalIterator {
+ public:
+  static constexpr size_t kMaxBatchEntries = 256;
+  static constexpr size_t kMaxBatchBytes = 1 << 20;
+
+  FilterBatchingIterWrapper(InternalIterator* iter,
+                            const CompactionFilter* compaction_filter,
+                            int level, SystemClock* clock,
+                            bool report_detailed_time)
+      : inner_iter_(iter),
+        compaction_filter_(compaction_filter),
+        level_(level),
+        clock_(clock),
+        report_detailed_time_(report_detailed_time) {
+    FillBatch();
+  }
+
+  bool Valid() const override { return pos_ < entries_.size(); }
+  Status status() const override {
+    return Valid() ? Status::OK() : inner_iter_->status();
+  }
+  void Next() override {
+    assert(Valid());
+    if (++pos_ == entries_.size()) {
+      FillBatch();
+    }
+  }
+  void Seek(const Slice& target) override {
+    inner_iter_->Seek(target);
+    FillBatch();
+  }
+  Slice key() const override {
+    assert(Valid());
+    return entries_[pos_].key;
+  }
+  Slice value() const override {
+    assert(Valid());
+    return entries_[pos_].value;
+  }
+
+  // Unused InternalIterator methods
+  void SeekToFirst() override { assert(false); }
+  void Prev() override { assert(false); }
+  void SeekForPrev(const Slice& /* target */) override { assert(false); }
+  void SeekToLast() override { assert(false); }
+
+  // FilterBatch() decision for the current entry, kUndetermined if the entry
+  // is not a plain value or the filter deferred to FilterV2().
+  CompactionFilter::Decision decision() const {
+    assert(Valid());
+    return entries_[pos_].decision;
+  }
+  // Only meaningful if decision() is kChangeValue.
+  const std::string& new_value() const {
+    assert(Valid());
+    return new_values_[entries_[pos_].batch_index];
+  }
+
+  // Returns the time spent in FilterBatch() since the last call.
+  uint64_t ConsumeFilterTime() {
+    uint64_t t = filter_time_;
+    filter_time_ = 0;
+    return t;
+  }
+
+ private:
+  static constexpr size_t kNotInBatch = port::kMaxSizet;
+
+  struct Entry {
+    Slice key;
+    Slice value;
+    CompactionFilter::Decision decision;
+    // Index into the FilterBatch() arguments, kNotInBatch if the entry is not
+    // a plain value.
+    size_t batch_index;
+  };
+
+  void FillBatch();
+
+  InternalIterator* inner_iter_;  // not owned
+  const CompactionFilter* compaction_filter_;
+  const int level_;
+  SystemClock* clock_;
+  const bool report_detailed_time_;
+  std::string buf_;
+  std::vector<Entry> entries_;
+  size_t pos_ = 0;
+  // Arguments of the FilterBatch() call, reused across chunks.
+  std::vector<Slice> batch_keys_;
+  std::vector<Slice> batch_values_;
+  std::vector<CompactionFilter::Decision> decisions_;
+  std::vector<std::string> new_values_;
+  uint64_t filter_time_ = 0;
+};
+
 class CompactionIterator {
  public:
   // A wrapper around Compaction. Has a much smaller interface, only what
@@ -296,6 +396,9 @@ class CompactionIterator {
   static uint64_t ComputeBlobGarbageCollectionCutoffFileNumber(
       const CompactionProxy* compaction);
 
+  // Sits between the input iterator and input_ if the compaction filter
+  // supports FilterBatch(), nullptr otherwise.
+  std::unique_ptr<FilterBatchingIterWrapper> filter_batching_iter_;
   SequenceIterWrapper input_;
   const Comparator* cmp_;
   MergeHelper* merge_helper_;
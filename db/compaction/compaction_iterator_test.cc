@@ -523,6 +523,70 @@ TEST_P(CompactionIteratorTest, CompactionFilterSkipUntil) {
   ASSERT_EQ(expected_actions, iter_->log);
 }
 
+TEST_P(CompactionIteratorTest, CompactionFilterBatch) {
+  class Filter : public CompactionFilter {
+   public:
+    bool SupportsFilterBatch() const override { return true; }
+
+    void FilterBatch(int /*level*/, size_t num_entries, const Slice* keys,
+                     const Slice* existing_values, Decision* decisions,
+                     std::string* new_values) const override {
+      ++num_batches;
+      for (size_t i = 0; i < num_entries; ++i) {
+        batched_keys.push_back(keys[i].ToString());
+        if (existing_values[i] == "drop") {
+          decisions[i] = Decision::kRemove;
+        } else if (existing_values[i] == "change") {
+          decisions[i] = Decision::kChangeValue;
+          new_values[i] = "changed";
+        } else if (existing_values[i] == "single") {
+          decisions[i] = Decision::kUndetermined;
+        } else {
+          decisions[i] = Decision::kKeep;
+        }
+      }
+    }
+
+    Decision FilterV2(int /*level*/, const Slice& key, ValueType t,
+                      const Slice& existing_value, std::string* new_value,
+                      std::string* /*skip_until*/) const override {
+      EXPECT_EQ(ValueType::kValue, t);
+      EXPECT_EQ("d", key.ToString());
+      EXPECT_EQ("single", existing_value.ToString());
+      ++num_single_calls;
+      *new_value = "single-changed";
+      return Decision::kChangeValue;
+    }
+
+    const char* Name() const override {
+      return "CompactionIteratorTest.CompactionFilterBatch::Filter";
+    }
+
+    mutable int num_batches = 0;
+    mutable int num_single_calls = 0;
+    mutable std::vector<std::string> batched_keys;
+  };
+
+  NoMergingMergeOp merge_op;
+  Filter filter;
+  RunTest({test::KeyStr("a", 50, kTypeValue), test::KeyStr("b", 60, kTypeValue),
+           test::KeyStr("c", 70, kTypeValue), test::KeyStr("d", 80, kTypeValue),
+           test::KeyStr("d", 30, kTypeValue)},
+          {"keep", "drop", "change", "single", "drop"},
+          {test::KeyStr("a", 50, kTypeValue),
+           test::KeyStr("b", 60, kTypeDeletion),
+           test::KeyStr("c", 70, kTypeValue), test::KeyStr("d", 80, kTypeValue)},
+          {"keep", "", "changed", "single-changed"}, kMaxSequenceNumber,
+          &merge_op, &filter);
+
+  // All plain values, including the hidden version of "d", were evaluated in
+  // one batch. FilterV2() was only called for the deferred key.
+  ASSERT_EQ(1, filter.num_batches);
+  ASSERT_EQ(std::vector<std::string>({"a", "b", "c", "d", "d"}),
+            filter.batched_keys);
+  ASSERT_EQ(1, filter.num_single_calls);
+}
+
 TEST_P(CompactionIteratorTest, ShuttingDownInFilter) {
   NoMergingMergeOp merge_op;
   StallingFilter filter;
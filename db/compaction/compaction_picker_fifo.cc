@@ -75,13 +75,13 @@ Compaction* FIFOCompactionPicker::PickTTLCompaction(
     for (auto ritr = level_files.rbegin(); ritr != level_files.rend(); ++ritr) {
       FileMetaData* f = *ritr;
       assert(f);
-      if (f->fd.table_reader && f->fd.table_reader->GetTableProperties()) {
-        uint64_t creation_time =
-            f->fd.table_reader->GetTableProperties()->creation_time;
-        if (creation_time == 0 ||
-            creation_time >= (current_time - mutable_cf_options.ttl)) {
-          break;
-        }
+      // The creation time comes from the MANIFEST, or from the table
+      // properties if the table is open. A table not opened yet, as with
+      // DBOptions::open_tables_lazily, is not known to be expired.
+      uint64_t creation_time = f->TryGetOldestAncesterTime();
+      if (creation_time == kUnknownOldestAncesterTime ||
+          creation_time >= (current_time - mutable_cf_options.ttl)) {
+        break;
       }
       total_size -= f->compensated_file_size;
       inputs[0].files.push_back(f);
@@ -99,11 +99,8 @@ Compaction* FIFOCompactionPicker::PickTTLCompaction(
   }
 
   for (const auto& f : inputs[0].files) {
-    uint64_t creation_time = 0;
     assert(f);
-    if (f->fd.table_reader && f->fd.table_reader->GetTableProperties()) {
-      creation_time = f->fd.table_reader->GetTableProperties()->creation_time;
-    }
+    uint64_t creation_time = f->TryGetOldestAncesterTime();
     ROCKS_LOG_BUFFER(log_buffer,
                      "[%s] FIFO compaction: picking file %" PRIu64
                      " with creation time %" PRIu64 " for deletion",
@@ -0,0 +1,387 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Copyright (c) 2011 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#include "db/compaction/compaction_picker_hybrid.h"
+#ifndef ROCKSDB_LITE
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "db/column_family.h"
+#include "logging/log_buffer.h"
+#include "logging/logging.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+bool HybridCompactionPicker::NeedsCompaction(
+    const VersionStorageInfo* vstorage) const {
+  for (int i = 0; i <= vstorage->MaxInputLevel(); i++) {
+    if (vstorage->CompactionScore(i) >= 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+// A helper class that forms hybrid compactions. The class is used by
+// HybridCompactionPicker::PickCompaction().
+//
+// Physical level layout, with R(t) = MaxSortedRuns(t), S(t) =
+// FirstLevelOfTieredLevel(t) = 1 + R(0) + .. + R(t - 1) and
+// T = num_tiered_levels:
+//   L0                      tiered level 0, one sorted run per file
+//   L(S(t)) ..
+//   L(S(t) + R(t) - 1)      tiered level t + 1, one sorted run per level
+//   L(S(T)) ..              leveled levels
+//
+// Within a tiered level runs are filled bottom-up: a new run is always placed
+// right above the newest existing run of that tiered level, so runs at lower
+// physical levels are always newer, as required for reads. A run merged away
+// while newer runs were added above it leaves empty levels below them. Once
+// the first physical level of the tiered level is taken, its runs are moved
+// down into these levels, usually as trivial moves, before another run is
+// added.
+class HybridCompactionBuilder {
+ public:
+  HybridCompactionBuilder(const ImmutableOptions& ioptions,
+                          const std::string& cf_name,
+                          const MutableCFOptions& mutable_cf_options,
+                          const MutableDBOptions& mutable_db_options,
+                          VersionStorageInfo* vstorage,
+                          HybridCompactionPicker* picker,
+                          LogBuffer* log_buffer)
+      : ioptions_(ioptions),
+        cf_name_(cf_name),
+        mutable_cf_options_(mutable_cf_options),
+        mutable_db_options_(mutable_db_options),
+        vstorage_(vstorage),
+        picker_(picker),
+        log_buffer_(log_buffer) {
+    const CompactionOptionsHybrid& hybrid =
+        ioptions.compaction_options_hybrid;
+    for (int t = 0; t <= hybrid.num_tiered_levels; t++) {
+      tiered_level_starts_.push_back(hybrid.FirstLevelOfTieredLevel(t));
+    }
+    first_leveled_level_ = tiered_level_starts_.back();
+  }
+
+  // Form and return the compaction object. The caller owns return object.
+  Compaction* PickCompaction();
+
+ private:
+  // Merge all sorted runs of the tiered level starting at physical level
+  // `start_level` into one run of the next level.
+  Compaction* PickTieredCompaction(int start_level, double score);
+
+  // Compact one file (expanded to a clean cut) of the leveled level
+  // `start_level` into the last level.
+  Compaction* PickLeveledCompaction(int start_level, double score);
+
+  // First physical level of the tiered level following the one that
+  // `level` belongs to.
+  int NextTieredLevelStart(int level) const;
+
+  // Physical level that receives the merged run of the tiered level ending
+  // right above `next_level_start`, or -1 if the first physical level of the
+  // next tiered level is taken.
+  int FindTieredOutputLevel(int next_level_start) const;
+
+  // Moves the newest run of the tiered level starting at `level_start` that
+  // has an empty level below it into the lowest of those empty levels, to
+  // make room for a new run. Returns nullptr if there is no such run.
+  Compaction* PickRunMove(int level_start, double score);
+
+  // Whether a running compaction writes to `level`.
+  bool IsOutputLevelOfRunningCompaction(int level) const;
+
+  Compaction* NewCompaction(std::vector<CompactionInputFiles>&& inputs,
+                            int output_level, uint64_t max_compaction_bytes,
+                            double score, CompactionReason compaction_reason);
+
+  const ImmutableOptions& ioptions_;
+  const std::string& cf_name_;
+  const MutableCFOptions& mutable_cf_options_;
+  const MutableDBOptions& mutable_db_options_;
+  VersionStorageInfo* vstorage_;
+  HybridCompactionPicker* picker_;
+  LogBuffer* log_buffer_;
+  // The first physical level of each tiered level below L0, followed by the
+  // first leveled level
+  std::vector<int> tiered_level_starts_;
+  int first_leveled_level_;
+};
+
+Compaction* HybridCompactionBuilder::PickCompaction() {
+  assert(vstorage_->num_levels() ==
+         ioptions_.compaction_options_hybrid.NumLevels());
+  for (int i = 0; i < vstorage_->num_levels() - 1; i++) {
+    const double score = vstorage_->CompactionScore(i);
+    const int level = vstorage_->CompactionScoreLevel(i);
+    if (score < 1) {
+      // Compaction scores are sorted in descending order, no further scores
+      // will be >= 1.
+      break;
+    }
+    Compaction* c = level < first_leveled_level_
+                        ? PickTieredCompaction(level, score)
+                        : PickLeveledCompaction(level, score);
+    if (c != nullptr) {
+      picker_->RegisterCompaction(c);
+      // The score takes running compactions into account, so it must be
+      // recomputed now that new files are being compacted.
+      vstorage_->ComputeCompactionScore(ioptions_, mutable_cf_options_);
+      TEST_SYNC_POINT_CALLBACK("HybridCompactionPicker::PickCompaction:Return",
+                               c);
+      return c;
+    }
+  }
+  TEST_SYNC_POINT_CALLBACK("HybridCompactionPicker::PickCompaction:Return",
+                           nullptr);
+  return nullptr;
+}
+
+bool HybridCompactionBuilder::IsOutputLevelOfRunningCompaction(
+    int level) const {
+  for (Compaction* c : *picker_->compactions_in_progress()) {
+    if (c->output_level() == level) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int HybridCompactionBuilder::NextTieredLevelStart(int level) const {
+  assert(level < first_leveled_level_);
+  return *std::upper_bound(tiered_level_starts_.begin(),
+                           tiered_level_starts_.end(), level);
+}
+
+int HybridCompactionBuilder::FindTieredOutputLevel(
+    int next_level_start) const {
+  const int next_level_end = NextTieredLevelStart(next_level_start) - 1;
+  int output_level = next_level_end;
+  for (int level = next_level_start; level <= next_level_end; level++) {
+    if (vstorage_->NumLevelFiles(level) > 0 ||
+        IsOutputLevelOfRunningCompaction(level)) {
+      output_level = level - 1;
+      break;
+    }
+  }
+  return output_level < next_level_start ? -1 : output_level;
+}
+
+Compaction* HybridCompactionBuilder::PickTieredCompaction(int start_level,
+                                                          double score) {
+  if (start_level == 0 && picker_->IsLevel0CompactionInProgress()) {
+    // L0 files overlap, so only one compaction may consume them at a time.
+    return nullptr;
+  }
+  const int next_level_start = NextTieredLevelStart(start_level);
+  const int end_level = start_level == 0 ? 0 : next_level_start - 1;
+
+  std::vector<CompactionInputFiles> inputs;
+  for (int level = start_level; level <= end_level; level++) {
+    const std::vector<FileMetaData*>& files = vstorage_->LevelFiles(level);
+    if (files.empty()) {
+      continue;
+    }
+    if (picker_->AreFilesInCompaction(files)) {
+      return nullptr;
+    }
+    inputs.emplace_back();
+    inputs.back().level = level;
+    inputs.back().files = files;
+  }
+  if (inputs.empty()) {
+    return nullptr;
+  }
+
+  int output_level;
+  uint64_t max_compaction_bytes = port::kMaxUint64;
+  if (next_level_start < first_leveled_level_) {
+    output_level = FindTieredOutputLevel(next_level_start);
+    if (output_level < 0) {
+      Compaction* c = PickRunMove(next_level_start, score);
+      if (c == nullptr) {
+        ROCKS_LOG_BUFFER(log_buffer_,
+                         "[%s] Hybrid: tiered level at L%d is full, cannot "
+                         "merge L%d-L%d\n",
+                         cf_name_.c_str(), next_level_start, start_level,
+                         end_level);
+      }
+      return c;
+    }
+  } else {
+    // Merge into the first leveled level, rewriting only the files of that
+    // level which overlap with the merged runs.
+    output_level = first_leveled_level_;
+    max_compaction_bytes = mutable_cf_options_.max_compaction_bytes;
+    InternalKey smallest, largest;
+    picker_->GetRange(inputs, &smallest, &largest);
+    CompactionInputFiles output_level_inputs;
+    output_level_inputs.level = output_level;
+    vstorage_->GetOverlappingInputs(output_level, &smallest, &largest,
+                                    &output_level_inputs.files);
+    if (!output_level_inputs.empty()) {
+      if (!picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                           &output_level_inputs)) {
+        return nullptr;
+      }
+      inputs.push_back(std::move(output_level_inputs));
+    }
+    if (picker_->FilesRangeOverlapWithCompaction(inputs, output_level)) {
+      return nullptr;
+    }
+  }
+
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] Hybrid: merging sorted runs of L%d-L%d into L%d, "
+                   "score %.2f\n",
+                   cf_name_.c_str(), start_level, end_level, output_level,
+                   score);
+  return NewCompaction(std::move(inputs), output_level, max_compaction_bytes,
+                       score,
+                       start_level == 0
+                           ? CompactionReason::kLevelL0FilesNum
+                           : CompactionReason::kUniversalSortedRunNum);
+}
+
+Compaction* HybridCompactionBuilder::PickRunMove(int level_start,
+                                                 double score) {
+  const int level_end = NextTieredLevelStart(level_start) - 1;
+  // The lowest empty level with a run above it
+  int output_level = -1;
+  for (int level = level_end; level > level_start; level--) {
+    if (vstorage_->NumLevelFiles(level) == 0) {
+      output_level = level;
+      break;
+    }
+  }
+  if (output_level < 0) {
+    return nullptr;
+  }
+  int input_level = output_level - 1;
+  while (vstorage_->NumLevelFiles(input_level) == 0) {
+    if (--input_level < level_start) {
+      return nullptr;
+    }
+  }
+  // The run must not overtake a run being written between the two levels
+  for (int level = input_level; level <= output_level; level++) {
+    if (IsOutputLevelOfRunningCompaction(level)) {
+      return nullptr;
+    }
+  }
+  const std::vector<FileMetaData*>& files = vstorage_->LevelFiles(input_level);
+  if (picker_->AreFilesInCompaction(files)) {
+    return nullptr;
+  }
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = input_level;
+  inputs[0].files = files;
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] Hybrid: moving sorted run of L%d down to L%d\n",
+                   cf_name_.c_str(), input_level, output_level);
+  return NewCompaction(std::move(inputs), output_level, port::kMaxUint64,
+                       score, CompactionReason::kUniversalSortedRunNum);
+}
+
+Compaction* HybridCompactionBuilder::PickLeveledCompaction(int start_level,
+                                                           double score) {
+  const int output_level = start_level + 1;
+  assert(output_level < vstorage_->num_levels());
+
+  const std::vector<int>& file_order =
+      vstorage_->FilesByCompactionPri(start_level);
+  const std::vector<FileMetaData*>& level_files =
+      vstorage_->LevelFiles(start_level);
+
+  unsigned int cmp_idx;
+  for (cmp_idx = vstorage_->NextCompactionIndex(start_level);
+       cmp_idx < file_order.size(); cmp_idx++) {
+    int index = file_order[cmp_idx];
+    FileMetaData* f = level_files[index];
+    if (f->being_compacted) {
+      continue;
+    }
+
+    CompactionInputFiles start_level_inputs;
+    start_level_inputs.level = start_level;
+    start_level_inputs.files.push_back(f);
+    if (!picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                         &start_level_inputs) ||
+        picker_->FilesRangeOverlapWithCompaction({start_level_inputs},
+                                                 output_level)) {
+      continue;
+    }
+
+    CompactionInputFiles output_level_inputs;
+    output_level_inputs.level = output_level;
+    int parent_index = -1;
+    if (!picker_->SetupOtherInputs(cf_name_, mutable_cf_options_, vstorage_,
+                                   &start_level_inputs, &output_level_inputs,
+                                   &parent_index, index)) {
+      continue;
+    }
+
+    std::vector<CompactionInputFiles> inputs;
+    inputs.push_back(std::move(start_level_inputs));
+    if (!output_level_inputs.empty()) {
+      inputs.push_back(std::move(output_level_inputs));
+    }
+    if (picker_->FilesRangeOverlapWithCompaction(inputs, output_level)) {
+      continue;
+    }
+
+    vstorage_->SetNextCompactionIndex(start_level, cmp_idx);
+    return NewCompaction(std::move(inputs), output_level,
+                         mutable_cf_options_.max_compaction_bytes, score,
+                         CompactionReason::kLevelMaxLevelSize);
+  }
+
+  vstorage_->SetNextCompactionIndex(start_level, cmp_idx);
+  return nullptr;
+}
+
+Compaction* HybridCompactionBuilder::NewCompaction(
+    std::vector<CompactionInputFiles>&& inputs, int output_level,
+    uint64_t max_compaction_bytes, double score,
+    CompactionReason compaction_reason) {
+  return new Compaction(
+      vstorage_, ioptions_, mutable_cf_options_, mutable_db_options_,
+      std::move(inputs), output_level,
+      MaxFileSizeForLevel(mutable_cf_options_, output_level,
+                          kCompactionStyleHybrid),
+      max_compaction_bytes, /* output_path_id */ 0,
+      GetCompressionType(ioptions_, vstorage_, mutable_cf_options_,
+                         output_level, vstorage_->base_level()),
+      GetCompressionOptions(mutable_cf_options_, vstorage_, output_level),
+      Temperature::kUnknown,
+      /* max_subcompactions */ 0, /* grandparents */ {}, /* is manual */ false,
+      score, false /* deletion_compaction */, compaction_reason);
+}
+}  // namespace
+
+Compaction* HybridCompactionPicker::PickCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer, SequenceNumber /* earliest_memtable_seqno */) {
+  HybridCompactionBuilder builder(ioptions_, cf_name, mutable_cf_options,
+                                  mutable_db_options, vstorage, this,
+                                  log_buffer);
+  return builder.PickCompaction();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+#endif  // !ROCKSDB_LITE
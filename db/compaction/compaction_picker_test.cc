@@ -9,6 +9,7 @@
 #include <utility>
 #include "db/compaction/compaction.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_hybrid.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 
@@ -1013,6 +1014,37 @@ TEST_F(CompactionPickerTest, FIFOToWarm1) {
   ASSERT_EQ(3U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, FIFOTtlStopsAtUnknownCreationTime) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 100000;
+  const uint64_t kTtl = 2000;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.ttl = kTtl;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  uint64_t expired_time = static_cast<uint64_t>(current_time) - kTtl - 1000;
+  // File 4 has no known creation time, as a table not opened yet, so it and
+  // the newer files are kept even though file 5 is expired
+  Add(0, 5U, "240", "290", kFileSize, 0, 2700, 2800, 0, false,
+      Temperature::kUnknown, expired_time);
+  Add(0, 4U, "260", "300", kFileSize, 0, 2500, 2600);
+  Add(0, 3U, "200", "300", kFileSize, 0, 2300, 2400, 0, false,
+      Temperature::kUnknown, expired_time);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(3U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, FIFOToWarm2) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const uint64_t kFileSize = 100000;
@@ -1215,6 +1247,204 @@ TEST_F(CompactionPickerTest, FIFOToWarmWithHotBetweenWarms) {
   ASSERT_EQ(2U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, NeedsCompactionHybrid) {
+  // L0, one tiered level spanning L1-L4, leveled L5 and L6.
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  ASSERT_EQ(7, ioptions_.compaction_options_hybrid.NumLevels());
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  UpdateVersionStorageInfo();
+  ASSERT_FALSE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  Add(0, 1U, "150", "200");
+  Add(0, 2U, "150", "200");
+  Add(3, 3U, "150", "200");
+  Add(4, 4U, "150", "200");
+  UpdateVersionStorageInfo();
+  ASSERT_FALSE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  // Runs count against the capacity of the tiered level, wherever they are.
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  Add(1, 3U, "150", "200");
+  Add(4, 4U, "150", "200");
+  UpdateVersionStorageInfo();
+  ASSERT_FALSE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  for (int level = 1; level <= 4; level++) {
+    Add(level, static_cast<uint32_t>(level), "150", "200");
+  }
+  UpdateVersionStorageInfo();
+  ASSERT_TRUE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+}
+
+TEST_F(CompactionPickerTest, NeedsCompactionHybridRunsPerTieredLevel) {
+  // L0, tiered levels spanning L1-L2 and L3-L5, leveled L6 and L7.
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  ioptions_.compaction_options_hybrid.num_tiered_levels = 2;
+  ioptions_.compaction_options_hybrid.max_sorted_runs_per_tiered_level = {2,
+                                                                          3};
+  ASSERT_EQ(8, ioptions_.compaction_options_hybrid.NumLevels());
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(8, kCompactionStyleHybrid);
+  Add(3, 1U, "150", "200");
+  Add(4, 2U, "150", "200");
+  UpdateVersionStorageInfo();
+  ASSERT_FALSE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+
+  NewVersionStorage(8, kCompactionStyleHybrid);
+  Add(1, 1U, "150", "200");
+  Add(2, 2U, "150", "200");
+  UpdateVersionStorageInfo();
+  ASSERT_TRUE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(2U, compaction->num_input_levels());
+  // Into the lowest level of the second tiered level
+  ASSERT_EQ(5, compaction->output_level());
+}
+
+TEST_F(CompactionPickerTest, HybridMovesRunsIntoEmptiedLevels) {
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  Add(0, 1U, "150", "200", 1000U, 0, 400, 499);
+  Add(0, 2U, "150", "200", 1000U, 0, 300, 399);
+  Add(0, 3U, "150", "200", 1000U, 0, 200, 299);
+  Add(0, 4U, "150", "200", 1000U, 0, 100, 199);
+  // The tiered level holds two runs, the newer one in its first physical
+  // level, with L2 and L3 emptied below it.
+  Add(1, 5U, "100", "300", 4000U, 0, 20, 29);
+  Add(4, 6U, "100", "300", 4000U, 0, 10, 19);
+  UpdateVersionStorageInfo();
+
+  // L0 cannot be merged yet; the newer run is moved down to make room.
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(1, compaction->start_level());
+  ASSERT_EQ(3, compaction->output_level());
+  ASSERT_EQ(5U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_TRUE(compaction->IsTrivialMove());
+}
+
+TEST_F(CompactionPickerTest, HybridL0ToTieredLevel) {
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  Add(0, 1U, "150", "200", 1000U, 0, 400, 499);
+  Add(0, 2U, "150", "200", 1000U, 0, 300, 399);
+  Add(0, 3U, "150", "200", 1000U, 0, 200, 299);
+  Add(0, 4U, "150", "200", 1000U, 0, 100, 199);
+  // The two oldest runs of the tiered level.
+  Add(4, 5U, "100", "300", 4000U, 0, 10, 19);
+  Add(3, 6U, "100", "300", 4000U, 0, 20, 29);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kLevelL0FilesNum,
+            compaction->compaction_reason());
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(4U, compaction->num_input_files(0));
+  // The new run goes right above the newest run of the tiered level.
+  ASSERT_EQ(2, compaction->output_level());
+}
+
+TEST_F(CompactionPickerTest, HybridTieredLevelToLeveledLevel) {
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  mutable_cf_options_.max_bytes_for_level_base = 1000000;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  Add(0, 1U, "150", "200", 1000U, 0, 400, 499);
+  Add(0, 2U, "150", "200", 1000U, 0, 300, 399);
+  Add(0, 3U, "150", "200", 1000U, 0, 200, 299);
+  Add(0, 4U, "150", "200", 1000U, 0, 100, 199);
+  // The tiered level is full, so L0 cannot be merged into it.
+  Add(1, 5U, "100", "300", 4000U, 0, 80, 89);
+  Add(2, 6U, "100", "300", 4000U, 0, 60, 69);
+  Add(3, 7U, "100", "300", 4000U, 0, 40, 49);
+  Add(4, 8U, "100", "300", 4000U, 0, 20, 29);
+  Add(5, 9U, "000", "099", 10000U, 0, 10, 10);
+  Add(5, 10U, "200", "400", 10000U, 0, 10, 10);
+  Add(5, 11U, "500", "600", 10000U, 0, 10, 10);
+  Add(6, 12U, "000", "900", 1000000U, 0, 1, 1);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kUniversalSortedRunNum,
+            compaction->compaction_reason());
+  ASSERT_EQ(5, compaction->output_level());
+  // All four runs plus the overlapping file of the first leveled level.
+  ASSERT_EQ(5U, compaction->num_input_levels());
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(i + 1, compaction->level(i));
+    ASSERT_EQ(1U, compaction->num_input_files(i));
+  }
+  ASSERT_EQ(1U, compaction->num_input_files(4));
+  ASSERT_EQ(10U, compaction->input(4, 0)->fd.GetNumber());
+
+  // Once the tiered level is being merged, L0 still has nowhere to go.
+  ASSERT_TRUE(hybrid_compaction_picker.PickCompaction(
+                  cf_name_, mutable_cf_options_, mutable_db_options_,
+                  vstorage_.get(), &log_buffer_) == nullptr);
+}
+
+TEST_F(CompactionPickerTest, HybridLeveledLevels) {
+  ioptions_.compaction_style = kCompactionStyleHybrid;
+  ioptions_.compaction_pri = kMinOverlappingRatio;
+  mutable_cf_options_.max_bytes_for_level_base = 1000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+  HybridCompactionPicker hybrid_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(7, kCompactionStyleHybrid);
+  // L5 is larger than a tenth of L6.
+  Add(5, 1U, "100", "200", 2500U);
+  Add(5, 2U, "300", "400", 2500U);
+  Add(6, 3U, "100", "250", 10000U);
+  Add(6, 4U, "251", "500", 30000U);
+  UpdateVersionStorageInfo();
+
+  ASSERT_TRUE(hybrid_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      hybrid_compaction_picker.PickCompaction(cf_name_, mutable_cf_options_,
+                                              mutable_db_options_,
+                                              vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kLevelMaxLevelSize,
+            compaction->compaction_reason());
+  ASSERT_EQ(6, compaction->output_level());
+  ASSERT_EQ(2U, compaction->num_input_levels());
+  // File 1 has the smaller overlapping ratio.
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+  ASSERT_EQ(3U, compaction->input(1, 0)->fd.GetNumber());
+}
+
 #endif  // ROCKSDB_LITE
 
 TEST_F(CompactionPickerTest, CompactionPriMinOverlapping1) {
@@ -1337,6 +1567,59 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping4) {
   ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriReadAmpBenefit1) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kReadAmpBenefitRatio;
+  mutable_cf_options_.max_bytes_for_level_base = 10000000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+
+  Add(2, 6U, "150", "167", 60000000U);  // Overlaps with file 26, 27
+  Add(2, 7U, "168", "169", 60000000U);  // Overlaps with file 27
+  Add(2, 8U, "201", "300", 61000000U);  // Overlaps with file 28
+
+  Add(3, 26U, "160", "165", 260000000U);
+  Add(3, 27U, "166", "170", 260000000U);
+  Add(3, 28U, "180", "400", 260000000U);
+  Add(3, 29U, "401", "500", 260000000U);
+  // File 6 is by far the hottest, which outweighs its larger overlap.
+  file_map_[6U].first->stats.num_reads_sampled = 100000;
+  file_map_[7U].first->stats.num_reads_sampled = 1000;
+  file_map_[8U].first->stats.num_reads_sampled = 1000;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, CompactionPriReadAmpBenefit2) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kReadAmpBenefitRatio;
+  mutable_cf_options_.max_bytes_for_level_base = 10000000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+
+  // Without any sampled reads, files are picked as with kMinOverlappingRatio.
+  Add(2, 6U, "150", "167", 60000000U);  // Overlaps with file 26, 27
+  Add(2, 7U, "168", "169", 60000000U);  // Overlaps with file 27
+  Add(2, 8U, "201", "300", 61000000U);  // Overlaps with file 28
+
+  Add(3, 26U, "160", "165", 260000000U);
+  Add(3, 27U, "166", "170", 260000000U);
+  Add(3, 28U, "180", "400", 260000000U);
+  Add(3, 29U, "401", "500", 260000000U);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(8U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 // This test exhibits the bug where we don't properly reset parent_index in
 // PickCompaction()
 TEST_F(CompactionPickerTest, ParentIndexResetBug) {
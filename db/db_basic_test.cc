@@ -556,6 +556,47 @@ TEST_F(DBBasicTest, ManifestRollOver) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, ManifestRollOverInBackground) {
+  Options options = CurrentOptions();
+  options.max_manifest_file_size = 10;  // 10 bytes
+  options.background_manifest_rollover = true;
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  std::atomic<int> num_sync_rollovers{0};
+  std::atomic<int> num_switches{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::ProcessManifestWrites:BeforeNewManifest",
+      [&](void* /*arg*/) { num_sync_rollovers++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::ProcessManifestWrites:SwitchToNewManifest",
+      [&](void* /*arg*/) { num_switches++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Each flush either starts writing a new manifest file in the background,
+  // or switches to the one written since the previous flush
+  const uint64_t first_manifest = dbfull()->TEST_Current_Manifest_FileNo();
+  int num_keys = 0;
+  for (; num_keys < 1000 && num_switches < 3; num_keys++) {
+    ASSERT_OK(Put(1, Key(num_keys), "v" + ToString(num_keys)));
+    ASSERT_OK(Flush(1));
+    env_->SleepForMicroseconds(1000);
+  }
+  ASSERT_GE(num_switches, 3);
+  ASSERT_EQ(0, num_sync_rollovers);
+  ASSERT_GT(dbfull()->TEST_Current_Manifest_FileNo(), first_manifest);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The edits appended to the previous manifest file while the new one was
+  // written are recovered
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  ASSERT_EQ(num_keys, NumTableFilesAtLevel(0, 1));
+  for (int i = 0; i < num_keys; i++) {
+    ASSERT_EQ("v" + ToString(i), Get(1, Key(i)));
+  }
+}
+
 TEST_F(DBBasicTest, IdentityAcrossRestarts1) {
   do {
     std::string id1;
@@ -612,6 +612,62 @@ TEST_F(DBBlockCacheTest, DynamicallyWarmCacheDuringFlush) {
 }
 #endif
 
+TEST_F(DBBlockCacheTest, PinHotDataBlocks) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.compression = kNoCompression;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  std::shared_ptr<Cache> cache = NewLRUCache(1 << 25, 0, false);
+  table_options.block_cache = cache;
+  table_options.block_size = 512;
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.max_pinned_hot_data_blocks = 2;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  const int kNumKeys = 1000;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    values.push_back(rnd.RandomString(100));
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  // The cache entry stats collector keeps its own entry pinned
+  const size_t base_pinned_usage = cache->GetPinnedUsage();
+
+  // Reading the same block over and over pins it.
+  const int kNumHotReads = 100;
+  for (int i = 0; i < kNumHotReads; i++) {
+    ASSERT_EQ(values[0], Get(Key(0)));
+  }
+  ASSERT_GT(cache->GetPinnedUsage(), base_pinned_usage);
+  // Reads served from the pinned block still count as block cache hits.
+  ASSERT_EQ(1, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(kNumHotReads - 1,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_HIT));
+
+  // Reading other blocks evenly does not pin them, and the hot block gets
+  // unpinned once it is not read anymore.
+  for (int pass = 0; pass < 20; pass++) {
+    for (int i = 100; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  }
+  ASSERT_EQ(base_pinned_usage, cache->GetPinnedUsage());
+  ASSERT_EQ(values[0], Get(Key(0)));
+
+  // Pinned blocks are released when the table reader is closed.
+  for (int i = 0; i < kNumHotReads; i++) {
+    ASSERT_EQ(values[kNumKeys - 1], Get(Key(kNumKeys - 1)));
+  }
+  ASSERT_GT(cache->GetPinnedUsage(), base_pinned_usage);
+  Close();
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+}
+
 namespace {
 
 // A mock cache wraps LRUCache, and record how many entries have been
@@ -268,9 +268,9 @@ Status DBImpl::GetLiveFilesStorageInfo(
       results.emplace_back();
       LiveFileStorageInfo& info = results.back();
 
-      info.relative_filename = BlobFileName(meta->GetBlobFileNumber());
+      info.relative_filename = BlobFileName(meta->GetPhysicalBlobFileNumber());
       info.directory = GetName();  // TODO?: support db_paths/cf_paths
-      info.file_number = meta->GetBlobFileNumber();
+      info.file_number = meta->GetPhysicalBlobFileNumber();
       info.file_type = kBlobFile;
       info.size = meta->GetBlobFileSize();
       if (opts.include_checksum_info) {
@@ -1493,6 +1493,78 @@ TEST_F(DBFlushTest, CFDropRaceWithWaitForFlushMemTables) {
   SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBFlushTest, InstallResultsOfConcurrentFlushes) {
+  Options options = CurrentOptions();
+  options.max_background_flushes = 4;
+  options.disable_auto_compactions = true;
+  // Only flushes write to the MANIFEST, so that a held writer cannot block
+  // flushes that sync closed WALs
+  options.track_and_verify_wals_in_manifest = false;
+  CreateAndReopenWithCF({"one", "two", "three"}, options);
+
+  // New versions are built without holding the DB mutex
+  std::atomic<int> num_builds{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::ProcessManifestWrites:AfterBuildVersions", [&](void*) {
+        dbfull()->TEST_LockMutex();
+        dbfull()->TEST_UnlockMutex();
+        num_builds.fetch_add(1);
+      });
+  // The first writer to the MANIFEST is held until the flushes of the other
+  // three column families are queued behind it, so that the next writer
+  // installs their results together
+  std::atomic<int> num_writers{0};
+  std::atomic<bool> held{false};
+  std::atomic<bool> queued_together{false};
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::LogAndApply:BeforeWriterWaiting",
+      [&](void*) { num_writers.fetch_add(1); });
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::LogAndApply:WriteManifestStart", [&](void*) {
+        if (held.exchange(true)) {
+          return;
+        }
+        for (int i = 0; i < 10000 && num_writers.load() < 4; ++i) {
+          env_->SleepForMicroseconds(1000);
+        }
+        queued_together.store(num_writers.load() >= 4);
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  const int kNumRounds = 5;
+  FlushOptions flush_opts;
+  flush_opts.wait = false;
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (int cf = 0; cf < 4; ++cf) {
+      ASSERT_OK(Put(cf, Key(round), "v" + ToString(cf)));
+    }
+    ASSERT_OK(db_->Flush(flush_opts, handles_));
+  }
+  for (int cf = 0; cf < 4; ++cf) {
+    ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable(handles_[cf]));
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Results of flushes queued together are installed by a single writer, so
+  // there are fewer version builds than flushes
+  ASSERT_TRUE(queued_together.load());
+  ASSERT_GT(num_builds.load(), 0);
+  ASSERT_LT(num_builds.load(), 4 * kNumRounds);
+  for (int cf = 0; cf < 4; ++cf) {
+    ASSERT_EQ(kNumRounds, NumTableFilesAtLevel(0, cf));
+    for (int round = 0; round < kNumRounds; ++round) {
+      ASSERT_EQ("v" + ToString(cf), Get(cf, Key(round)));
+    }
+  }
+
+  ReopenWithColumnFamilies({"default", "one", "two", "three"}, options);
+  for (int cf = 0; cf < 4; ++cf) {
+    ASSERT_EQ(kNumRounds, NumTableFilesAtLevel(0, cf));
+    ASSERT_EQ("v" + ToString(cf), Get(cf, Key(kNumRounds - 1)));
+  }
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(DBFlushTest, FireOnFlushCompletedAfterCommittedResult) {
   class TestListener : public EventListener {
@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "db/arena_wrapped_db_iter.h"
+#include "db/blob/blob_garbage_collection_job.h"
 #include "db/builder.h"
 #include "db/compaction/compaction_job.h"
 #include "db/db_info_dumper.h"
@@ -189,6 +190,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       nonmem_write_thread_(immutable_db_options_),
       write_controller_(mutable_db_options_.delayed_write_rate),
       last_batch_group_size_(0),
+      superversion_reclaim_scheduled_(false),
       unscheduled_flushes_(0),
       unscheduled_compactions_(0),
       bg_bottom_compaction_scheduled_(0),
@@ -197,6 +199,9 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       bg_flush_scheduled_(0),
       num_running_flushes_(0),
       bg_purge_scheduled_(0),
+      bg_table_warmup_scheduled_(0),
+      bg_blob_gc_scheduled_(0),
+      num_tables_pending_warmup_(0),
       disable_delete_obsolete_files_(0),
       pending_purge_obsolete_files_(0),
       delete_obsolete_files_last_run_(immutable_db_options_.clock->NowMicros()),
@@ -251,11 +256,20 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   const int table_cache_size = (mutable_db_options_.max_open_files == -1)
                                    ? TableCache::kInfiniteCapacity
                                    : mutable_db_options_.max_open_files - 10;
-  LRUCacheOptions co;
-  co.capacity = table_cache_size;
-  co.num_shard_bits = immutable_db_options_.table_cache_numshardbits;
-  co.metadata_charge_policy = kDontChargeCacheMetadata;
-  table_cache_ = NewLRUCache(co);
+  if (immutable_db_options_.table_cache_use_clock_cache &&
+      mutable_db_options_.max_open_files != -1) {
+    // nullptr if the clock cache is not supported
+    table_cache_ = NewClockCache(
+        table_cache_size, immutable_db_options_.table_cache_numshardbits,
+        false /* strict_capacity_limit */, kDontChargeCacheMetadata);
+  }
+  if (table_cache_ == nullptr) {
+    LRUCacheOptions co;
+    co.capacity = table_cache_size;
+    co.num_shard_bits = immutable_db_options_.table_cache_numshardbits;
+    co.metadata_charge_policy = kDontChargeCacheMetadata;
+    table_cache_ = NewLRUCache(co);
+  }
   SetDbSessionId();
   assert(!db_session_id_.empty());
 
@@ -449,6 +463,7 @@ Status DBImpl::ResumeImpl(DBRecoverContext context) {
       SchedulePendingCompaction(cfd);
     }
     MaybeScheduleFlushOrCompaction();
+    MaybeScheduleBlobGarbageCollection();
   }
 
   // Wake up any waiters - in this case, it could be the shutdown thread
@@ -542,6 +557,7 @@ Status DBImpl::CloseHelper() {
   // Wait for background work to finish
   while (bg_bottom_compaction_scheduled_ || bg_compaction_scheduled_ ||
          bg_flush_scheduled_ || bg_purge_scheduled_ ||
+         bg_table_warmup_scheduled_ || bg_blob_gc_scheduled_ ||
          pending_purge_obsolete_files_ ||
          error_handler_.IsRecoveryInProgress()) {
     TEST_SYNC_POINT("DBImpl::~DBImpl:WaitJob");
@@ -597,6 +613,14 @@ Status DBImpl::CloseHelper() {
     cfd->UnrefAndTryDelete();
   }
 
+  if (!superversion_reclaim_queue_.empty()) {
+    SuperVersionContext sv_context;
+    ReclaimRetiredSuperVersions(&sv_context);
+    mutex_.Unlock();
+    sv_context.Clean();
+    mutex_.Lock();
+  }
+
   if (default_cf_handle_ != nullptr || persist_stats_cf_handle_ != nullptr) {
     // we need to delete handle outside of lock because it does its own locking
     mutex_.Unlock();
@@ -673,6 +697,12 @@ Status DBImpl::CloseHelper() {
     delete txn_entry.second;
   }
 
+  // The manifest file being rolled over to in the background is not waited
+  // for with the mutex held
+  mutex_.Unlock();
+  versions_->WaitForManifestCheckpoint();
+  mutex_.Lock();
+
   // versions need to be destroyed before table_cache since it can hold
   // references to table_cache.
   versions_.reset();
@@ -1096,6 +1126,8 @@ Status DBImpl::SetOptions(
       // options to file, otherwise there will be a deadlock with writer
       // thread.
       InstallSuperVersionAndScheduleWork(cfd, &sv_context, new_options);
+      // A lower threshold may make blob files worth garbage collecting
+      MaybeScheduleBlobGarbageCollection();
 
       persist_options_status = WriteOptionsFile(
           false /*need_mutex_lock*/, true /*need_enter_write_thread*/);
@@ -1632,14 +1664,28 @@ void DBImpl::SchedulePurge() {
   mutex_.AssertHeld();
   assert(opened_successfully_);
 
-  // Purge operations are put into High priority queue
+  // Purge operations are put into High priority queue, or into the Low
+  // priority one when the former has no thread, like flushes
+  bool is_flush_pool_empty =
+      env_->GetBackgroundThreads(Env::Priority::HIGH) == 0;
   bg_purge_scheduled_++;
-  env_->Schedule(&DBImpl::BGWorkPurge, this, Env::Priority::HIGH, nullptr);
+  env_->Schedule(&DBImpl::BGWorkPurge, this,
+                 is_flush_pool_empty ? Env::Priority::LOW : Env::Priority::HIGH,
+                 nullptr);
 }
 
 void DBImpl::BackgroundCallPurge() {
   mutex_.Lock();
 
+  if (superversion_reclaim_scheduled_) {
+    superversion_reclaim_scheduled_ = false;
+    SuperVersionContext sv_context;
+    ReclaimRetiredSuperVersions(&sv_context);
+    mutex_.Unlock();
+    sv_context.Clean();
+    mutex_.Lock();
+  }
+
   while (!logs_to_free_queue_.empty()) {
     assert(!logs_to_free_queue_.empty());
     log::Writer* log_writer = *(logs_to_free_queue_.begin());
@@ -1687,6 +1733,272 @@ void DBImpl::BackgroundCallPurge() {
   mutex_.Unlock();
 }
 
+void DBImpl::MaybeScheduleTableWarmup() {
+  mutex_.AssertHeld();
+  if (!immutable_db_options_.open_tables_lazily ||
+      mutable_db_options_.max_open_files != -1) {
+    return;
+  }
+  uint64_t num_files = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (!cfd->IsDropped() && cfd->initialized()) {
+      const auto* vstorage = cfd->current()->storage_info();
+      for (int level = 0; level < vstorage->num_levels(); level++) {
+        num_files += vstorage->NumLevelFiles(level);
+      }
+    }
+  }
+  num_tables_pending_warmup_.store(num_files, std::memory_order_relaxed);
+  bg_table_warmup_scheduled_++;
+  env_->Schedule(&DBImpl::BGWorkTableWarmup, this, Env::Priority::LOW,
+                 nullptr);
+}
+
+void DBImpl::BackgroundCallTableWarmup() {
+  struct WarmupColumnFamily {
+    ColumnFamilyData* cfd;
+    Version* version;
+    std::shared_ptr<const SliceTransform> prefix_extractor;
+    size_t max_file_size_for_l0_meta_pin;
+  };
+  struct WarmupFile {
+    const WarmupColumnFamily* cf;
+    const FileMetaData* meta;
+    int level;
+  };
+  std::vector<WarmupColumnFamily> cfs;
+  std::vector<WarmupFile> files;
+
+  mutex_.Lock();
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    cfd->Ref();
+    Version* version = cfd->current();
+    version->Ref();
+    const MutableCFOptions* cf_options = cfd->GetLatestMutableCFOptions();
+    cfs.push_back({cfd, version, cf_options->prefix_extractor,
+                   MaxFileSizeForL0MetaPin(*cf_options)});
+  }
+  for (const auto& cf : cfs) {
+    const auto* vstorage = cf.version->storage_info();
+    for (int level = 0; level < vstorage->num_non_empty_levels(); level++) {
+      for (const FileMetaData* meta : vstorage->LevelFiles(level)) {
+        files.push_back({&cf, meta, level});
+      }
+    }
+  }
+  num_tables_pending_warmup_.store(files.size(), std::memory_order_relaxed);
+  mutex_.Unlock();
+
+  // The upper levels are read by most lookups, so they go first. Nothing
+  // tells which files of a level will be read the most, as the sampled read
+  // counts are not persisted and start from 0 at DB::Open()
+  std::stable_sort(files.begin(), files.end(),
+                   [](const WarmupFile& a, const WarmupFile& b) {
+                     return a.level < b.level;
+                   });
+
+  for (const auto& file : files) {
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      break;
+    }
+    ColumnFamilyData* cfd = file.cf->cfd;
+    TableCache* table_cache = cfd->table_cache();
+    Cache::Handle* handle = nullptr;
+    Status s = table_cache->FindTable(
+        ReadOptions(), file_options_, cfd->internal_comparator(),
+        file.meta->fd, &handle, file.cf->prefix_extractor.get(),
+        false /* no_io */, true /* record_read_stats */,
+        cfd->internal_stats()->GetFileReadHist(file.level),
+        false /* skip_filters */, file.level,
+        true /* prefetch_index_and_filter_in_cache */,
+        file.cf->max_file_size_for_l0_meta_pin, file.meta->temperature);
+    if (s.ok()) {
+      if (!table_cache->MaybePinTableHandle(*file.meta, handle)) {
+        table_cache->ReleaseHandle(handle);
+      }
+    } else {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "[%s] Failed to warm up table #%" PRIu64 ": %s",
+                     cfd->GetName().c_str(), file.meta->fd.GetNumber(),
+                     s.ToString().c_str());
+    }
+    num_tables_pending_warmup_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  TEST_SYNC_POINT("DBImpl::BackgroundCallTableWarmup:Done");
+
+  mutex_.Lock();
+  num_tables_pending_warmup_.store(0, std::memory_order_relaxed);
+  for (const auto& cf : cfs) {
+    cf.version->Unref();
+    cf.cfd->UnrefAndTryDelete();
+  }
+  bg_table_warmup_scheduled_--;
+
+  bg_cv_.SignalAll();
+  // IMPORTANT: there should be no code after calling SignalAll, see
+  // BackgroundCallPurge().
+  mutex_.Unlock();
+}
+
+void DBImpl::MaybeScheduleBlobGarbageCollection() {
+  mutex_.AssertHeld();
+  if (!opened_successfully_ || bg_work_paused_ > 0 ||
+      bg_blob_gc_scheduled_ > 0 ||
+      shutting_down_.load(std::memory_order_acquire) ||
+      (error_handler_.IsBGWorkStopped() &&
+       !error_handler_.IsRecoveryInProgress())) {
+    return;
+  }
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    if (BlobGarbageCollectionJob::NeedsGarbageCollection(
+            cfd->current()->storage_info(),
+            cfd->GetLatestMutableCFOptions()
+                ->blob_garbage_collection_job_threshold,
+            blob_files_failed_gc_)) {
+      bg_blob_gc_scheduled_++;
+      env_->Schedule(&DBImpl::BGWorkBlobGarbageCollection, this,
+                     Env::Priority::LOW, nullptr);
+      return;
+    }
+  }
+}
+
+void DBImpl::BackgroundCallBlobGarbageCollection() {
+  bool made_progress = false;
+  // The files written by a job whose edit is not applied, and the files a
+  // relocation to a blob file dropped meanwhile orphaned, are only found by a
+  // full scan
+  bool force_full_scan = false;
+
+  mutex_.Lock();
+  JobContext job_context(next_job_id_.fetch_add(1));
+  std::unique_ptr<std::list<uint64_t>::iterator>
+      pending_outputs_inserted_elem(new std::list<uint64_t>::iterator(
+          CaptureCurrentFileNumberInPendingOutputs()));
+
+  autovector<ColumnFamilyData*> cfds;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    cfd->Ref();
+    cfds.push_back(cfd);
+  }
+
+  for (auto cfd : cfds) {
+    if (shutting_down_.load(std::memory_order_acquire) ||
+        error_handler_.IsBGWorkStopped()) {
+      break;
+    }
+    if (cfd->IsDropped()) {
+      continue;
+    }
+
+    BlobGarbageCollectionJob job(job_context.job_id, cfd, file_options_,
+                                 &mutex_, &shutting_down_, &blob_callback_,
+                                 io_tracer_);
+    if (!job.Prepare(blob_files_failed_gc_)) {
+      continue;
+    }
+
+    mutex_.Unlock();
+    Status s = job.Run([this]() { return versions_->NewFileNumber(); });
+    VersionEdit* const edit = job.GetEdit();
+    if (s.ok() && !edit->GetBlobFileRelocations().empty()) {
+      FSDirectory* const data_dir = GetDataDir(cfd, 0);
+      if (data_dir) {
+        s = data_dir->Fsync(IOOptions(), nullptr);
+      }
+    }
+    mutex_.Lock();
+
+    for (uint64_t blob_file_number : job.GetFailedBlobFiles()) {
+      blob_files_failed_gc_.insert(blob_file_number);
+    }
+    if (job.HasFailedRelocations()) {
+      force_full_scan = true;
+    }
+
+    if (s.ok() && !edit->GetBlobFileRelocations().empty() &&
+        !cfd->IsDropped()) {
+      s = versions_->LogAndApply(cfd, job.GetMutableCFOptions(), edit, &mutex_,
+                                 directories_.GetDbDir());
+      if (s.ok()) {
+        job_context.superversion_contexts.emplace_back(
+            SuperVersionContext(true));
+        InstallSuperVersionAndScheduleWork(
+            cfd, &job_context.superversion_contexts.back(),
+            *cfd->GetLatestMutableCFOptions());
+
+        // A relocation is skipped if its blob file became obsolete while the
+        // job ran
+        const auto* vstorage = cfd->current()->storage_info();
+        for (const auto& relocation : edit->GetBlobFileRelocations()) {
+          const auto& relocated_file = relocation.GetRelocatedFile();
+          const auto it = vstorage->GetBlobFiles().find(
+              relocated_file.GetBlobFileNumber());
+          if (it == vstorage->GetBlobFiles().end() ||
+              it->second->GetPhysicalBlobFileNumber() !=
+                  relocated_file.GetPhysicalBlobFileNumber()) {
+            force_full_scan = true;
+          }
+        }
+        made_progress = true;
+      } else if (versions_->io_status().IsIOError()) {
+        error_handler_.SetBGError(versions_->io_status(),
+                                  BackgroundErrorReason::kManifestWrite);
+      }
+    }
+
+    if (!s.ok() && !s.IsShutdownInProgress()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "[%s] [JOB %d] Blob garbage collection failed: %s",
+                     cfd->GetName().c_str(), job_context.job_id,
+                     s.ToString().c_str());
+    }
+    if (!s.ok() || cfd->IsDropped()) {
+      force_full_scan = true;
+    }
+  }
+
+  ReleaseFileNumberFromPendingOutputs(pending_outputs_inserted_elem);
+  ReclaimRetiredSuperVersions(&job_context);
+  FindObsoleteFiles(&job_context, force_full_scan);
+  if (job_context.HaveSomethingToClean() ||
+      job_context.HaveSomethingToDelete()) {
+    mutex_.Unlock();
+    if (job_context.HaveSomethingToDelete()) {
+      PurgeObsoleteFiles(job_context);
+    }
+    job_context.Clean();
+    mutex_.Lock();
+  }
+
+  for (auto cfd : cfds) {
+    cfd->UnrefAndTryDelete();
+  }
+  bg_blob_gc_scheduled_--;
+  MaybeScheduleSuperVersionReclaim();
+  TEST_SYNC_POINT("DBImpl::BackgroundCallBlobGarbageCollection:Done");
+
+  // The files that became garbage meanwhile, or were skipped, may be picked
+  // now
+  if (made_progress) {
+    MaybeScheduleBlobGarbageCollection();
+  }
+
+  bg_cv_.SignalAll();
+  // IMPORTANT: there should be no code after calling SignalAll, see
+  // BackgroundCallPurge().
+  mutex_.Unlock();
+}
+
 namespace {
 struct IterState {
   IterState(DBImpl* _db, InstrumentedMutex* _mu, SuperVersion* _super_version,
@@ -4124,6 +4436,7 @@ Status DBImpl::DeleteFile(std::string name) {
                                          &job_context.superversion_contexts[0],
                                          *cfd->GetLatestMutableCFOptions());
     }
+    ReclaimRetiredSuperVersions(&job_context);
     FindObsoleteFiles(&job_context, false);
   }  // lock released here
 
@@ -4215,6 +4528,7 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
       deleted_file->being_compacted = false;
     }
     input_version->Unref();
+    ReclaimRetiredSuperVersions(&job_context);
     FindObsoleteFiles(&job_context, false);
   }  // lock released here
 
@@ -5429,9 +5743,9 @@ Status DBImpl::VerifyChecksumInternal(const ReadOptions& read_options,
     if (s.ok() && use_file_checksum) {
       const auto& blob_files = vstorage->GetBlobFiles();
       for (const auto& pair : blob_files) {
-        const uint64_t blob_file_number = pair.first;
         const auto& meta = pair.second;
         assert(meta);
+        const uint64_t blob_file_number = meta->GetPhysicalBlobFileNumber();
         const std::string blob_file_name = BlobFileName(
             cfd->ioptions()->cf_paths.front().path, blob_file_number);
         s = VerifyFullFileChecksum(meta->GetChecksumValue(),
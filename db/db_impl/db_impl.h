@@ -803,6 +803,11 @@ class DBImpl : public DB {
     return num_running_compactions_;
   }
 
+  // Returns the number of tables the table warmup job has yet to open.
+  uint64_t num_tables_pending_warmup() const {
+    return num_tables_pending_warmup_.load(std::memory_order_relaxed);
+  }
+
   const WriteController& write_controller() { return write_controller_; }
 
   // @param read_options Must outlive the returned iterator.
@@ -1856,12 +1861,25 @@ class DBImpl : public DB {
   static void BGWorkBottomCompaction(void* arg);
   static void BGWorkFlush(void* arg);
   static void BGWorkPurge(void* arg);
+  static void BGWorkTableWarmup(void* arg);
+  static void BGWorkBlobGarbageCollection(void* arg);
   static void UnscheduleCompactionCallback(void* arg);
   static void UnscheduleFlushCallback(void* arg);
   void BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
                                 Env::Priority thread_pri);
   void BackgroundCallFlush(Env::Priority thread_pri);
   void BackgroundCallPurge();
+  // Opens the tables of the current versions that are not open yet, when
+  // DBOptions::open_tables_lazily is set
+  void MaybeScheduleTableWarmup();
+  void BackgroundCallTableWarmup();
+  // Schedules the blob garbage collection job if a column family has blob
+  // files to garbage collect (see blob_garbage_collection_job_threshold).
+  // It checks all blob files, so it is only called when their garbage or the
+  // threshold may have changed: after compactions that add blob garbage, on
+  // SetOptions() and when background work resumes.
+  void MaybeScheduleBlobGarbageCollection();
+  void BackgroundCallBlobGarbageCollection();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
                               LogBuffer* log_buffer,
                               PrepickedCompaction* prepicked_compaction,
@@ -1934,6 +1952,21 @@ class DBImpl : public DB {
       ColumnFamilyData* cfd, SuperVersionContext* sv_context,
       const MutableCFOptions& mutable_cf_options);
 
+  // Queues cfd for ReclaimRetiredSuperVersions(), unless it is already
+  // queued. REQUIRES: mutex locked
+  void EnqueueSuperVersionReclaim(ColumnFamilyData* cfd);
+
+  // Schedules a purge to run ReclaimRetiredSuperVersions() if cfds are
+  // queued for it and no background job will. REQUIRES: mutex locked
+  void MaybeScheduleSuperVersionReclaim();
+
+  // Reclaims the retired SuperVersions of the column families in
+  // superversion_reclaim_queue_. Thread-local storage is scraped with the
+  // mutex released. The SuperVersions to delete are added to the last
+  // superversion context of job_context. REQUIRES: mutex locked
+  void ReclaimRetiredSuperVersions(JobContext* job_context);
+  void ReclaimRetiredSuperVersions(SuperVersionContext* sv_context);
+
   bool GetIntPropertyInternal(ColumnFamilyData* cfd,
                               const DBPropertyInfo& property_info,
                               bool is_locked, uint64_t* value);
@@ -2214,6 +2247,12 @@ class DBImpl : public DB {
   // invariant(column family present in compaction_queue_ <==>
   // ColumnFamilyData::pending_compaction_ == true)
   std::deque<ColumnFamilyData*> compaction_queue_;
+  // Column families with retired SuperVersions to reclaim, each referenced.
+  // invariant(column family present in superversion_reclaim_queue_ <==>
+  // ColumnFamilyData::queued_for_superversion_reclaim() == true)
+  std::deque<ColumnFamilyData*> superversion_reclaim_queue_;
+  // True if a purge is scheduled to drain superversion_reclaim_queue_
+  bool superversion_reclaim_scheduled_;
 
   // A map to store file numbers and filenames of the files to be purged
   std::unordered_map<uint64_t, PurgeFileInfo> purge_files_;
@@ -2247,6 +2286,21 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_;
 
+  // number of background table warmup jobs, submitted to the LOW pool
+  int bg_table_warmup_scheduled_;
+
+  // number of background blob garbage collection jobs, submitted to the LOW
+  // pool
+  int bg_blob_gc_scheduled_;
+
+  // blob files whose live blobs did not match their garbage, which the blob
+  // garbage collection job does not pick again. Blob files it failed to
+  // relocate for other reasons are picked again by the next job.
+  std::unordered_set<uint64_t> blob_files_failed_gc_;
+
+  // number of tables the table warmup job has yet to open
+  std::atomic<uint64_t> num_tables_pending_warmup_;
+
   std::deque<ManualCompactionState*> manual_compaction_dequeue_;
 
   // shall we disable deletion of obsolete files
@@ -1181,6 +1181,7 @@ Status DBImpl::CompactFiles(const CompactionOptions& compact_options,
     // to delete all obsolete files we might have created and we force
     // FindObsoleteFiles(). This is because job_context does not
     // catch all created files if compaction failed.
+    ReclaimRetiredSuperVersions(&job_context);
     FindObsoleteFiles(&job_context, !s.ok());
   }  // release the mutex
 
@@ -1337,6 +1338,9 @@ Status DBImpl::CompactFilesImpl(
     InstallSuperVersionAndScheduleWork(c->column_family_data(),
                                        &job_context->superversion_contexts[0],
                                        *c->mutable_cf_options());
+    if (!c->edit()->GetBlobFileGarbages().empty()) {
+      MaybeScheduleBlobGarbageCollection();
+    }
   }
   // status above captures any error during compaction_job.Install, so its ok
   // not check compaction_job.io_status() explicitly if we're not calling
@@ -1413,7 +1417,7 @@ Status DBImpl::PauseBackgroundWork() {
   InstrumentedMutexLock guard_lock(&mutex_);
   bg_compaction_paused_++;
   while (bg_bottom_compaction_scheduled_ > 0 || bg_compaction_scheduled_ > 0 ||
-         bg_flush_scheduled_ > 0) {
+         bg_flush_scheduled_ > 0 || bg_blob_gc_scheduled_ > 0) {
     bg_cv_.Wait();
   }
   bg_work_paused_++;
@@ -1433,6 +1437,7 @@ Status DBImpl::ContinueBackgroundWork() {
   // bg_work_paused_ is always no greater than bg_compaction_paused_
   if (bg_work_paused_ == 0) {
     MaybeScheduleFlushOrCompaction();
+    MaybeScheduleBlobGarbageCollection();
   }
   return Status::OK();
 }
@@ -2560,6 +2565,20 @@ void DBImpl::BGWorkPurge(void* db) {
   TEST_SYNC_POINT("DBImpl::BGWorkPurge:end");
 }
 
+void DBImpl::BGWorkTableWarmup(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  TEST_SYNC_POINT("DBImpl::BGWorkTableWarmup:start");
+  reinterpret_cast<DBImpl*>(db)->BackgroundCallTableWarmup();
+  TEST_SYNC_POINT("DBImpl::BGWorkTableWarmup:end");
+}
+
+void DBImpl::BGWorkBlobGarbageCollection(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  TEST_SYNC_POINT("DBImpl::BGWorkBlobGarbageCollection:start");
+  reinterpret_cast<DBImpl*>(db)->BackgroundCallBlobGarbageCollection();
+  TEST_SYNC_POINT("DBImpl::BGWorkBlobGarbageCollection:end");
+}
+
 void DBImpl::UnscheduleCompactionCallback(void* arg) {
   CompactionArg* ca_ptr = reinterpret_cast<CompactionArg*>(arg);
   Env::Priority compaction_pri = ca_ptr->compaction_pri_;
@@ -2724,6 +2743,8 @@ void DBImpl::BackgroundCallFlush(Env::Priority thread_pri) {
     TEST_SYNC_POINT("DBImpl::BackgroundCallFlush:FlushFinish:0");
     ReleaseFileNumberFromPendingOutputs(pending_outputs_inserted_elem);
 
+    // Let go of the memtables and versions the flush made obsolete
+    ReclaimRetiredSuperVersions(&job_context);
     // If flush failed, we want to delete all temporary files that we might have
     // created. Thus, we force full scan in FindObsoleteFiles()
     FindObsoleteFiles(&job_context, !s.ok() && !s.IsShutdownInProgress() &&
@@ -2750,6 +2771,7 @@ void DBImpl::BackgroundCallFlush(Env::Priority thread_pri) {
     assert(num_running_flushes_ > 0);
     num_running_flushes_--;
     bg_flush_scheduled_--;
+    MaybeScheduleSuperVersionReclaim();
     // See if there's more work to be done
     MaybeScheduleFlushOrCompaction();
     atomic_flush_install_cv_.SignalAll();
@@ -2820,6 +2842,8 @@ void DBImpl::BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
 
     ReleaseFileNumberFromPendingOutputs(pending_outputs_inserted_elem);
 
+    // Let go of the versions the compaction made obsolete
+    ReclaimRetiredSuperVersions(&job_context);
     // If compaction failed, we want to delete all temporary files that we might
     // have created (they might not be all recorded in job_context in case of a
     // failure). Thus, we force full scan in FindObsoleteFiles()
@@ -2855,6 +2879,7 @@ void DBImpl::BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
       assert(bg_thread_pri == Env::Priority::BOTTOM);
       bg_bottom_compaction_scheduled_--;
     }
+    MaybeScheduleSuperVersionReclaim();
 
     versions_->GetColumnFamilySet()->FreeDeadColumnFamilies();
 
@@ -3268,6 +3293,11 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
       InstallSuperVersionAndScheduleWork(c->column_family_data(),
                                          &job_context->superversion_contexts[0],
                                          *c->mutable_cf_options());
+      // Only compactions add blob garbage, so only they can make blob files
+      // worth garbage collecting
+      if (!c->edit()->GetBlobFileGarbages().empty()) {
+        MaybeScheduleBlobGarbageCollection();
+      }
     }
     *made_progress = true;
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
@@ -3572,7 +3602,9 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
   if (UNLIKELY(sv_context->new_superversion == nullptr)) {
     sv_context->NewSuperVersion();
   }
-  cfd->InstallSuperVersion(sv_context, mutable_cf_options);
+  if (cfd->InstallSuperVersion(sv_context, mutable_cf_options)) {
+    EnqueueSuperVersionReclaim(cfd);
+  }
 
   // There may be a small data race here. The snapshot tricking bottommost
   // compaction may already be released here. But assuming there will always be
@@ -3596,6 +3628,73 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
                                    mutable_cf_options.max_write_buffer_number;
 }
 
+void DBImpl::EnqueueSuperVersionReclaim(ColumnFamilyData* cfd) {
+  mutex_.AssertHeld();
+  if (cfd->queued_for_superversion_reclaim()) {
+    return;
+  }
+  cfd->Ref();
+  cfd->set_queued_for_superversion_reclaim(true);
+  superversion_reclaim_queue_.push_back(cfd);
+  MaybeScheduleSuperVersionReclaim();
+}
+
+void DBImpl::MaybeScheduleSuperVersionReclaim() {
+  mutex_.AssertHeld();
+  // Flush, compaction and blob garbage collection jobs reclaim before they
+  // look for obsolete files, so a purge is only needed when none is pending.
+  // Each of them checks again when it is done.
+  if (superversion_reclaim_queue_.empty() || superversion_reclaim_scheduled_ ||
+      !opened_successfully_ || bg_flush_scheduled_ > 0 ||
+      bg_compaction_scheduled_ > 0 || bg_bottom_compaction_scheduled_ > 0 ||
+      bg_blob_gc_scheduled_ > 0) {
+    return;
+  }
+  superversion_reclaim_scheduled_ = true;
+  SchedulePurge();
+}
+
+void DBImpl::ReclaimRetiredSuperVersions(JobContext* job_context) {
+  mutex_.AssertHeld();
+  if (superversion_reclaim_queue_.empty()) {
+    return;
+  }
+  // Appending to a non-empty superversion_contexts would move the pending
+  // write stall notifications
+  if (job_context->superversion_contexts.empty()) {
+    job_context->superversion_contexts.emplace_back();
+  }
+  ReclaimRetiredSuperVersions(&job_context->superversion_contexts.back());
+}
+
+void DBImpl::ReclaimRetiredSuperVersions(SuperVersionContext* sv_context) {
+  mutex_.AssertHeld();
+  if (superversion_reclaim_queue_.empty()) {
+    return;
+  }
+  autovector<ColumnFamilyData*> cfds;
+  autovector<SuperVersion*> retired;
+  while (!superversion_reclaim_queue_.empty()) {
+    ColumnFamilyData* cfd = superversion_reclaim_queue_.front();
+    superversion_reclaim_queue_.pop_front();
+    cfd->set_queued_for_superversion_reclaim(false);
+    cfd->TakeRetiredSuperVersions(&retired);
+    cfds.push_back(cfd);
+  }
+  // The taken SuperVersions are still referenced, so thread-local storage
+  // cannot hold their last reference while it is scraped
+  mutex_.Unlock();
+  TEST_SYNC_POINT("DBImpl::ReclaimRetiredSuperVersions:Unlocked");
+  for (auto cfd : cfds) {
+    cfd->ResetThreadLocalSuperVersions();
+  }
+  mutex_.Lock();
+  ColumnFamilyData::ReleaseSuperVersions(retired, sv_context);
+  for (auto cfd : cfds) {
+    cfd->UnrefAndTryDelete();
+  }
+}
+
 // ShouldPurge is called by FindObsoleteFiles when doing a full scan,
 // and db mutex (mutex_) should already be held.
 // Actually, the current implementation of FindObsoleteFiles with
@@ -176,7 +176,7 @@ Status DBImpl::TEST_WaitForCompact(bool wait_unscheduled) {
 
   InstrumentedMutexLock l(&mutex_);
   while ((bg_bottom_compaction_scheduled_ || bg_compaction_scheduled_ ||
-          bg_flush_scheduled_ ||
+          bg_flush_scheduled_ || bg_blob_gc_scheduled_ ||
           (wait_unscheduled && unscheduled_compactions_)) &&
          (error_handler_.GetBGError().ok())) {
     bg_cv_.Wait();
@@ -6,6 +6,7 @@
 // Copyright (c) 2011 The LevelDB Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
+#include <algorithm>
 #include <cinttypes>
 #include <set>
 #include <unordered_set>
@@ -25,9 +26,18 @@ namespace ROCKSDB_NAMESPACE {
 uint64_t DBImpl::MinLogNumberToKeep() {
   if (allow_2pc()) {
     return versions_->min_log_number_to_keep_2pc();
-  } else {
-    return versions_->MinLogNumberWithUnflushedData();
   }
+  uint64_t min_log_number = versions_->MinLogNumberWithUnflushedData();
+  if (immutable_db_options_.track_and_verify_wals_in_manifest) {
+    // Flushes of different column families installed by the same MANIFEST
+    // write each compute the WALs to delete before the others are applied,
+    // so the MANIFEST can still track WALs that hold no unflushed data. They
+    // are kept until a later edit deletes them, or recovery would find them
+    // missing.
+    min_log_number = std::min(min_log_number,
+                              versions_->GetWalSet().GetMinWalNumberToKeep());
+  }
+  return min_log_number;
 }
 
 uint64_t DBImpl::MinObsoleteSstNumberToKeep() {
@@ -402,6 +412,7 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
     if (file.metadata->table_reader_handle) {
       table_cache_->Release(file.metadata->table_reader_handle);
     }
+    TableCache::ReleasePinnedTableHandle(table_cache_.get(), file.metadata);
     file.DeleteMetadata();
   }
 
@@ -7,6 +7,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cinttypes>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
@@ -216,6 +219,128 @@ Status ValidateOptionsByTable(
   }
   return Status::OK();
 }
+
+// Checks whether a WAL record can be replayed concurrently with the records
+// around it: it must be well formed, and only contain plain writes, which
+// carry their own sequence numbers. Merges are replayed in order, as their
+// result may depend on the entries already in the memtable.
+class ParallelReplayChecker : public WriteBatch::Handler {
+ public:
+  Status PutCF(uint32_t, const Slice&, const Slice&) override {
+    return Status::OK();
+  }
+  Status DeleteCF(uint32_t, const Slice&) override { return Status::OK(); }
+  Status SingleDeleteCF(uint32_t, const Slice&) override {
+    return Status::OK();
+  }
+  Status DeleteRangeCF(uint32_t, const Slice&, const Slice&) override {
+    return Status::OK();
+  }
+  Status PutBlobIndexCF(uint32_t, const Slice&, const Slice&) override {
+    return Status::OK();
+  }
+  Status MergeCF(uint32_t, const Slice&, const Slice&) override {
+    return Reject();
+  }
+  Status MarkBeginPrepare(bool) override { return Reject(); }
+  Status MarkEndPrepare(const Slice&) override { return Reject(); }
+  Status MarkNoop(bool) override {
+    // Iterate() requires a Noop to succeed
+    eligible_ = false;
+    return Status::OK();
+  }
+  Status MarkRollback(const Slice&) override { return Reject(); }
+  Status MarkCommit(const Slice&) override { return Reject(); }
+
+  static bool CanReplayInParallel(const WriteBatch& batch) {
+    ParallelReplayChecker checker;
+    Status s = batch.Iterate(&checker);
+    return s.ok() && checker.eligible_;
+  }
+
+ private:
+  Status Reject() {
+    eligible_ = false;
+    return Status::NotSupported();
+  }
+
+  bool eligible_ = true;
+};
+
+// Threads that help the thread opening the DB replay the WAL, for the
+// duration of the recovery
+class ParallelReplayWorkers {
+ public:
+  explicit ParallelReplayWorkers(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; i++) {
+      threads_.emplace_back([this]() { Work(); });
+    }
+  }
+
+  ~ParallelReplayWorkers() {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  // Runs func on every worker and on the calling thread, and waits for all
+  // of them to return
+  void Run(const std::function<void()>& func) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      func_ = &func;
+      num_running_ = threads_.size();
+      ++generation_;
+    }
+    work_cv_.notify_all();
+    func();
+    std::unique_lock<std::mutex> lock(mu_);
+    done_cv_.wait(lock, [this]() { return num_running_ == 0; });
+    func_ = nullptr;
+  }
+
+ private:
+  void Work() {
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(mu_);
+    while (true) {
+      work_cv_.wait(lock,
+                    [&]() { return stop_ || generation_ != generation; });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      const std::function<void()>* func = func_;
+      lock.unlock();
+      (*func)();
+      lock.lock();
+      if (--num_running_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  std::vector<port::Thread> threads_;
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void()>* func_ = nullptr;
+  size_t num_running_ = 0;
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+};
+
+// Upper bound of the size of the WAL records inserted concurrently between
+// two checks for full memtables
+const size_t kMaxParallelReplayGroupBytes = 8 << 20;
+// Groups of WAL records smaller than this are replayed by the thread opening
+// the DB alone, as waking up the workers would cost more
+const size_t kMinParallelReplayGroupBytes = 64 << 10;
 }  // namespace
 
 Status DBImpl::ValidateOptions(
@@ -852,6 +977,26 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
   }
 #endif
 
+  // Records made of plain writes are inserted concurrently in groups, as
+  // concurrent writes would. Each group is bounded to half a memtable, so
+  // that the memtables filled up by a group don't grow much past their limit
+  // before they are flushed.
+  const bool parallel_replay =
+      immutable_db_options_.max_wal_recovery_threads > 1 &&
+      immutable_db_options_.allow_concurrent_memtable_write &&
+      !immutable_db_options_.allow_2pc && !seq_per_batch_;
+  size_t max_replay_group_bytes = kMaxParallelReplayGroupBytes;
+  // Created for the first group of records large enough, and kept until the
+  // end of the recovery
+  std::unique_ptr<ParallelReplayWorkers> replay_workers;
+  if (parallel_replay) {
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      max_replay_group_bytes = std::min(
+          max_replay_group_bytes,
+          cfd->GetLatestMutableCFOptions()->write_buffer_size / 2);
+    }
+  }
+
   bool stop_replay_by_wal_filter = false;
   bool stop_replay_for_corruption = false;
   bool flushed = false;
@@ -935,6 +1080,177 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     Slice record;
     WriteBatch batch;
 
+    // Flushes the memtables that filled up during the replay
+    auto flush_scheduled = [&]() -> Status {
+      // we can do this because this is called before client has access to the
+      // DB and there is only a single thread operating on DB
+      ColumnFamilyData* cfd;
+
+      while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
+        cfd->UnrefAndTryDelete();
+        // If this asserts, it means that InsertInto failed in
+        // filtering updates to already-flushed column families
+        assert(cfd->GetLogNumber() <= wal_number);
+        auto iter = version_edits.find(cfd->GetID());
+        assert(iter != version_edits.end());
+        VersionEdit* edit = &iter->second;
+        Status s = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
+        if (!s.ok()) {
+          return s;
+        }
+        flushed = true;
+
+        cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                               *next_sequence);
+      }
+      return Status::OK();
+    };
+
+    // The records waiting to be replayed, in order
+    std::vector<WriteBatch> replay_group;
+    size_t replay_group_bytes = 0;
+    // Replays the records of replay_group. The records are checked by the
+    // workers, which then insert each run of records made of plain writes
+    // concurrently. The other records are inserted one at a time between the
+    // runs. A record that fails to be inserted on its own is reported like in
+    // the serial replay, and ends the replay of the group if the replay must
+    // stop there. Returns an error if DB::Open() must fail: when a flush
+    // fails, or when a record of a run fails to be inserted while the replay
+    // must stop there, as the later records of the run cannot be taken out of
+    // the memtables again.
+    auto replay_pending = [&]() -> Status {
+      const size_t num_batches = replay_group.size();
+      if (num_batches == 0) {
+        return Status::OK();
+      }
+      const bool use_workers =
+          replay_group_bytes >= kMinParallelReplayGroupBytes;
+      if (use_workers) {
+        if (replay_workers == nullptr) {
+          replay_workers.reset(new ParallelReplayWorkers(
+              static_cast<size_t>(
+                  immutable_db_options_.max_wal_recovery_threads) -
+              1));
+        }
+        TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:ParallelReplay",
+                                 &replay_group);
+      }
+      auto run = [&](const std::function<void()>& func) {
+        if (use_workers) {
+          replay_workers->Run(func);
+        } else {
+          func();
+        }
+      };
+
+      // Not a vector<bool>, which the workers could not set concurrently
+      std::vector<char> eligible(num_batches);
+      std::atomic<size_t> next_batch_idx(0);
+      run([&]() {
+        size_t batch_idx;
+        while ((batch_idx = next_batch_idx.fetch_add(1)) < num_batches) {
+          eligible[batch_idx] =
+              ParallelReplayChecker::CanReplayInParallel(replay_group[batch_idx]);
+        }
+      });
+
+      const bool stop_on_error = reporter.status != nullptr;
+      size_t begin = 0;
+      while (begin < num_batches) {
+        size_t end = begin;
+        while (end < num_batches && eligible[end]) {
+          ++end;
+        }
+        if (end > begin) {
+          std::vector<Status> statuses(end - begin);
+          std::vector<SequenceNumber> next_sequences(end - begin);
+          std::atomic<bool> has_valid_writes(false);
+          next_batch_idx.store(begin);
+          run([&]() {
+            // Seek() on the memtables of a column family is not thread safe
+            ColumnFamilyMemTablesImpl memtables(
+                versions_->GetColumnFamilySet());
+            bool valid_writes = false;
+            size_t batch_idx;
+            while ((batch_idx = next_batch_idx.fetch_add(1)) < end) {
+              Status* insert_status = &statuses[batch_idx - begin];
+              *insert_status = WriteBatchInternal::InsertInto(
+                  &replay_group[batch_idx], &memtables, &flush_scheduler_,
+                  &trim_history_scheduler_, true, wal_number, this,
+                  true /* concurrent_memtable_writes */,
+                  &next_sequences[batch_idx - begin], &valid_writes,
+                  seq_per_batch_, batch_per_txn_);
+              TEST_SYNC_POINT_CALLBACK(
+                  "DBImpl::RecoverLogFiles:ParallelInsert", insert_status);
+            }
+            if (valid_writes) {
+              has_valid_writes.store(true, std::memory_order_relaxed);
+            }
+          });
+
+          for (size_t i = 0; i < statuses.size(); i++) {
+            MaybeIgnoreError(&statuses[i]);
+            if (statuses[i].ok()) {
+              continue;
+            }
+            if (stop_on_error) {
+              ROCKS_LOG_ERROR(immutable_db_options_.info_log,
+                              "Recovering log #%" PRIu64
+                              ": failed to insert a record replayed "
+                              "concurrently with later records: %s",
+                              wal_number, statuses[i].ToString().c_str());
+              return Status::Corruption(
+                  "WAL record failed to replay after later records were "
+                  "inserted",
+                  statuses[i].ToString());
+            }
+            // Skipped, like in the serial replay
+            reporter.Corruption(replay_group[begin + i].GetDataSize(),
+                                statuses[i]);
+          }
+          *next_sequence = next_sequences.back();
+
+          if (has_valid_writes.load(std::memory_order_relaxed) &&
+              !read_only) {
+            Status s = flush_scheduled();
+            if (!s.ok()) {
+              return s;
+            }
+          }
+          begin = end;
+          continue;
+        }
+
+        // If column family was not found, it might mean that the WAL write
+        // batch references to the column family that was dropped after the
+        // insert. We don't want to fail the whole write batch in that case
+        // -- we just ignore the update.
+        bool has_valid_writes = false;
+        Status s = WriteBatchInternal::InsertInto(
+            &replay_group[begin], column_family_memtables_.get(),
+            &flush_scheduler_, &trim_history_scheduler_, true, wal_number,
+            this, false /* concurrent_memtable_writes */, next_sequence,
+            &has_valid_writes, seq_per_batch_, batch_per_txn_);
+        MaybeIgnoreError(&s);
+        if (!s.ok()) {
+          reporter.Corruption(replay_group[begin].GetDataSize(), s);
+          if (stop_on_error) {
+            // The later records are dropped, like the serial replay stops
+            break;
+          }
+        } else if (has_valid_writes && !read_only) {
+          s = flush_scheduled();
+          if (!s.ok()) {
+            return s;
+          }
+        }
+        ++begin;
+      }
+      replay_group.clear();
+      replay_group_bytes = 0;
+      return Status::OK();
+    };
+
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
     while (!stop_replay_by_wal_filter &&
@@ -1046,6 +1362,20 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
 #endif  // ROCKSDB_LITE
 
+      if (parallel_replay) {
+        // Decoding the record is left to the workers too
+        replay_group_bytes += batch.GetDataSize();
+        replay_group.push_back(std::move(batch));
+        batch.Clear();
+        if (replay_group_bytes >= max_replay_group_bytes) {
+          Status s = replay_pending();
+          if (!s.ok()) {
+            return s;
+          }
+        }
+        continue;
+      }
+
       // If column family was not found, it might mean that the WAL write
       // batch references to the column family that was dropped after the
       // insert. We don't want to fail the whole write batch in that case --
@@ -1066,32 +1396,26 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
 
       if (has_valid_writes && !read_only) {
-        // we can do this because this is called before client has access to the
-        // DB and there is only a single thread operating on DB
-        ColumnFamilyData* cfd;
-
-        while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
-          cfd->UnrefAndTryDelete();
-          // If this asserts, it means that InsertInto failed in
-          // filtering updates to already-flushed column families
-          assert(cfd->GetLogNumber() <= wal_number);
-          auto iter = version_edits.find(cfd->GetID());
-          assert(iter != version_edits.end());
-          VersionEdit* edit = &iter->second;
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Reflect errors immediately so that conditions like full
-            // file-systems cause the DB::Open() to fail.
-            return status;
-          }
-          flushed = true;
-
-          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
-                                 *next_sequence);
+        status = flush_scheduled();
+        if (!status.ok()) {
+          // Reflect errors immediately so that conditions like full
+          // file-systems cause the DB::Open() to fail.
+          return status;
         }
       }
     }
 
+    // The records read before the end of the WAL, or before the replay
+    // stopped, are replayed like they would have been one by one
+    {
+      Status s = replay_pending();
+      if (!s.ok()) {
+        // Reflect errors immediately so that conditions like full
+        // file-systems cause the DB::Open() to fail.
+        return s;
+      }
+    }
+
     if (!status.ok()) {
       if (status.IsNotSupported()) {
         // We should not treat NotSupported as corruption. It is rather a clear
@@ -1770,7 +2094,11 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
 
     *dbptr = impl;
     impl->opened_successfully_ = true;
+    // The SuperVersions retired during recovery
+    impl->MaybeScheduleSuperVersionReclaim();
     impl->MaybeScheduleFlushOrCompaction();
+    impl->MaybeScheduleTableWarmup();
+    impl->MaybeScheduleBlobGarbageCollection();
   } else {
     persist_options_status.PermitUncheckedError();
   }
@@ -2611,7 +2611,10 @@ Status DBImpl::TrimMemtableHistory(WriteContext* context) {
     if (trimmed) {
       context->superversion_context.NewSuperVersion();
       assert(context->superversion_context.new_superversion.get() != nullptr);
-      cfd->InstallSuperVersion(&context->superversion_context, &mutex_);
+      if (cfd->InstallSuperVersion(&context->superversion_context,
+                                   *cfd->GetLatestMutableCFOptions())) {
+        EnqueueSuperVersionReclaim(cfd);
+      }
     }
 
     if (cfd->UnrefAndTryDelete()) {
@@ -213,6 +213,50 @@ TEST_P(DBIteratorTest, IterReseekNewUpperBound) {
   delete iter;
 }
 
+TEST_P(DBIteratorTest, RangeFilterSkipsFiles) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.range_filter_bits_per_key = 64;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  // Three overlapping L0 files with interleaved keys
+  for (int file = 0; file < 3; ++file) {
+    for (int i = file; i < 300; i += 3) {
+      char key[16];
+      snprintf(key, sizeof(key), "k%03d", i);
+      ASSERT_OK(Put(key, "v"));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("3", FilesPerLevel());
+
+  ReadOptions ro;
+  Slice ub("k011");
+  ro.iterate_upper_bound = &ub;
+  std::unique_ptr<Iterator> iter(NewIterator(ro));
+  iter->Seek("k010");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("k010", iter->key().ToString());
+  iter->Next();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+  // Only the file with k010 may have keys in the range
+  ASSERT_EQ(3, TestGetTickerCount(options, RANGE_FILTER_CHECKED));
+  ASSERT_EQ(2, TestGetTickerCount(options, RANGE_FILTER_USEFUL));
+
+  ub = Slice("k100");
+  iter->Seek("k050");
+  int count = 0;
+  for (; iter->Valid(); iter->Next()) {
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(50, count);
+}
+
 TEST_P(DBIteratorTest, IterSeekForPrevBeforeNext) {
   ASSERT_OK(Put("a", "b"));
   ASSERT_OK(Put("c", "d"));
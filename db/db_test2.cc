@@ -12,6 +12,7 @@
 #include <functional>
 #include <memory>
 
+#include "cache/clock_cache.h"
 #include "db/db_test_util.h"
 #include "db/read_callback.h"
 #include "options/options_helper.h"
@@ -5980,6 +5981,226 @@ TEST_F(DBTest2, FileConsistencyCheckInOpen) {
   SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBTest2, OpenTablesLazily) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_open_files = -1;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBTest2::OpenTablesLazily:Opened", "DBImpl::BGWorkTableWarmup:start"},
+       {"DBImpl::BackgroundCallTableWarmup:Done",
+        "DBTest2::OpenTablesLazily:WarmedUp"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  options.open_tables_lazily = true;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  // No table was opened by DB::Open()
+  ASSERT_EQ(0, options.statistics->getTickerCount(NO_FILE_OPENS));
+  uint64_t pending = 0;
+  ASSERT_TRUE(
+      db_->GetIntProperty(DB::Properties::kNumTablesPendingWarmup, &pending));
+  ASSERT_EQ(10, pending);
+  // Tables are opened on first access
+  ASSERT_EQ("v9", Get(Key(9)));
+  ASSERT_EQ(1, options.statistics->getTickerCount(NO_FILE_OPENS));
+
+  TEST_SYNC_POINT("DBTest2::OpenTablesLazily:Opened");
+  TEST_SYNC_POINT("DBTest2::OpenTablesLazily:WarmedUp");
+  ASSERT_TRUE(
+      db_->GetIntProperty(DB::Properties::kNumTablesPendingWarmup, &pending));
+  ASSERT_EQ(0, pending);
+  ASSERT_EQ(10, options.statistics->getTickerCount(NO_FILE_OPENS));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+  ASSERT_EQ(10, options.statistics->getTickerCount(NO_FILE_OPENS));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBTest2, PinLazilyOpenedTables) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_open_files = -1;
+  Reopen(options);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBImpl::BackgroundCallTableWarmup:Done",
+        "DBTest2::PinLazilyOpenedTables:WarmedUp"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  options.open_tables_lazily = true;
+  Reopen(options);
+  auto* cfd = static_cast_with_check<ColumnFamilyHandleImpl>(
+                  db_->DefaultColumnFamily())
+                  ->cfd();
+  ASSERT_EQ("v1", Get(Key(1)));
+  TEST_SYNC_POINT("DBTest2::PinLazilyOpenedTables:WarmedUp");
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  // Each table was pinned in its metadata by the first read or the warmup
+  for (const FileMetaData* f :
+       cfd->current()->storage_info()->LevelFiles(0)) {
+    ASSERT_EQ(nullptr, f->fd.table_reader);
+    ASSERT_NE(nullptr, f->pinned_table_handle.handle.load());
+  }
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+
+  // The pinned handles are released with the files
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+  Close();
+}
+
+TEST_F(DBTest2, ClockTableCache) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_open_files = 20;
+  options.table_cache_use_clock_cache = true;
+  Reopen(options);
+#ifdef SUPPORT_CLOCK_CACHE
+  ASSERT_STREQ("ClockCache", dbfull()->TEST_table_cache()->Name());
+#else
+  ASSERT_STREQ("LRUCache", dbfull()->TEST_table_cache()->Name());
+#endif  // SUPPORT_CLOCK_CACHE
+  for (int i = 0; i < 20; i++) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+  // Tables are not pinned with a bounded table cache
+  auto* cfd = static_cast_with_check<ColumnFamilyHandleImpl>(
+                  db_->DefaultColumnFamily())
+                  ->cfd();
+  for (const FileMetaData* f :
+       cfd->current()->storage_info()->LevelFiles(0)) {
+    ASSERT_EQ(nullptr, f->pinned_table_handle.handle.load());
+  }
+}
+
+TEST_F(DBTest2, RetireSuperVersionOnMemtableSwitch) {
+  Options options = CurrentOptions();
+  options.max_write_buffer_number = 8;
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"one"}, options);
+  auto* cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(handles_[1])->cfd();
+
+  ASSERT_OK(Put(1, "foo", "v0"));
+  ASSERT_EQ("v0", Get(1, "foo"));
+  void* cached = cfd->TEST_GetLocalSV()->Get();
+  for (int i = 1; i <= 3; ++i) {
+    // Switching the memtable does not scrape the SuperVersion cached by this
+    // thread, which is refreshed on the next read
+    ASSERT_OK(dbfull()->TEST_SwitchMemtable(cfd));
+    ASSERT_EQ(cached, cfd->TEST_GetLocalSV()->Get());
+    ASSERT_OK(Put(1, "foo", "v" + ToString(i)));
+    ASSERT_EQ("v" + ToString(i), Get(1, "foo"));
+    ASSERT_NE(cached, cfd->TEST_GetLocalSV()->Get());
+    cached = cfd->TEST_GetLocalSV()->Get();
+  }
+
+  // Installing the flush result releases the memtables, so the flush job
+  // scrapes the SuperVersion afterwards, without the DB mutex
+  int reclaims = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::ReclaimRetiredSuperVersions:Unlocked", [&](void* /*arg*/) {
+        dbfull()->TEST_LockMutex();
+        dbfull()->TEST_UnlockMutex();
+        ++reclaims;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(Flush(1));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(1, reclaims);
+  ASSERT_EQ(SuperVersion::kSVObsolete, cfd->TEST_GetLocalSV()->Get());
+  ASSERT_EQ("v3", Get(1, "foo"));
+
+  // A column family can be dropped with retired SuperVersions
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable(cfd));
+  ASSERT_OK(Put(1, "foo", "v4"));
+  ASSERT_EQ("v4", Get(1, "foo"));
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable(cfd));
+  ASSERT_OK(Put(0, "foo", "bar"));
+  ASSERT_EQ("bar", Get(0, "foo"));
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  ASSERT_OK(db_->DropColumnFamily(handles_[1]));
+  ASSERT_OK(db_->DestroyColumnFamilyHandle(handles_[1]));
+  handles_.resize(1);
+  ASSERT_EQ("bar", Get(0, "foo"));
+  Close();
+}
+
+TEST_F(DBTest2, VersionsShareUnchangedLevels) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(Put(Key(i), "v" + ToString(i)));
+    ASSERT_OK(Flush());
+  }
+  MoveFilesToLevel(6);
+  ASSERT_EQ("0,0,0,0,0,0,3", FilesPerLevel());
+
+  auto* cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(db_->DefaultColumnFamily())
+          ->cfd();
+  dbfull()->TEST_LockMutex();
+  Version* old_version = cfd->current();
+  old_version->Ref();
+  dbfull()->TEST_UnlockMutex();
+
+  // A flush only changes L0, the new version shares L6 with the old one
+  ASSERT_OK(Put(Key(3), "v3"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,0,0,0,0,0,3", FilesPerLevel());
+  dbfull()->TEST_LockMutex();
+  Version* new_version = cfd->current();
+  ASSERT_NE(old_version, new_version);
+  ASSERT_EQ(old_version->storage_info()->LevelFiles(6),
+            new_version->storage_info()->LevelFiles(6));
+  ASSERT_EQ(old_version->storage_info()->LevelFilesBrief(6).files,
+            new_version->storage_info()->LevelFilesBrief(6).files);
+  old_version->Unref();
+  dbfull()->TEST_UnlockMutex();
+
+  // The files of the shared level are deleted once no version has them
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(1, GetSstFileCount(dbname_));
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+
+  Reopen(options);
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ("v3", Get(Key(3)));
+}
+
 TEST_F(DBTest2, BlockBasedTablePrefixIndexSeekForPrev) {
   // create a DB with block prefix index
   BlockBasedTableOptions table_options;
@@ -15,6 +15,7 @@
 #include "test_util/sync_point.h"
 #include "utilities/fault_injection_env.h"
 #include "utilities/fault_injection_fs.h"
+#include "utilities/merge_operators.h"
 
 namespace ROCKSDB_NAMESPACE {
 class DBWALTestBase : public DBTestBase {
@@ -1045,6 +1046,134 @@ TEST_F(DBWALTest, RecoverWithLargeLog) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, RecoverWithParallelReplay) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  CreateAndReopenWithCF({"pikachu", "dobrynia"}, options);
+
+  // Keys are overwritten across records, so replaying the records out of
+  // order must still leave the latest values
+  std::map<std::string, std::string> expected[3];
+  Random rnd(301);
+  for (int i = 0; i < 6000; i++) {
+    const int cf = i % 3;
+    const std::string key = Key(rnd.Uniform(500));
+    if (i % 97 == 0) {
+      ASSERT_OK(Merge(cf, key, "m"));
+      auto it = expected[cf].find(key);
+      expected[cf][key] = it == expected[cf].end() ? "m" : it->second + ",m";
+    } else if (i % 13 == 0) {
+      ASSERT_OK(Delete(cf, key));
+      expected[cf].erase(key);
+    } else {
+      WriteBatch batch;
+      const std::string value = rnd.RandomString(100);
+      ASSERT_OK(batch.Put(handles_[cf], key, value));
+      ASSERT_OK(batch.Put(handles_[(cf + 1) % 3], key, value));
+      ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+      expected[cf][key] = value;
+      expected[(cf + 1) % 3][key] = value;
+    }
+  }
+  ASSERT_EQ(NumTableFilesAtLevel(0, 1), 0);
+
+  // Small memtables make the replay flush between groups of records
+  std::atomic<int> parallel_replays(0);
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::RecoverLogFiles:ParallelReplay",
+      [&](void* /*arg*/) { parallel_replays++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  options.max_wal_recovery_threads = 4;
+  options.write_buffer_size = 256 << 10;
+  ReopenWithColumnFamilies({"default", "pikachu", "dobrynia"}, options);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_GT(parallel_replays.load(), 1);
+  ASSERT_GT(NumTableFilesAtLevel(0, 1), 1);
+  for (int cf = 0; cf < 3; cf++) {
+    for (int k = 0; k < 500; k++) {
+      auto it = expected[cf].find(Key(k));
+      ASSERT_EQ(it == expected[cf].end() ? "NOT_FOUND" : it->second,
+                Get(cf, Key(k)));
+    }
+  }
+}
+
+TEST_F(DBWALTest, ParallelReplayPointInTimeRecovery) {
+  Options options = CurrentOptions();
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(200)));
+  }
+  // Corrupt the WAL in the middle of the next records
+  uint64_t wal_file_id = dbfull()->TEST_LogfileNumber();
+  std::string fname = LogFileName(dbname_, wal_file_id);
+  uint64_t offset_to_corrupt;
+  ASSERT_OK(env_->GetFileSize(fname, &offset_to_corrupt));
+  for (int i = 1000; i < 2000; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(200)));
+  }
+  ASSERT_OK(test::CorruptFile(env_, fname,
+                              static_cast<int>(offset_to_corrupt) + 5000, 4,
+                              false));
+
+  // The records before the corrupted one are replayed concurrently
+  std::atomic<int> parallel_replays(0);
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::RecoverLogFiles:ParallelReplay",
+      [&](void* /*arg*/) { parallel_replays++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  options.max_wal_recovery_threads = 4;
+  Reopen(options);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_GT(parallel_replays.load(), 0);
+
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_NE("NOT_FOUND", Get(Key(i)));
+  }
+  for (int i = 1100; i < 2000; i++) {
+    ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+  }
+}
+
+TEST_F(DBWALTest, ParallelReplayInsertFailure) {
+  Options options = CurrentOptions();
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  for (int i = 0; i < 2000; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(200)));
+  }
+
+  // A record failing while later records of its group are inserted cannot
+  // be recovered to, so DB::Open() fails
+  std::atomic<int> inserts(0);
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::RecoverLogFiles:ParallelInsert", [&](void* arg) {
+        if (inserts++ == 500) {
+          *static_cast<Status*>(arg) = Status::Corruption("injected");
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  options.max_wal_recovery_threads = 4;
+  Status s = TryReopen(options);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_TRUE(s.IsCorruption()) << s.ToString();
+  ASSERT_GT(inserts.load(), 500);
+
+  // Nothing was recovered, so the WAL can still be replayed in full
+  Reopen(options);
+  for (int i = 0; i < 2000; i++) {
+    ASSERT_NE("NOT_FOUND", Get(Key(i)));
+  }
+}
+
 // In https://reviews.facebook.net/D20661 we change
 // recovery behavior: previously for each log file each column family
 // memtable was flushed, even it was empty. Now it's changed:
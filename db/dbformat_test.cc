@@ -9,6 +9,7 @@
 
 #include "db/dbformat.h"
 #include "test_util/testharness.h"
+#include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -198,6 +199,53 @@ TEST_F(FormatTest, RangeTombstoneSerializeEndKey) {
   ASSERT_LT(cmp.Compare(t.SerializeEndKey(), k), 0);
 }
 
+namespace {
+// Orders keys like BytewiseComparator(), but is a different comparator, so
+// comparisons go through the virtual call
+class ForwardingBytewiseComparator : public Comparator {
+ public:
+  const char* Name() const override { return "ForwardingBytewiseComparator"; }
+  int Compare(const Slice& a, const Slice& b) const override {
+    return BytewiseComparator()->Compare(a, b);
+  }
+  void FindShortestSeparator(std::string*, const Slice&) const override {}
+  void FindShortSuccessor(std::string*) const override {}
+};
+
+int Sign(int r) { return (r > 0) - (r < 0); }
+}  // namespace
+
+TEST_F(FormatTest, InternalKeyComparatorBytewiseFastPath) {
+  ForwardingBytewiseComparator forwarding;
+  const InternalKeyComparator fast(BytewiseComparator());
+  const InternalKeyComparator slow(&forwarding);
+  ASSERT_TRUE(UserComparatorWrapper(BytewiseComparator()).IsBytewise());
+  ASSERT_FALSE(UserComparatorWrapper(&forwarding).IsBytewise());
+
+  Random rnd(301);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 200; ++i) {
+    // Short keys over few bytes so that many user keys are equal or
+    // prefixes of each other
+    std::string user_key;
+    for (int len = rnd.Uniform(4); len > 0; --len) {
+      user_key.push_back(static_cast<char>("\0a\xff"[rnd.Uniform(3)]));
+    }
+    keys.push_back(IKey(user_key, rnd.Uniform(3),
+                        rnd.OneIn(2) ? kTypeValue : kTypeDeletion));
+  }
+  for (const std::string& a : keys) {
+    for (const std::string& b : keys) {
+      ASSERT_EQ(Sign(slow.Compare(a, b)), Sign(fast.Compare(a, b)));
+      ASSERT_EQ(Sign(slow.CompareKeySeq(a, b)),
+                Sign(fast.CompareKeySeq(a, b)));
+      ASSERT_EQ(
+          Sign(slow.Compare(a, kDisableGlobalSequenceNumber, b, 1)),
+          Sign(fast.Compare(a, kDisableGlobalSequenceNumber, b, 1)));
+    }
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
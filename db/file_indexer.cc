@@ -74,6 +74,12 @@ void FileIndexer::GetNextLevelIndex(const size_t level, const size_t file_index,
 
 void FileIndexer::UpdateIndex(Arena* arena, const size_t num_levels,
                               std::vector<FileMetaData*>* const files) {
+  UpdateIndex(arena, num_levels, files, nullptr);
+}
+
+void FileIndexer::UpdateIndex(Arena* arena, const size_t num_levels,
+                              std::vector<FileMetaData*>* const files,
+                              LevelIndexCache* const* caches) {
   if (files == nullptr) {
     return;
   }
@@ -102,44 +108,74 @@ void FileIndexer::UpdateIndex(Arena* arena, const size_t num_levels,
       continue;
     }
     IndexLevel& index_level = next_level_index_[level];
-    index_level.num_index = upper_size;
-    mem = arena->AllocateAligned(upper_size * sizeof(IndexUnit));
-    index_level.index_units = new (mem) IndexUnit[upper_size];
-
-    CalculateLB(
-        upper_files, lower_files, &index_level,
-        [this](const FileMetaData* a, const FileMetaData* b) -> int {
-          return ucmp_->CompareWithoutTimestamp(a->smallest.user_key(),
-                                                b->largest.user_key());
-        },
-        [](IndexUnit* index, int32_t f_idx) { index->smallest_lb = f_idx; });
-    CalculateLB(
-        upper_files, lower_files, &index_level,
-        [this](const FileMetaData* a, const FileMetaData* b) -> int {
-          return ucmp_->CompareWithoutTimestamp(a->largest.user_key(),
-                                                b->largest.user_key());
-        },
-        [](IndexUnit* index, int32_t f_idx) { index->largest_lb = f_idx; });
-    CalculateRB(
-        upper_files, lower_files, &index_level,
-        [this](const FileMetaData* a, const FileMetaData* b) -> int {
-          return ucmp_->CompareWithoutTimestamp(a->smallest.user_key(),
-                                                b->smallest.user_key());
-        },
-        [](IndexUnit* index, int32_t f_idx) { index->smallest_rb = f_idx; });
-    CalculateRB(
-        upper_files, lower_files, &index_level,
-        [this](const FileMetaData* a, const FileMetaData* b) -> int {
-          return ucmp_->CompareWithoutTimestamp(a->largest.user_key(),
-                                                b->smallest.user_key());
-        },
-        [](IndexUnit* index, int32_t f_idx) { index->largest_rb = f_idx; });
+
+    LevelIndexCache* const cache =
+        caches != nullptr ? caches[level] : nullptr;
+    const LevelIndexCache* const lower_cache =
+        caches != nullptr ? caches[level + 1] : nullptr;
+    if (cache == nullptr || lower_cache == nullptr) {
+      index_level.num_index = upper_size;
+      mem = arena->AllocateAligned(upper_size * sizeof(IndexUnit));
+      index_level.index_units = new (mem) IndexUnit[upper_size];
+      CalculateIndex(upper_files, lower_files, &index_level);
+      continue;
+    }
+
+    if (cache->lower_files_id != lower_cache->files_id) {
+      // The index units the cache held stay alive as long as the indexes
+      // using them
+      IndexLevel computed;
+      computed.num_index = upper_size;
+      computed.index_units = new IndexUnit[upper_size];
+      cache->index_units.reset(computed.index_units,
+                               std::default_delete<IndexUnit[]>());
+      cache->num_index = computed.num_index;
+      cache->lower_files_id = lower_cache->files_id;
+      CalculateIndex(upper_files, lower_files, &computed);
+    }
+    assert(cache->num_index == static_cast<size_t>(upper_size));
+    index_level.num_index = cache->num_index;
+    index_level.index_units = cache->index_units.get();
+    cached_index_units_.push_back(cache->index_units);
   }
 
   level_rb_[num_levels_ - 1] =
       static_cast<int32_t>(files[num_levels_ - 1].size()) - 1;
 }
 
+void FileIndexer::CalculateIndex(const std::vector<FileMetaData*>& upper_files,
+                                 const std::vector<FileMetaData*>& lower_files,
+                                 IndexLevel* index_level) {
+  CalculateLB(
+      upper_files, lower_files, index_level,
+      [this](const FileMetaData* a, const FileMetaData* b) -> int {
+        return ucmp_->CompareWithoutTimestamp(a->smallest.user_key(),
+                                              b->largest.user_key());
+      },
+      [](IndexUnit* index, int32_t f_idx) { index->smallest_lb = f_idx; });
+  CalculateLB(
+      upper_files, lower_files, index_level,
+      [this](const FileMetaData* a, const FileMetaData* b) -> int {
+        return ucmp_->CompareWithoutTimestamp(a->largest.user_key(),
+                                              b->largest.user_key());
+      },
+      [](IndexUnit* index, int32_t f_idx) { index->largest_lb = f_idx; });
+  CalculateRB(
+      upper_files, lower_files, index_level,
+      [this](const FileMetaData* a, const FileMetaData* b) -> int {
+        return ucmp_->CompareWithoutTimestamp(a->smallest.user_key(),
+                                              b->smallest.user_key());
+      },
+      [](IndexUnit* index, int32_t f_idx) { index->smallest_rb = f_idx; });
+  CalculateRB(
+      upper_files, lower_files, index_level,
+      [this](const FileMetaData* a, const FileMetaData* b) -> int {
+        return ucmp_->CompareWithoutTimestamp(a->largest.user_key(),
+                                              b->smallest.user_key());
+      },
+      [](IndexUnit* index, int32_t f_idx) { index->largest_rb = f_idx; });
+}
+
 void FileIndexer::CalculateLB(
     const std::vector<FileMetaData*>& upper_files,
     const std::vector<FileMetaData*>& lower_files, IndexLevel* index_level,
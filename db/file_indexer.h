@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <vector>
 #include "memory/arena.h"
 #include "port/port.h"
@@ -58,6 +59,18 @@ class FileIndexer {
   void UpdateIndex(Arena* arena, const size_t num_levels,
                    std::vector<FileMetaData*>* const files);
 
+  // The index of the files of a level against the files of the next level,
+  // kept with the files of the level (see LevelIndexCache below).
+  struct LevelIndexCache;
+
+  // Same as above, but the index of level i against level i + 1 is taken
+  // from caches[i] if caches[i] and caches[i + 1] are not nullptr, and it was
+  // computed against the files of caches[i + 1]. Otherwise it is computed
+  // into caches[i]. Each cache must only be updated by one thread at a time.
+  void UpdateIndex(Arena* arena, const size_t num_levels,
+                   std::vector<FileMetaData*>* const files,
+                   LevelIndexCache* const* caches);
+
   enum {
     // MSVC version 1800 still does not have constexpr for ::max()
     kLevelMaxIndex = ROCKSDB_NAMESPACE::port::kMaxInt32
@@ -123,6 +136,10 @@ class FileIndexer {
     IndexLevel() : num_index(0), index_units(nullptr) {}
   };
 
+  void CalculateIndex(const std::vector<FileMetaData*>& upper_files,
+                      const std::vector<FileMetaData*>& lower_files,
+                      IndexLevel* index_level);
+
   void CalculateLB(
       const std::vector<FileMetaData*>& upper_files,
       const std::vector<FileMetaData*>& lower_files, IndexLevel* index_level,
@@ -137,6 +154,23 @@ class FileIndexer {
 
   autovector<IndexLevel> next_level_index_;
   int32_t* level_rb_;
+  // The index units taken from caches, which may replace them
+  std::vector<std::shared_ptr<IndexUnit>> cached_index_units_;
+};
+
+// Identifies the files of a level by a number, unique among the files of all
+// levels, so that an index computed against the files of the next level is
+// only reused while that level holds the same files.
+struct FileIndexer::LevelIndexCache {
+  explicit LevelIndexCache(uint64_t _files_id) : files_id(_files_id) {}
+
+  // Identifies the files of the level
+  const uint64_t files_id;
+  // Identifies the files of the next level the index was computed against,
+  // or 0 if there is no index
+  uint64_t lower_files_id = 0;
+  size_t num_index = 0;
+  std::shared_ptr<IndexUnit> index_units;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
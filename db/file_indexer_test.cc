@@ -341,6 +341,70 @@ TEST_F(FileIndexerTest, mixed) {
   ClearFiles();
 }
 
+// Case 6: the index of a level is reused while it and the next level hold
+// the same files
+TEST_F(FileIndexerTest, cached_index) {
+  Arena arena;
+  // level 1
+  AddFile(1, 100, 200);
+  AddFile(1, 250, 400);
+  // level 2
+  AddFile(2, 100, 150);
+  AddFile(2, 300, 350);
+  // level 3
+  AddFile(3, 0, 50);
+  AddFile(3, 201, 250);
+  FileIndexer::LevelIndexCache l1(1), l2(2), l3(3);
+  FileIndexer::LevelIndexCache* caches[] = {nullptr, &l1, &l2, &l3};
+  indexer = new FileIndexer(&ucmp);
+  indexer->UpdateIndex(&arena, kNumLevels, files, caches);
+  ASSERT_EQ(uint64_t{2}, l1.lower_files_id);
+  ASSERT_EQ(uint64_t{3}, l2.lower_files_id);
+  ASSERT_EQ(uint64_t{0}, l3.lower_files_id);
+  const auto* l1_units = l1.index_units.get();
+  const auto* l2_units = l2.index_units.get();
+  GetNextLevelIndex(1, 1, 1, -1, &left, &right);
+  ASSERT_EQ(1, left);
+  ASSERT_EQ(1, right);
+
+  // Level 2 changes, so the index of level 1 is computed again, while the
+  // one of level 2 only depends on the unchanged level 3
+  FileIndexer* old_indexer = indexer;
+  AddFile(2, 500, 600);
+  FileIndexer::LevelIndexCache new_l2(4);
+  caches[2] = &new_l2;
+  indexer = new FileIndexer(&ucmp);
+  indexer->UpdateIndex(&arena, kNumLevels, files, caches);
+  ASSERT_EQ(uint64_t{4}, l1.lower_files_id);
+  ASSERT_NE(l1_units, l1.index_units.get());
+  ASSERT_EQ(uint64_t{3}, new_l2.lower_files_id);
+  GetNextLevelIndex(1, 1, 1, 1, &left, &right);
+  ASSERT_EQ(2, left);
+  ASSERT_EQ(2, right);
+
+  // The previous index still works after the cache was replaced
+  std::swap(indexer, old_indexer);
+  GetNextLevelIndex(1, 1, 1, -1, &left, &right);
+  ASSERT_EQ(1, left);
+  ASSERT_EQ(1, right);
+  std::swap(indexer, old_indexer);
+  delete old_indexer;
+
+  // Nothing changes, everything is reused
+  l1_units = l1.index_units.get();
+  l2_units = new_l2.index_units.get();
+  delete indexer;
+  indexer = new FileIndexer(&ucmp);
+  indexer->UpdateIndex(&arena, kNumLevels, files, caches);
+  ASSERT_EQ(l1_units, l1.index_units.get());
+  ASSERT_EQ(l2_units, new_l2.index_units.get());
+  GetNextLevelIndex(2, 2, 1, 1, &left, &right);
+  ASSERT_EQ(2, left);
+  ASSERT_EQ(1, right);
+  delete indexer;
+  ClearFiles();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
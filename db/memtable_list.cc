@@ -255,6 +255,23 @@ SequenceNumber MemTableListVersion::GetEarliestSequenceNumber(
   }
 }
 
+bool MemTableListVersion::Contains(const MemTable* m) const {
+  return std::find(memlist_.begin(), memlist_.end(), m) != memlist_.end() ||
+         std::find(memlist_history_.begin(), memlist_history_.end(), m) !=
+             memlist_history_.end();
+}
+
+bool MemTableListVersion::IsSubsetOf(const MemTableListVersion& other) const {
+  for (const auto* list : {&memlist_, &memlist_history_}) {
+    for (const MemTable* m : *list) {
+      if (!other.Contains(m)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 // caller is responsible for referencing m
 void MemTableListVersion::Add(MemTable* m, autovector<MemTable*>* to_delete) {
   assert(refs_ == 1);  // only when refs_ == 1 is MemTableListVersion mutable
@@ -129,6 +129,14 @@ class MemTableListVersion {
   // History.
   SequenceNumber GetEarliestSequenceNumber(bool include_history = false) const;
 
+  // Returns true if `m` is one of the memtables of this version, including
+  // the history.
+  bool Contains(const MemTable* m) const;
+
+  // Returns true if all the memtables of this version, including the
+  // history, are also in `other`.
+  bool IsSubsetOf(const MemTableListVersion& other) const;
+
  private:
   friend class MemTableList;
 
@@ -74,6 +74,7 @@ TableCache::TableCache(const ImmutableOptions& ioptions,
       file_options_(*file_options),
       cache_(cache),
       immortal_tables_(false),
+      pin_table_handles_(cache->GetCapacity() >= kInfiniteCapacity),
       block_cache_tracer_(block_cache_tracer),
       loader_mutex_(kLoadConcurency, kGetSliceNPHash64UnseededFnPtr),
       io_tracer_(io_tracer),
@@ -96,6 +97,40 @@ void TableCache::ReleaseHandle(Cache::Handle* handle) {
   cache_->Release(handle);
 }
 
+TableReader* TableCache::GetPinnedTableReader(const FileMetaData& file_meta) {
+  TableReader* table_reader = file_meta.fd.table_reader;
+  if (table_reader == nullptr) {
+    Cache::Handle* handle =
+        file_meta.pinned_table_handle.handle.load(std::memory_order_acquire);
+    if (handle != nullptr) {
+      table_reader = GetTableReaderFromHandle(handle);
+    }
+  }
+  return table_reader;
+}
+
+bool TableCache::MaybePinTableHandle(const FileMetaData& file_meta,
+                                     Cache::Handle* handle) {
+  // Only the files of a version release their pinned handle, not the
+  // metadata of a file being built or verified
+  if (!pin_table_handles_ || file_meta.refs.load() <= 0) {
+    return false;
+  }
+  Cache::Handle* expected = nullptr;
+  // Another read may have pinned the file first
+  return file_meta.pinned_table_handle.handle.compare_exchange_strong(
+      expected, handle, std::memory_order_acq_rel);
+}
+
+void TableCache::ReleasePinnedTableHandle(Cache* cache,
+                                          FileMetaData* file_meta) {
+  Cache::Handle* handle = file_meta->pinned_table_handle.handle.exchange(
+      nullptr, std::memory_order_acq_rel);
+  if (handle != nullptr) {
+    cache->Release(handle);
+  }
+}
+
 Status TableCache::GetTableReader(
     const ReadOptions& ro, const FileOptions& file_options,
     const InternalKeyComparator& internal_comparator, const FileDescriptor& fd,
@@ -223,7 +258,7 @@ InternalIterator* TableCache::NewIterator(
   }
   bool for_compaction = caller == TableReaderCaller::kCompaction;
   auto& fd = file_meta.fd;
-  table_reader = fd.table_reader;
+  table_reader = GetPinnedTableReader(file_meta);
   if (table_reader == nullptr) {
     s = FindTable(
         options, file_options, icomparator, fd, &handle, prefix_extractor,
@@ -233,6 +268,9 @@ InternalIterator* TableCache::NewIterator(
         max_file_size_for_l0_meta_pin, file_meta.temperature);
     if (s.ok()) {
       table_reader = GetTableReaderFromHandle(handle);
+      if (MaybePinTableHandle(file_meta, handle)) {
+        handle = nullptr;
+      }
     }
   }
   InternalIterator* result = nullptr;
@@ -299,12 +337,15 @@ Status TableCache::GetRangeTombstoneIterator(
   assert(out_iter);
   const FileDescriptor& fd = file_meta.fd;
   Status s;
-  TableReader* t = fd.table_reader;
+  TableReader* t = GetPinnedTableReader(file_meta);
   Cache::Handle* handle = nullptr;
   if (t == nullptr) {
     s = FindTable(options, file_options_, internal_comparator, fd, &handle);
     if (s.ok()) {
       t = GetTableReaderFromHandle(handle);
+      if (MaybePinTableHandle(file_meta, handle)) {
+        handle = nullptr;
+      }
     }
   }
   if (s.ok()) {
@@ -420,7 +461,7 @@ Status TableCache::Get(const ReadOptions& options,
   }
 #endif  // ROCKSDB_LITE
   Status s;
-  TableReader* t = fd.table_reader;
+  TableReader* t = GetPinnedTableReader(file_meta);
   Cache::Handle* handle = nullptr;
   if (!done) {
     assert(s.ok());
@@ -433,6 +474,9 @@ Status TableCache::Get(const ReadOptions& options,
                     max_file_size_for_l0_meta_pin, file_meta.temperature);
       if (s.ok()) {
         t = GetTableReaderFromHandle(handle);
+        if (MaybePinTableHandle(file_meta, handle)) {
+          handle = nullptr;
+        }
       }
     }
     SequenceNumber* max_covering_tombstone_seq =
@@ -505,7 +549,7 @@ async_result TableCache::AsyncGet(
   }
 #endif  // ROCKSDB_LITE
   Status s;
-  TableReader* t = fd.table_reader;
+  TableReader* t = GetPinnedTableReader(file_meta);
   Cache::Handle* handle = nullptr;
   if (!done) {
     assert(s.ok());
@@ -518,6 +562,9 @@ async_result TableCache::AsyncGet(
                     max_file_size_for_l0_meta_pin);
       if (s.ok()) {
         t = GetTableReaderFromHandle(handle);
+        if (MaybePinTableHandle(file_meta, handle)) {
+          handle = nullptr;
+        }
       }
     }
     SequenceNumber* max_covering_tombstone_seq =
@@ -577,7 +624,7 @@ Status TableCache::MultiGet(const ReadOptions& options,
                             int level) {
   auto& fd = file_meta.fd;
   Status s;
-  TableReader* t = fd.table_reader;
+  TableReader* t = GetPinnedTableReader(file_meta);
   Cache::Handle* handle = nullptr;
   MultiGetRange table_range(*mget_range, mget_range->begin(),
                             mget_range->end());
@@ -627,6 +674,9 @@ Status TableCache::MultiGet(const ReadOptions& options,
       TEST_SYNC_POINT_CALLBACK("TableCache::MultiGet:FindTable", &s);
       if (s.ok()) {
         t = GetTableReaderFromHandle(handle);
+        if (MaybePinTableHandle(file_meta, handle)) {
+          handle = nullptr;
+        }
         assert(t);
       }
     }
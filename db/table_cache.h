@@ -33,6 +33,7 @@ class Arena;
 struct FileDescriptor;
 class GetContext;
 class HistogramImpl;
+struct FileMetaData;
 
 // Manages caching for TableReader objects for a column family. The actual
 // cache is allocated separately and passed to the constructor. TableCache
@@ -156,6 +157,22 @@ class TableCache {
   // Get TableReader from a cache handle.
   TableReader* GetTableReaderFromHandle(Cache::Handle* handle);
 
+  // Returns the table reader of a file if it was loaded with its version or
+  // pinned by an earlier read, or nullptr if it has to be found in the
+  // cache. Does not touch the cache.
+  TableReader* GetPinnedTableReader(const FileMetaData& file_meta);
+
+  // Pins `handle`, found for `file_meta`, in the file metadata, so that later
+  // reads of the file get its table reader from GetPinnedTableReader(). Only
+  // done if the cache had infinite capacity when this TableCache was created,
+  // since a pinned table is never evicted. Returns true if the metadata took
+  // over the handle, in which case the caller must not release it.
+  bool MaybePinTableHandle(const FileMetaData& file_meta,
+                           Cache::Handle* handle);
+
+  // Releases the handle pinned in the metadata of a file, if any.
+  static void ReleasePinnedTableHandle(Cache* cache, FileMetaData* file_meta);
+
   // Get the table properties of a given table.
   // @no_io: indicates if we should load table to the cache if it is not present
   //         in table cache yet.
@@ -238,6 +255,7 @@ class TableCache {
   Cache* const cache_;
   std::string row_cache_id_;
   bool immortal_tables_;
+  const bool pin_table_handles_;
   BlockCacheTracer* const block_cache_tracer_;
   Striped<port::Mutex, Slice> loader_mutex_;
   std::shared_ptr<IOTracer> io_tracer_;
@@ -89,15 +89,24 @@ class VersionBuilder::Rep {
   class BlobFileMetaDataDelta {
    public:
     bool IsEmpty() const {
-      return !shared_meta_ && !additional_garbage_count_ &&
-             !additional_garbage_bytes_ && newly_linked_ssts_.empty() &&
-             newly_unlinked_ssts_.empty();
+      return !shared_meta_ && !relocated_shared_meta_ &&
+             !additional_garbage_count_ && !additional_garbage_bytes_ &&
+             !removed_garbage_count_ && !removed_garbage_bytes_ &&
+             newly_linked_ssts_.empty() && newly_unlinked_ssts_.empty();
     }
 
     std::shared_ptr<SharedBlobFileMetaData> GetSharedMeta() const {
       return shared_meta_;
     }
 
+    std::shared_ptr<SharedBlobFileMetaData> GetRelocatedSharedMeta() const {
+      return relocated_shared_meta_;
+    }
+
+    uint64_t GetRemovedGarbageCount() const { return removed_garbage_count_; }
+
+    uint64_t GetRemovedGarbageBytes() const { return removed_garbage_bytes_; }
+
     uint64_t GetAdditionalGarbageCount() const {
       return additional_garbage_count_;
     }
@@ -126,6 +135,16 @@ class VersionBuilder::Rep {
       additional_garbage_bytes_ += bytes;
     }
 
+    void Relocate(std::shared_ptr<SharedBlobFileMetaData> relocated_shared_meta,
+                  uint64_t removed_garbage_count,
+                  uint64_t removed_garbage_bytes) {
+      assert(relocated_shared_meta);
+
+      relocated_shared_meta_ = std::move(relocated_shared_meta);
+      removed_garbage_count_ += removed_garbage_count;
+      removed_garbage_bytes_ += removed_garbage_bytes;
+    }
+
     void LinkSst(uint64_t sst_file_number) {
       assert(newly_linked_ssts_.find(sst_file_number) ==
              newly_linked_ssts_.end());
@@ -160,8 +179,13 @@ class VersionBuilder::Rep {
 
    private:
     std::shared_ptr<SharedBlobFileMetaData> shared_meta_;
+    // Set if the blob file was relocated by the blob garbage collection job;
+    // replaces the shared metadata of the blob file
+    std::shared_ptr<SharedBlobFileMetaData> relocated_shared_meta_;
     uint64_t additional_garbage_count_ = 0;
     uint64_t additional_garbage_bytes_ = 0;
+    uint64_t removed_garbage_count_ = 0;
+    uint64_t removed_garbage_bytes_ = 0;
     std::unordered_set<uint64_t> newly_linked_ssts_;
     std::unordered_set<uint64_t> newly_unlinked_ssts_;
   };
@@ -221,13 +245,15 @@ class VersionBuilder::Rep {
   }
 
   void UnrefFile(FileMetaData* f) {
-    f->refs--;
-    if (f->refs <= 0) {
+    if (--f->refs <= 0) {
       if (f->table_reader_handle) {
         assert(table_cache_ != nullptr);
         table_cache_->ReleaseHandle(f->table_reader_handle);
         f->table_reader_handle = nullptr;
       }
+      if (table_cache_ != nullptr) {
+        TableCache::ReleasePinnedTableHandle(table_cache_->get_cache(), f);
+      }
       delete f;
     }
   }
@@ -436,6 +462,16 @@ class VersionBuilder::Rep {
       return Status::Corruption("VersionBuilder", oss.str());
     }
 
+    auto shared_meta = CreateSharedMetaData(blob_file_addition);
+
+    blob_file_meta_deltas_[blob_file_number].SetSharedMeta(
+        std::move(shared_meta));
+
+    return Status::OK();
+  }
+
+  std::shared_ptr<SharedBlobFileMetaData> CreateSharedMetaData(
+      const BlobFileAddition& blob_file_addition) const {
     // Note: we use C++11 for now but in C++14, this could be done in a more
     // elegant way using generalized lambda capture.
     VersionSet* const vs = version_set_;
@@ -447,23 +483,30 @@ class VersionBuilder::Rep {
         assert(!ioptions->cf_paths.empty());
         assert(shared_meta);
 
-        vs->AddObsoleteBlobFile(shared_meta->GetBlobFileNumber(),
+        vs->AddObsoleteBlobFile(shared_meta->GetPhysicalBlobFileNumber(),
                                 ioptions->cf_paths.front().path);
       }
 
       delete shared_meta;
     };
 
-    auto shared_meta = SharedBlobFileMetaData::Create(
-        blob_file_number, blob_file_addition.GetTotalBlobCount(),
+    if (blob_file_addition.IsRelocated()) {
+      return SharedBlobFileMetaData::Create(
+          blob_file_addition.GetBlobFileNumber(),
+          blob_file_addition.GetTotalBlobCount(),
+          blob_file_addition.GetTotalBlobBytes(),
+          blob_file_addition.GetChecksumMethod(),
+          blob_file_addition.GetChecksumValue(),
+          blob_file_addition.GetPhysicalBlobFileNumber(),
+          blob_file_addition.GetOffsetMap(), deleter);
+    }
+
+    return SharedBlobFileMetaData::Create(
+        blob_file_addition.GetBlobFileNumber(),
+        blob_file_addition.GetTotalBlobCount(),
         blob_file_addition.GetTotalBlobBytes(),
         blob_file_addition.GetChecksumMethod(),
         blob_file_addition.GetChecksumValue(), deleter);
-
-    blob_file_meta_deltas_[blob_file_number].SetSharedMeta(
-        std::move(shared_meta));
-
-    return Status::OK();
   }
 
   Status ApplyBlobFileGarbage(const BlobFileGarbage& blob_file_garbage) {
@@ -483,6 +526,85 @@ class VersionBuilder::Rep {
     return Status::OK();
   }
 
+  Status ApplyBlobFileRelocation(
+      const BlobFileRelocation& blob_file_relocation) {
+    const uint64_t blob_file_number = blob_file_relocation.GetBlobFileNumber();
+
+    // The blob file can be dropped by a compaction while its blobs are being
+    // relocated, in which case the relocation is moot.
+    if (!IsBlobFileInVersion(blob_file_number)) {
+      return Status::OK();
+    }
+
+    uint64_t total_blob_count = 0;
+    uint64_t garbage_blob_count = 0;
+    uint64_t garbage_blob_bytes = 0;
+
+    bool is_new_blob_file = false;
+
+    auto delta_it = blob_file_meta_deltas_.find(blob_file_number);
+    if (delta_it != blob_file_meta_deltas_.end()) {
+      const BlobFileMetaDataDelta& delta = delta_it->second;
+
+      is_new_blob_file = delta.GetSharedMeta() != nullptr;
+
+      const auto& shared_meta = delta.GetRelocatedSharedMeta()
+                                    ? delta.GetRelocatedSharedMeta()
+                                    : delta.GetSharedMeta();
+      if (shared_meta) {
+        total_blob_count = shared_meta->GetTotalBlobCount();
+      }
+
+      garbage_blob_count =
+          delta.GetAdditionalGarbageCount() - delta.GetRemovedGarbageCount();
+      garbage_blob_bytes =
+          delta.GetAdditionalGarbageBytes() - delta.GetRemovedGarbageBytes();
+    }
+
+    // Note: the unsigned arithmetic above may wrap around until the garbage
+    // of the base version is added.
+    if (!is_new_blob_file) {
+      assert(base_vstorage_);
+
+      const auto& base_blob_files = base_vstorage_->GetBlobFiles();
+      auto base_it = base_blob_files.find(blob_file_number);
+      assert(base_it != base_blob_files.end());
+
+      const auto& base_meta = base_it->second;
+      assert(base_meta);
+
+      if (!total_blob_count) {
+        total_blob_count = base_meta->GetTotalBlobCount();
+      }
+
+      garbage_blob_count += base_meta->GetGarbageBlobCount();
+      garbage_blob_bytes += base_meta->GetGarbageBlobBytes();
+    }
+
+    const BlobFileAddition& relocated_file =
+        blob_file_relocation.GetRelocatedFile();
+
+    if (blob_file_relocation.GetRemovedGarbageBlobCount() >
+            garbage_blob_count ||
+        blob_file_relocation.GetRemovedGarbageBlobBytes() >
+            garbage_blob_bytes ||
+        relocated_file.GetTotalBlobCount() +
+                blob_file_relocation.GetRemovedGarbageBlobCount() !=
+            total_blob_count) {
+      std::ostringstream oss;
+      oss << "Inconsistent relocation of blob file #" << blob_file_number;
+
+      return Status::Corruption("VersionBuilder", oss.str());
+    }
+
+    blob_file_meta_deltas_[blob_file_number].Relocate(
+        CreateSharedMetaData(relocated_file),
+        blob_file_relocation.GetRemovedGarbageBlobCount(),
+        blob_file_relocation.GetRemovedGarbageBlobBytes());
+
+    return Status::OK();
+  }
+
   int GetCurrentLevelForTableFile(uint64_t file_number) const {
     auto it = table_file_levels_.find(file_number);
     if (it != table_file_levels_.end()) {
@@ -679,6 +801,14 @@ class VersionBuilder::Rep {
       }
     }
 
+    // Replace the blob files relocated by the blob garbage collection job
+    for (const auto& blob_file_relocation : edit->GetBlobFileRelocations()) {
+      const Status s = ApplyBlobFileRelocation(blob_file_relocation);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
     // Delete table files
     for (const auto& deleted_file : edit->GetDeletedFiles()) {
       const int level = deleted_file.first;
@@ -727,14 +857,18 @@ class VersionBuilder::Rep {
 
   static std::shared_ptr<BlobFileMetaData> CreateMetaDataForNewBlobFile(
       const BlobFileMetaDataDelta& delta) {
-    auto shared_meta = delta.GetSharedMeta();
+    auto shared_meta = delta.GetRelocatedSharedMeta();
+    if (!shared_meta) {
+      shared_meta = delta.GetSharedMeta();
+    }
     assert(shared_meta);
 
     assert(delta.GetNewlyUnlinkedSsts().empty());
 
     auto meta = BlobFileMetaData::Create(
         std::move(shared_meta), delta.GetNewlyLinkedSsts(),
-        delta.GetAdditionalGarbageCount(), delta.GetAdditionalGarbageBytes());
+        delta.GetAdditionalGarbageCount() - delta.GetRemovedGarbageCount(),
+        delta.GetAdditionalGarbageBytes() - delta.GetRemovedGarbageBytes());
 
     return meta;
   }
@@ -750,7 +884,10 @@ class VersionBuilder::Rep {
       return base_meta;
     }
 
-    auto shared_meta = base_meta->GetSharedMeta();
+    auto shared_meta = delta.GetRelocatedSharedMeta();
+    if (!shared_meta) {
+      shared_meta = base_meta->GetSharedMeta();
+    }
     assert(shared_meta);
 
     auto linked_ssts = ApplyLinkedSstChanges(base_meta->GetLinkedSsts(),
@@ -759,8 +896,10 @@ class VersionBuilder::Rep {
 
     auto meta = BlobFileMetaData::Create(
         std::move(shared_meta), std::move(linked_ssts),
-        base_meta->GetGarbageBlobCount() + delta.GetAdditionalGarbageCount(),
-        base_meta->GetGarbageBlobBytes() + delta.GetAdditionalGarbageBytes());
+        base_meta->GetGarbageBlobCount() + delta.GetAdditionalGarbageCount() -
+            delta.GetRemovedGarbageCount(),
+        base_meta->GetGarbageBlobBytes() + delta.GetAdditionalGarbageBytes() -
+            delta.GetRemovedGarbageBytes());
 
     return meta;
   }
@@ -880,12 +1019,21 @@ class VersionBuilder::Rep {
   }
 
   void SaveSSTFilesTo(VersionStorageInfo* vstorage) {
+    const bool share_levels = vstorage->shares_level_files() &&
+                              base_vstorage_->shares_level_files();
     for (int level = 0; level < num_levels_; level++) {
+      const auto& unordered_added_files = levels_[level].added_files;
+      if (share_levels && unordered_added_files.empty() &&
+          levels_[level].deleted_files.empty()) {
+        // The level is the same as in the base version
+        vstorage->ShareLevelFiles(*base_vstorage_, level);
+        continue;
+      }
+
       const auto& cmp = (level == 0) ? level_zero_cmp_ : level_nonzero_cmp_;
       // Merge the set of added files with the set of pre-existing files.
       // Drop any deleted files.  Store the result in *v.
       const auto& base_files = base_vstorage_->LevelFiles(level);
-      const auto& unordered_added_files = levels_[level].added_files;
       vstorage->Reserve(level,
                         base_files.size() + unordered_added_files.size());
 
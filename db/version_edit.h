@@ -16,6 +16,7 @@
 
 #include "db/blob/blob_file_addition.h"
 #include "db/blob/blob_file_garbage.h"
+#include "db/blob/blob_file_relocation.h"
 #include "db/dbformat.h"
 #include "db/wal_edit.h"
 #include "memory/arena.h"
@@ -54,6 +55,7 @@ enum Tag : uint32_t {
 
   kBlobFileAddition = 400,
   kBlobFileGarbage,
+  kBlobFileRelocation,
 
   // Mask for an unidentified tag from the future which can be safely ignored.
   kTagSafeIgnoreMask = 1 << 13,
@@ -158,6 +160,33 @@ struct FileSampledStats {
   mutable std::atomic<uint64_t> num_reads_sampled;
 };
 
+// Reference count of a FileMetaData. It is atomic because new versions are
+// built outside the DB mutex (see VersionSet::ProcessManifestWrites) while
+// others are released under it. Copies start from the count of the original.
+struct FileRefCount : public std::atomic<int> {
+  FileRefCount() : std::atomic<int>(0) {}
+  FileRefCount(const FileRefCount& other) : std::atomic<int>(other.load()) {}
+  FileRefCount& operator=(const FileRefCount& other) {
+    store(other.load());
+    return *this;
+  }
+  using std::atomic<int>::operator=;
+};
+
+// Table cache handle pinned by the first read of a file whose table reader
+// was not loaded with its version (see TableCache::MaybePinTableHandle), so
+// later reads skip the table cache. It is set at most once and released with
+// the file, and copies of a FileMetaData start without one.
+struct PinnedTableHandle {
+  PinnedTableHandle() = default;
+  PinnedTableHandle(const PinnedTableHandle& /*other*/) {}
+  PinnedTableHandle& operator=(const PinnedTableHandle& /*other*/) {
+    return *this;
+  }
+
+  mutable std::atomic<Cache::Handle*> handle{nullptr};
+};
+
 struct FileMetaData {
   FileDescriptor fd;
   InternalKey smallest;            // Smallest internal key served by table
@@ -165,6 +194,8 @@ struct FileMetaData {
 
   // Needs to be disposed when refs becomes 0.
   Cache::Handle* table_reader_handle = nullptr;
+  // Also needs to be disposed when refs becomes 0.
+  PinnedTableHandle pinned_table_handle;
 
   FileSampledStats stats;
 
@@ -181,7 +212,7 @@ struct FileMetaData {
   uint64_t raw_key_size = 0;    // total uncompressed key size.
   uint64_t raw_value_size = 0;  // total uncompressed value size.
 
-  int refs = 0;  // Reference count
+  FileRefCount refs;  // Reference count
 
   bool being_compacted = false;       // Is this file undergoing compaction?
   bool init_stats_from_file = false;  // true if the data-entry stats of this
@@ -461,6 +492,18 @@ class VersionEdit {
     blob_file_garbages_ = std::move(blob_file_garbages);
   }
 
+  // Record that the live blobs of an existing blob file were relocated to a
+  // new physical file by the blob garbage collection job.
+  void AddBlobFileRelocation(BlobFileRelocation blob_file_relocation) {
+    blob_file_relocations_.emplace_back(std::move(blob_file_relocation));
+  }
+
+  // Retrieve all the blob file relocations added.
+  using BlobFileRelocations = std::vector<BlobFileRelocation>;
+  const BlobFileRelocations& GetBlobFileRelocations() const {
+    return blob_file_relocations_;
+  }
+
   // Add a WAL (either just created or closed).
   // AddWal and DeleteWalsBefore cannot be called on the same VersionEdit.
   void AddWal(WalNumber number, WalMetadata metadata = WalMetadata()) {
@@ -494,7 +537,8 @@ class VersionEdit {
   size_t NumEntries() const {
     return new_files_.size() + deleted_files_.size() +
            blob_file_additions_.size() + blob_file_garbages_.size() +
-           wal_additions_.size() + !wal_deletion_.IsEmpty();
+           blob_file_relocations_.size() + wal_additions_.size() +
+           !wal_deletion_.IsEmpty();
   }
 
   void SetColumnFamily(uint32_t column_family_id) {
@@ -590,6 +634,7 @@ class VersionEdit {
 
   BlobFileAdditions blob_file_additions_;
   BlobFileGarbages blob_file_garbages_;
+  BlobFileRelocations blob_file_relocations_;
 
   WalAdditions wal_additions_;
   WalDeletion wal_deletion_;
@@ -126,6 +126,34 @@ Status FileChecksumRetriever::ApplyVersionEdit(VersionEdit& edit,
       return s;
     }
   }
+  for (const auto& blob_file_relocation : edit.GetBlobFileRelocations()) {
+    const BlobFileAddition& relocated_file =
+        blob_file_relocation.GetRelocatedFile();
+    const uint64_t blob_file_number = relocated_file.GetBlobFileNumber();
+    uint64_t& physical_blob_file_number =
+        physical_blob_file_numbers_[blob_file_number];
+    if (physical_blob_file_number == kInvalidBlobFileNumber) {
+      physical_blob_file_number = blob_file_number;
+    }
+    Status s =
+        file_checksum_list_.RemoveOneFileChecksum(physical_blob_file_number);
+    if (!s.ok() && !s.IsNotFound()) {
+      return s;
+    }
+    physical_blob_file_number = relocated_file.GetPhysicalBlobFileNumber();
+    std::string checksum_value = relocated_file.GetChecksumValue();
+    std::string checksum_method = relocated_file.GetChecksumMethod();
+    assert(checksum_value.empty() == checksum_method.empty());
+    if (checksum_method.empty()) {
+      checksum_value = kUnknownFileChecksum;
+      checksum_method = kUnknownFileChecksumFuncName;
+    }
+    s = file_checksum_list_.InsertOneFileChecksum(
+        physical_blob_file_number, checksum_value, checksum_method);
+    if (!s.ok()) {
+      return s;
+    }
+  }
   return Status::OK();
 }
 
@@ -399,6 +427,10 @@ void VersionEditHandler::CheckIterationResult(const log::Reader& reader,
       if (read_only_) {
         cfd->table_cache()->SetTablesAreImmortal();
       }
+      if (version_set_->db_options_->open_tables_lazily) {
+        // The tables are opened on first access instead
+        continue;
+      }
       *s = LoadTables(cfd, /*prefetch_index_and_filter_in_cache=*/false,
                       /*is_initial_load=*/true);
       if (!s->ok()) {
@@ -707,10 +739,25 @@ Status VersionEditHandlerPointInTime::MaybeCreateVersion(
 
   uint64_t missing_blob_file_num = prev_missing_blob_file_high;
   for (const auto& elem : edit.GetBlobFileAdditions()) {
-    uint64_t file_num = elem.GetBlobFileNumber();
-    s = VerifyBlobFile(cfd, file_num, elem);
+    // The blobs of a relocated blob file, as written by MANIFEST snapshots,
+    // are in the file it was relocated to
+    s = VerifyBlobFile(cfd, elem.GetPhysicalBlobFileNumber(), elem);
+    if (s.IsPathNotFound() || s.IsNotFound() || s.IsCorruption()) {
+      missing_blob_file_num =
+          std::max(missing_blob_file_num, elem.GetBlobFileNumber());
+      s = Status::OK();
+    } else if (!s.ok()) {
+      break;
+    }
+  }
+
+  for (const auto& elem : edit.GetBlobFileRelocations()) {
+    const BlobFileAddition& relocated_file = elem.GetRelocatedFile();
+    s = VerifyBlobFile(cfd, relocated_file.GetPhysicalBlobFileNumber(),
+                       relocated_file);
     if (s.IsPathNotFound() || s.IsNotFound() || s.IsCorruption()) {
-      missing_blob_file_num = std::max(missing_blob_file_num, file_num);
+      missing_blob_file_num = std::max(missing_blob_file_num,
+                                       relocated_file.GetBlobFileNumber());
       s = Status::OK();
     } else if (!s.ok()) {
       break;
@@ -85,6 +85,8 @@ class FileChecksumRetriever : public VersionEditHandlerBase {
 
  private:
   FileChecksumList& file_checksum_list_;
+  // The files the blobs of relocated blob files are stored in
+  std::unordered_map<uint64_t, uint64_t> physical_blob_file_numbers_;
 };
 
 using VersionBuilderUPtr = std::unique_ptr<BaseReferencedVersionBuilder>;
@@ -311,6 +311,45 @@ TEST_F(VersionEditTest, BlobFileAdditionAndGarbage) {
   TestEncodeDecode(edit);
 }
 
+TEST_F(VersionEditTest, BlobFileRelocation) {
+  VersionEdit edit;
+
+  for (uint64_t blob_file_number = 1; blob_file_number <= 10;
+       ++blob_file_number) {
+    const uint64_t physical_blob_file_number = blob_file_number + 100;
+
+    BlobOffsetMap offset_map;
+    offset_map.AddRun(blob_file_number << 10, 42);
+    offset_map.AddRun(blob_file_number << 11, 1024);
+
+    BlobFileAddition relocated_file(blob_file_number, 123, 4567, "Hash",
+                                    "Value");
+    relocated_file.SetRelocation(physical_blob_file_number,
+                                 std::move(offset_map));
+
+    edit.AddBlobFileRelocation(
+        BlobFileRelocation(std::move(relocated_file), 89, 101112));
+  }
+
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+
+  VersionEdit decoded;
+  ASSERT_OK(decoded.DecodeFrom(encoded));
+  ASSERT_EQ(decoded.GetBlobFileRelocations(), edit.GetBlobFileRelocations());
+
+  const auto& relocated_file =
+      decoded.GetBlobFileRelocations().front().GetRelocatedFile();
+  ASSERT_TRUE(relocated_file.IsRelocated());
+  ASSERT_EQ(relocated_file.GetPhysicalBlobFileNumber(), 101);
+  ASSERT_EQ(relocated_file.GetOffsetMap().Translate(1024), 42);
+  ASSERT_EQ(relocated_file.GetOffsetMap().Translate(1034), 52);
+  ASSERT_EQ(relocated_file.GetOffsetMap().Translate(2048), 1024);
+  ASSERT_EQ(relocated_file.GetOffsetMap().Translate(1000), 0);
+}
+
 TEST_F(VersionEditTest, AddWalEncodeDecode) {
   VersionEdit edit;
   for (uint64_t log_number = 1; log_number <= 20; log_number++) {
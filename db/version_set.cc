@@ -60,6 +60,7 @@
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 #include "util/coding.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/user_comparator_wrapper.h"
@@ -762,7 +763,36 @@ class FilePickerMultiGet {
 };
 }  // anonymous namespace
 
-VersionStorageInfo::~VersionStorageInfo() { delete[] files_; }
+VersionStorageInfo::~VersionStorageInfo() {
+  // Versions release the file sets of their levels before, see
+  // Version::~Version()
+  for (LevelFileSet* file_set : level_file_sets_) {
+    if (file_set != nullptr && file_set->refs.fetch_sub(1) == 1) {
+      delete file_set;
+    }
+  }
+  delete[] files_;
+}
+
+VersionStorageInfo::LevelFileSet::LevelFileSet()
+    : index_cache([]() {
+        // Numbers the file sets of all column families
+        static std::atomic<uint64_t> next_files_id{1};
+        return next_files_id.fetch_add(1, std::memory_order_relaxed);
+      }()) {}
+
+bool VersionStorageInfo::ReleaseLevelFiles(int level) {
+  LevelFileSet* const file_set = level_file_sets_[level];
+  if (file_set == nullptr) {
+    return true;
+  }
+  level_file_sets_[level] = nullptr;
+  if (file_set->refs.fetch_sub(1) > 1) {
+    return false;
+  }
+  delete file_set;
+  return true;
+}
 
 Version::~Version() {
   assert(refs_ == 0);
@@ -771,13 +801,15 @@ Version::~Version() {
   prev_->next_ = next_;
   next_->prev_ = prev_;
 
-  // Drop references to files
+  // Drop references to files, unless a newer version shares them
   for (int level = 0; level < storage_info_.num_levels_; level++) {
+    if (!storage_info_.ReleaseLevelFiles(level)) {
+      continue;
+    }
     for (size_t i = 0; i < storage_info_.files_[level].size(); i++) {
       FileMetaData* f = storage_info_.files_[level][i];
       assert(f->refs > 0);
-      f->refs--;
-      if (f->refs <= 0) {
+      if (--f->refs <= 0) {
         assert(cfd_ != nullptr);
         uint32_t path_id = f->fd.GetPathId();
         assert(path_id < cfd_->ioptions()->cf_paths.size());
@@ -1513,7 +1545,8 @@ void Version::GetColumnFamilyMetaData(ColumnFamilyMetaData* cf_meta) {
   for (const auto& iter : vstorage->GetBlobFiles()) {
     const auto meta = iter.second.get();
     cf_meta->blob_files.emplace_back(
-        meta->GetBlobFileNumber(), BlobFileName("", meta->GetBlobFileNumber()),
+        meta->GetPhysicalBlobFileNumber(),
+        BlobFileName("", meta->GetPhysicalBlobFileNumber()),
         ioptions->cf_paths.front().path, meta->GetBlobFileSize(),
         meta->GetTotalBlobCount(), meta->GetTotalBlobBytes(),
         meta->GetGarbageBlobCount(), meta->GetGarbageBlobBytes(),
@@ -1537,7 +1570,8 @@ void Version::GetCreationTimeOfOldestFile(uint64_t* creation_time) {
   uint64_t oldest_time = port::kMaxUint64;
   for (int level = 0; level < storage_info_.num_non_empty_levels_; level++) {
     for (FileMetaData* meta : storage_info_.LevelFiles(level)) {
-      assert(meta->fd.table_reader != nullptr);
+      assert(meta->fd.table_reader != nullptr ||
+             vset_->db_options_->open_tables_lazily);
       uint64_t file_creation_time = meta->TryGetFileCreationTime();
       if (file_creation_time == kUnknownFileCreationTime) {
         *creation_time = 0;
@@ -1741,6 +1775,7 @@ VersionStorageInfo::VersionStorageInfo(
       file_indexer_(user_comparator),
       compaction_style_(compaction_style),
       files_(new std::vector<FileMetaData*>[num_levels_]),
+      level_file_sets_(num_levels_, nullptr),
       base_level_(num_levels_ == 1 ? -1 : 1),
       level_multiplier_(0.0),
       files_by_compaction_pri_(num_levels_),
@@ -1807,15 +1842,13 @@ Version::Version(ColumnFamilyData* column_family_data, VersionSet* vset,
       max_file_size_for_l0_meta_pin_(
           MaxFileSizeForL0MetaPin(mutable_cf_options_)),
       version_number_(version_number),
-      io_tracer_(io_tracer) {}
+      io_tracer_(io_tracer) {
+  storage_info_.shares_level_files_ = true;
+}
 
 Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
                         const Slice& blob_index_slice, PinnableSlice* value,
                         uint64_t* bytes_read) const {
-  if (read_options.read_tier == kBlockCacheTier) {
-    return Status::Incomplete("Cannot read blob: no disk I/O allowed");
-  }
-
   BlobIndex blob_index;
 
   {
@@ -1825,6 +1858,27 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
     }
   }
 
+  if (read_options.read_tier == kBlockCacheTier) {
+    // Only the blob cache may be read
+    assert(blob_file_cache_);
+    const auto& blob_files = storage_info_.GetBlobFiles();
+    const auto it = blob_files.find(blob_index.file_number());
+    if (!blob_index.HasTTL() && !blob_index.IsInlined() &&
+        it != blob_files.end()) {
+      const auto& meta = it->second;
+      assert(meta);
+      if (blob_file_cache_->LookupBlob(
+              meta->GetPhysicalBlobFileNumber(),
+              meta->GetPhysicalOffset(blob_index.offset()), value)) {
+        if (bytes_read) {
+          *bytes_read = 0;
+        }
+        return Status::OK();
+      }
+    }
+    return Status::Incomplete("Cannot read blob: no disk I/O allowed");
+  }
+
   return GetBlob(read_options, user_key, blob_index, value, bytes_read);
 }
 
@@ -1839,17 +1893,28 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
 
   const auto& blob_files = storage_info_.GetBlobFiles();
 
-  const uint64_t blob_file_number = blob_index.file_number();
-
-  const auto it = blob_files.find(blob_file_number);
+  const auto it = blob_files.find(blob_index.file_number());
   if (it == blob_files.end()) {
     return Status::Corruption("Invalid blob file number");
   }
 
+  // The blob file may have been relocated by the blob garbage collection job
+  const auto& meta = it->second;
+  assert(meta);
+  const uint64_t blob_file_number = meta->GetPhysicalBlobFileNumber();
+  const uint64_t offset = meta->GetPhysicalOffset(blob_index.offset());
+
+  assert(blob_file_cache_);
+  if (blob_file_cache_->LookupBlob(blob_file_number, offset, value)) {
+    if (bytes_read) {
+      *bytes_read = 0;
+    }
+    return Status::OK();
+  }
+
   CacheHandleGuard<BlobFileReader> blob_file_reader;
 
   {
-    assert(blob_file_cache_);
     const Status s = blob_file_cache_->GetBlobFileReader(blob_file_number,
                                                          &blob_file_reader);
     if (!s.ok()) {
@@ -1859,8 +1924,11 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
 
   assert(blob_file_reader.GetValue());
   const Status s = blob_file_reader.GetValue()->GetBlob(
-      read_options, user_key, blob_index.offset(), blob_index.size(),
+      read_options, user_key, offset, blob_index.size(),
       blob_index.compression(), value, bytes_read);
+  if (s.ok() && read_options.fill_cache) {
+    blob_file_cache_->InsertBlob(blob_file_number, offset, *value);
+  }
 
   return s;
 }
@@ -1868,28 +1936,24 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
 void Version::MultiGetBlob(
     const ReadOptions& read_options, MultiGetRange& range,
     std::unordered_map<uint64_t, BlobReadRequests>& blob_rqs) {
-  if (read_options.read_tier == kBlockCacheTier) {
-    Status s = Status::Incomplete("Cannot read blob(s): no disk I/O allowed");
-    for (const auto& elem : blob_rqs) {
-      for (const auto& blob_rq : elem.second) {
-        const KeyContext& key_context = blob_rq.second;
-        assert(key_context.s);
-        assert(key_context.s->ok());
-        *(key_context.s) = s;
-        assert(key_context.get_context);
-        auto& get_context = *(key_context.get_context);
-        get_context.MarkKeyMayExist();
-      }
-    }
-    return;
-  }
-
   assert(!blob_rqs.empty());
   Status status;
   const auto& blob_files = storage_info_.GetBlobFiles();
+  const bool no_io = read_options.read_tier == kBlockCacheTier;
+  assert(blob_file_cache_);
+  // The reads of all the blob files are issued together
+  std::vector<uint64_t> blob_file_numbers;
+  std::vector<CacheHandleGuard<BlobFileReader>> blob_file_readers;
+  std::vector<BlobFileReader::MultiGetRequest> requests;
+  std::vector<autovector<std::reference_wrapper<const KeyContext>>>
+      blob_read_key_contexts;
+  blob_file_numbers.reserve(blob_rqs.size());
+  blob_file_readers.reserve(blob_rqs.size());
+  requests.reserve(blob_rqs.size());
+  blob_read_key_contexts.reserve(blob_rqs.size());
   for (auto& elem : blob_rqs) {
-    uint64_t blob_file_number = elem.first;
-    if (blob_files.find(blob_file_number) == blob_files.end()) {
+    const auto meta_it = blob_files.find(elem.first);
+    if (meta_it == blob_files.end()) {
       auto& blobs_in_file = elem.second;
       for (const auto& blob : blobs_in_file) {
         const KeyContext& key_context = blob.second;
@@ -1897,13 +1961,50 @@ void Version::MultiGetBlob(
       }
       continue;
     }
+
+    // The blob file may have been relocated by the blob garbage collection
+    // job; the translation of offsets preserves their order.
+    const auto& meta = meta_it->second;
+    assert(meta);
+    const uint64_t blob_file_number = meta->GetPhysicalBlobFileNumber();
+
+    auto& blobs_in_file = elem.second;
+    if (no_io || blob_file_cache_->HasBlobCache()) {
+      // Serve the blobs found in the blob cache, and only read the others
+      BlobReadRequests uncached;
+      for (const auto& blob : blobs_in_file) {
+        const auto& blob_index = blob.first;
+        const KeyContext& key_context = blob.second;
+        if (!blob_index.HasTTL() && !blob_index.IsInlined() &&
+            blob_file_cache_->LookupBlob(
+                blob_file_number, meta->GetPhysicalOffset(blob_index.offset()),
+                key_context.value)) {
+          range.AddValueSize(key_context.value->size());
+          if (range.GetValueSize() > read_options.value_size_soft_limit) {
+            *(key_context.s) = Status::Aborted();
+          }
+        } else if (no_io) {
+          assert(key_context.s);
+          assert(key_context.s->ok());
+          *(key_context.s) =
+              Status::Incomplete("Cannot read blob(s): no disk I/O allowed");
+          assert(key_context.get_context);
+          key_context.get_context->MarkKeyMayExist();
+        } else {
+          uncached.push_back(blob);
+        }
+      }
+      blobs_in_file.swap(uncached);
+      if (blobs_in_file.empty()) {
+        continue;
+      }
+    }
+
     CacheHandleGuard<BlobFileReader> blob_file_reader;
-    assert(blob_file_cache_);
     status = blob_file_cache_->GetBlobFileReader(blob_file_number,
                                                  &blob_file_reader);
     assert(!status.ok() || blob_file_reader.GetValue());
 
-    auto& blobs_in_file = elem.second;
     if (!status.ok()) {
       for (const auto& blob : blobs_in_file) {
         const KeyContext& key_context = blob.second;
@@ -1925,12 +2026,8 @@ void Version::MultiGetBlob(
           return lhs.first.offset() < rhs.first.offset();
         });
 
-    autovector<std::reference_wrapper<const KeyContext>> blob_read_key_contexts;
-    autovector<std::reference_wrapper<const Slice>> user_keys;
-    autovector<uint64_t> offsets;
-    autovector<uint64_t> value_sizes;
-    autovector<Status*> statuses;
-    autovector<PinnableSlice*> values;
+    BlobFileReader::MultiGetRequest request;
+    autovector<std::reference_wrapper<const KeyContext>> key_contexts;
     for (const auto& blob : blobs_in_file) {
       const auto& blob_index = blob.first;
       const KeyContext& key_context = blob.second;
@@ -1940,7 +2037,7 @@ void Version::MultiGetBlob(
         continue;
       }
       const uint64_t key_size = key_context.ukey_with_ts.size();
-      const uint64_t offset = blob_index.offset();
+      const uint64_t offset = meta->GetPhysicalOffset(blob_index.offset());
       const uint64_t value_size = blob_index.size();
       if (!IsValidBlobOffset(offset, key_size, value_size, file_size)) {
         *(key_context.s) = Status::Corruption("Invalid blob offset");
@@ -1951,27 +2048,41 @@ void Version::MultiGetBlob(
             Status::Corruption("Compression type mismatch when reading a blob");
         continue;
       }
-      blob_read_key_contexts.emplace_back(std::cref(key_context));
-      user_keys.emplace_back(std::cref(key_context.ukey_with_ts));
-      offsets.push_back(blob_index.offset());
-      value_sizes.push_back(blob_index.size());
-      statuses.push_back(key_context.s);
-      values.push_back(key_context.value);
-    }
-    blob_file_reader.GetValue()->MultiGetBlob(read_options, user_keys, offsets,
-                                              value_sizes, statuses, values,
-                                              /*bytes_read=*/nullptr);
-    size_t num = blob_read_key_contexts.size();
-    assert(num == user_keys.size());
-    assert(num == offsets.size());
-    assert(num == value_sizes.size());
-    assert(num == statuses.size());
-    assert(num == values.size());
-    for (size_t i = 0; i < num; ++i) {
-      if (statuses[i]->ok()) {
-        range.AddValueSize(blob_read_key_contexts[i].get().value->size());
+      key_contexts.emplace_back(std::cref(key_context));
+      request.user_keys.emplace_back(std::cref(key_context.ukey_with_ts));
+      request.offsets.push_back(offset);
+      request.value_sizes.push_back(blob_index.size());
+      request.statuses.push_back(key_context.s);
+      request.values.push_back(key_context.value);
+    }
+    if (key_contexts.empty()) {
+      continue;
+    }
+    request.reader = blob_file_reader.GetValue();
+    blob_file_numbers.push_back(blob_file_number);
+    blob_file_readers.emplace_back(std::move(blob_file_reader));
+    requests.emplace_back(std::move(request));
+    blob_read_key_contexts.emplace_back(std::move(key_contexts));
+  }
+  if (requests.empty()) {
+    return;
+  }
+
+  BlobFileReader::MultiGetBlob(read_options, requests,
+                               /*bytes_read=*/nullptr);
+  for (size_t f = 0; f < requests.size(); ++f) {
+    const BlobFileReader::MultiGetRequest& request = requests[f];
+    const auto& key_contexts = blob_read_key_contexts[f];
+    assert(key_contexts.size() == request.statuses.size());
+    for (size_t i = 0; i < key_contexts.size(); ++i) {
+      if (request.statuses[i]->ok()) {
+        if (read_options.fill_cache) {
+          blob_file_cache_->InsertBlob(blob_file_numbers[f],
+                                       request.offsets[i], *request.values[i]);
+        }
+        range.AddValueSize(key_contexts[i].get().value->size());
         if (range.GetValueSize() > read_options.value_size_soft_limit) {
-          *(blob_read_key_contexts[i].get().s) = Status::Aborted();
+          *(key_contexts[i].get().s) = Status::Aborted();
         }
       }
     }
@@ -2589,11 +2700,40 @@ bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
          level == storage_info_.num_non_empty_levels() - 1;
 }
 
+void VersionStorageInfo::GenerateFileIndexer() {
+  if (!shares_level_files_) {
+    file_indexer_.UpdateIndex(&arena_, num_non_empty_levels_, files_);
+    return;
+  }
+  // The index of a level against the next one is computed again only if
+  // one of them changed since the base version
+  std::vector<FileIndexer::LevelIndexCache*> caches(num_non_empty_levels_,
+                                                    nullptr);
+  for (int level = 0; level < num_non_empty_levels_; level++) {
+    if (level_file_sets_[level] != nullptr) {
+      caches[level] = &level_file_sets_[level]->index_cache;
+    }
+  }
+  file_indexer_.UpdateIndex(&arena_, num_non_empty_levels_, files_,
+                            caches.data());
+}
+
 void VersionStorageInfo::GenerateLevelFilesBrief() {
   level_files_brief_.resize(num_non_empty_levels_);
   for (int level = 0; level < num_non_empty_levels_; level++) {
-    DoGenerateLevelFilesBrief(
-        &level_files_brief_[level], files_[level], &arena_);
+    LevelFileSet* const file_set = level_file_sets_[level];
+    if (file_set == nullptr) {
+      DoGenerateLevelFilesBrief(&level_files_brief_[level], files_[level],
+                                &arena_);
+      continue;
+    }
+    // Generated once for all the versions sharing the level
+    if (!file_set->has_brief) {
+      DoGenerateLevelFilesBrief(&file_set->brief, files_[level],
+                                &file_set->arena);
+      file_set->has_brief = true;
+    }
+    level_files_brief_[level] = file_set->brief;
   }
 }
 
@@ -2751,7 +2891,8 @@ void VersionStorageInfo::ComputeCompensatedSizes() {
 }
 
 int VersionStorageInfo::MaxInputLevel() const {
-  if (compaction_style_ == kCompactionStyleLevel) {
+  if (compaction_style_ == kCompactionStyleLevel ||
+      compaction_style_ == kCompactionStyleHybrid) {
     return num_levels() - 2;
   }
   return 0;
@@ -2959,6 +3100,34 @@ void VersionStorageInfo::ComputeCompactionScore(
               std::max(score, static_cast<double>(total_size) / l0_target_size);
         }
       }
+    } else if (compaction_style_ == kCompactionStyleHybrid &&
+               level < immutable_options.compaction_options_hybrid
+                           .FirstLevelOfTieredLevel(
+                               immutable_options.compaction_options_hybrid
+                                   .num_tiered_levels)) {
+      // A tiered level spans one physical level per sorted run it may hold.
+      // Its score is the number of its runs that are not being compacted
+      // over that capacity, and is kept on its first physical level only.
+      // Levels emptied below its newest run are free capacity too: the
+      // picker moves the runs above them down to make room (see
+      // HybridCompactionPicker).
+      const CompactionOptionsHybrid& hybrid =
+          immutable_options.compaction_options_hybrid;
+      score = 0;
+      for (int t = 0, start = 1; t < hybrid.num_tiered_levels; t++) {
+        const int max_runs = hybrid.MaxSortedRuns(t);
+        if (start == level) {
+          int num_sorted_runs = 0;
+          for (int i = level; i < level + max_runs; i++) {
+            if (!files_[i].empty() && !files_[i][0]->being_compacted) {
+              num_sorted_runs++;
+            }
+          }
+          score = static_cast<double>(num_sorted_runs) / max_runs;
+          break;
+        }
+        start += max_runs;
+      }
     } else {
       // Compute the ratio of current size to size limit.
       uint64_t level_bytes_no_compacting = 0;
@@ -3239,9 +3408,27 @@ void VersionStorageInfo::AddFile(int level, FileMetaData* f) {
 
   const uint64_t file_number = f->fd.GetNumber();
 
-  assert(file_locations_.find(file_number) == file_locations_.end());
-  file_locations_.emplace(file_number,
-                          FileLocation(level, level_files.size() - 1));
+  assert(!GetFileLocation(file_number).IsValid());
+  LevelFileSet*& file_set = level_file_sets_[level];
+  if (file_set == nullptr) {
+    file_set = new LevelFileSet;
+  }
+  assert(file_set->refs.load() == 1);
+  file_set->positions.emplace(file_number, level_files.size() - 1);
+}
+
+void VersionStorageInfo::ShareLevelFiles(const VersionStorageInfo& base,
+                                         int level) {
+  assert(shares_level_files_ && base.shares_level_files_);
+  assert(level < num_levels_ && level < base.num_levels_);
+  assert(files_[level].empty() && level_file_sets_[level] == nullptr);
+
+  files_[level] = base.files_[level];
+  LevelFileSet* const file_set = base.level_file_sets_[level];
+  if (file_set != nullptr) {
+    file_set->refs.fetch_add(1);
+    level_file_sets_[level] = file_set;
+  }
 }
 
 void VersionStorageInfo::AddBlobFile(
@@ -3315,12 +3502,13 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
-void SortFileByOverlappingRatio(
+// Compute, for every file in `files`, the total size of the files in
+// `next_level_files` whose key range overlaps with it. Both vectors must be
+// sorted by key and non-overlapping within themselves.
+void ComputeNextLevelOverlappingBytes(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
     const std::vector<FileMetaData*>& next_level_files,
-    std::vector<Fsize>* temp) {
-  std::unordered_map<uint64_t, uint64_t> file_to_order;
+    std::unordered_map<uint64_t, uint64_t>* file_to_overlapping_bytes) {
   auto next_level_it = next_level_files.begin();
 
   for (auto& file : files) {
@@ -3342,9 +3530,23 @@ void SortFileByOverlappingRatio(
       next_level_it++;
     }
 
+    (*file_to_overlapping_bytes)[file->fd.GetNumber()] = overlapping_bytes;
+  }
+}
+
+// Sort `temp` based on ratio of overlapping size over file size
+void SortFileByOverlappingRatio(
+    const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
+    const std::vector<FileMetaData*>& next_level_files,
+    std::vector<Fsize>* temp) {
+  std::unordered_map<uint64_t, uint64_t> file_to_order;
+  ComputeNextLevelOverlappingBytes(icmp, files, next_level_files,
+                                   &file_to_order);
+
+  for (auto& file : files) {
     assert(file->compensated_file_size != 0);
-    file_to_order[file->fd.GetNumber()] =
-        overlapping_bytes * 1024u / file->compensated_file_size;
+    uint64_t& order = file_to_order[file->fd.GetNumber()];
+    order = order * 1024u / file->compensated_file_size;
   }
 
   std::sort(temp->begin(), temp->end(),
@@ -3353,6 +3555,57 @@ void SortFileByOverlappingRatio(
                      file_to_order[f2.file->fd.GetNumber()];
             });
 }
+
+// Sort `temp` so that files promising the largest read I/O savings per byte
+// of compaction write come first.
+//
+// A sampled read of a file at this level that does not find its key there
+// goes on to probe the next level. Compacting the file away removes that
+// extra probe for its key range, so the read benefit is estimated as the
+// sampled reads of the file weighted by the fraction of the merged range's
+// data that lives in the next level. The write cost is the number of bytes
+// the compaction rewrites, i.e. the file plus its overlapping files. Ties
+// (typically files that have not been read at all) are broken by the
+// kMinOverlappingRatio order so cold data still compacts write-efficiently.
+void SortFileByReadAmpBenefit(
+    const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
+    const std::vector<FileMetaData*>& next_level_files,
+    std::vector<Fsize>* temp) {
+  std::unordered_map<uint64_t, uint64_t> file_to_overlapping_bytes;
+  ComputeNextLevelOverlappingBytes(icmp, files, next_level_files,
+                                   &file_to_overlapping_bytes);
+
+  struct Score {
+    double read_benefit_per_byte;
+    uint64_t overlapping_ratio;
+  };
+  std::unordered_map<uint64_t, Score> file_to_score;
+  for (auto& file : files) {
+    assert(file->compensated_file_size != 0);
+    const uint64_t overlapping_bytes =
+        file_to_overlapping_bytes[file->fd.GetNumber()];
+    const uint64_t reads =
+        file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+    const double write_cost = static_cast<double>(
+        file->compensated_file_size + overlapping_bytes);
+    const double read_benefit =
+        static_cast<double>(reads) * static_cast<double>(overlapping_bytes) /
+        write_cost;
+    file_to_score[file->fd.GetNumber()] = {
+        read_benefit / write_cost,
+        overlapping_bytes * 1024u / file->compensated_file_size};
+  }
+
+  std::sort(temp->begin(), temp->end(),
+            [&](const Fsize& f1, const Fsize& f2) -> bool {
+              const Score& s1 = file_to_score[f1.file->fd.GetNumber()];
+              const Score& s2 = file_to_score[f2.file->fd.GetNumber()];
+              if (s1.read_benefit_per_byte != s2.read_benefit_per_byte) {
+                return s1.read_benefit_per_byte > s2.read_benefit_per_byte;
+              }
+              return s1.overlapping_ratio < s2.overlapping_ratio;
+            });
+}
 }  // namespace
 
 void VersionStorageInfo::UpdateFilesByCompactionPri(
@@ -3404,6 +3657,10 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
         SortFileByOverlappingRatio(*internal_comparator_, files_[level],
                                    files_[level + 1], &temp);
         break;
+      case kReadAmpBenefitRatio:
+        SortFileByReadAmpBenefit(*internal_comparator_, files_[level],
+                                 files_[level + 1], &temp);
+        break;
       default:
         assert(false);
     }
@@ -3851,7 +4108,10 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableOptions& ioptions,
 
   level_max_bytes_.resize(ioptions.num_levels);
   if (!ioptions.level_compaction_dynamic_level_bytes) {
-    base_level_ = (ioptions.compaction_style == kCompactionStyleLevel) ? 1 : -1;
+    base_level_ = (ioptions.compaction_style == kCompactionStyleLevel ||
+                   ioptions.compaction_style == kCompactionStyleHybrid)
+                      ? 1
+                      : -1;
 
     // Calculate for static bytes base case
     for (int i = 0; i < ioptions.num_levels; ++i) {
@@ -3978,6 +4238,18 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableOptions& ioptions,
       }
     }
   }
+
+  if (compaction_style_ == kCompactionStyleHybrid &&
+      ioptions.compaction_options_hybrid.num_leveled_levels > 1 &&
+      num_levels_ > 1) {
+    // The upper of the two leveled levels is sized relative to the last
+    // level, as with level_compaction_dynamic_level_bytes.
+    const int level = num_levels_ - 2;
+    level_max_bytes_[level] = std::max(
+        options.max_bytes_for_level_base,
+        static_cast<uint64_t>(NumLevelBytes(num_levels_ - 1) /
+                              options.max_bytes_for_level_multiplier));
+  }
 }
 
 uint64_t VersionStorageInfo::EstimateLiveDataSize() const {
@@ -4073,7 +4345,7 @@ void Version::AddLiveFiles(std::vector<uint64_t>* live_table_files,
     const auto& meta = pair.second;
     assert(meta);
 
-    live_blob_files->emplace_back(meta->GetBlobFileNumber());
+    live_blob_files->emplace_back(meta->GetPhysicalBlobFileNumber());
   }
 }
 
@@ -4253,12 +4525,20 @@ VersionSet::VersionSet(const std::string& dbname,
       db_session_id_(db_session_id) {}
 
 VersionSet::~VersionSet() {
+  WaitForManifestCheckpoint();
+  ReleaseManifestCheckpoint(true /* delete_manifest */);
   // we need to delete column_family_set_ because its destructor depends on
   // VersionSet
   column_family_set_.reset();
   for (auto& file : obsolete_files_) {
+    const bool pinned =
+        file.metadata->table_reader_handle != nullptr ||
+        file.metadata->pinned_table_handle.handle.load() != nullptr;
     if (file.metadata->table_reader_handle) {
       table_cache_->Release(file.metadata->table_reader_handle);
+    }
+    TableCache::ReleasePinnedTableHandle(table_cache_, file.metadata);
+    if (pinned) {
       TableCache::Evict(table_cache_, file.metadata->fd.GetNumber());
     }
     file.DeleteMetadata();
@@ -4268,6 +4548,8 @@ VersionSet::~VersionSet() {
 }
 
 void VersionSet::Reset() {
+  WaitForManifestCheckpoint();
+  ReleaseManifestCheckpoint(true /* delete_manifest */);
   if (column_family_set_) {
     WriteBufferManager* wbm = column_family_set_->write_buffer_manager();
     WriteController* wc = column_family_set_->write_controller();
@@ -4440,19 +4722,6 @@ Status VersionSet::ProcessManifestWrites(
         batch_edits.push_back(e);
       }
     }
-    for (int i = 0; i < static_cast<int>(versions.size()); ++i) {
-      assert(!builder_guards.empty() &&
-             builder_guards.size() == versions.size());
-      auto* builder = builder_guards[i]->version_builder();
-      Status s = builder->SaveTo(versions[i]->storage_info());
-      if (!s.ok()) {
-        // free up the allocated memory
-        for (auto v : versions) {
-          delete v;
-        }
-        return s;
-      }
-    }
   }
 
 #ifndef NDEBUG
@@ -4492,8 +4761,39 @@ Status VersionSet::ProcessManifestWrites(
 #endif  // NDEBUG
 
   assert(pending_manifest_file_number_ == 0);
-  if (!descriptor_log_ ||
-      manifest_file_size_ > db_options_->max_manifest_file_size) {
+  // A new manifest file is written from the current state anyway. The
+  // background write is waited for once the DB mutex is released.
+  const bool drop_manifest_checkpoint =
+      manifest_checkpoint_ != nullptr &&
+      (!descriptor_log_ || new_descriptor_log);
+  // Switch to the manifest file written in the background once it is ready
+  bool from_manifest_checkpoint = false;
+  if (manifest_checkpoint_ != nullptr && !drop_manifest_checkpoint &&
+      manifest_checkpoint_->done.load(std::memory_order_acquire)) {
+    if (manifest_checkpoint_->status.ok()) {
+      from_manifest_checkpoint = true;
+      new_descriptor_log = true;
+      pending_manifest_file_number_ =
+          manifest_checkpoint_->manifest_file_number;
+    } else {
+      ROCKS_LOG_WARN(db_options_->info_log,
+                     "Failed to write manifest %" PRIu64 " in background: %s",
+                     manifest_checkpoint_->manifest_file_number,
+                     manifest_checkpoint_->status.ToString().c_str());
+      ReleaseManifestCheckpoint(true /* delete_manifest */);
+    }
+  }
+  if (from_manifest_checkpoint) {
+    TEST_SYNC_POINT("VersionSet::ProcessManifestWrites:SwitchToNewManifest");
+  } else if (descriptor_log_ && !new_descriptor_log &&
+             manifest_file_size_ > db_options_->max_manifest_file_size &&
+             db_options_->background_manifest_rollover) {
+    if (manifest_checkpoint_ == nullptr) {
+      StartManifestCheckpoint();
+    }
+    pending_manifest_file_number_ = manifest_file_number_;
+  } else if (!descriptor_log_ ||
+             manifest_file_size_ > db_options_->max_manifest_file_size) {
     TEST_SYNC_POINT("VersionSet::ProcessManifestWrites:BeforeNewManifest");
     new_descriptor_log = true;
   } else {
@@ -4506,7 +4806,9 @@ Status VersionSet::ProcessManifestWrites(
   std::unordered_map<uint32_t, MutableCFState> curr_state;
   VersionEdit wal_additions;
   if (new_descriptor_log) {
-    pending_manifest_file_number_ = NewFileNumber();
+    if (!from_manifest_checkpoint) {
+      pending_manifest_file_number_ = NewFileNumber();
+    }
     batch_edits.back()->SetNextFile(next_file_number_.load());
 
     // if we are writing out new snapshot make sure to persist max column
@@ -4515,15 +4817,19 @@ Status VersionSet::ProcessManifestWrites(
       first_writer.edit_list.front()->SetMaxColumnFamily(
           column_family_set_->GetMaxColumnFamily());
     }
-    for (const auto* cfd : *column_family_set_) {
-      assert(curr_state.find(cfd->GetID()) == curr_state.end());
-      curr_state.emplace(std::make_pair(
-          cfd->GetID(),
-          MutableCFState(cfd->GetLogNumber(), cfd->GetFullHistoryTsLow())));
-    }
+    // The snapshot of a manifest file written in the background is taken
+    // already
+    if (!from_manifest_checkpoint) {
+      for (const auto* cfd : *column_family_set_) {
+        assert(curr_state.find(cfd->GetID()) == curr_state.end());
+        curr_state.emplace(std::make_pair(
+            cfd->GetID(),
+            MutableCFState(cfd->GetLogNumber(), cfd->GetFullHistoryTsLow())));
+      }
 
-    for (const auto& wal : wals_.GetWals()) {
-      wal_additions.AddWal(wal.first, wal.second);
+      for (const auto& wal : wals_.GetWals()) {
+        wal_additions.AddWal(wal.first, wal.second);
+      }
     }
   }
 
@@ -4534,10 +4840,28 @@ Status VersionSet::ProcessManifestWrites(
   {
     FileOptions opt_file_opts = fs_->OptimizeForManifestWrite(file_options_);
     mu->Unlock();
+    if (drop_manifest_checkpoint) {
+      WaitForManifestCheckpoint();
+    }
     TEST_SYNC_POINT("VersionSet::LogAndApply:WriteManifestStart");
     TEST_SYNC_POINT_CALLBACK("VersionSet::LogAndApply:WriteManifest", nullptr);
     if (!first_writer.edit_list.front()->IsColumnFamilyManipulation()) {
+      // Build the new versions without holding the DB mutex. Only the thread
+      // at the front of manifest_writers_ touches the builders, their base
+      // versions are pinned, and files are reference counted atomically, so
+      // readers and writers waiting on the mutex are not held up by the
+      // O(number of files) merge of each column family.
       for (int i = 0; i < static_cast<int>(versions.size()); ++i) {
+        assert(!builder_guards.empty() &&
+               builder_guards.size() == versions.size());
+        s = builder_guards[i]->version_builder()->SaveTo(
+            versions[i]->storage_info());
+        if (!s.ok()) {
+          break;
+        }
+      }
+      TEST_SYNC_POINT("VersionSet::ProcessManifestWrites:AfterBuildVersions");
+      for (int i = 0; s.ok() && i < static_cast<int>(versions.size()); ++i) {
         assert(!builder_guards.empty() &&
                builder_guards.size() == versions.size());
         assert(!mutable_cf_options_ptrs.empty() &&
@@ -4558,28 +4882,32 @@ Status VersionSet::ProcessManifestWrites(
       }
     }
 
-    if (s.ok() && new_descriptor_log) {
+    if (s.ok() && from_manifest_checkpoint) {
+      // The snapshot is already written, copy the records appended to the
+      // current manifest file since then
+      ROCKS_LOG_INFO(db_options_->info_log,
+                     "Switching to manifest %" PRIu64 " with %" ROCKSDB_PRIszt
+                     " records appended after its snapshot\n",
+                     pending_manifest_file_number_,
+                     manifest_checkpoint_->tail.size());
+      descriptor_log_ = std::move(manifest_checkpoint_->log);
+      for (const auto& record : manifest_checkpoint_->tail) {
+        io_s = descriptor_log_->AddRecord(record);
+        if (!io_s.ok()) {
+          manifest_io_status = io_s;
+          s = io_s;
+          break;
+        }
+      }
+    } else if (s.ok() && new_descriptor_log) {
       // This is fine because everything inside of this block is serialized --
       // only one thread can be here at the same time
       // create new manifest file
       ROCKS_LOG_INFO(db_options_->info_log, "Creating manifest %" PRIu64 "\n",
                      pending_manifest_file_number_);
-      std::string descriptor_fname =
-          DescriptorFileName(dbname_, pending_manifest_file_number_);
-      std::unique_ptr<FSWritableFile> descriptor_file;
-      io_s = NewWritableFile(fs_.get(), descriptor_fname, &descriptor_file,
-                             opt_file_opts);
+      io_s = NewManifestWriter(pending_manifest_file_number_, opt_file_opts,
+                               &descriptor_log_);
       if (io_s.ok()) {
-        descriptor_file->SetPreallocationBlockSize(
-            db_options_->manifest_preallocation_size);
-        FileTypeSet tmp_set = db_options_->checksum_handoff_file_types;
-        std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
-            std::move(descriptor_file), descriptor_fname, opt_file_opts, clock_,
-            io_tracer_, nullptr, db_options_->listeners, nullptr,
-            tmp_set.Contains(FileType::kDescriptorFile),
-            tmp_set.Contains(FileType::kDescriptorFile)));
-        descriptor_log_.reset(
-            new log::Writer(std::move(file_writer), 0, false));
         s = WriteCurrentStateToManifest(curr_state, wal_additions,
                                         descriptor_log_.get(), io_s);
       } else {
@@ -4624,6 +4952,10 @@ Status VersionSet::ProcessManifestWrites(
           manifest_io_status = io_s;
           break;
         }
+        if (manifest_checkpoint_ != nullptr && !from_manifest_checkpoint) {
+          // Also goes to the manifest file being written in the background
+          manifest_checkpoint_->tail.push_back(std::move(record));
+        }
       }
       if (s.ok()) {
         io_s = SyncManifest(db_options_, descriptor_log_->file());
@@ -4667,6 +4999,13 @@ Status VersionSet::ProcessManifestWrites(
     mu->Lock();
   }
 
+  if (from_manifest_checkpoint) {
+    // The new manifest file is deleted below if it could not be written
+    ReleaseManifestCheckpoint(false /* delete_manifest */);
+  } else if (drop_manifest_checkpoint) {
+    ReleaseManifestCheckpoint(true /* delete_manifest */);
+  }
+
   if (s.ok()) {
     // Apply WAL edits, DB mutex must be held.
     for (auto& e : batch_edits) {
@@ -5351,15 +5690,9 @@ Status VersionSet::ReduceNumberOfLevels(const std::string& dbname,
 
     new_last_level = vstorage->LevelFiles(first_nonempty_level);
 
-    for (size_t i = 0; i < new_last_level.size(); ++i) {
-      const FileMetaData* const meta = new_last_level[i];
-      assert(meta);
-
-      const uint64_t file_number = meta->fd.GetNumber();
-
-      vstorage->file_locations_[file_number] =
-          VersionStorageInfo::FileLocation(new_levels - 1, i);
-    }
+    // The positions of the files on the level do not change
+    std::swap(vstorage->level_file_sets_[new_levels - 1],
+              vstorage->level_file_sets_[first_nonempty_level]);
   }
 
   delete[] vstorage -> files_;
@@ -5423,7 +5756,8 @@ Status VersionSet::GetLiveFilesChecksumInfo(FileChecksumList* checksum_list) {
         checksum_method = kUnknownFileChecksumFuncName;
       }
 
-      s = checksum_list->InsertOneFileChecksum(blob_file_number, checksum_value,
+      s = checksum_list->InsertOneFileChecksum(meta->GetPhysicalBlobFileNumber(),
+                                               checksum_value,
                                                checksum_method);
       if (!s.ok()) {
         return s;
@@ -5484,6 +5818,134 @@ void VersionSet::MarkMinLogNumberToKeep2PC(uint64_t number) {
   }
 }
 
+IOStatus VersionSet::NewManifestWriter(uint64_t manifest_file_number,
+                                       const FileOptions& file_opts,
+                                       std::unique_ptr<log::Writer>* log) {
+  std::string descriptor_fname =
+      DescriptorFileName(dbname_, manifest_file_number);
+  std::unique_ptr<FSWritableFile> descriptor_file;
+  IOStatus io_s = NewWritableFile(fs_.get(), descriptor_fname,
+                                  &descriptor_file, file_opts);
+  if (io_s.ok()) {
+    descriptor_file->SetPreallocationBlockSize(
+        db_options_->manifest_preallocation_size);
+    FileTypeSet tmp_set = db_options_->checksum_handoff_file_types;
+    std::unique_ptr<WritableFileWriter> file_writer(new WritableFileWriter(
+        std::move(descriptor_file), descriptor_fname, file_opts, clock_,
+        io_tracer_, nullptr, db_options_->listeners, nullptr,
+        tmp_set.Contains(FileType::kDescriptorFile),
+        tmp_set.Contains(FileType::kDescriptorFile)));
+    log->reset(new log::Writer(std::move(file_writer), 0, false));
+  }
+  return io_s;
+}
+
+void VersionSet::StartManifestCheckpoint() {
+  assert(manifest_checkpoint_ == nullptr);
+  std::unique_ptr<ManifestCheckpoint> checkpoint(new ManifestCheckpoint());
+  checkpoint->manifest_file_number = NewFileNumber();
+  checkpoint->file_opts = fs_->OptimizeForManifestWrite(file_options_);
+  for (auto cfd : *column_family_set_) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    assert(cfd->initialized());
+    cfd->Ref();
+    Version* v = cfd->current();
+    v->Ref();
+    checkpoint->versions.push_back(v);
+    checkpoint->curr_state.emplace(
+        cfd->GetID(),
+        MutableCFState(cfd->GetLogNumber(), cfd->GetFullHistoryTsLow()));
+  }
+  for (const auto& wal : wals_.GetWals()) {
+    checkpoint->wal_additions.AddWal(wal.first, wal.second);
+  }
+  checkpoint->min_log_number_to_keep = min_log_number_to_keep_2pc();
+  ROCKS_LOG_INFO(db_options_->info_log,
+                 "Creating manifest %" PRIu64 " in background\n",
+                 checkpoint->manifest_file_number);
+
+  // Manifest writes are as urgent as flushes
+  checkpoint->pri = env_->GetBackgroundThreads(Env::Priority::HIGH) > 0
+                        ? Env::Priority::HIGH
+                        : Env::Priority::LOW;
+  checkpoint->version_set = this;
+  manifest_checkpoint_ = std::move(checkpoint);
+  ManifestCheckpoint* c = manifest_checkpoint_.get();
+  env_->Schedule(&VersionSet::BGWorkManifestCheckpoint, c, c->pri,
+                 c /* tag */);
+}
+
+void VersionSet::BGWorkManifestCheckpoint(void* arg) {
+  ManifestCheckpoint* checkpoint = reinterpret_cast<ManifestCheckpoint*>(arg);
+  checkpoint->version_set->WriteManifestCheckpoint(checkpoint);
+}
+
+void VersionSet::WriteManifestCheckpoint(ManifestCheckpoint* checkpoint) {
+  TEST_SYNC_POINT("VersionSet::WriteManifestCheckpoint:Start");
+  IOStatus io_s = NewManifestWriter(checkpoint->manifest_file_number,
+                                    checkpoint->file_opts, &checkpoint->log);
+  Status s = io_s;
+  if (io_s.ok()) {
+    s = WriteVersionsToManifest(checkpoint->versions, checkpoint->curr_state,
+                                checkpoint->wal_additions,
+                                checkpoint->min_log_number_to_keep,
+                                checkpoint->log.get(), io_s);
+  }
+  if (s.ok()) {
+    s = SyncManifest(db_options_, checkpoint->log->file());
+  }
+  {
+    MutexLock l(&checkpoint->mutex);
+    checkpoint->status = s;
+    checkpoint->done.store(true, std::memory_order_release);
+    checkpoint->cv.SignalAll();
+  }
+  // The checkpoint may be released from here on
+  TEST_SYNC_POINT("VersionSet::WriteManifestCheckpoint:Done");
+}
+
+void VersionSet::WaitForManifestCheckpoint() {
+  ManifestCheckpoint* c = manifest_checkpoint_.get();
+  if (c == nullptr || c->done.load(std::memory_order_acquire)) {
+    return;
+  }
+  MutexLock l(&c->mutex);
+  if (env_->UnSchedule(c, c->pri) > 0) {
+    c->status = Status::Incomplete("Manifest rollover cancelled");
+    c->done.store(true, std::memory_order_release);
+    return;
+  }
+  while (!c->done.load(std::memory_order_acquire)) {
+    c->cv.Wait();
+  }
+}
+
+void VersionSet::ReleaseManifestCheckpoint(bool delete_manifest) {
+  if (manifest_checkpoint_ == nullptr) {
+    return;
+  }
+  assert(manifest_checkpoint_->done.load(std::memory_order_acquire));
+  for (Version* v : manifest_checkpoint_->versions) {
+    ColumnFamilyData* cfd = v->cfd();
+    v->Unref();
+    cfd->UnrefAndTryDelete();
+  }
+  if (delete_manifest) {
+    manifest_checkpoint_->log.reset();
+    Status s = env_->DeleteFile(
+        DescriptorFileName(dbname_, manifest_checkpoint_->manifest_file_number));
+    if (!s.ok() && !s.IsNotFound()) {
+      ROCKS_LOG_WARN(db_options_->info_log,
+                     "Failed to delete manifest %" PRIu64 ": %s",
+                     manifest_checkpoint_->manifest_file_number,
+                     s.ToString().c_str());
+    }
+  }
+  manifest_checkpoint_.reset();
+}
+
 Status VersionSet::WriteCurrentStateToManifest(
     const std::unordered_map<uint32_t, MutableCFState>& curr_state,
     const VersionEdit& wal_additions, log::Writer* log, IOStatus& io_s) {
@@ -5494,7 +5956,27 @@ Status VersionSet::WriteCurrentStateToManifest(
   // This is done without DB mutex lock held, but only within single-threaded
   // LogAndApply. Column family manipulations can only happen within LogAndApply
   // (the same single thread), so we're safe to iterate.
+  std::vector<Version*> versions;
+  for (auto cfd : *column_family_set_) {
+    assert(cfd);
+
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    assert(cfd->initialized());
+    versions.push_back(cfd->current());
+  }
+  return WriteVersionsToManifest(versions, curr_state, wal_additions,
+                                 min_log_number_to_keep_2pc(), log, io_s);
+}
 
+Status VersionSet::WriteVersionsToManifest(
+    const std::vector<Version*>& versions,
+    const std::unordered_map<uint32_t, MutableCFState>& curr_state,
+    const VersionEdit& wal_additions, uint64_t min_log_number_to_keep,
+    log::Writer* log, IOStatus& io_s) {
+  // The versions and their column families are referenced, and only their
+  // immutable parts are read, so this can run without the DB mutex.
   assert(io_s.ok());
   if (db_options_->write_dbid_to_manifest) {
     VersionEdit edit_for_db_id;
@@ -5526,13 +6008,10 @@ Status VersionSet::WriteCurrentStateToManifest(
     }
   }
 
-  for (auto cfd : *column_family_set_) {
+  for (Version* v : versions) {
+    assert(v);
+    ColumnFamilyData* cfd = v->cfd();
     assert(cfd);
-
-    if (cfd->IsDropped()) {
-      continue;
-    }
-    assert(cfd->initialized());
     {
       // Store column family info
       VersionEdit edit;
@@ -5560,12 +6039,10 @@ Status VersionSet::WriteCurrentStateToManifest(
       VersionEdit edit;
       edit.SetColumnFamily(cfd->GetID());
 
-      assert(cfd->current());
-      assert(cfd->current()->storage_info());
+      assert(v->storage_info());
 
       for (int level = 0; level < cfd->NumberLevels(); level++) {
-        for (const auto& f :
-             cfd->current()->storage_info()->LevelFiles(level)) {
+        for (const auto& f : v->storage_info()->LevelFiles(level)) {
           edit.AddFile(level, f->fd.GetNumber(), f->fd.GetPathId(),
                        f->fd.GetFileSize(), f->smallest, f->largest,
                        f->fd.smallest_seqno, f->fd.largest_seqno,
@@ -5575,7 +6052,7 @@ Status VersionSet::WriteCurrentStateToManifest(
         }
       }
 
-      const auto& blob_files = cfd->current()->storage_info()->GetBlobFiles();
+      const auto& blob_files = v->storage_info()->GetBlobFiles();
       for (const auto& pair : blob_files) {
         const uint64_t blob_file_number = pair.first;
         const auto& meta = pair.second;
@@ -5583,9 +6060,18 @@ Status VersionSet::WriteCurrentStateToManifest(
         assert(meta);
         assert(blob_file_number == meta->GetBlobFileNumber());
 
-        edit.AddBlobFile(blob_file_number, meta->GetTotalBlobCount(),
-                         meta->GetTotalBlobBytes(), meta->GetChecksumMethod(),
-                         meta->GetChecksumValue());
+        BlobFileAddition blob_file_addition(
+            blob_file_number, meta->GetTotalBlobCount(),
+            meta->GetTotalBlobBytes(), meta->GetChecksumMethod(),
+            meta->GetChecksumValue());
+        if (meta->IsRelocated()) {
+          const auto& shared_meta = meta->GetSharedMeta();
+          assert(shared_meta);
+          blob_file_addition.SetRelocation(
+              shared_meta->GetPhysicalBlobFileNumber(),
+              shared_meta->GetOffsetMap());
+        }
+        edit.AddBlobFile(std::move(blob_file_addition));
         if (meta->GetGarbageBlobCount() > 0) {
           edit.AddBlobFileGarbage(blob_file_number, meta->GetGarbageBlobCount(),
                                   meta->GetGarbageBlobBytes());
@@ -5601,9 +6087,8 @@ Status VersionSet::WriteCurrentStateToManifest(
         // min_log_number_to_keep is for the whole db, not for specific column family.
         // So it does not need to be set for every column family, just need to be set once.
         // Since default CF can never be dropped, we set the min_log to the default CF here.
-        uint64_t min_log = min_log_number_to_keep_2pc();
-        if (min_log != 0) {
-          edit.SetMinLogNumberToKeep(min_log);
+        if (min_log_number_to_keep != 0) {
+          edit.SetMinLogNumberToKeep(min_log_number_to_keep);
         }
       }
 
@@ -6110,10 +6595,12 @@ uint64_t VersionSet::GetTotalBlobFileSize(Version* dummy_versions) {
     auto* vstorage = v->storage_info();
     const auto& blob_files = vstorage->GetBlobFiles();
     for (const auto& pair : blob_files) {
-      if (unique_blob_files.find(pair.first) == unique_blob_files.end()) {
+      const auto& meta = pair.second;
+      const uint64_t blob_file_number = meta->GetPhysicalBlobFileNumber();
+      if (unique_blob_files.find(blob_file_number) ==
+          unique_blob_files.end()) {
         // find Blob file that has not been counted
-        unique_blob_files.insert(pair.first);
-        const auto& meta = pair.second;
+        unique_blob_files.insert(blob_file_number);
         all_v_blob_file_size += meta->GetBlobFileSize();
       }
     }
@@ -128,6 +128,16 @@ class VersionStorageInfo {
 
   void AddFile(int level, FileMetaData* f);
 
+  // Makes `level` hold the files of the same level of `base`, sharing the
+  // references to them and what is derived from them alone, instead of
+  // adding each file again.
+  // REQUIRES: shares_level_files() of both, and no file added to `level`
+  void ShareLevelFiles(const VersionStorageInfo& base, int level);
+
+  // True for the storage of a Version, whose levels can be shared with the
+  // versions built from it (see Version::~Version())
+  bool shares_level_files() const { return shares_level_files_; }
+
   void AddBlobFile(std::shared_ptr<BlobFileMetaData> blob_file_meta);
 
   void SetFinalized();
@@ -135,9 +145,7 @@ class VersionStorageInfo {
   // Update num_non_empty_levels_.
   void UpdateNumNonEmptyLevels();
 
-  void GenerateFileIndexer() {
-    file_indexer_.UpdateIndex(&arena_, num_non_empty_levels_, files_);
-  }
+  void GenerateFileIndexer();
 
   // Update the accumulated stats from a file-meta.
   void UpdateAccumulatedStats(FileMetaData* file_meta);
@@ -324,19 +332,25 @@ class VersionStorageInfo {
 
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
   FileLocation GetFileLocation(uint64_t file_number) const {
-    const auto it = file_locations_.find(file_number);
+    for (int level = 0; level < num_levels_; ++level) {
+      const LevelFileSet* const file_set = level_file_sets_[level];
+      if (file_set == nullptr) {
+        continue;
+      }
 
-    if (it == file_locations_.end()) {
-      return FileLocation::Invalid();
-    }
+      const auto it = file_set->positions.find(file_number);
+      if (it == file_set->positions.end()) {
+        continue;
+      }
 
-    assert(it->second.GetLevel() < num_levels_);
-    assert(it->second.GetPosition() < files_[it->second.GetLevel()].size());
-    assert(files_[it->second.GetLevel()][it->second.GetPosition()]);
-    assert(files_[it->second.GetLevel()][it->second.GetPosition()]
-               ->fd.GetNumber() == file_number);
+      assert(it->second < files_[level].size());
+      assert(files_[level][it->second]);
+      assert(files_[level][it->second]->fd.GetNumber() == file_number);
+
+      return FileLocation(level, it->second);
+    }
 
-    return it->second;
+    return FileLocation::Invalid();
   }
 
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
@@ -549,10 +563,31 @@ class VersionStorageInfo {
   // in increasing order of keys
   std::vector<FileMetaData*>* files_;
 
-  // Map of all table files in version. Maps file number to (level, position on
-  // level).
-  using FileLocations = std::unordered_map<uint64_t, FileLocation>;
-  FileLocations file_locations_;
+  // The files of a level, shared by the versions of a column family in which
+  // the level holds the same files. All these versions reference each file
+  // of the level once: Version::~Version() releases the references when the
+  // last of them goes away. Maps file number to position on the level, and
+  // holds the LevelFilesBrief of the level once it is generated, and the
+  // last index of the level against the next one.
+  struct LevelFileSet {
+    LevelFileSet();
+
+    std::atomic<int> refs{1};
+    std::unordered_map<uint64_t, size_t> positions;
+    bool has_brief = false;
+    ROCKSDB_NAMESPACE::LevelFilesBrief brief;
+    Arena arena;
+    FileIndexer::LevelIndexCache index_cache;
+  };
+
+  // Returns true if no other version shares the files of `level`, in which
+  // case the caller releases the references to them.
+  bool ReleaseLevelFiles(int level);
+
+  // The file set of each level, or nullptr if the level is empty. Sized for
+  // the number of levels the storage was created with.
+  std::vector<LevelFileSet*> level_file_sets_;
+  bool shares_level_files_ = false;
 
   // Map of blob files in version by number.
   BlobFiles blob_files_;
@@ -1257,6 +1292,11 @@ class VersionSet {
   // Return the size of the current manifest file
   uint64_t manifest_file_size() const { return manifest_file_size_; }
 
+  // Cancels writing the manifest file being rolled over to in the
+  // background, if any, unless it has started, in which case it waits for it
+  // to finish. REQUIRES: DB mutex not held, no manifest writes in progress.
+  void WaitForManifestCheckpoint();
+
   Status GetMetadataForFile(uint64_t number, int* filelevel,
                             FileMetaData** metadata, ColumnFamilyData** cfd);
 
@@ -1358,6 +1398,56 @@ class VersionSet {
       const std::unordered_map<uint32_t, MutableCFState>& curr_state,
       const VersionEdit& wal_additions, log::Writer* log, IOStatus& io_s);
 
+  // Save the contents of `versions`, one per column family, to *log
+  Status WriteVersionsToManifest(
+      const std::vector<Version*>& versions,
+      const std::unordered_map<uint32_t, MutableCFState>& curr_state,
+      const VersionEdit& wal_additions, uint64_t min_log_number_to_keep,
+      log::Writer* log, IOStatus& io_s);
+
+  // Creates manifest file `manifest_file_number` and a log writer for it
+  IOStatus NewManifestWriter(uint64_t manifest_file_number,
+                             const FileOptions& file_opts,
+                             std::unique_ptr<log::Writer>* log);
+
+  // A new manifest file whose snapshot is being written in the background,
+  // see DBOptions::background_manifest_rollover.
+  struct ManifestCheckpoint {
+    VersionSet* version_set = nullptr;
+    uint64_t manifest_file_number = 0;
+    FileOptions file_opts;
+    // The versions the snapshot is taken from, referenced along with their
+    // column families
+    std::vector<Version*> versions;
+    std::unordered_map<uint32_t, MutableCFState> curr_state;
+    VersionEdit wal_additions;
+    uint64_t min_log_number_to_keep = 0;
+    // The records appended to the current manifest file since the snapshot
+    // was taken. Only accessed by the head of the manifest writers queue.
+    std::vector<std::string> tail;
+    std::unique_ptr<log::Writer> log;
+    // The thread pool the snapshot is written by
+    Env::Priority pri = Env::Priority::LOW;
+    // Set once the snapshot is synced, with status, or the write is
+    // cancelled
+    std::atomic<bool> done{false};
+    Status status;
+    port::Mutex mutex;
+    port::CondVar cv{&mutex};
+  };
+
+  // Takes a snapshot of the current versions and schedules writing it to a
+  // new manifest file in the background. REQUIRES: DB mutex held, at the head
+  // of the manifest writers queue.
+  void StartManifestCheckpoint();
+  static void BGWorkManifestCheckpoint(void* arg);
+  void WriteManifestCheckpoint(ManifestCheckpoint* checkpoint);
+  // Releases the versions of the snapshot, deleting its manifest file if
+  // `delete_manifest`, i.e. unless it was switched to. REQUIRES: DB mutex
+  // held, unless the DB is being closed; the background write done or
+  // cancelled, see WaitForManifestCheckpoint().
+  void ReleaseManifestCheckpoint(bool delete_manifest);
+
   void AppendVersion(ColumnFamilyData* column_family_data, Version* v);
 
   ColumnFamilyData* CreateColumnFamily(const ColumnFamilyOptions& cf_options,
@@ -1406,6 +1496,9 @@ class VersionSet {
   // Opened lazily
   std::unique_ptr<log::Writer> descriptor_log_;
 
+  // The manifest file being rolled over to in the background, if any
+  std::unique_ptr<ManifestCheckpoint> manifest_checkpoint_;
+
   // generates a increasing version number for every new version
   uint64_t current_version_number_;
 
@@ -718,7 +718,18 @@ async_result PosixRandomAccessFile::AsyncRead(uint64_t offset, size_t n,
                                             IOUringOptions::Ops::Read);
   }
 
-  *result = Slice(scratch, n);
+  if (data->res_set) {
+    if (data->res < 0) {
+      *result = Slice(scratch, 0);
+      co_return IOError("While reading offset " + ToString(offset) + " len " +
+                            ToString(n) + " asynchronously",
+                        filename_, -data->res);
+    }
+    // A short read means the end of the file was reached
+    *result = Slice(scratch, std::min(n, static_cast<size_t>(data->res)));
+  } else {
+    *result = Slice(scratch, n);
+  }
   co_return IOStatus::OK();
 }
 
@@ -200,6 +200,8 @@ class PosixRandomAccessFile : public FSRandomAccessFile {
                                  char* scratch,
                                  IODebugContext* dbg) const override;
 
+  virtual bool IsAsyncReadSupported() const override { return true; }
+
   virtual IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
                              const IOOptions& options,
                              IODebugContext* dbg) override;
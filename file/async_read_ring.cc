@@ -0,0 +1,64 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "file/async_read_ring.h"
+
+#include <coroutine>
+
+#include "rocksdb/async_result.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// Each reader has at most a few reads in flight, and completions beyond the
+// size of the completion queue are kept by the kernel
+constexpr unsigned kAsyncReadRingDepth = 256;
+}  // namespace
+
+AsyncReadRing::AsyncReadRing()
+    : io_uring_options_(&ring_),
+      initialized_(io_uring_queue_init(kAsyncReadRingDepth, &ring_, 0) == 0) {
+}
+
+AsyncReadRing::~AsyncReadRing() {
+  if (initialized_) {
+    io_uring_queue_exit(&ring_);
+  }
+}
+
+std::shared_ptr<AsyncReadRing> AsyncReadRing::ForThisThread() {
+  static thread_local std::shared_ptr<AsyncReadRing> thread_ring;
+  static thread_local bool created = false;
+  if (!created) {
+    created = true;
+    std::shared_ptr<AsyncReadRing> ring(new AsyncReadRing());
+    if (ring->initialized_) {
+      thread_ring = std::move(ring);
+    }
+  }
+  return thread_ring;
+}
+
+IOStatus AsyncReadRing::Reap() {
+  mutex_.AssertHeld();
+  struct io_uring_cqe* cqe = nullptr;
+  int ret;
+  do {
+    ret = io_uring_wait_cqe(&ring_, &cqe);
+  } while (ret == -EINTR || ret == -EAGAIN);
+  if (ret < 0) {
+    return IOStatus::IOError("io_uring_wait_cqe() returns " + ToString(ret));
+  }
+  FilePage* const page = static_cast<FilePage*>(io_uring_cqe_get_data(cqe));
+  page->res = cqe->res;
+  page->res_set = true;
+  io_uring_cqe_seen(&ring_, cqe);
+  std::coroutine_handle<async_result::promise_type>::from_promise(
+      *page->promise)
+      .resume();
+  return IOStatus::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
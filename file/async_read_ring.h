@@ -0,0 +1,58 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <memory>
+
+#include "port/port.h"
+#include "rocksdb/io_status.h"
+#include "rocksdb/options.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// AsyncReadRing is the io_uring that the reads a thread starts with
+// RandomAccessFileReader::AsyncRead() in the background are submitted to.
+// Each thread has one, shared by all its readers, rather than one per reader.
+//
+// Any reader waiting on the ring reaps the completions of the reads of the
+// other readers too, and records their results in their FilePage, so the
+// reads report the bytes actually read (see PosixRandomAccessFile).
+//
+// The ring is used under its mutex, as a read may be waited for by another
+// thread than the one that started it, e.g. by an iterator used from several
+// threads in turn. Readers keep a reference to the ring their read is in
+// flight on, so that it outlives its thread.
+class AsyncReadRing {
+ public:
+  // The ring of the calling thread, or nullptr if io_uring is not usable
+  static std::shared_ptr<AsyncReadRing> ForThisThread();
+
+  AsyncReadRing(const AsyncReadRing&) = delete;
+  AsyncReadRing& operator=(const AsyncReadRing&) = delete;
+
+  ~AsyncReadRing();
+
+  // To set as IOOptions::io_uring_option of the reads
+  IOUringOptions* io_uring_options() { return &io_uring_options_; }
+
+  // Held while reads are started and completions are reaped
+  port::Mutex* mutex() { return &mutex_; }
+
+  // Waits for a completion of the ring, and resumes the read it belongs to,
+  // which then completes or submits its next part. If it fails, the reads in
+  // flight can no longer be tracked, and the kernel may still write to their
+  // buffers. REQUIRES: mutex() held.
+  IOStatus Reap();
+
+ private:
+  AsyncReadRing();
+
+  struct io_uring ring_;
+  IOUringOptions io_uring_options_;
+  const bool initialized_;
+  port::Mutex mutex_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
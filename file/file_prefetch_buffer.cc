@@ -12,15 +12,28 @@
 #include <algorithm>
 #include <mutex>
 
+#include "file/async_read_ring.h"
 #include "file/random_access_file_reader.h"
 #include "monitoring/histogram.h"
 #include "monitoring/iostats_context_imp.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
+#include "util/mutexlock.h"
 #include "util/random.h"
-#include "util/rate_limiter.h"
+#include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
+
+FilePrefetchBuffer::~FilePrefetchBuffer() {
+  IOSTATS_ADD(prefetch_bytes_wasted, WastedBytes(0, 0));
+  if (async_read_ != nullptr) {
+    // The read must not outlive async_buffer_
+    Status s = WaitForAsyncRead();
+    s.PermitUncheckedError();
+    IOSTATS_ADD(prefetch_bytes_wasted, async_buffer_.CurrentSize());
+  }
+}
+
 Status FilePrefetchBuffer::Prefetch(const IOOptions& opts,
                                     RandomAccessFileReader* reader,
                                     uint64_t offset, size_t n,
@@ -73,6 +86,19 @@ Status FilePrefetchBuffer::Prefetch(const IOOptions& opts,
     }
   }
 
+  // Count the bytes dropped from the buffer without having been read. The
+  // reads are mostly forward, so those of the kept chunk are at its start.
+  const uint64_t kept_start = buffer_offset_ + chunk_offset_in_buffer;
+  const uint64_t used_in_chunk =
+      chunk_len > 0 && used_end_ > kept_start
+          ? std::min(used_end_ - kept_start, chunk_len)
+          : 0;
+  IOSTATS_ADD(prefetch_bytes_wasted, WastedBytes(chunk_len, used_in_chunk));
+  used_bytes_ = used_in_chunk;
+  if (chunk_len == 0) {
+    used_end_ = rounddown_offset;
+  }
+
   // Create a new buffer only if current capacity is not sufficient, and memcopy
   // bytes from old buffer if needed (i.e., if chunk_len is greater than 0).
   if (buffer_.Capacity() < roundup_len) {
@@ -94,6 +120,7 @@ Status FilePrefetchBuffer::Prefetch(const IOOptions& opts,
   if (!s.ok()) {
     return s;
   }
+  IOSTATS_ADD(prefetch_bytes_read, result.size());
 
 #ifndef NDEBUG
   if (result.size() < read_len) {
@@ -117,6 +144,7 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
   if (!enable_ || offset < buffer_offset_) {
     return false;
   }
+  bool straddled = false;
 
   // If the buffer contains only a few of the requested bytes:
   //    If readahead is enabled: prefetch the remaining bytes + readahead bytes
@@ -127,29 +155,32 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
       assert(file_reader_ != nullptr);
       assert(max_readahead_size_ >= readahead_size_);
       Status s;
-      if (for_compaction) {
-        s = Prefetch(opts, file_reader_, offset, std::max(n, readahead_size_),
-                     for_compaction);
-      } else {
-        if (implicit_auto_readahead_) {
-          // Prefetch only if this read is sequential otherwise reset
-          // readahead_size_ to initial value.
-          if (!IsBlockSequential(offset)) {
-            UpdateReadPattern(offset, n);
-            ResetValues();
-            // Ignore status as Prefetch is not called.
-            s.PermitUncheckedError();
-            return false;
-          }
-          num_file_reads_++;
-          if (num_file_reads_ <= kMinNumFileReadsToStartAutoReadahead) {
-            UpdateReadPattern(offset, n);
-            // Ignore status as Prefetch is not called.
-            s.PermitUncheckedError();
-            return false;
-          }
+      if (!for_compaction && implicit_auto_readahead_) {
+        // Prefetch only if this read is sequential otherwise reset
+        // readahead_size_ to initial value.
+        if (!IsBlockSequential(offset)) {
+          UpdateReadPattern(offset, n);
+          ResetValues();
+          // Ignore status as Prefetch is not called.
+          s.PermitUncheckedError();
+          return false;
+        }
+        num_file_reads_++;
+        if (num_file_reads_ <= kMinNumFileReadsToStartAutoReadahead) {
+          UpdateReadPattern(offset, n);
+          // Ignore status as Prefetch is not called.
+          s.PermitUncheckedError();
+          return false;
         }
-        s = Prefetch(opts, file_reader_, offset, n + readahead_size_,
+      }
+      // The window read in the background may have the data
+      if (async_read_ != nullptr) {
+        straddled = SwitchToAsyncBuffer(offset, n, result);
+      }
+      if (!straddled && offset + n > buffer_offset_ + buffer_.CurrentSize()) {
+        s = Prefetch(opts, file_reader_, offset,
+                     for_compaction ? std::max(n, readahead_size_)
+                                    : n + readahead_size_,
                      for_compaction);
       }
       if (!s.ok()) {
@@ -161,14 +192,139 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
 #endif
         return false;
       }
+      // While the buffer is consumed, read the next window in the background
+      if (async_io_) {
+        ReadAheadAsync(opts, for_compaction);
+      }
       readahead_size_ = std::min(max_readahead_size_, readahead_size_ * 2);
     } else {
       return false;
     }
   }
   UpdateReadPattern(offset, n);
-  uint64_t offset_in_buffer = offset - buffer_offset_;
-  *result = Slice(buffer_.BufferStart() + offset_in_buffer, n);
+  if (offset + n > used_end_) {
+    used_bytes_ += offset + n - std::max(offset, used_end_);
+    used_end_ = offset + n;
+  }
+  if (!straddled) {
+    uint64_t offset_in_buffer = offset - buffer_offset_;
+    *result = Slice(buffer_.BufferStart() + offset_in_buffer, n);
+  }
   return true;
 }
+
+void FilePrefetchBuffer::ReadAheadAsync(const IOOptions& opts,
+                                        bool for_compaction) {
+  assert(async_io_);
+  const size_t alignment = file_reader_->file()->GetRequiredBufferAlignment();
+  const uint64_t offset = buffer_offset_ + buffer_.CurrentSize();
+  // A buffer that is not a multiple of the alignment ends at the end of the
+  // file
+  if (async_read_ != nullptr || buffer_.CurrentSize() == 0 ||
+      offset % alignment != 0) {
+    return;
+  }
+  std::shared_ptr<AsyncReadRing> ring = AsyncReadRing::ForThisThread();
+  if (ring == nullptr) {
+    async_io_ = false;
+    return;
+  }
+
+  const size_t len = Roundup(readahead_size_, alignment);
+  if (async_buffer_.Capacity() < len) {
+    async_buffer_.Alignment(alignment);
+    async_buffer_.AllocateNewBuffer(len);
+  }
+  async_buffer_.Size(0);
+  async_offset_ = offset;
+  async_opts_ = opts;
+  async_opts_.io_uring_option = ring->io_uring_options();
+
+  MutexLock l(ring->mutex());
+  // Reads for compaction are charged to the rate limiter like the
+  // synchronous ones
+  async_read_.reset(new async_result(file_reader_->AsyncRead(
+      async_opts_, async_offset_, len, &async_result_,
+      async_buffer_.BufferStart(), nullptr /* aligned_buf */,
+      for_compaction)));
+  if (async_read_->await_ready()) {
+    // The read could not be submitted, so this window is left to a
+    // synchronous read
+    async_read_->io_result().PermitUncheckedError();
+    async_read_.reset();
+    return;
+  }
+  async_ring_ = std::move(ring);
+}
+
+bool FilePrefetchBuffer::SwitchToAsyncBuffer(uint64_t offset, size_t n,
+                                             Slice* result) {
+  Status s = WaitForAsyncRead();
+  if (!s.ok()) {
+    s.PermitUncheckedError();
+    async_io_ = false;
+    return false;
+  }
+  const uint64_t buffer_end = buffer_offset_ + buffer_.CurrentSize();
+  const uint64_t async_end = async_offset_ + async_buffer_.CurrentSize();
+  const bool straddles = offset >= buffer_offset_ &&
+                         buffer_end == async_offset_ && offset < buffer_end &&
+                         offset + n > buffer_end && offset + n <= async_end;
+  if (!straddles && (offset < async_offset_ || offset >= async_end)) {
+    IOSTATS_ADD(prefetch_bytes_wasted, async_buffer_.CurrentSize());
+    async_buffer_.Size(0);
+    return false;
+  }
+  if (straddles) {
+    const size_t head = static_cast<size_t>(buffer_end - offset);
+    straddle_buffer_.assign(buffer_.BufferStart() + (offset - buffer_offset_),
+                            head);
+    straddle_buffer_.append(async_buffer_.BufferStart(), n - head);
+    *result = Slice(straddle_buffer_);
+    if (buffer_end > used_end_) {
+      used_bytes_ += buffer_end - std::max(offset, used_end_);
+    }
+  }
+  IOSTATS_ADD(prefetch_bytes_wasted, WastedBytes(0, 0));
+  std::swap(buffer_, async_buffer_);
+  buffer_offset_ = async_offset_;
+  used_bytes_ = 0;
+  used_end_ = buffer_offset_;
+  return straddles;
+}
+
+Status FilePrefetchBuffer::WaitForAsyncRead() {
+  assert(async_read_ != nullptr);
+  assert(async_ring_ != nullptr);
+  IOStatus s;
+  {
+    MutexLock l(async_ring_->mutex());
+    while (!async_read_->await_ready()) {
+      s = async_ring_->Reap();
+      if (!s.ok()) {
+        // The read can no longer be tracked, and the kernel may still write
+        // to async_buffer_, so the read and the buffer are leaked
+        async_read_.release();
+        async_buffer_.Release();
+        async_io_ = false;
+        break;
+      }
+    }
+  }
+  async_ring_.reset();
+  if (!s.ok()) {
+    return s;
+  }
+  s = async_read_->io_result();
+  async_read_.reset();
+  if (!s.ok()) {
+    async_buffer_.Size(0);
+    return s;
+  }
+  assert(async_result_.size() == 0 ||
+         async_result_.data() == async_buffer_.BufferStart());
+  async_buffer_.Size(async_result_.size());
+  IOSTATS_ADD(prefetch_bytes_read, async_result_.size());
+  return s;
+}
 }  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <algorithm>
 #include <atomic>
 #include <sstream>
 #include <string>
@@ -20,6 +21,48 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class AsyncReadRing;
+
+// ReadPattern tracks the reads of a file for automatic readahead, which
+// starts over when the reads stop being sequential. It is shared by
+// FilePrefetchBuffer and BlockPrefetcher.
+class ReadPattern {
+ public:
+  void Update(size_t offset, size_t len) {
+    const size_t prev_end = prev_offset_ + prev_len_;
+    prev_skip_ = prev_len_ > 0 && offset > prev_end ? offset - prev_end : 0;
+    prev_offset_ = offset;
+    prev_len_ = len;
+  }
+
+  // Whether a read at `offset` keeps up the pattern of the previous reads, so
+  // that readahead is not reset: it follows the previous read, or skips
+  // forward by the same stride as the previous read, or skips forward by no
+  // more than the readahead size once readahead has started (readahead would
+  // have read the skipped data anyway).
+  bool IsSequential(size_t offset, bool readahead_started,
+                    size_t readahead_size, size_t max_readahead_size) const {
+    const size_t prev_end = prev_offset_ + prev_len_;
+    if (prev_len_ == 0 || offset == prev_end) {
+      return true;
+    }
+    if (offset < prev_end) {
+      return false;
+    }
+    const size_t skip = offset - prev_end;
+    if (skip == prev_skip_) {
+      return skip <= max_readahead_size;
+    }
+    return readahead_started && skip <= readahead_size;
+  }
+
+ private:
+  size_t prev_offset_ = 0;
+  size_t prev_len_ = 0;
+  // Bytes skipped between the last two reads, if forward
+  size_t prev_skip_ = 0;
+};
+
 // FilePrefetchBuffer is a smart buffer to store and read data from a file.
 class FilePrefetchBuffer {
  public:
@@ -40,7 +83,14 @@ class FilePrefetchBuffer {
   // track_min_offset : Track the minimum offset ever read and collect stats on
   //   it. Used for adaptable readahead of the file footer/metadata.
   // implicit_auto_readahead : Readahead is enabled implicitly by rocksdb after
-  //   doing sequential scans for two times.
+  //   doing sequential scans for two times. Reads skipping forward by the
+  //   same stride as the previous one, or once readahead has started, by no
+  //   more than the readahead size, still count as sequential.
+  // async_io : Once readahead has started, read the next readahead window
+  //   into a second buffer with RandomAccessFileReader::AsyncRead() while the
+  //   current one is consumed. The read is submitted to the io_uring of the
+  //   thread (see AsyncReadRing). It is ignored if the file does not support
+  //   FSRandomAccessFile::AsyncRead().
   //
   // Automatic readhead is enabled for a file if file_reader, readahead_size,
   // and max_readahead_size are passed in.
@@ -51,7 +101,8 @@ class FilePrefetchBuffer {
   FilePrefetchBuffer(RandomAccessFileReader* file_reader = nullptr,
                      size_t readahead_size = 0, size_t max_readahead_size = 0,
                      bool enable = true, bool track_min_offset = false,
-                     bool implicit_auto_readahead = false)
+                     bool implicit_auto_readahead = false,
+                     bool async_io = false)
       : buffer_offset_(0),
         file_reader_(file_reader),
         readahead_size_(readahead_size),
@@ -61,9 +112,14 @@ class FilePrefetchBuffer {
         enable_(enable),
         track_min_offset_(track_min_offset),
         implicit_auto_readahead_(implicit_auto_readahead),
-        prev_offset_(0),
-        prev_len_(0),
-        num_file_reads_(kMinNumFileReadsToStartAutoReadahead + 1) {}
+        num_file_reads_(kMinNumFileReadsToStartAutoReadahead + 1),
+        used_bytes_(0),
+        used_end_(0),
+        async_io_(async_io && file_reader != nullptr &&
+                  file_reader->file()->IsAsyncReadSupported()),
+        async_offset_(0) {}
+
+  ~FilePrefetchBuffer();
 
   // Load data into the buffer from a file.
   // reader : the file reader.
@@ -91,12 +147,13 @@ class FilePrefetchBuffer {
   size_t min_offset_read() const { return min_offset_read_; }
 
   void UpdateReadPattern(const size_t& offset, const size_t& len) {
-    prev_offset_ = offset;
-    prev_len_ = len;
+    read_pattern_.Update(offset, len);
   }
 
   bool IsBlockSequential(const size_t& offset) {
-    return (prev_len_ == 0 || (prev_offset_ + prev_len_ == offset));
+    return read_pattern_.IsSequential(
+        offset, num_file_reads_ > kMinNumFileReadsToStartAutoReadahead,
+        readahead_size_, max_readahead_size_);
   }
 
   void ResetValues() {
@@ -105,6 +162,30 @@ class FilePrefetchBuffer {
   }
 
  private:
+  // Returns the number of bytes of the buffer that were never read, if all
+  // but `chunk_len` of them, of which `used_in_chunk` were read, are dropped.
+  uint64_t WastedBytes(uint64_t chunk_len, uint64_t used_in_chunk) const {
+    const uint64_t dropped = buffer_.CurrentSize() - chunk_len;
+    const uint64_t used_in_dropped =
+        used_bytes_ - std::min(used_bytes_, used_in_chunk);
+    return dropped - std::min(dropped, used_in_dropped);
+  }
+
+  // Starts reading the readahead window following buffer_ into async_buffer_,
+  // unless a read is already in flight or the end of the file was reached.
+  void ReadAheadAsync(const IOOptions& opts, bool for_compaction);
+
+  // Waits for the read into async_buffer_ to complete, and makes async_buffer_
+  // the current buffer if it has the data at `offset`. If the `n` bytes at
+  // `offset` start in buffer_ and end in async_buffer_, they are copied to
+  // `result`, and true is returned. If the read failed, async_io is turned
+  // off, and the data is left to a synchronous read.
+  bool SwitchToAsyncBuffer(uint64_t offset, size_t n, Slice* result);
+
+  // Reaps the completions of the ring of the read into async_buffer_ until
+  // it is done.
+  Status WaitForAsyncRead();
+
   AlignedBuffer buffer_;
   uint64_t buffer_offset_;
   RandomAccessFileReader* file_reader_;
@@ -123,8 +204,25 @@ class FilePrefetchBuffer {
   // implicit_auto_readahead is enabled by rocksdb internally after 2 sequential
   // IOs.
   bool implicit_auto_readahead_;
-  size_t prev_offset_;
-  size_t prev_len_;
+  ReadPattern read_pattern_;
   int num_file_reads_;
+
+  // Bytes of buffer_ returned to callers, and the end offset of the last of
+  // them, to count the bytes that were read in vain
+  uint64_t used_bytes_;
+  uint64_t used_end_;
+
+  // State of async_io. The second buffer has the async_result_ bytes read
+  // at async_offset_ once async_read_ completes.
+  bool async_io_;
+  AlignedBuffer async_buffer_;
+  uint64_t async_offset_;
+  Slice async_result_;
+  // A read spanning both buffers
+  std::string straddle_buffer_;
+  IOOptions async_opts_;
+  // The read in flight, if any, and the ring of the thread that started it
+  std::unique_ptr<async_result> async_read_;
+  std::shared_ptr<AsyncReadRing> async_ring_;
 };
 }  // namespace ROCKSDB_NAMESPACE
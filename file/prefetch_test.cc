@@ -4,6 +4,10 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #include "db/db_test_util.h"
+#include "file/async_read_ring.h"
+#include "file/file_prefetch_buffer.h"
+#include "file/random_access_file_reader.h"
+#include "rocksdb/iostats_context.h"
 #include "test_util/sync_point.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -667,6 +671,143 @@ TEST_P(PrefetchTest, PrefetchWhenReseekwithCache) {
   Close();
 }
 
+TEST_P(PrefetchTest, ForwardSkipsKeepReadahead) {
+  // First param is if the mockFS support_prefetch or not
+  bool support_prefetch =
+      std::get<0>(GetParam()) &&
+      test::IsPrefetchSupported(env_->GetFileSystem(), dbname_);
+  std::shared_ptr<MockFS> fs =
+      std::make_shared<MockFS>(env_->GetFileSystem(), support_prefetch);
+
+  const size_t kBlockSize = 4096;
+  const size_t kFileSize = 64 * kBlockSize;
+  Random rnd(309);
+  const std::string contents = rnd.RandomString(kFileSize);
+  const std::string fname = dbname_ + "/forward_skips";
+  ASSERT_OK(env_->CreateDirIfMissing(dbname_));
+  ASSERT_OK(WriteStringToFile(env_, contents, fname));
+
+  // Second param is if directIO is enabled or not
+  FileOptions file_options;
+  file_options.use_direct_reads = std::get<1>(GetParam());
+  std::unique_ptr<FSRandomAccessFile> file;
+  IOStatus io_s = fs->NewRandomAccessFile(fname, file_options, &file, nullptr);
+  if (file_options.use_direct_reads &&
+      (io_s.IsNotSupported() || io_s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  }
+  ASSERT_OK(io_s);
+  std::unique_ptr<RandomAccessFileReader> reader(
+      new RandomAccessFileReader(std::move(file), fname));
+
+  int buff_prefetch_count = 0;
+  SyncPoint::GetInstance()->SetCallBack("FilePrefetchBuffer::Prefetch:Start",
+                                        [&](void*) { buff_prefetch_count++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  get_iostats_context()->Reset();
+  {
+    FilePrefetchBuffer prefetch_buffer(
+        reader.get(), 2 * kBlockSize /* readahead_size */,
+        16 * kBlockSize /* max_readahead_size */, true /* enable */,
+        false /* track_min_offset */, true /* implicit_auto_readahead */);
+    // Read every other block. Skipping the same number of bytes every time
+    // does not reset readahead, so all the reads after the first are served
+    // by the buffer, and each block is only read once.
+    for (size_t offset = 0; offset + kBlockSize <= kFileSize;
+         offset += 2 * kBlockSize) {
+      Slice result;
+      Status s;
+      ASSERT_TRUE(prefetch_buffer.TryReadFromCache(IOOptions(), offset,
+                                                   kBlockSize, &result, &s));
+      ASSERT_OK(s);
+      ASSERT_EQ(Slice(contents.data() + offset, kBlockSize), result);
+    }
+  }
+  ASSERT_GT(buff_prefetch_count, 0);
+  ASSERT_LT(buff_prefetch_count, 16);
+  // Half of what was prefetched was skipped
+  ASSERT_GE(get_iostats_context()->prefetch_bytes_read, kFileSize / 2);
+  ASSERT_LE(get_iostats_context()->prefetch_bytes_read, kFileSize);
+  ASSERT_EQ(get_iostats_context()->prefetch_bytes_read,
+            kFileSize / 2 + get_iostats_context()->prefetch_bytes_wasted);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_P(PrefetchTest, ReadaheadAsync) {
+  // First param is if the mockFS support_prefetch or not
+  bool support_prefetch =
+      std::get<0>(GetParam()) &&
+      test::IsPrefetchSupported(env_->GetFileSystem(), dbname_);
+  std::shared_ptr<MockFS> fs =
+      std::make_shared<MockFS>(env_->GetFileSystem(), support_prefetch);
+
+  const size_t kReadaheadSize = 16 * 1024;
+  const size_t kFileSize = 64 * kReadaheadSize + 100;
+  Random rnd(301);
+  const std::string contents = rnd.RandomString(kFileSize);
+  const std::string fname = dbname_ + "/readahead_async";
+  ASSERT_OK(env_->CreateDirIfMissing(dbname_));
+  ASSERT_OK(WriteStringToFile(env_, contents, fname));
+
+  // Second param is if directIO is enabled or not
+  FileOptions file_options;
+  file_options.use_direct_reads = std::get<1>(GetParam());
+  std::unique_ptr<FSRandomAccessFile> file;
+  IOStatus io_s = fs->NewRandomAccessFile(fname, file_options, &file, nullptr);
+  if (file_options.use_direct_reads &&
+      (io_s.IsNotSupported() || io_s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  }
+  ASSERT_OK(io_s);
+  if (!file->IsAsyncReadSupported() ||
+      AsyncReadRing::ForThisThread() == nullptr) {
+    return;
+  }
+  std::unique_ptr<RandomAccessFileReader> reader(
+      new RandomAccessFileReader(std::move(file), fname));
+
+  int buff_prefetch_count = 0;
+  SyncPoint::GetInstance()->SetCallBack("FilePrefetchBuffer::Prefetch:Start",
+                                        [&](void*) { buff_prefetch_count++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Compactions and iterators with a readahead size both double buffer
+  for (bool for_compaction : {true, false}) {
+    buff_prefetch_count = 0;
+    get_iostats_context()->Reset();
+    {
+      FilePrefetchBuffer prefetch_buffer(
+          reader.get(), kReadaheadSize, kReadaheadSize, true /* enable */,
+          false /* track_min_offset */, false /* implicit_auto_readahead */,
+          true /* async_io */);
+      // Read the file sequentially, with reads spanning the readahead
+      // windows
+      size_t offset = 0;
+      while (offset < kFileSize) {
+        const size_t n = std::min(kFileSize - offset,
+                                  static_cast<size_t>(1 + rnd.Uniform(10000)));
+        Slice result;
+        Status s;
+        ASSERT_TRUE(prefetch_buffer.TryReadFromCache(
+            IOOptions(), offset, n, &result, &s, for_compaction));
+        ASSERT_OK(s);
+        ASSERT_EQ(Slice(contents.data() + offset, n), result);
+        offset += n;
+      }
+    }
+    // Only the first window is read synchronously
+    ASSERT_EQ(1, buff_prefetch_count);
+    ASSERT_GE(get_iostats_context()->prefetch_bytes_read, kFileSize);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
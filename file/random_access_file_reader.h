@@ -148,6 +148,8 @@ class RandomAccessFileReader {
 
   const std::string& file_name() const { return file_name_; }
 
+  RateLimiter* GetRateLimiter() const { return rate_limiter_; }
+
   bool use_direct_io() const { return file_->use_direct_io(); }
 
   IOStatus PrepareIOOptions(const ReadOptions& ro, IOOptions& opts);
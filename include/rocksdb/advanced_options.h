@@ -16,6 +16,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Cache;
 class Slice;
 class SliceTransform;
 class TablePropertiesCollectorFactory;
@@ -35,6 +36,10 @@ enum CompactionStyle : char {
   // via CompactFiles().
   // Not supported in ROCKSDB_LITE
   kCompactionStyleNone = 0x3,
+  // Tiered upper levels followed by one or two leveled levels at the bottom.
+  // See CompactionOptionsHybrid.
+  // Not supported in ROCKSDB_LITE
+  kCompactionStyleHybrid = 0x4,
 };
 
 // In Level-based compaction, it Determines which file from a level to be
@@ -54,6 +59,15 @@ enum CompactionPri : char {
   // and its size is the smallest. It in many cases can optimize write
   // amplification.
   kMinOverlappingRatio = 0x3,
+  // First compact files with the largest estimated read I/O saved per byte
+  // of compaction write. The read benefit is estimated from the sampled
+  // number of reads served by the file (see
+  // SstFileMetaData::num_reads_sampled) and the share of its key range that
+  // is shadowed by overlapping data in the next level; the write cost is the
+  // file size plus the overlapping bytes in the next level. Files with no
+  // sampled reads are ordered as with kMinOverlappingRatio. Try this if
+  // reads are skewed towards a few hot key ranges.
+  kReadAmpBenefitRatio = 0x4,
 };
 
 struct CompactionOptionsFIFO {
@@ -80,6 +94,68 @@ struct CompactionOptionsFIFO {
         allow_compaction(_allow_compaction) {}
 };
 
+// Options for kCompactionStyleHybrid.
+//
+// The LSM tree is split into tiered levels on top and leveled levels at the
+// bottom. L0 is the first tiered level; it holds up to
+// level0_file_num_compaction_trigger sorted runs (its files). Each of the
+// following `num_tiered_levels` logical levels holds up to
+// MaxSortedRuns(t) sorted runs, each stored in its own physical LSM level.
+// When a tiered level holds that many runs, all of them are merged into a
+// single new run of the next tiered level, so every byte is rewritten only
+// once per tiered level. The last tiered level is merged into the first
+// leveled level, and the leveled levels are compacted like
+// kCompactionStyleLevel, which bounds space amplification.
+//
+// num_levels is derived from these options:
+//   1 + (sum of MaxSortedRuns(t) over the tiered levels) + num_leveled_levels
+struct CompactionOptionsHybrid {
+  // Number of tiered levels below L0.
+  // Default: 1
+  int num_tiered_levels = 1;
+
+  // Maximum number of sorted runs each tiered level below L0 accumulates
+  // before they are merged into the next level, unless set for the level in
+  // max_sorted_runs_per_tiered_level.
+  // Default: 4
+  int max_sorted_runs_per_level = 4;
+
+  // Maximum number of sorted runs of each tiered level below L0, from the
+  // top one. Tiered levels without an entry use max_sorted_runs_per_level.
+  // Default: empty
+  std::vector<int> max_sorted_runs_per_tiered_level;
+
+  // Number of leveled levels at the bottom of the tree; either 1 or 2. With
+  // 2, the target size of the upper leveled level is the size of the last
+  // level divided by max_bytes_for_level_multiplier (but at least
+  // max_bytes_for_level_base).
+  // Default: 2
+  int num_leveled_levels = 2;
+
+  // Maximum number of sorted runs of tiered level `t` below L0, counting
+  // from 0.
+  int MaxSortedRuns(int t) const {
+    return static_cast<size_t>(t) < max_sorted_runs_per_tiered_level.size()
+               ? max_sorted_runs_per_tiered_level[t]
+               : max_sorted_runs_per_level;
+  }
+
+  // First physical level of tiered level `t` below L0. For
+  // t == num_tiered_levels, the first leveled level.
+  int FirstLevelOfTieredLevel(int t) const {
+    int level = 1;
+    for (int i = 0; i < t; i++) {
+      level += MaxSortedRuns(i);
+    }
+    return level;
+  }
+
+  // Number of LSM levels needed for the layout described above.
+  int NumLevels() const {
+    return FirstLevelOfTieredLevel(num_tiered_levels) + num_leveled_levels;
+  }
+};
+
 // Compression options for different compression algorithms like Zlib
 struct CompressionOptions {
   // RocksDB's generic default compression level. Internally it'll be translated
@@ -625,6 +701,13 @@ struct AdvancedColumnFamilyOptions {
   // SetOptions("compaction_options_fifo", "{max_table_files_size=100;}")
   CompactionOptionsFIFO compaction_options_fifo;
 
+  // The options for hybrid (tiered+leveled) compaction style. num_levels is
+  // overridden to CompactionOptionsHybrid::NumLevels() when
+  // kCompactionStyleHybrid is used.
+  //
+  // Not dynamically changeable
+  CompactionOptionsHybrid compaction_options_hybrid;
+
   // An iteration->Next() sequentially skips over keys with the same
   // user-key unless this option is set. This number specifies the number
   // of keys (with the same userkey) that will be sequentially
@@ -869,6 +952,32 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   double blob_garbage_collection_force_threshold = 1.0;
 
+  // EXPERIMENTAL
+  // If non-zero, a background job garbage collects the blob files whose
+  // ratio of garbage bytes exceeds this threshold, independently of
+  // compactions: the live blobs of such a file are copied to a new blob file,
+  // and the blob references in the table files are redirected to the new file
+  // through an offset map recorded in the MANIFEST, without rewriting the
+  // table files. The original blob file is then deleted.
+  //
+  // Default: 0.0 (disabled)
+  //
+  // Dynamically changeable through the SetOptions() API
+  double blob_garbage_collection_job_threshold = 0.0;
+
+  // EXPERIMENTAL
+  // If non-nullptr, uncompressed blob values read from blob files are cached
+  // in this cache, keyed by blob file number and offset, so that hot blobs
+  // are not read and decompressed again. The cache can be dedicated to blobs
+  // or shared with the block cache, where the blobs are accounted as
+  // CacheEntryRole "blob-value". ReadOptions::fill_cache controls whether
+  // blobs read from files are added to it.
+  //
+  // Default: nullptr (disabled)
+  //
+  // Not dynamically changeable through SetOptions()
+  std::shared_ptr<Cache> blob_cache = nullptr;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -136,6 +136,10 @@ struct file_page {
   async_result::promise_type* promise = nullptr;
   struct iovec* iov = nullptr;
   int pages_ = 0;
+  // The result of the completion (bytes transferred, or -errno), if whoever
+  // reaped the completion recorded it
+  int res = 0;
+  bool res_set = false;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -182,6 +182,40 @@ class CompactionFilter : public Customizable {
     return Decision::kKeep;
   }
 
+  // Whether FilterBatch() should be used for plain values (ValueType::kValue)
+  // instead of calling FilterV2() once per key.
+  virtual bool SupportsFilterBatch() const { return false; }
+
+  // A batched variant of FilterV2() for plain values, used only if
+  // SupportsFilterBatch() returns true. The table file creation process reads
+  // ahead a chunk of its input and passes the user keys and values of all
+  // plain values in it at once, which allows amortizing the per-key overhead
+  // (e.g. a TTL check on a timestamp stored in every value can be vectorized).
+  //
+  // For each i in [0, num_entries), decisions[i] must be set to one of
+  //  * kKeep - keep the key-value pair.
+  //  * kRemove - remove the key-value pair.
+  //  * kChangeValue - keep the key and change the value to new_values[i].
+  //  * kUndetermined - call FilterV2() for this key as usual, e.g. to return
+  //      kRemoveAndSkipUntil.
+  // Any other decision is treated as kUndetermined. The strings in new_values
+  // are empty on entry.
+  //
+  // Since the input is read ahead, a key-value may be passed here even if
+  // FilterV2() would not have been called for it, e.g. for an older version
+  // of a user key or a key that ends up being skipped. The decisions for such
+  // entries are ignored, so the filter should not have side effects that
+  // depend on being called exactly once per surviving key.
+  virtual void FilterBatch(int /*level*/, size_t num_entries,
+                           const Slice* /*keys*/,
+                           const Slice* /*existing_values*/,
+                           Decision* decisions,
+                           std::string* /*new_values*/) const {
+    for (size_t i = 0; i < num_entries; ++i) {
+      decisions[i] = Decision::kUndetermined;
+    }
+  }
+
   // Internal (BlobDB) use only. Do not override in application code.
   virtual BlobDecision PrepareBlobOutput(const Slice& /* key */,
                                          const Slice& /* existing_value */,
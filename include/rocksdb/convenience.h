@@ -157,8 +157,8 @@ struct ConfigOptions {
 //   - CompressionType: valid values are "kNoCompression",
 //     "kSnappyCompression", "kZlibCompression", "kBZip2Compression", ...
 //   - CompactionStyle: valid values are "kCompactionStyleLevel",
-//     "kCompactionStyleUniversal", "kCompactionStyleFIFO", and
-//     "kCompactionStyleNone".
+//     "kCompactionStyleUniversal", "kCompactionStyleFIFO",
+//     "kCompactionStyleNone", and "kCompactionStyleHybrid".
 //
 
 // Take a default ColumnFamilyOptions "base_options" in addition to a
@@ -730,6 +730,10 @@ class FSRandomAccessFile {
                                  const IOOptions& options, Slice* result,
                                  char* scratch, IODebugContext* dbg) const = 0;
 
+  // true if AsyncRead() submits the read to options.io_uring_option->ioring
+  // and suspends until the completion of the read is run by the caller.
+  virtual bool IsAsyncReadSupported() const { return false; }
+
   // Readahead the file starting from offset by n bytes for caching.
   // If it's not implemented (default: `NotSupported`), RocksDB will create
   // internal prefetch buffer to improve read performance.
@@ -1469,6 +1473,9 @@ class FSRandomAccessFileWrapper : public FSRandomAccessFile {
                          IODebugContext* dbg) const override {
     return target_->AsyncRead(offset, n, options, result, scratch, dbg);
   }
+  bool IsAsyncReadSupported() const override {
+    return target_->IsAsyncReadSupported();
+  }
 
   IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
                      const IOOptions& options, IODebugContext* dbg) override {
@@ -75,6 +75,13 @@ struct IOStatsContext {
   // CPU time spent in read() and pread()
   uint64_t cpu_read_nanos;
 
+  // number of bytes read into prefetch buffers, for readahead or explicit
+  // prefetching of a range of a file.
+  uint64_t prefetch_bytes_read;
+  // number of bytes read into prefetch buffers that were discarded without
+  // being read, e.g. because a scan stopped or skipped past them.
+  uint64_t prefetch_bytes_wasted;
+
   FileIOByTemperature file_io_stats_by_temperature;
 };
 
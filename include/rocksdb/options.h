@@ -562,6 +562,25 @@ struct DBOptions {
   // Default: 16
   int max_file_opening_threads = 16;
 
+  // EXPERIMENTAL
+  // If true, DB::Open() does not open the table files of the DB, and returns
+  // once the MANIFEST and the WALs are recovered. Each table is then opened
+  // on its first access. If max_open_files is -1, a background job also
+  // opens all the tables in the LOW priority thread pool, level by level
+  // starting with L0, so that they are warm by the time they are needed. The
+  // "rocksdb.num-tables-pending-warmup" property tells how many tables it
+  // still has to open.
+  //
+  // The tables opened this way, by reads or by the warmup, are pinned to the
+  // file metadata, so later reads skip the table cache lookup.
+  //
+  // With FIFO compaction and a ttl, a table not opened yet is not compacted
+  // away by the ttl until it is opened, unless the MANIFEST records its
+  // creation time.
+  //
+  // Default: false
+  bool open_tables_lazily = false;
+
   // Once write-ahead logs exceed this size, we will start forcing the flush of
   // column families whose memtables are backed by the oldest live WAL file
   // (i.e. the ones that are causing all the space amplification). If set to 0
@@ -734,9 +753,34 @@ struct DBOptions {
   // reach the limit of storage capacity.
   uint64_t max_manifest_file_size = 1024 * 1024 * 1024;
 
+  // EXPERIMENTAL
+  // If true, the manifest file is rolled over in the background once it
+  // reaches max_manifest_file_size: a snapshot of the current versions is
+  // written to the new manifest file by a background job, in the HIGH
+  // priority thread pool like flushes, while version edits keep being
+  // appended to the old one. The next version edit after the
+  // snapshot is done copies the edits appended in the meantime to the new
+  // manifest file and switches to it. Version edits never wait for a snapshot
+  // to be written, so max_manifest_file_size can be set low enough to keep
+  // the number of edits replayed by DB::Open() small.
+  //
+  // Default: false
+  bool background_manifest_rollover = false;
+
   // Number of shards used for table cache.
   int table_cache_numshardbits = 6;
 
+  // EXPERIMENTAL
+  // If true and max_open_files is not -1, the table cache is a clock cache
+  // (see NewClockCache()), whose lookups of open tables take no mutex, instead
+  // of an LRU cache. Ignored if the clock cache is not supported by the build.
+  // With max_open_files = -1, tables are kept open for as long as they are
+  // live and their table readers are found without a table cache lookup
+  // after the first read, regardless of this option.
+  //
+  // Default: false
+  bool table_cache_use_clock_cache = false;
+
   // NOT SUPPORTED ANYMORE
   // int table_cache_remove_scan_count_limit;
 
@@ -1138,6 +1182,22 @@ struct DBOptions {
   // Default: kPointInTimeRecovery
   WALRecoveryMode wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
 
+  // EXPERIMENTAL
+  // If greater than 1, WAL replay on DB::Open() inserts the write batches
+  // into the memtables with up to this many threads. The WAL is still read
+  // and checksummed in order by one thread, which hands the batches out in
+  // groups; the threads decode the batches of a group and insert those made
+  // of plain writes concurrently, each with its own sequence numbers, and
+  // memtables are flushed between groups. If a batch inserted concurrently
+  // with later batches fails, DB::Open() fails unless paranoid_checks is off
+  // or kSkipAnyCorruptedRecords is used, as the replay cannot stop before
+  // that batch.
+  // Requires allow_concurrent_memtable_write, and is not used with allow_2pc
+  // or two_write_queues.
+  //
+  // Default: 1
+  int max_wal_recovery_threads = 1;
+
   // if set to false then recovery will fail when a prepared
   // transaction is encountered in the WAL
   bool allow_2pc = false;
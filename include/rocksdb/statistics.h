@@ -417,6 +417,20 @@ enum Tickers : uint32_t {
   REMOTE_COMPACT_READ_BYTES,
   REMOTE_COMPACT_WRITE_BYTES,
 
+  // # of times the range filter was checked by a bounded seek, and # of
+  // times it avoided reading a table.
+  RANGE_FILTER_CHECKED,
+  RANGE_FILTER_USEFUL,
+
+  // Blob cache lookups that missed and hit, blobs added to it, failures to
+  // add them, and bytes read from and written into it.
+  BLOB_DB_CACHE_MISS,
+  BLOB_DB_CACHE_HIT,
+  BLOB_DB_CACHE_ADD,
+  BLOB_DB_CACHE_ADD_FAILURES,
+  BLOB_DB_CACHE_BYTES_READ,
+  BLOB_DB_CACHE_BYTES_WRITE,
+
   TICKER_ENUM_MAX
 };
 
@@ -204,6 +204,20 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // EXPERIMENTAL: like kBinarySearch, but a piecewise linear model of the
+    // position of the index entries, fitted when the table is built, narrows
+    // down the binary search of a seek to a window of a few entries. This
+    // does not make the index smaller: the window is still searched by
+    // comparing keys, so the index keeps every separator key and block
+    // handle, and the model is stored and kept in memory on top of it. Only
+    // the restart key prefixes of format_version=6 (see below) are left out.
+    // The extra memory buys fewer key comparisons per seek. Requires
+    // index_block_restart_interval=1 (forced), and only helps with
+    // BytewiseComparator(), working best when the keys (e.g. big-endian
+    // integers) are densely or evenly distributed; with other comparators
+    // it is the same as kBinarySearch.
+    kLearnedIndexSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -212,12 +226,17 @@ struct BlockBasedTableOptions {
   enum DataBlockIndexType : char {
     kDataBlockBinarySearch = 0,   // traditional block type
     kDataBlockBinaryAndHash = 1,  // additional hash index
+    // EXPERIMENTAL: additional cuckoo hash index that points at the exact
+    // entry of each user key and covers blocks with many restart intervals.
+    // Requires format_version >= 6.
+    kDataBlockBinaryAndCuckooHash = 2,
   };
 
   DataBlockIndexType data_block_index_type = kDataBlockBinarySearch;
 
   // #entries/#buckets. It is valid only when data_block_hash_index_type is
-  // kDataBlockBinaryAndHash.
+  // kDataBlockBinaryAndHash. With kDataBlockBinaryAndCuckooHash, it is the
+  // target #entries/#slots instead, capped at 0.9.
   double data_block_hash_table_util_ratio = 0.75;
 
   // This option is now deprecated. No matter what value it is set to,
@@ -392,6 +411,11 @@ struct BlockBasedTableOptions {
   // 5 -- Can be read by RocksDB's versions since 6.6.0. Full and partitioned
   // filters use a generally faster and more accurate Bloom filter
   // implementation, with a different schema.
+  // 6 -- Can be read by RocksDB's versions since 6.27.0. Allows data blocks
+  // to use the kDataBlockBinaryAndCuckooHash data_block_index_type. With
+  // BytewiseComparator(), data and index blocks up to 64KiB also store a
+  // fixed-width prefix of the key of each restart point, which speeds up
+  // seeks within blocks at the cost of 8 bytes per restart point.
   uint32_t format_version = 5;
 
   // Store index blocks on disk in compressed format. Changing this option to
@@ -485,6 +509,32 @@ struct BlockBasedTableOptions {
 
   PrepopulateBlockCache prepopulate_block_cache =
       PrepopulateBlockCache::kDisable;
+
+  // EXPERIMENTAL
+  // If non-zero, each table reader keeps up to this many of its most
+  // frequently read data blocks pinned in the block cache, and serves reads of
+  // them from a small per-table array without looking up the (sharded) block
+  // cache. Blocks are pinned once they are read often within a window of
+  // block cache accesses of the table, and unpinned once their access count
+  // decays. Pinned blocks count toward the block cache pinned usage.
+  //
+  // Only takes effect if a block cache is configured. Default: 0 (disabled)
+  uint32_t max_pinned_hot_data_blocks = 0;
+
+  // EXPERIMENTAL
+  // If positive, tables are built with a range filter of about this many
+  // bits per key, which tells whether a table may have keys in a range of
+  // user keys. Iterators with ReadOptions::iterate_upper_bound set skip
+  // tables without keys between the seek key and the bound, without reading
+  // their index or data blocks. This helps short range scans, which
+  // otherwise read a block from every L0 file and from each level. The
+  // filter keeps a prefix of each key after the bytes shared by all keys of
+  // the table, and works best when fewer bits per key are needed to tell
+  // keys apart, e.g. with integer keys. It is kept in memory while the table
+  // is open.
+  //
+  // Only supported with BytewiseComparator(). Default: 0 (disabled)
+  double range_filter_bits_per_key = 0;
 };
 
 // Table Properties that are specific to block-based table properties.
@@ -30,6 +30,7 @@ enum class BlobFileCreationReason {
   kFlush,
   kCompaction,
   kRecovery,
+  kGarbageCollection,
 };
 
 // The types of files RocksDB uses in a DB directory. (Available for
@@ -4568,6 +4568,8 @@ class CompactionPriorityJni {
         return 0x2;
       case ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio:
         return 0x3;
+      case ROCKSDB_NAMESPACE::CompactionPri::kReadAmpBenefitRatio:
+        return 0x4;
       default:
         return 0x0;  // undefined
     }
@@ -4586,6 +4588,8 @@ class CompactionPriorityJni {
         return ROCKSDB_NAMESPACE::CompactionPri::kOldestSmallestSeqFirst;
       case 0x3:
         return ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio;
+      case 0x4:
+        return ROCKSDB_NAMESPACE::CompactionPri::kReadAmpBenefitRatio;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionPri::kByCompensatedSize;
@@ -5012,6 +5016,22 @@ class TickerTypeJni {
         return -0x22;
       case ROCKSDB_NAMESPACE::Tickers::REMOTE_COMPACT_WRITE_BYTES:
         return -0x23;
+      case ROCKSDB_NAMESPACE::Tickers::RANGE_FILTER_CHECKED:
+        return -0x24;
+      case ROCKSDB_NAMESPACE::Tickers::RANGE_FILTER_USEFUL:
+        return -0x25;
+      case ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_MISS:
+        return -0x26;
+      case ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_HIT:
+        return -0x27;
+      case ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_ADD:
+        return -0x28;
+      case ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_ADD_FAILURES:
+        return -0x29;
+      case ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_BYTES_READ:
+        return -0x2A;
+      case ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_BYTES_WRITE:
+        return -0x2B;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -5361,6 +5381,22 @@ class TickerTypeJni {
         return ROCKSDB_NAMESPACE::Tickers::REMOTE_COMPACT_READ_BYTES;
       case -0x23:
         return ROCKSDB_NAMESPACE::Tickers::REMOTE_COMPACT_WRITE_BYTES;
+      case -0x24:
+        return ROCKSDB_NAMESPACE::Tickers::RANGE_FILTER_CHECKED;
+      case -0x25:
+        return ROCKSDB_NAMESPACE::Tickers::RANGE_FILTER_USEFUL;
+      case -0x26:
+        return ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_MISS;
+      case -0x27:
+        return ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_HIT;
+      case -0x28:
+        return ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_ADD;
+      case -0x29:
+        return ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_ADD_FAILURES;
+      case -0x2A:
+        return ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_BYTES_READ;
+      case -0x2B:
+        return ROCKSDB_NAMESPACE::Tickers::BLOB_DB_CACHE_BYTES_WRITE;
       case 0x5F:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -6924,6 +6960,8 @@ class CompactionStyleJni {
         return 0x2;
       case ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleNone:
         return 0x3;
+      case ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleHybrid:
+        return 0x4;
       default:
         return 0x7F;  // undefined
     }
@@ -6942,6 +6980,8 @@ class CompactionStyleJni {
         return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleFIFO;
       case 0x3:
         return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleNone;
+      case 0x4:
+        return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleHybrid;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleLevel;
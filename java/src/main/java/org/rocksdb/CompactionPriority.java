@@ -33,7 +33,15 @@ public enum CompactionPriority {
    * and its size is the smallest. It in many cases can optimize write
    * amplification.
    */
-  MinOverlappingRatio((byte)0x3);
+  MinOverlappingRatio((byte)0x3),
+
+  /**
+   * First compact files with the largest estimated read I/O saved per byte
+   * of compaction write, based on the sampled number of reads of each file
+   * and its overlapping size in the next level. Files that have not been
+   * read are ordered as with {@link #MinOverlappingRatio}.
+   */
+  ReadAmpBenefitRatio((byte)0x4);
 
 
   private final byte value;
@@ -26,6 +26,9 @@ import java.util.List;
  *   <li><strong>NONE</strong> - Disable background compaction.
  *   Compaction jobs are submitted
  *   {@link RocksDB#compactFiles(CompactionOptions, ColumnFamilyHandle, List, int, int, CompactionJobInfo)} ()}.</li>
+ *   <li><strong>HYBRID</strong> - Tiered upper levels with one or two
+ *   leveled levels at the bottom, trading a little space amplification
+ *   for lower write amplification than level based compaction.</li>
  * </ol>
  *
  * @see <a
@@ -39,7 +42,8 @@ public enum CompactionStyle {
   LEVEL((byte) 0x0),
   UNIVERSAL((byte) 0x1),
   FIFO((byte) 0x2),
-  NONE((byte) 0x3);
+  NONE((byte) 0x3),
+  HYBRID((byte) 0x4);
 
   private final byte value;
 
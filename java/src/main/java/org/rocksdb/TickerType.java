@@ -786,6 +786,46 @@ public enum TickerType {
     REMOTE_COMPACT_READ_BYTES((byte) -0x22),
     REMOTE_COMPACT_WRITE_BYTES((byte) -0x23),
 
+    /**
+     * # of times the range filter was checked by a bounded seek.
+     */
+    RANGE_FILTER_CHECKED((byte) -0x24),
+
+    /**
+     * # of times the range filter avoided reading a table.
+     */
+    RANGE_FILTER_USEFUL((byte) -0x25),
+
+    /**
+     * # of times the blob cache was looked up and missed.
+     */
+    BLOB_DB_CACHE_MISS((byte) -0x26),
+
+    /**
+     * # of times a blob was found in the blob cache.
+     */
+    BLOB_DB_CACHE_HIT((byte) -0x27),
+
+    /**
+     * # of blobs added to the blob cache.
+     */
+    BLOB_DB_CACHE_ADD((byte) -0x28),
+
+    /**
+     * # of failures when adding blobs to the blob cache.
+     */
+    BLOB_DB_CACHE_ADD_FAILURES((byte) -0x29),
+
+    /**
+     * # of bytes read from the blob cache.
+     */
+    BLOB_DB_CACHE_BYTES_READ((byte) -0x2A),
+
+    /**
+     * # of bytes written into the blob cache.
+     */
+    BLOB_DB_CACHE_BYTES_WRITE((byte) -0x2B),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
@@ -39,6 +39,8 @@ void IOStatsContext::Reset() {
   logger_nanos = 0;
   cpu_write_nanos = 0;
   cpu_read_nanos = 0;
+  prefetch_bytes_read = 0;
+  prefetch_bytes_wasted = 0;
   file_io_stats_by_temperature.Reset();
 #endif  //! NIOSTATS_CONTEXT
 }
@@ -67,6 +69,8 @@ std::string IOStatsContext::ToString(bool exclude_zero_counters) const {
   IOSTATS_CONTEXT_OUTPUT(logger_nanos);
   IOSTATS_CONTEXT_OUTPUT(cpu_write_nanos);
   IOSTATS_CONTEXT_OUTPUT(cpu_read_nanos);
+  IOSTATS_CONTEXT_OUTPUT(prefetch_bytes_read);
+  IOSTATS_CONTEXT_OUTPUT(prefetch_bytes_wasted);
   IOSTATS_CONTEXT_OUTPUT(file_io_stats_by_temperature.hot_file_bytes_read);
   IOSTATS_CONTEXT_OUTPUT(file_io_stats_by_temperature.warm_file_bytes_read);
   IOSTATS_CONTEXT_OUTPUT(file_io_stats_by_temperature.cold_file_bytes_read);
@@ -186,6 +186,28 @@ static std::unordered_map<std::string, OptionTypeInfo>
           OptionTypeFlags::kMutable}},
 };
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    hybrid_compaction_options_type_info = {
+        {"num_tiered_levels",
+         {offsetof(struct CompactionOptionsHybrid, num_tiered_levels),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_sorted_runs_per_level",
+         {offsetof(struct CompactionOptionsHybrid, max_sorted_runs_per_level),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_sorted_runs_per_tiered_level",
+         OptionTypeInfo::Vector<int>(
+             offsetof(struct CompactionOptionsHybrid,
+                      max_sorted_runs_per_tiered_level),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone,
+             {0, OptionType::kInt})},
+        {"num_leveled_levels",
+         {offsetof(struct CompactionOptionsHybrid, num_leveled_levels),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
 static std::unordered_map<std::string, OptionTypeInfo>
     universal_compaction_options_type_info = {
         {"size_ratio",
@@ -434,6 +456,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    blob_garbage_collection_force_threshold),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"blob_garbage_collection_job_threshold",
+         {offsetof(struct MutableCFOptions,
+                   blob_garbage_collection_job_threshold),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"sample_for_compression",
          {offsetof(struct MutableCFOptions, sample_for_compression),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -712,6 +739,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offset_of(&ImmutableCFOptions::compaction_pri),
           OptionType::kCompactionPri, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"compaction_options_hybrid",
+         OptionTypeInfo::Struct(
+             "compaction_options_hybrid", &hybrid_compaction_options_type_info,
+             offset_of(&ImmutableCFOptions::compaction_options_hybrid),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone)},
         {"sst_partitioner_factory",
          OptionTypeInfo::AsCustomSharedPtr<SstPartitionerFactory>(
              offset_of(&ImmutableCFOptions::sst_partitioner_factory),
@@ -827,6 +859,7 @@ ImmutableCFOptions::ImmutableCFOptions() : ImmutableCFOptions(Options()) {}
 ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
     : compaction_style(cf_options.compaction_style),
       compaction_pri(cf_options.compaction_pri),
+      compaction_options_hybrid(cf_options.compaction_options_hybrid),
       user_comparator(cf_options.comparator),
       internal_comparator(InternalKeyComparator(cf_options.comparator)),
       merge_operator(cf_options.merge_operator),
@@ -857,7 +890,8 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
           cf_options.memtable_insert_with_hint_prefix_extractor),
       cf_paths(cf_options.cf_paths),
       compaction_thread_limiter(cf_options.compaction_thread_limiter),
-      sst_partitioner_factory(cf_options.sst_partitioner_factory) {}
+      sst_partitioner_factory(cf_options.sst_partitioner_factory),
+      blob_cache(cf_options.blob_cache) {}
 
 ImmutableOptions::ImmutableOptions() : ImmutableOptions(Options()) {}
 
@@ -1055,6 +1089,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  blob_garbage_collection_age_cutoff);
   ROCKS_LOG_INFO(log, "  blob_garbage_collection_force_threshold: %f",
                  blob_garbage_collection_force_threshold);
+  ROCKS_LOG_INFO(log, "    blob_garbage_collection_job_threshold: %f",
+                 blob_garbage_collection_job_threshold);
 }
 
 MutableCFOptions::MutableCFOptions(const Options& options)
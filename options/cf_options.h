@@ -29,6 +29,8 @@ struct ImmutableCFOptions {
 
   CompactionPri compaction_pri;
 
+  CompactionOptionsHybrid compaction_options_hybrid;
+
   const Comparator* user_comparator;
   InternalKeyComparator internal_comparator;  // Only in Immutable
 
@@ -82,6 +84,8 @@ struct ImmutableCFOptions {
   std::shared_ptr<ConcurrentTaskLimiter> compaction_thread_limiter;
 
   std::shared_ptr<SstPartitionerFactory> sst_partitioner_factory;
+
+  std::shared_ptr<Cache> blob_cache;
 };
 
 struct ImmutableOptions : public ImmutableDBOptions, public ImmutableCFOptions {
@@ -143,6 +147,8 @@ struct MutableCFOptions {
             options.blob_garbage_collection_age_cutoff),
         blob_garbage_collection_force_threshold(
             options.blob_garbage_collection_force_threshold),
+        blob_garbage_collection_job_threshold(
+            options.blob_garbage_collection_job_threshold),
         max_sequential_skip_in_iterations(
             options.max_sequential_skip_in_iterations),
         check_flush_compaction_key_order(
@@ -190,6 +196,7 @@ struct MutableCFOptions {
         enable_blob_garbage_collection(false),
         blob_garbage_collection_age_cutoff(0.0),
         blob_garbage_collection_force_threshold(0.0),
+        blob_garbage_collection_job_threshold(0.0),
         max_sequential_skip_in_iterations(0),
         check_flush_compaction_key_order(true),
         paranoid_file_checks(false),
@@ -255,6 +262,7 @@ struct MutableCFOptions {
   bool enable_blob_garbage_collection;
   double blob_garbage_collection_age_cutoff;
   double blob_garbage_collection_force_threshold;
+  double blob_garbage_collection_job_threshold;
 
   // Misc options
   uint64_t max_sequential_skip_in_iterations;
@@ -261,10 +261,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, max_file_opening_threads),
           OptionType::kInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"open_tables_lazily",
+         {offsetof(struct ImmutableDBOptions, open_tables_lazily),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"table_cache_numshardbits",
          {offsetof(struct ImmutableDBOptions, table_cache_numshardbits),
           OptionType::kInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"table_cache_use_clock_cache",
+         {offsetof(struct ImmutableDBOptions, table_cache_use_clock_cache),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"db_write_buffer_size",
          {offsetof(struct ImmutableDBOptions, db_write_buffer_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
@@ -307,6 +315,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, max_manifest_file_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"background_manifest_rollover",
+         {offsetof(struct ImmutableDBOptions, background_manifest_rollover),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"persist_stats_to_disk",
          {offsetof(struct ImmutableDBOptions, persist_stats_to_disk),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -331,6 +343,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          OptionTypeInfo::Enum<WALRecoveryMode>(
              offsetof(struct ImmutableDBOptions, wal_recovery_mode),
              &wal_recovery_mode_string_map)},
+        {"max_wal_recovery_threads",
+         {offsetof(struct ImmutableDBOptions, max_wal_recovery_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"enable_write_thread_adaptive_yield",
          {offsetof(struct ImmutableDBOptions,
                    enable_write_thread_adaptive_yield),
@@ -662,6 +678,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       info_log(options.info_log),
       info_log_level(options.info_log_level),
       max_file_opening_threads(options.max_file_opening_threads),
+      open_tables_lazily(options.open_tables_lazily),
       statistics(options.statistics),
       use_fsync(options.use_fsync),
       db_paths(options.db_paths),
@@ -672,7 +689,9 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       keep_log_file_num(options.keep_log_file_num),
       recycle_log_file_num(options.recycle_log_file_num),
       max_manifest_file_size(options.max_manifest_file_size),
+      background_manifest_rollover(options.background_manifest_rollover),
       table_cache_numshardbits(options.table_cache_numshardbits),
+      table_cache_use_clock_cache(options.table_cache_use_clock_cache),
       WAL_ttl_seconds(options.WAL_ttl_seconds),
       WAL_size_limit_MB(options.WAL_size_limit_MB),
       max_write_batch_group_size_bytes(
@@ -707,6 +726,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       skip_checking_sst_file_sizes_on_db_open(
           options.skip_checking_sst_file_sizes_on_db_open),
       wal_recovery_mode(options.wal_recovery_mode),
+      max_wal_recovery_threads(options.max_wal_recovery_threads),
       allow_2pc(options.allow_2pc),
       row_cache(options.row_cache),
 #ifndef ROCKSDB_LITE
@@ -765,6 +785,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    info_log.get());
   ROCKS_LOG_HEADER(log, "               Options.max_file_opening_threads: %d",
                    max_file_opening_threads);
+  ROCKS_LOG_HEADER(log, "                     Options.open_tables_lazily: %d",
+                   open_tables_lazily);
   ROCKS_LOG_HEADER(log, "                             Options.statistics: %p",
                    stats);
   ROCKS_LOG_HEADER(log, "                              Options.use_fsync: %d",
@@ -775,6 +797,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "                 Options.max_manifest_file_size: %" PRIu64,
                    max_manifest_file_size);
+  ROCKS_LOG_HEADER(log, "           Options.background_manifest_rollover: %d",
+                   background_manifest_rollover);
   ROCKS_LOG_HEADER(
       log, "                  Options.log_file_time_to_roll: %" ROCKSDB_PRIszt,
       log_file_time_to_roll);
@@ -804,6 +828,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    wal_dir.c_str());
   ROCKS_LOG_HEADER(log, "               Options.table_cache_numshardbits: %d",
                    table_cache_numshardbits);
+  ROCKS_LOG_HEADER(log, "            Options.table_cache_use_clock_cache: %d",
+                   table_cache_use_clock_cache);
   ROCKS_LOG_HEADER(log,
                    "                        Options.WAL_ttl_seconds: %" PRIu64,
                    WAL_ttl_seconds);
@@ -845,6 +871,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
       sst_file_manager ? sst_file_manager->GetDeleteRateBytesPerSecond() : 0);
   ROCKS_LOG_HEADER(log, "                      Options.wal_recovery_mode: %d",
                    static_cast<int>(wal_recovery_mode));
+  ROCKS_LOG_HEADER(log, "               Options.max_wal_recovery_threads: %d",
+                   max_wal_recovery_threads);
   ROCKS_LOG_HEADER(log, "                 Options.enable_thread_tracking: %d",
                    enable_thread_tracking);
   ROCKS_LOG_HEADER(log, "                 Options.enable_pipelined_write: %d",
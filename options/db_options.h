@@ -32,6 +32,7 @@ struct ImmutableDBOptions {
   std::shared_ptr<Logger> info_log;
   InfoLogLevel info_log_level;
   int max_file_opening_threads;
+  bool open_tables_lazily;
   std::shared_ptr<Statistics> statistics;
   bool use_fsync;
   std::vector<DbPath> db_paths;
@@ -45,7 +46,9 @@ struct ImmutableDBOptions {
   size_t keep_log_file_num;
   size_t recycle_log_file_num;
   uint64_t max_manifest_file_size;
+  bool background_manifest_rollover;
   int table_cache_numshardbits;
+  bool table_cache_use_clock_cache;
   uint64_t WAL_ttl_seconds;
   uint64_t WAL_size_limit_MB;
   uint64_t max_write_batch_group_size_bytes;
@@ -75,6 +78,7 @@ struct ImmutableDBOptions {
   bool skip_stats_update_on_db_open;
   bool skip_checking_sst_file_sizes_on_db_open;
   WALRecoveryMode wal_recovery_mode;
+  int max_wal_recovery_threads;
   bool allow_2pc;
   std::shared_ptr<Cache> row_cache;
 #ifndef ROCKSDB_LITE
@@ -78,6 +78,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       compaction_pri(options.compaction_pri),
       compaction_options_universal(options.compaction_options_universal),
       compaction_options_fifo(options.compaction_options_fifo),
+      compaction_options_hybrid(options.compaction_options_hybrid),
       max_sequential_skip_in_iterations(
           options.max_sequential_skip_in_iterations),
       memtable_factory(options.memtable_factory),
@@ -99,7 +100,10 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       blob_garbage_collection_age_cutoff(
           options.blob_garbage_collection_age_cutoff),
       blob_garbage_collection_force_threshold(
-          options.blob_garbage_collection_force_threshold) {
+          options.blob_garbage_collection_force_threshold),
+      blob_garbage_collection_job_threshold(
+          options.blob_garbage_collection_job_threshold),
+      blob_cache(options.blob_cache) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -343,6 +347,26 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "Options.compaction_options_fifo.allow_compaction: %d",
                      compaction_options_fifo.allow_compaction);
+    ROCKS_LOG_HEADER(log,
+                     "Options.compaction_options_hybrid.num_tiered_levels: %d",
+                     compaction_options_hybrid.num_tiered_levels);
+    ROCKS_LOG_HEADER(
+        log, "Options.compaction_options_hybrid.max_sorted_runs_per_level: %d",
+        compaction_options_hybrid.max_sorted_runs_per_level);
+    for (size_t t = 0;
+         t < compaction_options_hybrid.max_sorted_runs_per_tiered_level.size();
+         t++) {
+      ROCKS_LOG_HEADER(log,
+                       "Options.compaction_options_hybrid."
+                       "max_sorted_runs_per_tiered_level[%" ROCKSDB_PRIszt
+                       "]: %d",
+                       t,
+                       compaction_options_hybrid
+                           .max_sorted_runs_per_tiered_level[t]);
+    }
+    ROCKS_LOG_HEADER(log,
+                     "Options.compaction_options_hybrid.num_leveled_levels: %d",
+                     compaction_options_hybrid.num_leveled_levels);
     std::ostringstream collector_info;
     for (const auto& collector_factory : table_properties_collector_factories) {
       collector_info << collector_factory->ToString() << ';';
@@ -405,6 +429,16 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                      blob_garbage_collection_age_cutoff);
     ROCKS_LOG_HEADER(log, "Options.blob_garbage_collection_force_threshold: %f",
                      blob_garbage_collection_force_threshold);
+    ROCKS_LOG_HEADER(log, "  Options.blob_garbage_collection_job_threshold: %f",
+                     blob_garbage_collection_job_threshold);
+    if (blob_cache) {
+      ROCKS_LOG_HEADER(
+          log, "                             Options.blob_cache: %" ROCKSDB_PRIszt,
+          blob_cache->GetCapacity());
+    } else {
+      ROCKS_LOG_HEADER(log,
+                       "                             Options.blob_cache: None");
+    }
 }  // ColumnFamilyOptions::Dump
 
 void Options::Dump(Logger* log) const {
@@ -77,6 +77,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_open_files = mutable_db_options.max_open_files;
   options.max_file_opening_threads =
       immutable_db_options.max_file_opening_threads;
+  options.open_tables_lazily = immutable_db_options.open_tables_lazily;
   options.max_total_wal_size = mutable_db_options.max_total_wal_size;
   options.statistics = immutable_db_options.statistics;
   options.use_fsync = immutable_db_options.use_fsync;
@@ -100,8 +101,12 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.keep_log_file_num = immutable_db_options.keep_log_file_num;
   options.recycle_log_file_num = immutable_db_options.recycle_log_file_num;
   options.max_manifest_file_size = immutable_db_options.max_manifest_file_size;
+  options.background_manifest_rollover =
+      immutable_db_options.background_manifest_rollover;
   options.table_cache_numshardbits =
       immutable_db_options.table_cache_numshardbits;
+  options.table_cache_use_clock_cache =
+      immutable_db_options.table_cache_use_clock_cache;
   options.WAL_ttl_seconds = immutable_db_options.WAL_ttl_seconds;
   options.WAL_size_limit_MB = immutable_db_options.WAL_size_limit_MB;
   options.manifest_preallocation_size =
@@ -153,6 +158,8 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.skip_checking_sst_file_sizes_on_db_open =
       immutable_db_options.skip_checking_sst_file_sizes_on_db_open;
   options.wal_recovery_mode = immutable_db_options.wal_recovery_mode;
+  options.max_wal_recovery_threads =
+      immutable_db_options.max_wal_recovery_threads;
   options.allow_2pc = immutable_db_options.allow_2pc;
   options.row_cache = immutable_db_options.row_cache;
 #ifndef ROCKSDB_LITE
@@ -253,6 +260,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.blob_garbage_collection_age_cutoff;
   cf_opts->blob_garbage_collection_force_threshold =
       moptions.blob_garbage_collection_force_threshold;
+  cf_opts->blob_garbage_collection_job_threshold =
+      moptions.blob_garbage_collection_job_threshold;
 
   // Misc options
   cf_opts->max_sequential_skip_in_iterations =
@@ -272,6 +281,7 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
                                ColumnFamilyOptions* cf_opts) {
   cf_opts->compaction_style = ioptions.compaction_style;
   cf_opts->compaction_pri = ioptions.compaction_pri;
+  cf_opts->compaction_options_hybrid = ioptions.compaction_options_hybrid;
   cf_opts->comparator = ioptions.user_comparator;
   cf_opts->merge_operator = ioptions.merge_operator;
   cf_opts->compaction_filter = ioptions.compaction_filter;
@@ -302,6 +312,7 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
   cf_opts->cf_paths = ioptions.cf_paths;
   cf_opts->compaction_thread_limiter = ioptions.compaction_thread_limiter;
   cf_opts->sst_partitioner_factory = ioptions.sst_partitioner_factory;
+  cf_opts->blob_cache = ioptions.blob_cache;
 
   // TODO(yhchiang): find some way to handle the following derived options
   // * max_file_size
@@ -312,13 +323,15 @@ std::map<CompactionStyle, std::string>
         {kCompactionStyleLevel, "kCompactionStyleLevel"},
         {kCompactionStyleUniversal, "kCompactionStyleUniversal"},
         {kCompactionStyleFIFO, "kCompactionStyleFIFO"},
-        {kCompactionStyleNone, "kCompactionStyleNone"}};
+        {kCompactionStyleNone, "kCompactionStyleNone"},
+        {kCompactionStyleHybrid, "kCompactionStyleHybrid"}};
 
 std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kByCompensatedSize, "kByCompensatedSize"},
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
-    {kMinOverlappingRatio, "kMinOverlappingRatio"}};
+    {kMinOverlappingRatio, "kMinOverlappingRatio"},
+    {kReadAmpBenefitRatio, "kReadAmpBenefitRatio"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -799,14 +812,16 @@ std::unordered_map<std::string, CompactionStyle>
         {"kCompactionStyleLevel", kCompactionStyleLevel},
         {"kCompactionStyleUniversal", kCompactionStyleUniversal},
         {"kCompactionStyleFIFO", kCompactionStyleFIFO},
-        {"kCompactionStyleNone", kCompactionStyleNone}};
+        {"kCompactionStyleNone", kCompactionStyleNone},
+        {"kCompactionStyleHybrid", kCompactionStyleHybrid}};
 
 std::unordered_map<std::string, CompactionPri>
     OptionsHelper::compaction_pri_string_map = {
         {"kByCompensatedSize", kByCompensatedSize},
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
-        {"kMinOverlappingRatio", kMinOverlappingRatio}};
+        {"kMinOverlappingRatio", kMinOverlappingRatio},
+        {"kReadAmpBenefitRatio", kReadAmpBenefitRatio}};
 
 std::unordered_map<std::string, CompactionStopStyle>
     OptionsHelper::compaction_stop_style_string_map = {
@@ -181,7 +181,9 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "enable_index_compression=false;"
       "block_align=true;"
       "max_auto_readahead_size=0;"
-      "prepopulate_block_cache=kDisable",
+      "prepopulate_block_cache=kDisable;"
+      "max_pinned_hot_data_blocks=0;"
+      "range_filter_bits_per_key=0",
       new_bbto));
 
   ASSERT_EQ(unset_bytes_base,
@@ -270,8 +272,10 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "db_write_buffer_size=2587;"
                              "max_subcompactions=64330;"
                              "table_cache_numshardbits=28;"
+                             "table_cache_use_clock_cache=true;"
                              "max_open_files=72;"
                              "max_file_opening_threads=35;"
+                             "open_tables_lazily=true;"
                              "max_background_jobs=8;"
                              "base_background_compactions=3;"
                              "max_background_compactions=33;"
@@ -284,6 +288,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "skip_stats_update_on_db_open=false;"
                              "skip_checking_sst_file_sizes_on_db_open=false;"
                              "max_manifest_file_size=4295009941;"
+                             "background_manifest_rollover=true;"
                              "db_log_dir=path/to/db_log_dir;"
                              "skip_log_error_on_recovery=true;"
                              "writable_file_max_buffer_size=1048576;"
@@ -319,6 +324,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "unordered_write=false;"
                              "allow_concurrent_memtable_write=true;"
                              "wal_recovery_mode=kPointInTimeRecovery;"
+                             "max_wal_recovery_threads=3;"
                              "enable_write_thread_adaptive_yield=true;"
                              "write_thread_slow_yield_usec=5;"
                              "write_thread_max_yield_usec=1000;"
@@ -385,10 +391,15 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       {offset_of(
            &ColumnFamilyOptions::max_bytes_for_level_multiplier_additional),
        sizeof(std::vector<int>)},
+      {offset_of(&ColumnFamilyOptions::compaction_options_hybrid) +
+           offsetof(CompactionOptionsHybrid, max_sorted_runs_per_tiered_level),
+       sizeof(std::vector<int>)},
       {offset_of(&ColumnFamilyOptions::memtable_factory),
        sizeof(std::shared_ptr<MemTableRepFactory>)},
       {offset_of(&ColumnFamilyOptions::table_properties_collector_factories),
        sizeof(ColumnFamilyOptions::TablePropertiesCollectorFactories)},
+      {offset_of(&ColumnFamilyOptions::blob_cache),
+       sizeof(std::shared_ptr<Cache>)},
       {offset_of(&ColumnFamilyOptions::comparator), sizeof(Comparator*)},
       {offset_of(&ColumnFamilyOptions::merge_operator),
        sizeof(std::shared_ptr<MergeOperator>)},
@@ -517,8 +528,11 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "enable_blob_garbage_collection=true;"
       "blob_garbage_collection_age_cutoff=0.5;"
       "blob_garbage_collection_force_threshold=0.75;"
+      "blob_garbage_collection_job_threshold=0.5;"
       "compaction_options_fifo={max_table_files_size=3;allow_"
-      "compaction=false;age_for_warm=1;};",
+      "compaction=false;age_for_warm=1;};"
+      "compaction_options_hybrid={num_tiered_levels=2;max_sorted_runs_per_"
+      "level=3;max_sorted_runs_per_tiered_level=2:4;num_leveled_levels=1;};",
       new_options));
 
   ASSERT_EQ(unset_bytes_base,
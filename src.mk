@@ -4,6 +4,7 @@ LIB_SOURCES =                                                   \
   cache/cache_entry_roles.cc                                    \
   cache/cache_reservation_manager.cc                                            \
   cache/clock_cache.cc                                          \
+  cache/compressed_secondary_cache.cc                           \
   cache/lru_cache.cc                                            \
   cache/sharded_cache.cc                                        \
   db/async_result.cc                                            \
@@ -15,10 +16,13 @@ LIB_SOURCES =                                                   \
   db/blob/blob_file_garbage.cc                                  \
   db/blob/blob_file_meta.cc                                     \
   db/blob/blob_file_reader.cc                                   \
+  db/blob/blob_file_relocation.cc                               \
+  db/blob/blob_garbage_collection_job.cc                        \
   db/blob/blob_garbage_meter.cc                                 \
   db/blob/blob_log_format.cc                                    \
   db/blob/blob_log_sequential_reader.cc                         \
   db/blob/blob_log_writer.cc                                    \
+  db/blob/blob_offset_map.cc                                    \
   db/builder.cc                                                 \
   db/c.cc                                                       \
   db/column_family.cc                                           \
@@ -27,6 +31,7 @@ LIB_SOURCES =                                                   \
   db/compaction/compaction_job.cc                               \
   db/compaction/compaction_picker.cc                            \
   db/compaction/compaction_picker_fifo.cc                       \
+  db/compaction/compaction_picker_hybrid.cc                     \
   db/compaction/compaction_picker_level.cc                      \
   db/compaction/compaction_picker_universal.cc                  \
   db/compaction/sst_partitioner.cc                              \
@@ -96,6 +101,7 @@ LIB_SOURCES =                                                   \
   env/io_posix.cc                                               \
   env/mock_env.cc                                               \
   env/unique_id_gen.cc                                          \
+  file/async_read_ring.cc                                       \
   file/delete_scheduler.cc                                      \
   file/file_prefetch_buffer.cc                                  \
   file/file_util.cc                                             \
@@ -160,6 +166,7 @@ LIB_SOURCES =                                                   \
   table/block_based/block_builder.cc                            \
   table/block_based/block_prefetcher.cc                         \
   table/block_based/block_prefix_index.cc                       \
+  table/block_based/data_block_cuckoo_index.cc                  \
   table/block_based/data_block_hash_index.cc                    \
   table/block_based/data_block_footer.cc                        \
   table/block_based/filter_block_reader_common.cc               \
@@ -167,12 +174,16 @@ LIB_SOURCES =                                                   \
   table/block_based/flush_block_policy.cc                       \
   table/block_based/full_filter_block.cc                        \
   table/block_based/hash_index_reader.cc                        \
+  table/block_based/hot_block_cache.cc                          \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
+  table/block_based/learned_index.cc                            \
+  table/block_based/learned_index_reader.cc                     \
   table/block_based/parsed_full_filter_block.cc                 \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
   table/block_based/partitioned_index_reader.cc                 \
+  table/block_based/range_filter.cc                             \
   table/block_based/reader_common.cc                            \
   table/block_based/uncompression_dict_reader.cc                \
   table/block_fetcher.cc                                        \
@@ -395,6 +406,7 @@ BENCH_MAIN_SOURCES =                                                    \
 TEST_MAIN_SOURCES =                                                     \
   cache/cache_test.cc                                                   \
   cache/cache_reservation_manager_test.cc                                               \
+  cache/compressed_secondary_cache_test.cc                              \
   cache/lru_cache_test.cc                                               \
   db/blob/blob_counting_iterator_test.cc                                \
   db/blob/blob_file_addition_test.cc                                    \
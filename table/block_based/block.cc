@@ -21,6 +21,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/learned_index.h"
 #include "table/format.h"
 #include "util/coding.h"
 
@@ -276,8 +277,27 @@ void DataBlockIter::SeekImpl(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
-  uint8_t entry =
-      data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
+  if (restart_key_prefixes_ != nullptr) {
+    map_offset += static_cast<uint32_t>(RestartKeyPrefixesSize(num_restarts_));
+  }
+  uint8_t entry;
+  if (data_block_cuckoo_index_ != nullptr) {
+    if (SeekToUserKeyWithCuckooIndex(map_offset, target_user_key)) {
+      // Skip the versions of the user key that are newer than the target.
+      // They may continue past the restart interval.
+      while (CompareCurrentKey(target) < 0) {
+        if (!ParseNextDataKey<DecodeEntry>()) {
+          break;
+        }
+      }
+      return SeekForGetCheckResult(target_user_key, target);
+    }
+    // Not in this block, but the result may be in the next one, as with
+    // kNoEntry below
+    entry = kNoEntry;
+  } else {
+    entry = data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
+  }
 
   if (entry == kCollision) {
     // HashSeek not effective, falling back
@@ -331,6 +351,41 @@ bool DataBlockIter::SeekForGetImpl(const Slice& target) {
     }
   }
 
+  return SeekForGetCheckResult(target_user_key, target);
+}
+
+bool DataBlockIter::SeekToUserKeyWithCuckooIndex(
+    uint32_t map_offset, const Slice& target_user_key) {
+  uint16_t locators[DataBlockCuckooIndex::kMaxCandidates];
+  size_t num_candidates = data_block_cuckoo_index_->Lookup(
+      data_, map_offset, target_user_key, locators);
+  for (size_t i = 0; i < num_candidates; ++i) {
+    uint32_t restart_index =
+        data_block_cuckoo_index_->GetRestartIndex(locators[i]);
+    if (restart_index >= num_restarts_) {
+      // Corrupted locator; let the fallback search deal with the block
+      continue;
+    }
+    SeekToRestartPoint(restart_index);
+    bool ok = true;
+    for (uint32_t n = data_block_cuckoo_index_->GetOrdinal(locators[i]);
+         ok && n > 0; --n) {
+      ok = ParseNextDataKey<DecodeEntry>();
+    }
+    // Fingerprints may collide, so compare the user key once
+    if (ok && ParseNextDataKey<DecodeEntry>() &&
+        ucmp().Compare(raw_key_.GetUserKey(), target_user_key) == 0) {
+      return true;
+    }
+    if (!status_.ok()) {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool DataBlockIter::SeekForGetCheckResult(const Slice& target_user_key,
+                                          const Slice& target) {
   if (current_ == restarts_) {
     // Search reaches to the end of the block. There are three possibilites:
     // 1) there is only one user_key match in the block (otherwise collsion).
@@ -705,6 +760,16 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
   int64_t left = -1, right = num_restarts_ - 1;
+  if (learned_index_ != nullptr) {
+    if (!NarrowBinarySeekWithLearnedIndex<DecodeKeyFunc>(target, &left,
+                                                         &right)) {
+      return false;
+    }
+  } else if (restart_key_prefixes_ != nullptr &&
+             !NarrowBinarySeekWithKeyPrefixes<DecodeKeyFunc>(target, &left,
+                                                             &right)) {
+    return false;
+  }
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -744,6 +809,137 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   return true;
 }
 
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::NarrowBinarySeekWithKeyPrefixes(const Slice& target,
+                                                        int64_t* left,
+                                                        int64_t* right) {
+  const Slice target_user_key =
+      raw_key_.IsUserKey() ? target : ExtractUserKey(target);
+  const uint32_t skip = DecodeFixed32(
+      restart_key_prefixes_ + num_restarts_ * sizeof(uint64_t));
+  if (skip > 0) {
+    // All restart keys start with the same `skip` bytes, so the target
+    // either starts with them too, or is before or after all restart keys
+    uint32_t shared, non_shared;
+    const char* key_ptr =
+        DecodeKeyFunc()(data_, data_ + restarts_, &shared, &non_shared);
+    if (key_ptr == nullptr || shared != 0 ||
+        non_shared < skip + (raw_key_.IsUserKey() ? 0 : kNumInternalBytes)) {
+      CorruptionError();
+      return false;
+    }
+    const size_t n = std::min(size_t{skip}, target_user_key.size());
+    int cmp = memcmp(target_user_key.data(), key_ptr, n);
+    if (cmp == 0 && n < skip) {
+      cmp = -1;
+    }
+    if (cmp < 0) {
+      *left = *right = -1;
+      return true;
+    } else if (cmp > 0) {
+      *left = *right = num_restarts_ - 1;
+      return true;
+    }
+  }
+
+  const uint64_t prefix = GetRestartKeyPrefix(target_user_key, skip);
+  *left = int64_t{CountRestartKeyPrefixesBelow<false>(prefix)} - 1;
+  *right = int64_t{CountRestartKeyPrefixesBelow<true>(prefix)} - 1;
+  return true;
+}
+
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::NarrowBinarySeekWithLearnedIndex(const Slice& target,
+                                                         int64_t* left,
+                                                         int64_t* right) {
+  const Slice target_user_key =
+      raw_key_.IsUserKey() ? target : ExtractUserKey(target);
+  // Position of the first restart key greater than or equal to the target,
+  // within epsilon (plus one for keys between those of the model)
+  const int64_t predicted = learned_index_->Predict(target_user_key);
+  const int64_t epsilon = learned_index_->epsilon();
+  const int64_t lo = std::max<int64_t>(predicted - epsilon - 1, -1);
+  const int64_t hi =
+      std::min<int64_t>(predicted + epsilon, int64_t{num_restarts_} - 1);
+  int cmp;
+  if (lo >= 0) {
+    if (!CompareRestartKey<DecodeKeyFunc>(static_cast<uint32_t>(lo), target,
+                                          &cmp)) {
+      return false;
+    }
+    if (cmp > 0) {
+      // Predicted too far
+      *right = lo - 1;
+      return true;
+    } else if (cmp == 0) {
+      // Leave the match to the binary search, which skips the linear scan
+      *left = lo - 1;
+      *right = lo;
+      return true;
+    }
+  }
+  if (hi + 1 < int64_t{num_restarts_}) {
+    if (!CompareRestartKey<DecodeKeyFunc>(static_cast<uint32_t>(hi + 1),
+                                          target, &cmp)) {
+      return false;
+    }
+    if (cmp < 0) {
+      // Predicted not far enough
+      *left = hi + 1;
+      return true;
+    } else if (cmp == 0) {
+      *left = hi;
+      *right = hi + 1;
+      return true;
+    }
+  }
+  *left = lo;
+  *right = hi;
+  return true;
+}
+
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::CompareRestartKey(uint32_t index, const Slice& target,
+                                          int* cmp) {
+  uint32_t shared, non_shared;
+  const char* key_ptr = DecodeKeyFunc()(
+      data_ + GetRestartPoint(index), data_ + restarts_, &shared, &non_shared);
+  if (key_ptr == nullptr || (shared != 0)) {
+    CorruptionError();
+    return false;
+  }
+  raw_key_.SetKey(Slice(key_ptr, non_shared), false /* copy */);
+  *cmp = CompareCurrentKey(target);
+  return true;
+}
+
+template <class TValue>
+template <bool kOrEqual>
+uint32_t BlockIter<TValue>::CountRestartKeyPrefixesBelow(
+    uint64_t prefix) const {
+  // Branch-free binary search, down to a window small enough to be counted
+  // with a loop that the compiler vectorizes
+  constexpr uint32_t kMaxWindow = 16;
+  const char* prefixes = restart_key_prefixes_;
+  uint32_t base = 0, n = num_restarts_;
+  while (n > kMaxWindow) {
+    const uint32_t half = n / 2;
+    const uint64_t mid =
+        DecodeFixed64(prefixes + (base + half) * sizeof(uint64_t));
+    base = (kOrEqual ? mid <= prefix : mid < prefix) ? base + half : base;
+    n -= half;
+  }
+  uint32_t count = base;
+  for (uint32_t i = base; i < base + n; ++i) {
+    const uint64_t p = DecodeFixed64(prefixes + i * sizeof(uint64_t));
+    count += static_cast<uint32_t>(kOrEqual ? p <= prefix : p < prefix);
+  }
+  return count;
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
@@ -894,6 +1090,19 @@ uint32_t Block::NumRestarts() const {
   return num_restarts;
 }
 
+bool Block::HasRestartKeyPrefixes() const {
+  assert(size_ >= 2 * sizeof(uint32_t));
+  if (size_ > kMaxBlockSizeSupportedByHashIndex) {
+    // The check is for the same reason as that in NumRestarts()
+    return false;
+  }
+  uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  bool has_restart_key_prefixes;
+  UnPackIndexTypeAndNumRestarts(block_footer, nullptr, nullptr,
+                                &has_restart_key_prefixes);
+  return has_restart_key_prefixes;
+}
+
 BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
   assert(size_ >= 2 * sizeof(uint32_t));
   if (size_ > kMaxBlockSizeSupportedByHashIndex) {
@@ -919,50 +1128,77 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
       data_(contents_.data.data()),
       size_(contents_.data.size()),
       restart_offset_(0),
-      num_restarts_(0) {
+      num_restarts_(0),
+      restart_key_prefixes_(nullptr) {
   TEST_SYNC_POINT("Block::Block:0");
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
     // Should only decode restart points for uncompressed blocks
     num_restarts_ = NumRestarts();
+    // The restart key prefixes sit between the restart array and the hash
+    // index, if any
+    const size_t restart_key_prefixes_size =
+        size_ >= 2 * sizeof(uint32_t) && HasRestartKeyPrefixes()
+            ? RestartKeyPrefixesSize(num_restarts_)
+            : 0;
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
-        restart_offset_ = static_cast<uint32_t>(size_) -
-                          (1 + num_restarts_) * sizeof(uint32_t);
-        if (restart_offset_ > size_ - sizeof(uint32_t)) {
-          // The size is too small for NumRestarts() and therefore
-          // restart_offset_ wrapped around.
+        if ((1 + size_t{num_restarts_}) * sizeof(uint32_t) +
+                restart_key_prefixes_size >
+            size_) {
+          // The size is too small for NumRestarts()
           size_ = 0;
+          break;
         }
+        restart_offset_ = static_cast<uint32_t>(
+            size_ - (1 + num_restarts_) * sizeof(uint32_t) -
+            restart_key_prefixes_size);
         break;
-      case BlockBasedTableOptions::kDataBlockBinaryAndHash:
+      case BlockBasedTableOptions::kDataBlockBinaryAndHash: {
         if (size_ < sizeof(uint32_t) /* block footer */ +
                         sizeof(uint16_t) /* NUM_BUCK */) {
           size_ = 0;
           break;
         }
 
-        uint16_t map_offset;
-        data_block_hash_index_.Initialize(
-            contents.data.data(),
-            static_cast<uint16_t>(contents.data.size() -
-                                  sizeof(uint32_t)), /*chop off
-                                                 NUM_RESTARTS*/
-            &map_offset);
-
-        restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
+        uint32_t map_offset;
+        const uint32_t index_end =
+            static_cast<uint32_t>(size_ - sizeof(uint32_t)); /*chop off
+                                                         NUM_RESTARTS*/
+        if (IsDataBlockCuckooIndex(contents.data.data(), index_end)) {
+          if (!data_block_cuckoo_index_.Initialize(contents.data.data(),
+                                                   index_end, &map_offset)) {
+            size_ = 0;
+            break;
+          }
+        } else {
+          uint16_t hash_map_offset;
+          data_block_hash_index_.Initialize(
+              contents.data.data(), static_cast<uint16_t>(index_end),
+              &hash_map_offset);
+          map_offset = hash_map_offset;
+        }
 
-        if (restart_offset_ > map_offset) {
-          // map_offset is too small for NumRestarts() and
-          // therefore restart_offset_ wrapped around.
+        if (size_t{num_restarts_} * sizeof(uint32_t) +
+                restart_key_prefixes_size >
+            map_offset) {
+          // map_offset is too small for NumRestarts()
           size_ = 0;
           break;
         }
+        restart_offset_ = static_cast<uint32_t>(
+            map_offset - num_restarts_ * sizeof(uint32_t) -
+            restart_key_prefixes_size);
         break;
+      }
       default:
         size_ = 0;  // Error marker
     }
+    if (size_ != 0 && restart_key_prefixes_size != 0) {
+      restart_key_prefixes_ =
+          data_ + restart_offset_ + num_restarts_ * sizeof(uint32_t);
+    }
   }
   if (read_amp_bytes_per_bit != 0 && statistics && size_ != 0) {
     read_amp_bitmap_.reset(new BlockReadAmpBitmap(
@@ -992,7 +1228,10 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
     ret_iter->Initialize(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         read_amp_bitmap_.get(), block_contents_pinned,
-        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr);
+        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        data_block_cuckoo_index_.Valid() ? &data_block_cuckoo_index_
+                                         : nullptr,
+        restart_key_prefixes_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1008,7 +1247,8 @@ IndexBlockIter* Block::NewIndexIterator(
     const Comparator* raw_ucmp, SequenceNumber global_seqno,
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
-    bool block_contents_pinned, BlockPrefixIndex* prefix_index) {
+    bool block_contents_pinned, BlockPrefixIndex* prefix_index,
+    const LearnedIndexModel* learned_index) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1026,10 +1266,16 @@ IndexBlockIter* Block::NewIndexIterator(
   } else {
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index;
+    // Ignore a model that does not describe this block
+    if (learned_index != nullptr &&
+        learned_index->num_entries() != num_restarts_) {
+      learned_index = nullptr;
+    }
     ret_iter->Initialize(raw_ucmp, data_, restart_offset_, num_restarts_,
                          global_seqno, prefix_index_ptr, have_first_key,
                          key_includes_seq, value_is_full,
-                         block_contents_pinned);
+                         block_contents_pinned, restart_key_prefixes_,
+                         learned_index);
   }
 
   return ret_iter;
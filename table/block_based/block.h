@@ -20,7 +20,9 @@
 #include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "table/block_based/block_prefix_index.h"
+#include "table/block_based/data_block_cuckoo_index.h"
 #include "table/block_based/data_block_hash_index.h"
+#include "table/block_based/restart_key_prefixes.h"
 #include "table/format.h"
 #include "table/internal_iterator.h"
 #include "test_util/sync_point.h"
@@ -35,6 +37,7 @@ class BlockIter;
 class DataBlockIter;
 class IndexBlockIter;
 class BlockPrefixIndex;
+class LearnedIndexModel;
 
 // BlockReadAmpBitmap is a bitmap that map the ROCKSDB_NAMESPACE::Block data
 // bytes to a bitmap with ratio bytes_per_bit. Whenever we access a range of
@@ -166,6 +169,8 @@ class Block {
   bool own_bytes() const { return contents_.own_bytes(); }
 
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
+  // Whether the restart array is followed by restart key prefixes
+  bool HasRestartKeyPrefixes() const;
 
   // raw_ucmp is a raw (i.e., not wrapped by `UserComparatorWrapper`) user key
   // comparator.
@@ -203,6 +208,9 @@ class Block {
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
   //
+  // If `learned_index` is not nullptr and models the entries of this block,
+  // it narrows down the binary search of seeks.
+  //
   // `have_first_key` controls whether IndexValue will contain
   // first_internal_key. It affects data serialization format, so the same value
   // have_first_key must be used when writing and reading index.
@@ -213,7 +221,9 @@ class Block {
                                    bool total_order_seek, bool have_first_key,
                                    bool key_includes_seq, bool value_is_full,
                                    bool block_contents_pinned = false,
-                                   BlockPrefixIndex* prefix_index = nullptr);
+                                   BlockPrefixIndex* prefix_index = nullptr,
+                                   const LearnedIndexModel* learned_index =
+                                       nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -224,8 +234,11 @@ class Block {
   size_t size_;              // contents_.data.size()
   uint32_t restart_offset_;  // Offset in data_ of restart array
   uint32_t num_restarts_;
+  // Start of the restart key prefixes, or nullptr
+  const char* restart_key_prefixes_;
   std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
   DataBlockHashIndex data_block_hash_index_;
+  DataBlockCuckooIndex data_block_cuckoo_index_;
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -252,11 +265,14 @@ class BlockIter : public InternalIteratorBase<TValue> {
  public:
   void InitializeBase(const Comparator* raw_ucmp, const char* data,
                       uint32_t restarts, uint32_t num_restarts,
-                      SequenceNumber global_seqno, bool block_contents_pinned) {
+                      SequenceNumber global_seqno, bool block_contents_pinned,
+                      const char* restart_key_prefixes) {
     assert(data_ == nullptr);  // Ensure it is called only once
     assert(num_restarts > 0);  // Ensure the param is valid
 
-    raw_ucmp_ = raw_ucmp;
+    // Build the comparators once per block rather than once per comparison
+    ucmp_ = UserComparatorWrapper(raw_ucmp);
+    icmp_ = InternalKeyComparator(raw_ucmp, false /* named */);
     data_ = data;
     restarts_ = restarts;
     num_restarts_ = num_restarts;
@@ -264,6 +280,7 @@ class BlockIter : public InternalIteratorBase<TValue> {
     restart_index_ = num_restarts_;
     global_seqno_ = global_seqno;
     block_contents_pinned_ = block_contents_pinned;
+    restart_key_prefixes_ = restart_key_prefixes;
     cache_handle_ = nullptr;
   }
 
@@ -378,6 +395,12 @@ class BlockIter : public InternalIteratorBase<TValue> {
   // e.g. PinnableSlice, the pointer to the bytes will still be valid.
   bool block_contents_pinned_;
   SequenceNumber global_seqno_;
+  // Restart key prefixes of the block, or nullptr. See
+  // restart_key_prefixes.h
+  const char* restart_key_prefixes_ = nullptr;
+  // Model of the positions of the restart keys, or nullptr. Only set for
+  // index blocks. See learned_index.h
+  const LearnedIndexModel* learned_index_ = nullptr;
 
   virtual void SeekToFirstImpl() = 0;
   virtual void SeekToLastImpl() = 0;
@@ -386,11 +409,9 @@ class BlockIter : public InternalIteratorBase<TValue> {
   virtual void NextImpl() = 0;
   virtual void PrevImpl() = 0;
 
-  InternalKeyComparator icmp() {
-    return InternalKeyComparator(raw_ucmp_, false /* named */);
-  }
+  const InternalKeyComparator& icmp() const { return icmp_; }
 
-  UserComparatorWrapper ucmp() { return UserComparatorWrapper(raw_ucmp_); }
+  const UserComparatorWrapper& ucmp() const { return ucmp_; }
 
   // Must be called every time a key is found that needs to be returned to user,
   // and may be called when no key is found (as a no-op). Updates `key_`,
@@ -430,7 +451,8 @@ class BlockIter : public InternalIteratorBase<TValue> {
   }
 
  private:
-  const Comparator* raw_ucmp_;
+  UserComparatorWrapper ucmp_;
+  InternalKeyComparator icmp_;
   // Store the cache handle, if the block is cached. We need this since the
   // only other place the handle is stored is as an argument to the Cleanable
   // function callback, which is hard to retrieve. When multiple value
@@ -467,6 +489,34 @@ class BlockIter : public InternalIteratorBase<TValue> {
   inline bool BinarySeek(const Slice& target, uint32_t* index,
                          bool* is_index_key_result);
 
+  // Narrows the binary search of `target` to the restart points whose key
+  // prefix equals that of target, which the binary search then looks at
+  // with full key comparisons, with the same loop invariants as
+  // BinarySeek().
+  // REQUIRES: restart_key_prefixes_ != nullptr
+  template <typename DecodeKeyFunc>
+  inline bool NarrowBinarySeekWithKeyPrefixes(const Slice& target,
+                                              int64_t* left, int64_t* right);
+
+  // Narrows the binary search of `target` to the window of restart points
+  // predicted by learned_index_, with the same loop invariants as
+  // BinarySeek(). The bounds of the window are checked against the restart
+  // keys, so the search stays correct wherever the prediction lands.
+  // REQUIRES: learned_index_ != nullptr
+  template <typename DecodeKeyFunc>
+  inline bool NarrowBinarySeekWithLearnedIndex(const Slice& target,
+                                               int64_t* left, int64_t* right);
+
+  // Compares the key of restart point `index` to `target`, storing the result
+  // in `*cmp`. Returns false on corruption.
+  template <typename DecodeKeyFunc>
+  inline bool CompareRestartKey(uint32_t index, const Slice& target, int* cmp);
+
+  // Number of restart points whose key prefix is less than (or, if
+  // kOrEqual, not greater than) prefix.
+  template <bool kOrEqual>
+  inline uint32_t CountRestartKeyPrefixesBelow(uint64_t prefix) const;
+
   void FindKeyAfterBinarySeek(const Slice& target, uint32_t index,
                               bool is_index_key_result);
 };
@@ -478,23 +528,29 @@ class DataBlockIter final : public BlockIter<Slice> {
   DataBlockIter(const Comparator* raw_ucmp, const char* data, uint32_t restarts,
                 uint32_t num_restarts, SequenceNumber global_seqno,
                 BlockReadAmpBitmap* read_amp_bitmap, bool block_contents_pinned,
-                DataBlockHashIndex* data_block_hash_index)
+                DataBlockHashIndex* data_block_hash_index,
+                DataBlockCuckooIndex* data_block_cuckoo_index = nullptr,
+                const char* restart_key_prefixes = nullptr)
       : DataBlockIter() {
     Initialize(raw_ucmp, data, restarts, num_restarts, global_seqno,
-               read_amp_bitmap, block_contents_pinned, data_block_hash_index);
+               read_amp_bitmap, block_contents_pinned, data_block_hash_index,
+               data_block_cuckoo_index, restart_key_prefixes);
   }
   void Initialize(const Comparator* raw_ucmp, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno,
                   BlockReadAmpBitmap* read_amp_bitmap,
                   bool block_contents_pinned,
-                  DataBlockHashIndex* data_block_hash_index) {
+                  DataBlockHashIndex* data_block_hash_index,
+                  DataBlockCuckooIndex* data_block_cuckoo_index = nullptr,
+                  const char* restart_key_prefixes = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
-                   block_contents_pinned);
+                   block_contents_pinned, restart_key_prefixes);
     raw_key_.SetIsUserKey(false);
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    data_block_cuckoo_index_ = data_block_cuckoo_index;
   }
 
   Slice value() const override {
@@ -509,7 +565,7 @@ class DataBlockIter final : public BlockIter<Slice> {
   }
 
   inline bool SeekForGet(const Slice& target) {
-    if (!data_block_hash_index_) {
+    if (!data_block_hash_index_ && !data_block_cuckoo_index_) {
       SeekImpl(target);
       UpdateKey();
       return true;
@@ -581,11 +637,20 @@ class DataBlockIter final : public BlockIter<Slice> {
   int32_t prev_entries_idx_ = -1;
 
   DataBlockHashIndex* data_block_hash_index_;
+  DataBlockCuckooIndex* data_block_cuckoo_index_;
 
   template <typename DecodeEntryFunc>
   inline bool ParseNextDataKey(const char* limit = nullptr);
 
   bool SeekForGetImpl(const Slice& target);
+  // Positions the iterator at the first entry of target_user_key using the
+  // cuckoo index. Returns false if the user key is not in the block.
+  bool SeekToUserKeyWithCuckooIndex(uint32_t map_offset,
+                                    const Slice& target_user_key);
+  // Decides the result of SeekForGetImpl() once the iterator is positioned
+  // at the first entry not less than target, or at the end of the block.
+  bool SeekForGetCheckResult(const Slice& target_user_key,
+                             const Slice& target);
   void NextOrReportImpl();
   void SeekToFirstOrReportImpl();
 };
@@ -602,11 +667,15 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                   uint32_t restarts, uint32_t num_restarts,
                   SequenceNumber global_seqno, BlockPrefixIndex* prefix_index,
                   bool have_first_key, bool key_includes_seq,
-                  bool value_is_full, bool block_contents_pinned) {
+                  bool value_is_full, bool block_contents_pinned,
+                  const char* restart_key_prefixes = nullptr,
+                  const LearnedIndexModel* learned_index = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts,
-                   kDisableGlobalSequenceNumber, block_contents_pinned);
+                   kDisableGlobalSequenceNumber, block_contents_pinned,
+                   restart_key_prefixes);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
+    learned_index_ = learned_index;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
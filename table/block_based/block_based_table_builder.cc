@@ -45,6 +45,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/range_filter.h"
 #include "table/format.h"
 #include "table/table_builder.h"
 #include "util/coding.h"
@@ -319,6 +320,8 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<CacheReservationManager> cache_rev_mng;
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
+  // Builds the range filter, if enabled
+  std::unique_ptr<RangeFilterBuilder> range_filter_builder;
   char cache_key_prefix[BlockBasedTable::kMaxCacheKeyPrefixSize];
   size_t cache_key_prefix_size;
   char compressed_cache_key_prefix[BlockBasedTable::kMaxCacheKeyPrefixSize];
@@ -415,7 +418,10 @@ struct BlockBasedTableBuilder::Rep {
                            ->CanKeysWithDifferentByteContentsBeEqual()
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
-                   table_options.data_block_hash_table_util_ratio),
+                   table_options.data_block_hash_table_util_ratio,
+                   UseRestartKeyPrefixes(
+                       table_options.format_version,
+                       tbo.internal_comparator.user_comparator())),
         range_del_block(1 /* block_restart_interval */),
         internal_prefix_transform(tbo.moptions.prefix_extractor.get()),
         compression_type(tbo.compression_type),
@@ -502,6 +508,13 @@ struct BlockBasedTableBuilder::Rep {
           ioptions, moptions, filter_context,
           use_delta_encoding_for_index_values, p_index_builder_));
     }
+    // The range filter orders keys like BytewiseComparator(), which also has
+    // no timestamps
+    if (table_options.range_filter_bits_per_key > 0 && !tbo.skip_filters &&
+        internal_comparator.user_comparator() == BytewiseComparator()) {
+      range_filter_builder.reset(
+          new RangeFilterBuilder(table_options.range_filter_bits_per_key));
+    }
 
     assert(tbo.int_tbl_prop_collector_factories);
     for (auto& factory : *tbo.int_tbl_prop_collector_factories) {
@@ -872,6 +885,17 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
     // behavior
     sanitized_table_options.format_version = 1;
   }
+  if (sanitized_table_options.data_block_index_type ==
+          BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash &&
+      sanitized_table_options.format_version < 6) {
+    ROCKS_LOG_WARN(
+        tbo.ioptions.logger,
+        "Silently converting data_block_index_type to kDataBlockBinaryAndHash "
+        "because format_version < 6");
+    // Older versions cannot read the cuckoo index
+    sanitized_table_options.data_block_index_type =
+        BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  }
 
   rep_ = new Rep(sanitized_table_options, tbo, file);
 
@@ -961,6 +985,10 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       }
     }
 
+    if (r->range_filter_builder != nullptr) {
+      r->range_filter_builder->Add(ExtractUserKey(key));
+    }
+
     r->data_block.AddWithLastKey(key, value, r->last_key);
     r->last_key.assign(key.data(), key.size());
     if (r->state == Rep::State::kBuffered) {
@@ -1780,6 +1808,20 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WriteRangeFilterBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  std::string range_filter_block;
+  if (ok() && rep_->range_filter_builder != nullptr &&
+      rep_->range_filter_builder->Finish(&range_filter_block)) {
+    BlockHandle range_filter_block_handle;
+    WriteRawBlock(range_filter_block, kNoCompression,
+                  &range_filter_block_handle, BlockType::kRangeFilter);
+    if (ok()) {
+      meta_index_builder->Add(kRangeFilterBlock, range_filter_block_handle);
+    }
+  }
+}
+
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
                                          BlockHandle& index_block_handle) {
   Rep* r = rep_;
@@ -2000,6 +2042,7 @@ Status BlockBasedTableBuilder::Finish() {
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WriteRangeFilterBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
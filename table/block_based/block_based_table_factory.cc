@@ -178,7 +178,9 @@ static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kLearnedIndexSearch",
+         BlockBasedTableOptions::IndexType::kLearnedIndexSearch}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::DataBlockIndexType>
@@ -186,7 +188,10 @@ static std::unordered_map<std::string,
         {"kDataBlockBinarySearch",
          BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch},
         {"kDataBlockBinaryAndHash",
-         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash}};
+         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash},
+        {"kDataBlockBinaryAndCuckooHash",
+         BlockBasedTableOptions::DataBlockIndexType::
+             kDataBlockBinaryAndCuckooHash}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::IndexShorteningMode>
@@ -430,6 +435,14 @@ static std::unordered_map<std::string, OptionTypeInfo>
              offsetof(struct BlockBasedTableOptions, prepopulate_block_cache),
              &block_base_table_prepopulate_block_cache_string_map,
              OptionTypeFlags::kMutable)},
+        {"max_pinned_hot_data_blocks",
+         {offsetof(struct BlockBasedTableOptions, max_pinned_hot_data_blocks),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"range_filter_bits_per_key",
+         {offsetof(struct BlockBasedTableOptions, range_filter_bits_per_key),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 
 #endif  // ROCKSDB_LITE
 };
@@ -473,6 +486,12 @@ void BlockBasedTableFactory::InitializeOptions() {
     // Currently kHashSearch is incompatible with index_block_restart_interval > 1
     table_options_.index_block_restart_interval = 1;
   }
+  if (table_options_.index_type ==
+          BlockBasedTableOptions::kLearnedIndexSearch &&
+      table_options_.index_block_restart_interval != 1) {
+    // The learned index predicts the position of every index entry
+    table_options_.index_block_restart_interval = 1;
+  }
   if (table_options_.partition_filters &&
       table_options_.index_type !=
           BlockBasedTableOptions::kTwoLevelIndexSearch) {
@@ -558,6 +577,13 @@ Status BlockBasedTableFactory::ValidateOptions(
         "data_block_hash_table_util_ratio should be greater than 0 when "
         "data_block_index_type is set to kDataBlockBinaryAndHash");
   }
+  if (table_options_.data_block_index_type ==
+          BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash &&
+      table_options_.format_version < 6) {
+    return Status::InvalidArgument(
+        "data_block_index_type kDataBlockBinaryAndCuckooHash requires "
+        "format_version >= 6");
+  }
   if (db_opts.unordered_write && cf_opts.max_successive_merges > 0) {
     // TODO(myabandeh): support it
     return Status::InvalidArgument(
@@ -697,6 +723,12 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  prepopulate_block_cache: %d\n",
            static_cast<int>(table_options_.prepopulate_block_cache));
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  max_pinned_hot_data_blocks: %u\n",
+           table_options_.max_pinned_hot_data_blocks);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  range_filter_bits_per_key: %g\n",
+           table_options_.range_filter_bits_per_key);
+  ret.append(buffer);
   return ret;
 }
 
@@ -843,6 +875,8 @@ const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kLearnedIndexBlock = "rocksdb.learned.index";
+const std::string kRangeFilterBlock = "rocksdb.range.filter";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -20,6 +20,9 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target) {
     ResetDataIter();
     return;
   }
+  if (!CheckRangeMayMatch(target)) {
+    return;
+  }
 
   bool need_seek_index = true;
   if (block_iter_points_to_real_block_ && block_iter_.Valid()) {
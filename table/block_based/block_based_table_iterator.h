@@ -24,7 +24,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
       const BlockBasedTable* table, const ReadOptions& read_options,
       const InternalKeyComparator& icomp,
       std::unique_ptr<InternalIteratorBase<IndexValue>>&& index_iter,
-      bool check_filter, bool need_upper_bound_check,
+      bool check_filter, bool check_range_filter, bool need_upper_bound_check,
       const SliceTransform* prefix_extractor, TableReaderCaller caller,
       size_t compaction_readahead_size = 0, bool allow_unprepared_value = false)
       : table_(table),
@@ -39,6 +39,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
         allow_unprepared_value_(allow_unprepared_value),
         block_iter_points_to_real_block_(false),
         check_filter_(check_filter),
+        check_range_filter_(check_range_filter),
         need_upper_bound_check_(need_upper_bound_check) {}
 
   ~BlockBasedTableIterator() {}
@@ -209,6 +210,8 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   // that block yet. A call to PrepareValue() will trigger loading the block.
   bool is_at_first_key_from_index_ = false;
   bool check_filter_;
+  // Unlike check_filter_, does not depend on the prefix extractor.
+  bool check_range_filter_;
   // TODO(Zhongyi): pick a better name
   bool need_upper_bound_check_;
 
@@ -247,5 +250,17 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
     }
     return true;
   }
+
+  // Like CheckPrefixMayMatch(), but checks the range filter of the table for
+  // keys between target and the upper bound. Unlike for an upper bound
+  // check, later tables of the level may still have keys in the range, so
+  // the iterator is not marked out of bound.
+  bool CheckRangeMayMatch(const Slice* target) {
+    if (check_range_filter_ && !table_->RangeMayMatch(target, read_options_)) {
+      ResetDataIter();
+      return false;
+    }
+    return true;
+  }
 };
 }  // namespace ROCKSDB_NAMESPACE
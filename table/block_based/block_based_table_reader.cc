@@ -50,6 +50,7 @@
 #include "table/block_based/filter_block.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -73,6 +74,8 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexBlock;
+extern const std::string kRangeFilterBlock;
 
 BlockBasedTable::~BlockBasedTable() {
   delete rep_;
@@ -699,12 +702,24 @@ Status BlockBasedTable::Open(
   }
   SetupCacheKeyPrefix(rep, db_session_id, file_num);
 
+  if (rep->table_options.max_pinned_hot_data_blocks > 0 &&
+      rep->table_options.block_cache != nullptr) {
+    rep->hot_blocks.reset(
+        new HotBlockCache(rep->table_options.block_cache.get(),
+                          rep->table_options.max_pinned_hot_data_blocks));
+  }
+
   s = new_table->ReadRangeDelBlock(ro, prefetch_buffer.get(),
                                    metaindex_iter.get(), internal_comparator,
                                    &lookup_context);
   if (!s.ok()) {
     return s;
   }
+  s = new_table->ReadRangeFilterBlock(prefetch_buffer.get(),
+                                      metaindex_iter.get());
+  if (!s.ok()) {
+    return s;
+  }
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
       prefetch_all, table_options, level, file_size,
@@ -957,6 +972,35 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+Status BlockBasedTable::ReadRangeFilterBlock(FilePrefetchBuffer* prefetch_buffer,
+                                             InternalIterator* meta_iter) {
+  BlockHandle range_filter_handle;
+  if (!FindMetaBlock(meta_iter, kRangeFilterBlock, &range_filter_handle)
+           .ok()) {
+    // No range filter
+    return Status::OK();
+  }
+  BlockContents contents;
+  BlockFetcher block_fetcher(
+      rep_->file.get(), prefetch_buffer, rep_->footer, ReadOptions(),
+      range_filter_handle, &contents, rep_->ioptions, false /* decompress */,
+      false /*maybe_compressed*/, BlockType::kRangeFilter,
+      UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options,
+      GetMemoryAllocator(rep_->table_options));
+  Status s = block_fetcher.ReadBlockContents();
+  if (s.ok()) {
+    s = RangeFilter::Create(std::move(contents), &rep_->range_filter);
+  }
+  if (!s.ok()) {
+    // The table can still be read without the filter
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Encountered error while reading range filter block: %s",
+                   s.ToString().c_str());
+    IGNORE_STATUS_IF_ERROR(s);
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
     InternalIterator* meta_iter, BlockBasedTable* new_table, bool prefetch_all,
@@ -1156,6 +1200,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->uncompression_dict_reader) {
     usage += rep_->uncompression_dict_reader->ApproximateMemoryUsage();
   }
+  if (rep_->range_filter) {
+    usage += rep_->range_filter->ApproximateMemoryUsage();
+  }
   return usage;
 }
 
@@ -2148,6 +2195,41 @@ void BlockBasedTable::RetrieveMultipleBlocks(
   }
 }
 
+bool BlockBasedTable::LookupHotBlock(FilePrefetchBuffer* prefetch_buffer,
+                                     const BlockHandle& handle,
+                                     BlockType block_type,
+                                     GetContext* get_context,
+                                     CachableEntry<Block>* block_entry) const {
+  HotBlockCache* const hot_blocks = rep_->hot_blocks.get();
+  if (hot_blocks == nullptr || block_type != BlockType::kData) {
+    return false;
+  }
+  // Keep block cache traces complete
+  if (block_cache_tracer_ && block_cache_tracer_->is_tracing_enabled()) {
+    return false;
+  }
+  if (!hot_blocks->Lookup(handle.offset(), block_entry)) {
+    return false;
+  }
+  // A pinned block is still a block cache hit as far as statistics and
+  // readahead are concerned.
+  UpdateCacheHitMetrics(block_type, get_context,
+                        rep_->table_options.block_cache->GetUsage(
+                            block_entry->GetCacheHandle()));
+  if (prefetch_buffer) {
+    prefetch_buffer->UpdateReadPattern(handle.offset(), block_size(handle));
+  }
+  return true;
+}
+
+void BlockBasedTable::RecordHotBlockAccess(
+    const BlockHandle& handle, BlockType block_type,
+    const CachableEntry<Block>& block_entry) const {
+  if (rep_->hot_blocks != nullptr && block_type == BlockType::kData) {
+    rep_->hot_blocks->RecordAccess(handle.offset(), block_entry);
+  }
+}
+
 template <typename TBlocklike>
 Status BlockBasedTable::RetrieveBlock(
     FilePrefetchBuffer* prefetch_buffer, const ReadOptions& ro,
@@ -2160,6 +2242,11 @@ Status BlockBasedTable::RetrieveBlock(
 
   Status s;
   if (use_cache) {
+    if (!for_compaction && LookupHotBlock(prefetch_buffer, handle, block_type,
+                                          get_context, block_entry)) {
+      return s;
+    }
+
     s = MaybeReadBlockAndLoadToCache(
         prefetch_buffer, ro, handle, uncompression_dict, wait_for_cache,
         block_entry, block_type, get_context, lookup_context,
@@ -2172,6 +2259,9 @@ Status BlockBasedTable::RetrieveBlock(
     if (block_entry->GetValue() != nullptr ||
         block_entry->GetCacheHandle() != nullptr) {
       assert(s.ok());
+      if (!for_compaction) {
+        RecordHotBlockAccess(handle, block_type, *block_entry);
+      }
       return s;
     }
   }
@@ -2243,6 +2333,11 @@ async_result BlockBasedTable::AsyncRetrieveBlock(
 
   Status s;
   if (use_cache) {
+    if (!for_compaction && LookupHotBlock(prefetch_buffer, handle, block_type,
+                                          get_context, block_entry)) {
+      co_return s;
+    }
+
     auto a_result = AsyncMaybeReadBlockAndLoadToCache(
         prefetch_buffer, ro, handle, uncompression_dict, wait_for_cache,
         block_entry, block_type, get_context, lookup_context,
@@ -2257,6 +2352,9 @@ async_result BlockBasedTable::AsyncRetrieveBlock(
     if (block_entry->GetValue() != nullptr ||
         block_entry->GetCacheHandle() != nullptr) {
       assert(s.ok());
+      if (!for_compaction) {
+        RecordHotBlockAccess(handle, block_type, *block_entry);
+      }
       co_return s;
     }
   }
@@ -2502,6 +2600,23 @@ bool BlockBasedTable::PrefixMayMatch(
   return may_match;
 }
 
+bool BlockBasedTable::RangeMayMatch(const Slice* target,
+                                    const ReadOptions& read_options) const {
+  const RangeFilter* const range_filter = rep_->range_filter.get();
+  if (range_filter == nullptr || read_options.iterate_upper_bound == nullptr) {
+    return true;
+  }
+  const Slice start = target != nullptr ? ExtractUserKey(*target) : Slice();
+  const bool may_match =
+      range_filter->MayContainRange(start, *read_options.iterate_upper_bound);
+  Statistics* statistics = rep_->ioptions.stats;
+  RecordTick(statistics, RANGE_FILTER_CHECKED);
+  if (!may_match) {
+    RecordTick(statistics, RANGE_FILTER_USEFUL);
+  }
+  return may_match;
+}
+
 
 InternalIterator* BlockBasedTable::NewIterator(
     const ReadOptions& read_options, const SliceTransform* prefix_extractor,
@@ -2521,7 +2636,7 @@ InternalIterator* BlockBasedTable::NewIterator(
         this, read_options, rep_->internal_comparator, std::move(index_iter),
         !skip_filters && !read_options.total_order_seek &&
             prefix_extractor != nullptr,
-        need_upper_bound_check, prefix_extractor, caller,
+        !skip_filters, need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   } else {
     auto* mem = arena->AllocateAligned(sizeof(BlockBasedTableIterator));
@@ -2529,7 +2644,7 @@ InternalIterator* BlockBasedTable::NewIterator(
         this, read_options, rep_->internal_comparator, std::move(index_iter),
         !skip_filters && !read_options.total_order_seek &&
             prefix_extractor != nullptr,
-        need_upper_bound_check, prefix_extractor, caller,
+        !skip_filters, need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   }
 }
@@ -3558,6 +3673,14 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kLearnedIndexBlock) {
+    return BlockType::kLearnedIndex;
+  }
+
+  if (meta_block_name == kRangeFilterBlock) {
+    return BlockType::kRangeFilter;
+  }
+
   assert(false);
   return BlockType::kInvalid;
 }
@@ -3597,6 +3720,18 @@ Status BlockBasedTable::VerifyChecksumInMetaBlocks(
   return s;
 }
 
+bool BlockBasedTable::TEST_BlockIsHot(const BlockHandle& handle) const {
+  assert(rep_ != nullptr);
+  return rep_->hot_blocks != nullptr &&
+         rep_->hot_blocks->TEST_IsPinned(handle.offset());
+}
+
+size_t BlockBasedTable::TEST_GetNumHotBlocks() const {
+  assert(rep_ != nullptr);
+  return rep_->hot_blocks != nullptr ? rep_->hot_blocks->TEST_GetNumPinned()
+                                     : 0;
+}
+
 bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
   assert(rep_ != nullptr);
 
@@ -3695,6 +3830,25 @@ Status BlockBasedTable::CreateIndexReader(
                                        pin, lookup_context, index_reader);
       }
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      std::unique_ptr<Block> metaindex_guard;
+      std::unique_ptr<InternalIterator> metaindex_iter_guard;
+      auto meta_index_iter = preloaded_meta_index_iter;
+      if (meta_index_iter == nullptr) {
+        auto s = ReadMetaIndexBlock(ro, prefetch_buffer, &metaindex_guard,
+                                    &metaindex_iter_guard);
+        if (!s.ok()) {
+          // The index block can still be binary searched without the model
+          ROCKS_LOG_WARN(rep_->ioptions.logger,
+                         "Unable to read the metaindex block."
+                         " Fall back to binary search index.");
+        }
+        meta_index_iter = metaindex_iter_guard.get();
+      }
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer,
+                                        meta_index_iter, use_cache, prefetch,
+                                        pin, lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + ToString(rep_->index_type);
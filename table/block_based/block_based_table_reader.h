@@ -19,6 +19,8 @@
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/hot_block_cache.h"
+#include "table/block_based/range_filter.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/table_properties_internal.h"
 #include "table/table_reader.h"
@@ -112,6 +114,12 @@ class BlockBasedTable : public TableReader {
                       const bool need_upper_bound_check,
                       BlockCacheLookupContext* lookup_context) const;
 
+  // Returns false if the range filter of the table shows that it has no key
+  // in [target, read_options.iterate_upper_bound). A null target is before
+  // all keys.
+  bool RangeMayMatch(const Slice* target,
+                     const ReadOptions& read_options) const;
+
   // Returns a new iterator over the table contents.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -190,6 +198,10 @@ class BlockBasedTable : public TableReader {
   bool TEST_FilterBlockInCache() const;
   bool TEST_IndexBlockInCache() const;
 
+  // Returns true if the data block is pinned in the hot block cache.
+  bool TEST_BlockIsHot(const BlockHandle& handle) const;
+  size_t TEST_GetNumHotBlocks() const;
+
   // IndexReader is the interface that provides the functionality for index
   // access.
   class IndexReader {
@@ -358,6 +370,31 @@ class BlockBasedTable : public TableReader {
       GetContext* get_context, BlockCacheLookupContext* lookup_context,
       bool for_compaction, bool use_cache, bool wait_for_cache) const;
 
+  // If the hot block cache is enabled and the data block identified by handle
+  // is pinned there, borrows it into block_entry and returns true. Only data
+  // blocks are served by the hot block cache, so this is a no-op for other
+  // block types.
+  bool LookupHotBlock(FilePrefetchBuffer* prefetch_buffer,
+                      const BlockHandle& handle, BlockType block_type,
+                      GetContext* get_context,
+                      CachableEntry<Block>* block_entry) const;
+  template <typename TBlocklike>
+  bool LookupHotBlock(FilePrefetchBuffer* /*prefetch_buffer*/,
+                      const BlockHandle& /*handle*/, BlockType /*block_type*/,
+                      GetContext* /*get_context*/,
+                      CachableEntry<TBlocklike>* /*block_entry*/) const {
+    return false;
+  }
+
+  // Counts a read of a data block from the block cache toward pinning it in
+  // the hot block cache.
+  void RecordHotBlockAccess(const BlockHandle& handle, BlockType block_type,
+                            const CachableEntry<Block>& block_entry) const;
+  template <typename TBlocklike>
+  void RecordHotBlockAccess(
+      const BlockHandle& /*handle*/, BlockType /*block_type*/,
+      const CachableEntry<TBlocklike>& /*block_entry*/) const {}
+
   void RetrieveMultipleBlocks(
       const ReadOptions& options, const MultiGetRange* batch,
       const autovector<BlockHandle, MultiGetContext::MAX_BATCH_SIZE>* handles,
@@ -474,6 +511,8 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  Status ReadRangeFilterBlock(FilePrefetchBuffer* prefetch_buffer,
+                              InternalIterator* meta_iter);
   Status PrefetchIndexAndFilterBlocks(
       const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
       InternalIterator* meta_iter, BlockBasedTable* new_table,
@@ -609,6 +648,10 @@ struct BlockBasedTable::Rep {
   std::unique_ptr<IndexReader> index_reader;
   std::unique_ptr<FilterBlockReader> filter;
   std::unique_ptr<UncompressionDictReader> uncompression_dict_reader;
+  // Frequently read data blocks pinned in the block cache, if enabled
+  std::unique_ptr<HotBlockCache> hot_blocks;
+  // The range filter of the table, if it has one
+  std::unique_ptr<RangeFilter> range_filter;
 
   enum class FilterType {
     kNoFilter,
@@ -693,20 +736,21 @@ struct BlockBasedTable::Rep {
   void CreateFilePrefetchBuffer(size_t readahead_size,
                                 size_t max_readahead_size,
                                 std::unique_ptr<FilePrefetchBuffer>* fpb,
-                                bool implicit_auto_readahead) const {
+                                bool implicit_auto_readahead,
+                                bool async_io = false) const {
     fpb->reset(new FilePrefetchBuffer(
         file.get(), readahead_size, max_readahead_size,
         !ioptions.allow_mmap_reads /* enable */, false /* track_min_offset*/,
-        implicit_auto_readahead));
+        implicit_auto_readahead, async_io));
   }
 
   void CreateFilePrefetchBufferIfNotExists(
       size_t readahead_size, size_t max_readahead_size,
-      std::unique_ptr<FilePrefetchBuffer>* fpb,
-      bool implicit_auto_readahead) const {
+      std::unique_ptr<FilePrefetchBuffer>* fpb, bool implicit_auto_readahead,
+      bool async_io = false) const {
     if (!(*fpb)) {
       CreateFilePrefetchBuffer(readahead_size, max_readahead_size, fpb,
-                               implicit_auto_readahead);
+                               implicit_auto_readahead, async_io);
     }
   }
 };
@@ -30,6 +30,9 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// The restart array may be followed by restart key prefixes and a hash index
+// (see restart_key_prefixes.h and data_block_hash_index.h), as flagged in
+// num_restarts.
 
 #include "table/block_based/block_builder.h"
 
@@ -46,10 +49,13 @@ BlockBuilder::BlockBuilder(
     int block_restart_interval, bool use_delta_encoding,
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    double data_block_hash_table_util_ratio)
+    double data_block_hash_table_util_ratio, bool use_restart_key_prefixes,
+    bool keys_include_seq)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
+      use_restart_key_prefixes_(use_restart_key_prefixes),
+      keys_include_seq_(keys_include_seq),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -60,6 +66,10 @@ BlockBuilder::BlockBuilder(
       data_block_hash_index_builder_.Initialize(
           data_block_hash_table_util_ratio);
       break;
+    case BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash:
+      data_block_cuckoo_index_builder_.Initialize(
+          data_block_hash_table_util_ratio, block_restart_interval);
+      break;
     default:
       assert(0);
   }
@@ -78,6 +88,7 @@ void BlockBuilder::Reset() {
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
+  data_block_cuckoo_index_builder_.Reset();
 #ifndef NDEBUG
   add_with_last_key_called_ = false;
 #endif
@@ -103,6 +114,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 
   if (counter_ >= block_restart_interval_) {
     estimate += sizeof(uint32_t);  // a new restart entry.
+    if (use_restart_key_prefixes_) {
+      estimate += sizeof(uint64_t);  // and its key prefix.
+    }
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -123,22 +137,65 @@ Slice BlockBuilder::Finish() {
   }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  // Readers ignore the flags of larger blocks
+  bool has_restart_key_prefixes =
+      use_restart_key_prefixes_ && counter_ > 0 &&
+      CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex;
+  if (has_restart_key_prefixes) {
+    AppendRestartKeyPrefixes();
+  }
+
   BlockBasedTableOptions::DataBlockIndexType index_type =
       BlockBasedTableOptions::kDataBlockBinarySearch;
   if (data_block_hash_index_builder_.Valid() &&
       CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  } else if (data_block_cuckoo_index_builder_.Valid() &&
+             CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex &&
+             data_block_cuckoo_index_builder_.Finish(buffer_)) {
+    index_type = BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash;
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer = PackIndexTypeAndNumRestarts(
+      index_type, num_restarts, has_restart_key_prefixes);
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
   return Slice(buffer_);
 }
 
+void BlockBuilder::AppendRestartKeyPrefixes() {
+  // The keys of restart points are not delta encoded, so read them back from
+  // the block
+  const uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  std::vector<Slice> user_keys;
+  user_keys.reserve(num_restarts);
+  const char* limit = buffer_.data() + buffer_.size();
+  for (uint32_t restart : restarts_) {
+    uint32_t shared = 0, non_shared = 0, value_length = 0;
+    const char* p = GetVarint32Ptr(buffer_.data() + restart, limit, &shared);
+    p = GetVarint32Ptr(p, limit, &non_shared);
+    if (!use_value_delta_encoding_) {
+      p = GetVarint32Ptr(p, limit, &value_length);
+    }
+    assert(p != nullptr && shared == 0);
+    Slice key(p, non_shared);
+    user_keys.push_back(keys_include_seq_ ? ExtractUserKey(key) : key);
+  }
+
+  // The keys point into buffer_, so do not grow it before they are used
+  const size_t skip = user_keys.front().difference_offset(user_keys.back());
+  std::string prefixes;
+  prefixes.reserve(RestartKeyPrefixesSize(num_restarts));
+  for (const Slice& user_key : user_keys) {
+    PutFixed64(&prefixes, GetRestartKeyPrefix(user_key, skip));
+  }
+  PutFixed32(&prefixes, static_cast<uint32_t>(skip));
+  buffer_.append(prefixes);
+}
+
 void BlockBuilder::Add(const Slice& key, const Slice& value,
                        const Slice* const delta_value) {
   // Ensure no unsafe mixing of Add and AddWithLastKey
@@ -223,6 +280,9 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Add(ExtractUserKey(key),
                                        restarts_.size() - 1);
+  } else if (data_block_cuckoo_index_builder_.Valid()) {
+    data_block_cuckoo_index_builder_.Add(ExtractUserKey(key),
+                                         restarts_.size() - 1, counter_);
   }
 
   counter_++;
@@ -13,7 +13,9 @@
 #include <stdint.h>
 #include "rocksdb/slice.h"
 #include "rocksdb/table.h"
+#include "table/block_based/data_block_cuckoo_index.h"
 #include "table/block_based/data_block_hash_index.h"
+#include "table/block_based/restart_key_prefixes.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -27,7 +29,9 @@ class BlockBuilder {
                         bool use_value_delta_encoding = false,
                         BlockBasedTableOptions::DataBlockIndexType index_type =
                             BlockBasedTableOptions::kDataBlockBinarySearch,
-                        double data_block_hash_table_util_ratio = 0.75);
+                        double data_block_hash_table_util_ratio = 0.75,
+                        bool use_restart_key_prefixes = false,
+                        bool keys_include_seq = true);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -63,9 +67,17 @@ class BlockBuilder {
   // Returns an estimate of the current (uncompressed) size of the block
   // we are building.
   inline size_t CurrentSizeEstimate() const {
-    return estimate_ + (data_block_hash_index_builder_.Valid()
-                            ? data_block_hash_index_builder_.EstimateSize()
-                            : 0);
+    return estimate_ +
+           (use_restart_key_prefixes_
+                ? RestartKeyPrefixesSize(
+                      static_cast<uint32_t>(restarts_.size()))
+                : 0) +
+           (data_block_hash_index_builder_.Valid()
+                ? data_block_hash_index_builder_.EstimateSize()
+                : 0) +
+           (data_block_cuckoo_index_builder_.Valid()
+                ? data_block_cuckoo_index_builder_.EstimateSize()
+                : 0);
   }
 
   // Returns an estimated block size after appending key and value.
@@ -79,12 +91,17 @@ class BlockBuilder {
                                  const Slice& last_key,
                                  const Slice* const delta_value,
                                  size_t buffer_size);
+  void AppendRestartKeyPrefixes();
 
   const int block_restart_interval_;
   // TODO(myabandeh): put it into a separate IndexBlockBuilder
   const bool use_delta_encoding_;
   // Refer to BlockIter::DecodeCurrentValue for format of delta encoded values
   const bool use_value_delta_encoding_;
+  // See restart_key_prefixes.h
+  const bool use_restart_key_prefixes_;
+  // Whether the keys are internal keys, whose user key the prefixes are of
+  const bool keys_include_seq_;
 
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
@@ -93,6 +110,7 @@ class BlockBuilder {
   bool finished_;  // Has Finish() been called?
   std::string last_key_;
   DataBlockHashIndexBuilder data_block_hash_index_builder_;
+  DataBlockCuckooIndexBuilder data_block_cuckoo_index_builder_;
 #ifndef NDEBUG
   bool add_with_last_key_called_ = false;
 #endif
@@ -14,16 +14,18 @@ void BlockPrefetcher::PrefetchIfNeeded(const BlockBasedTable::Rep* rep,
                                        size_t readahead_size,
                                        bool is_for_compaction) {
   if (is_for_compaction) {
-    rep->CreateFilePrefetchBufferIfNotExists(compaction_readahead_size_,
-                                             compaction_readahead_size_,
-                                             &prefetch_buffer_, false);
+    rep->CreateFilePrefetchBufferIfNotExists(
+        compaction_readahead_size_, compaction_readahead_size_,
+        &prefetch_buffer_, false /* implicit_auto_readahead */,
+        true /* async_io */);
     return;
   }
 
   // Explicit user requested readahead.
   if (readahead_size > 0) {
-    rep->CreateFilePrefetchBufferIfNotExists(readahead_size, readahead_size,
-                                             &prefetch_buffer_, false);
+    rep->CreateFilePrefetchBufferIfNotExists(
+        readahead_size, readahead_size, &prefetch_buffer_,
+        false /* implicit_auto_readahead */, true /* async_io */);
     return;
   }
 
@@ -46,7 +48,7 @@ void BlockPrefetcher::PrefetchIfNeeded(const BlockBasedTable::Rep* rep,
     return;
   }
 
-  if (!IsBlockSequential(offset)) {
+  if (!IsBlockSequential(offset, max_auto_readahead_size)) {
     UpdateReadPattern(offset, len);
     ResetValues();
     return;
@@ -68,9 +70,10 @@ void BlockPrefetcher::PrefetchIfNeeded(const BlockBasedTable::Rep* rep,
   }
 
   if (rep->file->use_direct_io()) {
-    rep->CreateFilePrefetchBufferIfNotExists(initial_auto_readahead_size,
-                                             max_auto_readahead_size,
-                                             &prefetch_buffer_, true);
+    rep->CreateFilePrefetchBufferIfNotExists(
+        initial_auto_readahead_size, max_auto_readahead_size,
+        &prefetch_buffer_, true /* implicit_auto_readahead */,
+        true /* async_io */);
     return;
   }
 
@@ -84,9 +87,10 @@ void BlockPrefetcher::PrefetchIfNeeded(const BlockBasedTable::Rep* rep,
   Status s = rep->file->Prefetch(handle.offset(),
                                  block_size(handle) + readahead_size_);
   if (s.IsNotSupported()) {
-    rep->CreateFilePrefetchBufferIfNotExists(initial_auto_readahead_size,
-                                             max_auto_readahead_size,
-                                             &prefetch_buffer_, true);
+    rep->CreateFilePrefetchBufferIfNotExists(
+        initial_auto_readahead_size, max_auto_readahead_size,
+        &prefetch_buffer_, true /* implicit_auto_readahead */,
+        true /* async_io */);
     return;
   }
 
@@ -7,6 +7,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
+#include "file/file_prefetch_buffer.h"
 #include "table/block_based/block_based_table_reader.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -20,12 +21,15 @@ class BlockPrefetcher {
   FilePrefetchBuffer* prefetch_buffer() { return prefetch_buffer_.get(); }
 
   void UpdateReadPattern(const size_t& offset, const size_t& len) {
-    prev_offset_ = offset;
-    prev_len_ = len;
+    read_pattern_.Update(offset, len);
   }
 
-  bool IsBlockSequential(const size_t& offset) {
-    return (prev_len_ == 0 || (prev_offset_ + prev_len_ == offset));
+  bool IsBlockSequential(const size_t& offset,
+                         const size_t& max_readahead_size) {
+    return read_pattern_.IsSequential(
+        offset,
+        num_file_reads_ > BlockBasedTable::kMinNumFileReadsToStartAutoReadahead,
+        readahead_size_, max_readahead_size);
   }
 
   void ResetValues() {
@@ -43,8 +47,7 @@ class BlockPrefetcher {
   size_t readahead_size_ = BlockBasedTable::kInitAutoReadaheadSize;
   size_t readahead_limit_ = 0;
   int64_t num_file_reads_ = 0;
-  size_t prev_offset_ = 0;
-  size_t prev_len_ = 0;
+  ReadPattern read_pattern_;
   std::unique_ptr<FilePrefetchBuffer> prefetch_buffer_;
 };
 }  // namespace ROCKSDB_NAMESPACE
@@ -22,6 +22,7 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_index.h"
 #include "table/format.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
@@ -489,6 +490,247 @@ TEST_F(BlockTest, ReadAmpBitmapPow2) {
   ASSERT_EQ(BlockReadAmpBitmap(100, 35, stats.get()).GetBytesPerBit(), 32u);
 }
 
+// Random user keys that share `common_prefix`, made of few distinct bytes
+// (including zero) so that many keys share their fixed-width prefixes or
+// only differ by zero padding.
+std::string RandomRestartKeyPrefixesTestKey(Random *rnd,
+                                            const std::string &common_prefix) {
+  static const char kBytes[] = {'\0', 'a', 'b'};
+  std::string key = common_prefix;
+  int len = rnd->Uniform(13);
+  for (int i = 0; i < len; ++i) {
+    key.push_back(kBytes[rnd->Uniform(3)]);
+  }
+  return key;
+}
+
+TEST_F(BlockTest, RestartKeyPrefixes) {
+  Random rnd(301);
+  for (const std::string common_prefix : {"", "common/prefix/"}) {
+    for (int restart_interval : {1, 4, 16}) {
+      std::set<std::string> user_keys;
+      while (user_keys.size() < 500) {
+        user_keys.insert(RandomRestartKeyPrefixesTestKey(&rnd, common_prefix));
+      }
+
+      BlockBuilder builder(restart_interval);
+      BlockBuilder prefixes_builder(
+          restart_interval, true /* use_delta_encoding */,
+          false /* use_value_delta_encoding */,
+          BlockBasedTableOptions::kDataBlockBinarySearch,
+          0.75 /* data_block_hash_table_util_ratio */,
+          true /* use_restart_key_prefixes */);
+      for (const std::string &user_key : user_keys) {
+        for (SequenceNumber seq = 1 + rnd.Uniform(3); seq > 0; --seq) {
+          InternalKey ikey(user_key, seq * 2, kTypeValue);
+          builder.Add(ikey.Encode(), "v");
+          prefixes_builder.Add(ikey.Encode(), "v");
+        }
+      }
+
+      BlockContents contents(builder.Finish());
+      Block block(std::move(contents));
+      BlockContents prefixes_contents(prefixes_builder.Finish());
+      Block prefixes_block(std::move(prefixes_contents));
+      ASSERT_FALSE(block.HasRestartKeyPrefixes());
+      ASSERT_TRUE(prefixes_block.HasRestartKeyPrefixes());
+      ASSERT_EQ(block.NumRestarts(), prefixes_block.NumRestarts());
+
+      std::unique_ptr<DataBlockIter> iter(block.NewDataIterator(
+          BytewiseComparator(), kDisableGlobalSequenceNumber));
+      std::unique_ptr<DataBlockIter> prefixes_iter(
+          prefixes_block.NewDataIterator(BytewiseComparator(),
+                                         kDisableGlobalSequenceNumber));
+
+      std::vector<std::string> targets(user_keys.begin(), user_keys.end());
+      for (int i = 0; i < 1000; ++i) {
+        targets.push_back(RandomRestartKeyPrefixesTestKey(&rnd, common_prefix));
+      }
+      for (size_t len = 0; len <= common_prefix.size(); ++len) {
+        targets.push_back(common_prefix.substr(0, len));
+        targets.push_back(common_prefix.substr(0, len) + "\xff");
+      }
+      for (const std::string &target : targets) {
+        InternalKey ikey(target, rnd.Uniform(8), kValueTypeForSeek);
+        iter->Seek(ikey.Encode());
+        prefixes_iter->Seek(ikey.Encode());
+        ASSERT_OK(prefixes_iter->status());
+        ASSERT_EQ(iter->Valid(), prefixes_iter->Valid());
+        if (iter->Valid()) {
+          ASSERT_EQ(iter->key(), prefixes_iter->key());
+        }
+
+        iter->SeekForPrev(ikey.Encode());
+        prefixes_iter->SeekForPrev(ikey.Encode());
+        ASSERT_OK(prefixes_iter->status());
+        ASSERT_EQ(iter->Valid(), prefixes_iter->Valid());
+        if (iter->Valid()) {
+          ASSERT_EQ(iter->key(), prefixes_iter->key());
+        }
+      }
+    }
+  }
+}
+
+TEST_F(BlockTest, RestartKeyPrefixesIndexBlockWithoutSeq) {
+  Random rnd(301);
+  const std::string common_prefix = "index/";
+  std::set<std::string> user_keys;
+  while (user_keys.size() < 300) {
+    user_keys.insert(RandomRestartKeyPrefixesTestKey(&rnd, common_prefix));
+  }
+
+  // Index blocks without sequence numbers hold user keys, and their values
+  // may be delta encoded
+  BlockBuilder builder(2 /* block_restart_interval */,
+                       true /* use_delta_encoding */,
+                       true /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinarySearch,
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       true /* use_restart_key_prefixes */,
+                       false /* keys_include_seq */);
+  BlockHandle last_handle = BlockHandle::NullBlockHandle();
+  uint64_t offset = 0;
+  for (const std::string &user_key : user_keys) {
+    IndexValue entry(BlockHandle(offset, 100), Slice());
+    offset += 100 + kBlockTrailerSize;
+    std::string encoded_entry;
+    std::string delta_encoded_entry;
+    entry.EncodeTo(&encoded_entry, false /* have_first_key */, nullptr);
+    if (!last_handle.IsNull()) {
+      entry.EncodeTo(&delta_encoded_entry, false /* have_first_key */,
+                     &last_handle);
+    }
+    last_handle = entry.handle;
+    const Slice delta_encoded_entry_slice(delta_encoded_entry);
+    builder.Add(user_key, encoded_entry, &delta_encoded_entry_slice);
+  }
+
+  BlockContents contents(builder.Finish());
+  Block block(std::move(contents));
+  ASSERT_TRUE(block.HasRestartKeyPrefixes());
+  std::unique_ptr<IndexBlockIter> iter(block.NewIndexIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+      true /* total_order_seek */, false /* have_first_key */,
+      false /* key_includes_seq */, false /* value_is_full */));
+
+  std::vector<std::string> targets(user_keys.begin(), user_keys.end());
+  for (int i = 0; i < 1000; ++i) {
+    targets.push_back(RandomRestartKeyPrefixesTestKey(&rnd, common_prefix));
+  }
+  targets.push_back("");
+  targets.push_back("\xff");
+  for (const std::string &target : targets) {
+    // The iterator extracts the user key of the target
+    InternalKey ikey(target, kMaxSequenceNumber, kValueTypeForSeek);
+    iter->Seek(ikey.Encode());
+    ASSERT_OK(iter->status());
+    auto expected = user_keys.lower_bound(target);
+    if (expected == user_keys.end()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(*expected, iter->key().ToString());
+      ASSERT_EQ(
+          static_cast<uint64_t>(std::distance(user_keys.begin(), expected)) *
+              (100 + kBlockTrailerSize),
+          iter->value().handle.offset());
+    }
+  }
+}
+
+namespace {
+// "key" followed by the big-endian encoding of n
+std::string LearnedIndexTestKey(uint64_t n) {
+  std::string key = "key";
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>((n >> shift) & 0xff));
+  }
+  return key;
+}
+}  // namespace
+
+TEST_F(BlockTest, LearnedIndex) {
+  Random rnd(301);
+  std::vector<std::string> user_keys;
+  for (uint64_t i = 0; i < 2000; ++i) {
+    user_keys.push_back(LearnedIndexTestKey(i * 7 + rnd.Uniform(3)));
+  }
+
+  BlockBuilder builder(1 /* block_restart_interval */,
+                       true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinarySearch,
+                       0.75 /* data_block_hash_table_util_ratio */,
+                       false /* use_restart_key_prefixes */,
+                       false /* keys_include_seq */);
+  LearnedIndexModelBuilder model_builder;
+  // A model of keys distributed differently, so that the predictions for
+  // user_keys are off
+  LearnedIndexModelBuilder skewed_model_builder;
+  for (size_t i = 0; i < user_keys.size(); ++i) {
+    IndexValue entry(BlockHandle(i * 1000, 100), Slice());
+    std::string encoded_entry;
+    entry.EncodeTo(&encoded_entry, false /* have_first_key */, nullptr);
+    builder.Add(user_keys[i], encoded_entry);
+    model_builder.Add(user_keys[i]);
+    skewed_model_builder.Add(LearnedIndexTestKey(uint64_t{i} * i * i));
+  }
+  BlockContents contents(builder.Finish());
+  Block block(std::move(contents));
+
+  std::string model_block;
+  ASSERT_TRUE(model_builder.Finish(&model_block));
+  std::unique_ptr<LearnedIndexModel> model;
+  ASSERT_OK(LearnedIndexModel::Create(model_block, &model));
+  ASSERT_EQ(user_keys.size(), model->num_entries());
+  // Evenly distributed keys fit in very few segments
+  ASSERT_LE(model->num_segments(), 2u);
+  for (size_t i = 0; i < user_keys.size(); ++i) {
+    ASSERT_LE(std::abs(static_cast<int64_t>(model->Predict(user_keys[i])) -
+                       static_cast<int64_t>(i)),
+              static_cast<int64_t>(model->epsilon()));
+  }
+
+  std::string skewed_model_block;
+  ASSERT_TRUE(skewed_model_builder.Finish(&skewed_model_block));
+  std::unique_ptr<LearnedIndexModel> skewed_model;
+  ASSERT_OK(LearnedIndexModel::Create(skewed_model_block, &skewed_model));
+  ASSERT_GT(skewed_model->num_segments(), 2u);
+
+  std::vector<std::string> targets(user_keys);
+  for (int i = 0; i < 1000; ++i) {
+    targets.push_back(LearnedIndexTestKey(rnd.Uniform(2000 * 7 + 10)));
+  }
+  targets.push_back("");
+  targets.push_back("key");
+  targets.push_back("kez");
+  targets.push_back("\xff");
+  for (const LearnedIndexModel *m : {model.get(), skewed_model.get()}) {
+    std::unique_ptr<IndexBlockIter> iter(block.NewIndexIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+        true /* total_order_seek */, false /* have_first_key */,
+        false /* key_includes_seq */, true /* value_is_full */,
+        false /* block_contents_pinned */, nullptr /* prefix_index */, m));
+    for (const std::string &target : targets) {
+      InternalKey ikey(target, kMaxSequenceNumber, kValueTypeForSeek);
+      iter->Seek(ikey.Encode());
+      ASSERT_OK(iter->status());
+      auto expected =
+          std::lower_bound(user_keys.begin(), user_keys.end(), target);
+      if (expected == user_keys.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(*expected, iter->key().ToString());
+        ASSERT_EQ(
+            static_cast<uint64_t>(expected - user_keys.begin()) * 1000,
+            iter->value().handle.offset());
+      }
+    }
+  }
+}
+
 class IndexBlockTest
     : public testing::Test,
       public testing::WithParamInterface<std::tuple<bool, bool>> {
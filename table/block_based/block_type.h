@@ -25,6 +25,8 @@ enum class BlockType : uint8_t {
   kHashIndexMetadata,
   kMetaIndex,
   kIndex,
+  kLearnedIndex,
+  kRangeFilter,
   // Note: keep kInvalid the last value when adding new enum values.
   kInvalid
 };
@@ -33,6 +33,10 @@ namespace ROCKSDB_NAMESPACE {
 // is transferred to some other object. This is used for instance with iterators
 // (where cleanup is performed using a chain of cleanup functions,
 // see Cleanable).
+// 5) It may borrow a reference to a cached object that somebody else keeps
+// pinned in the block cache (see HotBlockCache). In this case, cache_ and
+// cache_handle_ identify the cached object, but the reference is given back
+// by calling a custom release function instead of releasing the cache handle.
 //
 // Because of #1 and #2 above, copying a CachableEntry is not safe (and thus not
 // allowed); hence, this is a move-only type, where a move transfers the
@@ -64,6 +68,9 @@ public:
     , cache_(rhs.cache_)
     , cache_handle_(rhs.cache_handle_)
     , own_value_(rhs.own_value_)
+    , release_(rhs.release_)
+    , release_arg1_(rhs.release_arg1_)
+    , release_arg2_(rhs.release_arg2_)
   {
     assert(value_ != nullptr ||
       (cache_ == nullptr && cache_handle_ == nullptr && !own_value_));
@@ -84,6 +91,9 @@ public:
     cache_ = rhs.cache_;
     cache_handle_ = rhs.cache_handle_;
     own_value_ = rhs.own_value_;
+    release_ = rhs.release_;
+    release_arg1_ = rhs.release_arg1_;
+    release_arg2_ = rhs.release_arg2_;
 
     assert(value_ != nullptr ||
       (cache_ == nullptr && cache_handle_ == nullptr && !own_value_));
@@ -114,6 +124,7 @@ public:
   Cache* GetCache() const { return cache_; }
   Cache::Handle* GetCacheHandle() const { return cache_handle_; }
   bool GetOwnValue() const { return own_value_; }
+  bool IsBorrowed() const { return release_ != nullptr; }
 
   void Reset() {
     ReleaseResource();
@@ -122,7 +133,9 @@ public:
 
   void TransferTo(Cleanable* cleanable) {
     if (cleanable) {
-      if (cache_handle_ != nullptr) {
+      if (release_ != nullptr) {
+        cleanable->RegisterCleanup(release_, release_arg1_, release_arg2_);
+      } else if (cache_handle_ != nullptr) {
         assert(cache_ != nullptr);
         cleanable->RegisterCleanup(&ReleaseCacheHandle, cache_, cache_handle_);
       } else if (own_value_) {
@@ -166,7 +179,8 @@ public:
     assert(cache_handle != nullptr);
 
     if (UNLIKELY(value_ == value && cache_ == cache &&
-                 cache_handle_ == cache_handle && !own_value_)) {
+                 cache_handle_ == cache_handle && !own_value_ &&
+                 release_ == nullptr)) {
       return;
     }
 
@@ -178,6 +192,28 @@ public:
     assert(!own_value_);
   }
 
+  // Refer to a cached object without taking a reference of the cache handle.
+  // `release` is called with `release_arg1` and `release_arg2` once the
+  // entry (or the Cleanable it is transferred to) is done with the object.
+  void SetBorrowedValue(T* value, Cache* cache, Cache::Handle* cache_handle,
+                        Cleanable::CleanupFunction release, void* release_arg1,
+                        void* release_arg2) {
+    assert(value != nullptr);
+    assert(cache != nullptr);
+    assert(cache_handle != nullptr);
+    assert(release != nullptr);
+
+    Reset();
+
+    value_ = value;
+    cache_ = cache;
+    cache_handle_ = cache_handle;
+    release_ = release;
+    release_arg1_ = release_arg1;
+    release_arg2_ = release_arg2;
+    assert(!own_value_);
+  }
+
   void UpdateCachedValue() {
     assert(cache_ != nullptr);
     assert(cache_handle_ != nullptr);
@@ -196,7 +232,9 @@ public:
 
 private:
   void ReleaseResource() {
-    if (LIKELY(cache_handle_ != nullptr)) {
+    if (UNLIKELY(release_ != nullptr)) {
+      (*release_)(release_arg1_, release_arg2_);
+    } else if (LIKELY(cache_handle_ != nullptr)) {
       assert(cache_ != nullptr);
       cache_->Release(cache_handle_);
     } else if (own_value_) {
@@ -209,6 +247,9 @@ private:
     cache_ = nullptr;
     cache_handle_ = nullptr;
     own_value_ = false;
+    release_ = nullptr;
+    release_arg1_ = nullptr;
+    release_arg2_ = nullptr;
   }
 
   static void ReleaseCacheHandle(void* arg1, void* arg2) {
@@ -230,6 +271,9 @@ private:
   Cache* cache_ = nullptr;
   Cache::Handle* cache_handle_ = nullptr;
   bool own_value_ = false;
+  Cleanable::CleanupFunction release_ = nullptr;
+  void* release_arg1_ = nullptr;
+  void* release_arg2_ = nullptr;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,230 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/data_block_cuckoo_index.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "util/coding.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+#include "util/math.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+const double kDefaultCuckooUtilRatio = 0.75;
+// A 4-way bucketized cuckoo table fills reliably up to about 95%
+const double kMaxCuckooUtilRatio = 0.9;
+const uint32_t kMaxNumBuckets = 0xfffe;
+const int kMaxKicks = 500;
+const int kMaxPlacementAttempts = 4;
+
+inline void GetBucketsAndFingerprint(uint64_t hash, uint32_t num_buckets,
+                                     uint32_t* bucket1, uint32_t* bucket2,
+                                     uint8_t* fingerprint) {
+  assert(num_buckets >= 2);
+  *bucket1 = FastRange32(Lower32of64(hash), num_buckets);
+  *bucket2 = FastRange32(Upper32of64(hash), num_buckets);
+  if (*bucket2 == *bucket1) {
+    *bucket2 = *bucket1 + 1 < num_buckets ? *bucket1 + 1 : 0;
+  }
+  // FastRange32 only depends on the low bits weakly, so use them for the
+  // fingerprint. Zero marks an empty slot.
+  *fingerprint = static_cast<uint8_t>(hash);
+  if (*fingerprint == 0) {
+    *fingerprint = 1;
+  }
+}
+
+}  // namespace
+
+void DataBlockCuckooIndexBuilder::Initialize(double util_ratio,
+                                             int restart_interval) {
+  if (util_ratio <= 0) {
+    util_ratio = kDefaultCuckooUtilRatio;  // sanity check
+  }
+  util_ratio_ = std::min(util_ratio, kMaxCuckooUtilRatio);
+  ordinal_bits_ = 0;
+  while ((1 << ordinal_bits_) < restart_interval) {
+    ++ordinal_bits_;
+  }
+  // An entry of the first restart interval must be addressable
+  valid_ = ordinal_bits_ < 16;
+}
+
+size_t DataBlockCuckooIndexBuilder::NumBuckets(size_t num_keys) const {
+  size_t num_buckets = static_cast<size_t>(
+      static_cast<double>(num_keys) / (kSlotsPerBucket * util_ratio_) + 1);
+  // Even, to tell the index apart from DataBlockHashIndex
+  num_buckets = (num_buckets + 1) & ~size_t{1};
+  return std::max(num_buckets, size_t{2});
+}
+
+void DataBlockCuckooIndexBuilder::Add(const Slice& user_key,
+                                      size_t restart_index, size_t ordinal) {
+  assert(Valid());
+  if (!hashes_and_locators_.empty() && user_key == Slice(last_user_key_)) {
+    // Lookups start from the first (newest) entry of a user key
+    return;
+  }
+  assert(ordinal < (size_t{1} << ordinal_bits_));
+  if ((restart_index >> (16 - ordinal_bits_)) != 0 ||
+      hashes_and_locators_.size() >= kMaxKeysSupportedByCuckooIndex) {
+    valid_ = false;
+    return;
+  }
+  last_user_key_.assign(user_key.data(), user_key.size());
+  uint16_t locator =
+      static_cast<uint16_t>((restart_index << ordinal_bits_) | ordinal);
+  hashes_and_locators_.emplace_back(GetSliceHash64(user_key), locator);
+}
+
+bool DataBlockCuckooIndexBuilder::Finish(std::string& buffer) {
+  assert(Valid());
+  const size_t num_keys = hashes_and_locators_.size();
+  size_t num_buckets = NumBuckets(num_keys);
+
+  for (int attempt = 0; attempt < kMaxPlacementAttempts; ++attempt) {
+    if (num_buckets > kMaxNumBuckets) {
+      break;
+    }
+    const uint32_t nb = static_cast<uint32_t>(num_buckets);
+    // Index in hashes_and_locators_ of the key in each slot, or -1
+    std::vector<int32_t> slots(num_buckets * kSlotsPerBucket, -1);
+    // Deterministic, so that the same keys produce the same block
+    Random rnd(static_cast<uint32_t>(num_keys) + 0x9e37u);
+    bool placed_all = true;
+    for (size_t i = 0; i < num_keys && placed_all; ++i) {
+      int32_t item = static_cast<int32_t>(i);
+      placed_all = false;
+      for (int kick = 0; kick < kMaxKicks; ++kick) {
+        uint32_t buckets[2];
+        uint8_t fingerprint;
+        GetBucketsAndFingerprint(hashes_and_locators_[item].first, nb,
+                                 &buckets[0], &buckets[1], &fingerprint);
+        int32_t* free_slot = nullptr;
+        for (uint32_t bucket : buckets) {
+          for (size_t s = 0; s < kSlotsPerBucket && !free_slot; ++s) {
+            if (slots[bucket * kSlotsPerBucket + s] < 0) {
+              free_slot = &slots[bucket * kSlotsPerBucket + s];
+            }
+          }
+        }
+        if (free_slot != nullptr) {
+          *free_slot = item;
+          placed_all = true;
+          break;
+        }
+        // Evict a random key of a random candidate bucket, and move it to
+        // its other bucket in the next round
+        uint32_t bucket = buckets[rnd.Uniform(2)];
+        std::swap(
+            item,
+            slots[bucket * kSlotsPerBucket + rnd.Uniform(kSlotsPerBucket)]);
+      }
+    }
+
+    if (placed_all) {
+      std::string fingerprints(num_buckets * kSlotsPerBucket, '\0');
+      std::string locators;
+      locators.reserve(num_buckets * kSlotsPerBucket * sizeof(uint16_t));
+      for (size_t s = 0; s < slots.size(); ++s) {
+        uint16_t locator = 0;
+        if (slots[s] >= 0) {
+          uint32_t bucket1, bucket2;
+          uint8_t fingerprint;
+          GetBucketsAndFingerprint(hashes_and_locators_[slots[s]].first, nb,
+                                   &bucket1, &bucket2, &fingerprint);
+          fingerprints[s] = static_cast<char>(fingerprint);
+          locator = hashes_and_locators_[slots[s]].second;
+        }
+        PutFixed16(&locators, locator);
+      }
+      buffer.append(fingerprints);
+      buffer.append(locators);
+      PutFixed16(&buffer, ordinal_bits_);
+      PutFixed16(&buffer, static_cast<uint16_t>(num_buckets));
+      return true;
+    }
+    // Retry with more room
+    num_buckets = (num_buckets + num_buckets / 4 + 2) & ~size_t{1};
+  }
+  return false;
+}
+
+void DataBlockCuckooIndexBuilder::Reset() {
+  valid_ = ordinal_bits_ < 16;
+  last_user_key_.clear();
+  hashes_and_locators_.clear();
+}
+
+bool DataBlockCuckooIndex::Initialize(const char* data, uint32_t size,
+                                      uint32_t* map_offset) {
+  num_buckets_ = 0;
+  if (size < 2 * sizeof(uint16_t)) {
+    return false;
+  }
+  uint16_t num_buckets = DecodeFixed16(data + size - sizeof(uint16_t));
+  uint16_t ordinal_bits = DecodeFixed16(data + size - 2 * sizeof(uint16_t));
+  if (num_buckets == 0 || (num_buckets & 1) != 0 || ordinal_bits >= 16) {
+    return false;
+  }
+  const uint32_t index_size =
+      static_cast<uint32_t>(num_buckets * kSlotsPerBucket *
+                            (sizeof(uint8_t) + sizeof(uint16_t))) +
+      2 * sizeof(uint16_t);
+  if (index_size > size) {
+    return false;
+  }
+  num_buckets_ = num_buckets;
+  ordinal_bits_ = ordinal_bits;
+  *map_offset = size - index_size;
+  return true;
+}
+
+size_t DataBlockCuckooIndex::Lookup(const char* data, uint32_t map_offset,
+                                    const Slice& key,
+                                    uint16_t* locators) const {
+  assert(Valid());
+  uint32_t buckets[2];
+  uint8_t fingerprint;
+  GetBucketsAndFingerprint(GetSliceHash64(key), num_buckets_, &buckets[0],
+                           &buckets[1], &fingerprint);
+  const char* fingerprints = data + map_offset;
+  const char* locator_array = fingerprints + num_buckets_ * kSlotsPerBucket;
+  const uint32_t pattern = uint32_t{fingerprint} * 0x01010101u;
+
+  size_t num_candidates = 0;
+  for (uint32_t bucket : buckets) {
+    const char* bucket_fingerprints = fingerprints + bucket * kSlotsPerBucket;
+    // Flag the bytes of the bucket equal to the fingerprint, all four at
+    // once. A byte right above a matching one may be flagged spuriously, so
+    // the flagged slots are checked again below.
+    const uint32_t x = DecodeFixed32(bucket_fingerprints) ^ pattern;
+    uint32_t matches = (x - 0x01010101u) & ~x & 0x80808080u;
+    while (matches != 0) {
+      const int slot = CountTrailingZeroBits(matches) / 8;
+      matches &= matches - 1;
+      if (static_cast<uint8_t>(bucket_fingerprints[slot]) == fingerprint) {
+        locators[num_candidates++] = DecodeFixed16(
+            locator_array +
+            (bucket * kSlotsPerBucket + slot) * sizeof(uint16_t));
+      }
+    }
+  }
+  assert(num_candidates <= kMaxCandidates);
+  return num_candidates;
+}
+
+bool IsDataBlockCuckooIndex(const char* data, uint32_t size) {
+  return size >= sizeof(uint16_t) &&
+         (DecodeFixed16(data + size - sizeof(uint16_t)) & 1) == 0;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,131 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+// An in-block hash index for point lookups in data blocks, written with
+// BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash (format_version >= 6).
+// Unlike DataBlockHashIndex, it points at the exact entry holding the newest
+// version of a user key instead of at its restart interval, and it has no
+// collision marker: every distinct user key of the block is indexed.
+//
+// The block layout is the same as with DataBlockHashIndex:
+//
+// DATA_BLOCK: [RI RI RI ... RI RI_IDX CUCKOO_IDX FOOTER]
+//
+// where FOOTER has the hash index flag set. The index is a bucketized cuckoo
+// hash table with kSlotsPerBucket slots per bucket:
+//
+// CUCKOO_IDX: [FP FP ... FP LOC LOC ... LOC ORDINAL_BITS NUM_BUCK]
+//
+// FP:           uint8_t fingerprint of the user key in a slot, 0 if empty.
+//               The fingerprints of a bucket are adjacent, so a bucket is
+//               probed by a single word-wide comparison.
+// LOC:          uint16_t locator of the entry in a slot:
+//               (restart_index << ORDINAL_BITS) | ordinal, where ordinal is
+//               the position of the entry in its restart interval.
+// ORDINAL_BITS: uint16_t, enough bits for block_restart_interval - 1.
+// NUM_BUCK:     uint16_t number of buckets. It is always even, while the
+//               NUM_BUCK of DataBlockHashIndex is always odd, which tells
+//               the two indexes apart.
+//
+// A user key may be in either of its two candidate buckets, so a lookup
+// probes at most 2 * kSlotsPerBucket fingerprints and decodes the entries
+// whose fingerprint matches until the user key compares equal.
+//
+// The index is not built if a locator does not fit in 16 bits, if the keys
+// cannot be placed in the table, or if the block would be larger than
+// kMaxBlockSizeSupportedByHashIndex, as readers ignore the index flag of
+// larger blocks; such blocks are searched with binary search only.
+
+// Because the number of buckets is a uint16_t
+const size_t kMaxKeysSupportedByCuckooIndex = 1u << 16;
+
+class DataBlockCuckooIndexBuilder {
+ public:
+  static constexpr size_t kSlotsPerBucket = 4;
+
+  DataBlockCuckooIndexBuilder()
+      : util_ratio_(-1 /*uninitialized marker*/),
+        ordinal_bits_(0),
+        valid_(false) {}
+
+  void Initialize(double util_ratio, int restart_interval);
+
+  inline bool Valid() const { return valid_ && util_ratio_ > 0; }
+
+  // Adds an entry of the block. Only the first entry of each user key is
+  // indexed.
+  void Add(const Slice& user_key, size_t restart_index, size_t ordinal);
+
+  // Appends the index to buffer and returns true, or returns false without
+  // touching buffer if the keys could not be placed.
+  bool Finish(std::string& buffer);
+
+  void Reset();
+
+  size_t EstimateSize() const {
+    return (NumBuckets(hashes_and_locators_.size()) * kSlotsPerBucket) *
+               (sizeof(uint8_t) + sizeof(uint16_t)) +
+           2 * sizeof(uint16_t);
+  }
+
+ private:
+  size_t NumBuckets(size_t num_keys) const;
+
+  double util_ratio_;
+  uint16_t ordinal_bits_;
+  // Set to false when a locator does not fit in 16 bits. In this case the
+  // index is not appended to the block content.
+  bool valid_;
+  std::string last_user_key_;
+  std::vector<std::pair<uint64_t, uint16_t>> hashes_and_locators_;
+};
+
+class DataBlockCuckooIndex {
+ public:
+  static constexpr size_t kSlotsPerBucket =
+      DataBlockCuckooIndexBuilder::kSlotsPerBucket;
+  static constexpr size_t kMaxCandidates = 2 * kSlotsPerBucket;
+
+  DataBlockCuckooIndex() : num_buckets_(0), ordinal_bits_(0) {}
+
+  // Parses the index at the end of data[0, size), setting map_offset to its
+  // start. Returns false if the index is malformed.
+  bool Initialize(const char* data, uint32_t size, uint32_t* map_offset);
+
+  // Stores the locators of the entries whose fingerprint matches key in
+  // locators, which must have room for kMaxCandidates, and returns their
+  // number.
+  size_t Lookup(const char* data, uint32_t map_offset, const Slice& key,
+                uint16_t* locators) const;
+
+  uint32_t GetRestartIndex(uint16_t locator) const {
+    return locator >> ordinal_bits_;
+  }
+  uint32_t GetOrdinal(uint16_t locator) const {
+    return locator & ((1u << ordinal_bits_) - 1);
+  }
+
+  inline bool Valid() const { return num_buckets_ != 0; }
+
+ private:
+  uint16_t num_buckets_;
+  uint16_t ordinal_bits_;
+};
+
+// Returns true if the hash index of a data block whose content (without the
+// block footer) is data[0, size) is a DataBlockCuckooIndex rather than a
+// DataBlockHashIndex.
+bool IsDataBlockCuckooIndex(const char* data, uint32_t size);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -13,13 +13,16 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+// `has_restart_key_prefixes` says whether the restart array is followed by
+// restart key prefixes (see restart_key_prefixes.h), which only blocks of
+// format_version >= 6 tables may have.
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool has_restart_key_prefixes = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* has_restart_key_prefixes = nullptr);
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -14,6 +14,7 @@
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/data_block_cuckoo_index.h"
 #include "table/get_context.h"
 #include "table/table_builder.h"
 #include "test_util/testharness.h"
@@ -529,6 +530,184 @@ TEST(DataBlockHashIndex, BlockTestLarge) {
   }
 }
 
+TEST(DataBlockHashIndex, CuckooIndexTest) {
+  const int kRestartInterval = 16;
+  const int kNumKeys = 1000;
+  DataBlockCuckooIndexBuilder builder;
+  builder.Initialize(0.75 /* util_ratio */, kRestartInterval);
+  ASSERT_TRUE(builder.Valid());
+
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string key = "key" + std::to_string(i);
+    builder.Add(key, i / kRestartInterval, i % kRestartInterval);
+    // Only the first entry of a user key is indexed
+    builder.Add(key, i / kRestartInterval, i % kRestartInterval);
+  }
+
+  // Pretend the index follows some block content
+  std::string buffer("fake block content");
+  size_t estimated_size = builder.EstimateSize();
+  ASSERT_TRUE(builder.Finish(buffer));
+  // The table may have been grown to place all keys
+  ASSERT_GE(buffer.size() - 18, estimated_size);
+  ASSERT_TRUE(IsDataBlockCuckooIndex(buffer.data(),
+                                     static_cast<uint32_t>(buffer.size())));
+
+  DataBlockCuckooIndex index;
+  uint32_t map_offset;
+  ASSERT_TRUE(index.Initialize(buffer.data(),
+                               static_cast<uint32_t>(buffer.size()),
+                               &map_offset));
+  ASSERT_TRUE(index.Valid());
+  ASSERT_EQ(18, map_offset);
+
+  uint16_t locators[DataBlockCuckooIndex::kMaxCandidates];
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string key = "key" + std::to_string(i);
+    size_t num_candidates =
+        index.Lookup(buffer.data(), map_offset, key, locators);
+    bool found = false;
+    for (size_t j = 0; j < num_candidates; j++) {
+      if (index.GetRestartIndex(locators[j]) ==
+              static_cast<uint32_t>(i / kRestartInterval) &&
+          index.GetOrdinal(locators[j]) ==
+              static_cast<uint32_t>(i % kRestartInterval)) {
+        found = true;
+      }
+    }
+    ASSERT_TRUE(found);
+  }
+
+  // Absent keys only get a candidate on a fingerprint collision
+  size_t num_false_candidates = 0;
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string key = "absent" + std::to_string(i);
+    num_false_candidates +=
+        index.Lookup(buffer.data(), map_offset, key, locators);
+  }
+  ASSERT_LT(num_false_candidates, kNumKeys / 10);
+}
+
+TEST(DataBlockHashIndex, CuckooIndexLocatorExceedMax) {
+  DataBlockCuckooIndexBuilder builder;
+  builder.Initialize(0.75 /* util_ratio */, 16 /* restart_interval */);
+  // 12 bits are left for the restart index
+  builder.Add("key1", (1 << 12) - 1, 15);
+  ASSERT_TRUE(builder.Valid());
+  builder.Add("key2", 1 << 12, 0);
+  ASSERT_FALSE(builder.Valid());
+
+  builder.Reset();
+  ASSERT_TRUE(builder.Valid());
+}
+
+TEST(DataBlockHashIndex, BlockCuckooSizeExceedMax) {
+  std::string ukey(10, 'k');
+  InternalKey ikey(ukey, 0, kTypeValue);
+  BlockBuilder builder(1 /* block_restart_interval */,
+                       false /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash);
+
+  // Readers ignore the index flag of blocks larger than 64KiB, so no index
+  // is built for them
+  std::string value(kMaxBlockSizeSupportedByHashIndex, 'v');
+  builder.Add(ikey.Encode().ToString(), value);
+  Slice rawblock = builder.Finish();
+  ASSERT_GT(rawblock.size(), kMaxBlockSizeSupportedByHashIndex);
+
+  BlockContents contents;
+  contents.data = rawblock;
+  Block reader(std::move(contents));
+  ASSERT_EQ(reader.IndexType(),
+            BlockBasedTableOptions::kDataBlockBinarySearch);
+
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  ASSERT_TRUE(iter->SeekForGet(ikey.Encode().ToString()));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(value, iter->value().ToString());
+}
+
+TEST(DataBlockHashIndex, BlockTestCuckooMultipleVersions) {
+  Random rnd(1019);
+  const int kRestartInterval = 4;
+  const int kNumUserKeys = 300;
+  const SequenceNumber kMaxVersions = 6;
+
+  BlockBuilder builder(kRestartInterval, true /* use_delta_encoding */,
+                       false /* use_value_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash);
+
+  // Every user key has 1 to kMaxVersions versions with sequence numbers
+  // 10, 20, ..., so many of them span restart intervals.
+  std::vector<std::string> ukeys;
+  std::vector<SequenceNumber> num_versions;
+  for (int i = 0; i < kNumUserKeys; i++) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06d1", i);
+    ukeys.emplace_back(buf);
+    num_versions.push_back(1 + rnd.Uniform(kMaxVersions));
+    for (SequenceNumber v = num_versions.back(); v >= 1; v--) {
+      InternalKey ikey(ukeys.back(), v * 10, kTypeValue);
+      builder.Add(ikey.Encode().ToString(),
+                  ukeys.back() + "@" + std::to_string(v * 10));
+    }
+  }
+
+  Slice rawblock = builder.Finish();
+  ASSERT_TRUE(IsDataBlockCuckooIndex(
+      rawblock.data(),
+      static_cast<uint32_t>(rawblock.size() - sizeof(uint32_t))));
+
+  BlockContents contents;
+  contents.data = rawblock;
+  Block reader(std::move(contents));
+  const InternalKeyComparator icmp(BytewiseComparator());
+
+  for (int i = 0; i < kNumUserKeys; i++) {
+    // Look up the newest version visible at every snapshot
+    for (SequenceNumber snapshot = 5;
+         snapshot <= num_versions[i] * 10 + 5; snapshot += 5) {
+      std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+          icmp.user_comparator(), kDisableGlobalSequenceNumber));
+      InternalKey ikey(ukeys[i], snapshot, kValueTypeForSeek);
+      bool may_exist = iter->SeekForGet(ikey.Encode().ToString());
+      ASSERT_OK(iter->status());
+      if (snapshot < 10) {
+        // All versions are newer, so the iterator is past them
+        if (iter->Valid()) {
+          ASSERT_FALSE(may_exist);
+          ASSERT_NE(ukeys[i], ExtractUserKey(iter->key()).ToString());
+        }
+        continue;
+      }
+      ASSERT_TRUE(may_exist);
+      ASSERT_TRUE(iter->Valid());
+      SequenceNumber expected = std::min(snapshot / 10, num_versions[i]) * 10;
+      ASSERT_EQ(ukeys[i] + "@" + std::to_string(expected),
+                iter->value().ToString());
+    }
+  }
+
+  // Non-existent user keys behave as with DataBlockHashIndex, see
+  // BlockTestLarge
+  for (int i = 0; i < kNumUserKeys; i++) {
+    std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+        icmp.user_comparator(), kDisableGlobalSequenceNumber));
+    std::string ukey = ukeys[i];
+    ukey.back() = '0' /* non-existing key marker */;
+    InternalKey ikey(ukey, kMaxSequenceNumber, kValueTypeForSeek);
+    bool may_exist = iter->SeekForGet(ikey.Encode().ToString());
+    if (!may_exist) {
+      ASSERT_TRUE(iter->Valid());
+    }
+    if (!iter->Valid()) {
+      ASSERT_TRUE(may_exist);
+    }
+  }
+}
+
 // helper routine for DataBlockHashIndex.BlockBoundary
 void TestBoundary(InternalKey& ik1, std::string& v1, InternalKey& ik2,
                   std::string& v2, InternalKey& seek_ikey,
@@ -734,15 +734,22 @@ class Standard128RibbonBitsReader : public FilterBitsReader {
       uint32_t start_bits;
     };
     std::array<SavedData, MultiGetContext::MAX_BATCH_SIZE> saved;
+    // Prefetch the segments of all keys before querying any of them
     for (int i = 0; i < num_keys; ++i) {
       ribbon::InterleavedPrepareQuery(
           GetSliceHash64(*keys[i]), hasher_, soln_, &saved[i].seeded_hash,
           &saved[i].segment_num, &saved[i].num_columns, &saved[i].start_bits);
     }
     for (int i = 0; i < num_keys; ++i) {
+#ifdef HAVE_AVX2
+      may_match[i] = ribbon::InterleavedFilterQueryAvx2(
+          saved[i].seeded_hash, saved[i].segment_num, saved[i].num_columns,
+          saved[i].start_bits, hasher_, soln_);
+#else
       may_match[i] = ribbon::InterleavedFilterQuery(
           saved[i].seeded_hash, saved[i].segment_num, saved[i].num_columns,
           saved[i].start_bits, hasher_, soln_);
+#endif
     }
   }
 
@@ -1394,7 +1401,8 @@ FilterBitsBuilder* LevelThresholdFilterPolicy::GetBuilderWithContext(
     const FilterBuildingContext& context) const {
   switch (context.compaction_style) {
     case kCompactionStyleLevel:
-    case kCompactionStyleUniversal: {
+    case kCompactionStyleUniversal:
+    case kCompactionStyleHybrid: {
       int levelish;
       if (context.reason == TableFileCreationReason::kFlush) {
         // Treat flush as level -1
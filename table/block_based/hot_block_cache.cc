@@ -0,0 +1,230 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+
+#include "table/block_based/hot_block_cache.h"
+
+#include <cassert>
+
+#include "table/block_based/block.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+size_t CandidateIndex(uint64_t offset) {
+  static_assert(HotBlockCache::kNumCandidates == 1024,
+                "shift below assumes 10 bits of index");
+  // Block offsets are not uniformly distributed in their low bits, so use
+  // the high bits of a multiplicative hash.
+  return static_cast<size_t>((offset * 0x9E3779B97F4A7C15ULL) >> 54);
+}
+
+}  // namespace
+
+HotBlockCache::HotBlockCache(Cache* block_cache, size_t num_slots)
+    : block_cache_(block_cache), candidates_(kNumCandidates) {
+  assert(block_cache_ != nullptr);
+  assert(num_slots > 0);
+  slots_.reserve(num_slots);
+  for (size_t i = 0; i < num_slots; ++i) {
+    slots_.push_back(new Slot());
+  }
+}
+
+HotBlockCache::~HotBlockCache() {
+  MutexLock l(&mutex_);
+  for (Slot* slot : slots_) {
+    if (slot->pinned) {
+      Unpin(slot);
+    }
+    // Borrowed entries may still refer to the slot; the last of them deletes
+    // it in that case.
+    DropHolder(slot);
+  }
+}
+
+bool HotBlockCache::Lookup(uint64_t offset, CachableEntry<Block>* entry) {
+  assert(entry != nullptr);
+  assert(entry->IsEmpty());
+  for (Slot* slot : slots_) {
+    if (slot->offset.load(std::memory_order_acquire) != offset) {
+      continue;
+    }
+    // Only take a reference if the block is still referenced, as a zero
+    // count means it is being released.
+    uint32_t refs = slot->refs.load(std::memory_order_relaxed);
+    while (refs != 0 && !slot->refs.compare_exchange_weak(
+                            refs, refs + 1, std::memory_order_acquire,
+                            std::memory_order_relaxed)) {
+    }
+    if (refs == 0) {
+      return false;
+    }
+    // The slot may have been reused for another block between the two loads.
+    if (slot->offset.load(std::memory_order_acquire) != offset) {
+      Unref(slot);
+      return false;
+    }
+    slot->hits.fetch_add(1, std::memory_order_relaxed);
+    entry->SetBorrowedValue(slot->value, slot->cache, slot->handle,
+                            &ReleaseBorrowed, slot, nullptr);
+    return true;
+  }
+  return false;
+}
+
+void HotBlockCache::RecordAccess(uint64_t offset,
+                                 const CachableEntry<Block>& entry) {
+  if (!entry.IsCached() || entry.IsBorrowed() || entry.GetValue() == nullptr) {
+    return;
+  }
+  if (!mutex_.TryLock()) {
+    return;
+  }
+  Candidate* candidate = &candidates_[CandidateIndex(offset)];
+  if (candidate->offset != offset) {
+    candidate->offset = offset;
+    candidate->count = 0;
+  }
+  if (++candidate->count >= kPinThreshold) {
+    MaybePin(offset, entry, candidate);
+  }
+  if (++accesses_since_decay_ >= kDecayPeriod) {
+    Decay();
+  }
+  mutex_.Unlock();
+}
+
+void HotBlockCache::MaybePin(uint64_t offset,
+                             const CachableEntry<Block>& entry,
+                             Candidate* candidate) {
+  mutex_.AssertHeld();
+  Slot* free_slot = nullptr;
+  Slot* coldest = nullptr;
+  for (Slot* slot : slots_) {
+    if (slot->pinned) {
+      if (slot->offset.load(std::memory_order_relaxed) == offset) {
+        // Raced with a reader that looked the block up before it was pinned
+        return;
+      }
+      if (coldest == nullptr ||
+          slot->hits.load(std::memory_order_relaxed) <
+              coldest->hits.load(std::memory_order_relaxed)) {
+        coldest = slot;
+      }
+    } else if (free_slot == nullptr &&
+               slot->refs.load(std::memory_order_acquire) == 0 &&
+               slot->offset.load(std::memory_order_acquire) == kEmptyOffset) {
+      free_slot = slot;
+    }
+  }
+
+  if (free_slot == nullptr) {
+    // Make room by unpinning the coldest block if the candidate is hotter.
+    // The slot only becomes free once borrowed entries are released.
+    if (coldest == nullptr ||
+        coldest->hits.load(std::memory_order_relaxed) >= candidate->count) {
+      return;
+    }
+    Unpin(coldest);
+    if (coldest->refs.load(std::memory_order_acquire) != 0 ||
+        coldest->offset.load(std::memory_order_acquire) != kEmptyOffset) {
+      return;
+    }
+    free_slot = coldest;
+  }
+
+  if (!block_cache_->Ref(entry.GetCacheHandle())) {
+    return;
+  }
+  free_slot->value = entry.GetValue();
+  free_slot->cache = block_cache_;
+  free_slot->handle = entry.GetCacheHandle();
+  free_slot->hits.store(candidate->count, std::memory_order_relaxed);
+  free_slot->pinned = true;
+  free_slot->holders.fetch_add(1, std::memory_order_relaxed);
+  free_slot->refs.store(1, std::memory_order_release);
+  free_slot->offset.store(offset, std::memory_order_release);
+  candidate->count = 0;
+}
+
+void HotBlockCache::Unpin(Slot* slot) {
+  mutex_.AssertHeld();
+  assert(slot->pinned);
+  slot->pinned = false;
+  Unref(slot);
+}
+
+void HotBlockCache::Decay() {
+  mutex_.AssertHeld();
+  accesses_since_decay_ = 0;
+  for (Candidate& candidate : candidates_) {
+    candidate.count >>= 1;
+  }
+  for (Slot* slot : slots_) {
+    if (!slot->pinned) {
+      continue;
+    }
+    uint32_t hits = slot->hits.load(std::memory_order_relaxed);
+    if (hits < kUnpinThreshold) {
+      Unpin(slot);
+    } else {
+      // Keep the reads that raced with the decay
+      slot->hits.fetch_sub(hits - hits / 2, std::memory_order_relaxed);
+    }
+  }
+}
+
+void HotBlockCache::ReleaseBorrowed(void* arg1, void* /*arg2*/) {
+  Unref(static_cast<Slot*>(arg1));
+}
+
+void HotBlockCache::Unref(Slot* slot) {
+  if (slot->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  // Last reference: nobody can borrow the block anymore, and the slot cannot
+  // be reused before its offset is reset.
+  Cache* const cache = slot->cache;
+  Cache::Handle* const handle = slot->handle;
+  slot->value = nullptr;
+  slot->cache = nullptr;
+  slot->handle = nullptr;
+  slot->offset.store(kEmptyOffset, std::memory_order_release);
+  cache->Release(handle);
+  DropHolder(slot);
+}
+
+void HotBlockCache::DropHolder(Slot* slot) {
+  if (slot->holders.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete slot;
+  }
+}
+
+size_t HotBlockCache::TEST_GetNumPinned() const {
+  MutexLock l(&mutex_);
+  size_t num_pinned = 0;
+  for (const Slot* slot : slots_) {
+    if (slot->pinned) {
+      ++num_pinned;
+    }
+  }
+  return num_pinned;
+}
+
+bool HotBlockCache::TEST_IsPinned(uint64_t offset) const {
+  MutexLock l(&mutex_);
+  for (const Slot* slot : slots_) {
+    if (slot->pinned &&
+        slot->offset.load(std::memory_order_relaxed) == offset) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,115 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "table/block_based/cachable_entry.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Block;
+
+// HotBlockCache keeps the most frequently read data blocks of a single table
+// pinned in the block cache, and serves reads of them from a small array of
+// slots indexed by block offset, without computing a cache key or taking a
+// block cache shard lock.
+//
+// Accesses that go through the block cache are counted in a small
+// direct-mapped table of candidates; a block read kPinThreshold times is
+// pinned by taking an extra reference of its block cache handle. Every
+// kDecayPeriod counted accesses, all counts (including the hits of pinned
+// blocks) are halved and pinned blocks whose count dropped below
+// kUnpinThreshold are unpinned.
+//
+// Readers borrow a pinned block through a per-slot reference count. The
+// reference held for being pinned is dropped when the block is unpinned, and
+// whoever drops the last reference releases the block cache handle and frees
+// the slot for reuse. Borrowed references may outlive the HotBlockCache (e.g.
+// in a PinnableSlice), so the memory of a slot is reference counted
+// separately, by the HotBlockCache and by the block it holds, if any.
+//
+// Lookup() is lock-free. RecordAccess() only try-locks a mutex and skips the
+// bookkeeping under contention, so the counts are a sample.
+class HotBlockCache {
+ public:
+  HotBlockCache(Cache* block_cache, size_t num_slots);
+  ~HotBlockCache();
+
+  // No copying allowed
+  HotBlockCache(const HotBlockCache&) = delete;
+  HotBlockCache& operator=(const HotBlockCache&) = delete;
+
+  // If the data block at `offset` is pinned, set `entry` to borrow it and
+  // return true.
+  bool Lookup(uint64_t offset, CachableEntry<Block>* entry);
+
+  // Count a read of the data block at `offset` that was served by the block
+  // cache through `entry`, possibly pinning it.
+  void RecordAccess(uint64_t offset, const CachableEntry<Block>& entry);
+
+  size_t TEST_GetNumPinned() const;
+  bool TEST_IsPinned(uint64_t offset) const;
+
+  static constexpr uint32_t kPinThreshold = 32;
+  static constexpr uint32_t kUnpinThreshold = kPinThreshold / 4;
+  static constexpr uint32_t kDecayPeriod = 1024;
+  static constexpr size_t kNumCandidates = 1024;
+
+ private:
+  static constexpr uint64_t kEmptyOffset = port::kMaxUint64;
+
+  struct Slot {
+    // Offset of the pinned block, or kEmptyOffset when the slot is free.
+    std::atomic<uint64_t> offset{kEmptyOffset};
+    // One reference for being pinned plus one per borrowed entry. Zero means
+    // no block is (or is going to be) served from this slot.
+    std::atomic<uint32_t> refs{0};
+    // One for the owning HotBlockCache plus one while `refs` is non-zero.
+    // The slot is deleted when it drops to zero.
+    std::atomic<uint32_t> holders{1};
+    // Number of recent reads, halved on every decay.
+    std::atomic<uint32_t> hits{0};
+    Block* value = nullptr;
+    Cache* cache = nullptr;
+    Cache::Handle* handle = nullptr;
+    // Whether the slot holds the pinning reference. Protected by mutex_.
+    bool pinned = false;
+  };
+
+  struct Candidate {
+    uint64_t offset = kEmptyOffset;
+    uint32_t count = 0;
+  };
+
+  // Cleanup function of borrowed entries; `arg1` is the Slot.
+  static void ReleaseBorrowed(void* arg1, void* /*arg2*/);
+  // Drop one reference of the block held by `slot`, releasing it once it is
+  // unused.
+  static void Unref(Slot* slot);
+  static void DropHolder(Slot* slot);
+
+  // REQUIRES: mutex_ held
+  void MaybePin(uint64_t offset, const CachableEntry<Block>& entry,
+                Candidate* candidate);
+  // REQUIRES: mutex_ held
+  void Unpin(Slot* slot);
+  // REQUIRES: mutex_ held
+  void Decay();
+
+  Cache* const block_cache_;
+  std::vector<Slot*> slots_;
+  std::vector<Candidate> candidates_;
+  uint32_t accesses_since_decay_ = 0;
+  mutable port::Mutex mutex_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
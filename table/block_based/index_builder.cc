@@ -60,6 +60,15 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           table_opt.index_shortening, /* include_first_key */ true);
       break;
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      // The model predicts the position of every index entry
+      assert(table_opt.index_block_restart_interval == 1);
+      result = new LearnedIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding,
+          table_opt.index_shortening);
+      break;
+    }
     default: {
       assert(!"Do not recognize the index type ");
       break;
@@ -81,12 +90,22 @@ PartitionedIndexBuilder::PartitionedIndexBuilder(
     const BlockBasedTableOptions& table_opt,
     const bool use_value_delta_encoding)
     : IndexBuilder(comparator),
-      index_block_builder_(table_opt.index_block_restart_interval,
-                           true /*use_delta_encoding*/,
-                           use_value_delta_encoding),
-      index_block_builder_without_seq_(table_opt.index_block_restart_interval,
-                                       true /*use_delta_encoding*/,
-                                       use_value_delta_encoding),
+      index_block_builder_(
+          table_opt.index_block_restart_interval, true /*use_delta_encoding*/,
+          use_value_delta_encoding,
+          BlockBasedTableOptions::kDataBlockBinarySearch,
+          0.75 /*data_block_hash_table_util_ratio*/,
+          UseRestartKeyPrefixes(table_opt.format_version,
+                                comparator->user_comparator()),
+          true /*keys_include_seq*/),
+      index_block_builder_without_seq_(
+          table_opt.index_block_restart_interval, true /*use_delta_encoding*/,
+          use_value_delta_encoding,
+          BlockBasedTableOptions::kDataBlockBinarySearch,
+          0.75 /*data_block_hash_table_util_ratio*/,
+          UseRestartKeyPrefixes(table_opt.format_version,
+                                comparator->user_comparator()),
+          false /*keys_include_seq*/),
       sub_index_builder_(nullptr),
       table_opt_(table_opt),
       // We start by false. After each partition we revise the value based on
@@ -19,6 +19,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -125,14 +126,26 @@ class ShortenedIndexBuilder : public IndexBuilder {
       const int index_block_restart_interval, const uint32_t format_version,
       const bool use_value_delta_encoding,
       BlockBasedTableOptions::IndexShorteningMode shortening_mode,
-      bool include_first_key)
+      bool include_first_key, bool use_restart_key_prefixes = true)
       : IndexBuilder(comparator),
-        index_block_builder_(index_block_restart_interval,
-                             true /*use_delta_encoding*/,
-                             use_value_delta_encoding),
-        index_block_builder_without_seq_(index_block_restart_interval,
-                                         true /*use_delta_encoding*/,
-                                         use_value_delta_encoding),
+        index_block_builder_(
+            index_block_restart_interval, true /*use_delta_encoding*/,
+            use_value_delta_encoding,
+            BlockBasedTableOptions::kDataBlockBinarySearch,
+            0.75 /*data_block_hash_table_util_ratio*/,
+            use_restart_key_prefixes &&
+                UseRestartKeyPrefixes(format_version,
+                                      comparator->user_comparator()),
+            true /*keys_include_seq*/),
+        index_block_builder_without_seq_(
+            index_block_restart_interval, true /*use_delta_encoding*/,
+            use_value_delta_encoding,
+            BlockBasedTableOptions::kDataBlockBinarySearch,
+            0.75 /*data_block_hash_table_util_ratio*/,
+            use_restart_key_prefixes &&
+                UseRestartKeyPrefixes(format_version,
+                                      comparator->user_comparator()),
+            false /*keys_include_seq*/),
         use_value_delta_encoding_(use_value_delta_encoding),
         include_first_key_(include_first_key),
         shortening_mode_(shortening_mode) {
@@ -353,6 +366,72 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder builds a binary-searchable primary index with one
+// restart point per entry, and a learned model of the positions of its
+// entries in a meta block (see learned_index.h), which readers use to narrow
+// down the binary search. The primary index is written without restart key
+// prefixes, which the model replaces, but it keeps every separator key and
+// block handle, as the window the model predicts is searched by comparing
+// keys. The model adds to the size of the index rather than replacing it.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  explicit LearnedIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode)
+      : IndexBuilder(comparator),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               /* use_restart_key_prefixes */ false),
+        // The model orders keys like BytewiseComparator()
+        build_model_(comparator->user_comparator() == BytewiseComparator()) {
+    assert(index_block_restart_interval == 1);
+  }
+
+  virtual void AddIndexEntry(std::string* last_key_in_current_block,
+                             const Slice* first_key_in_next_block,
+                             const BlockHandle& block_handle) override {
+    primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                         first_key_in_next_block, block_handle);
+    if (build_model_) {
+      // Now the separator written to the index block
+      model_builder_.Add(ExtractUserKey(*last_key_in_current_block));
+    }
+  }
+
+  virtual void OnKeyAdded(const Slice& key) override {
+    primary_index_builder_.OnKeyAdded(key);
+  }
+
+  virtual Status Finish(
+      IndexBlocks* index_blocks,
+      const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    if (s.ok() && build_model_ && model_builder_.Finish(&model_block_)) {
+      index_blocks->meta_blocks.insert(
+          {kLearnedIndexBlock.c_str(), model_block_});
+    }
+    return s;
+  }
+
+  virtual size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_block_.size();
+  }
+
+  virtual bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  const bool build_model_;
+  LearnedIndexModelBuilder model_builder_;
+  std::string model_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
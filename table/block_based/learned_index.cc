@@ -0,0 +1,192 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "table/block_based/restart_key_prefixes.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+const size_t kSegmentSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+uint64_t EncodeDouble(double d) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(d), "double must be 64 bits");
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+double DecodeDouble(uint64_t bits) {
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+}  // namespace
+
+void LearnedIndexModelBuilder::Add(const Slice& user_key) {
+  assert(key_offsets_.empty() ||
+         Slice(keys_.data() + key_offsets_.back(),
+               keys_.size() - key_offsets_.back())
+                 .compare(user_key) <= 0);
+  key_offsets_.push_back(keys_.size());
+  keys_.append(user_key.data(), user_key.size());
+}
+
+bool LearnedIndexModelBuilder::Finish(std::string* buffer) {
+  const size_t num_entries = key_offsets_.size();
+  if (num_entries == 0 ||
+      num_entries > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  auto key_at = [&](size_t i) {
+    const size_t end = i + 1 < num_entries ? key_offsets_[i + 1] : keys_.size();
+    return Slice(keys_.data() + key_offsets_[i], end - key_offsets_[i]);
+  };
+
+  // The keys are sorted, so all of them share the common prefix of the first
+  // and the last one
+  const Slice first_key = key_at(0);
+  const Slice last_key = key_at(num_entries - 1);
+  size_t skip = 0;
+  while (skip < first_key.size() && skip < last_key.size() &&
+         first_key[skip] == last_key[skip]) {
+    ++skip;
+  }
+
+  // Fit the segments greedily: each segment starts at the first key it
+  // covers, and is extended while some slope keeps all of its keys within
+  // the error bound (the cone of such slopes shrinks with every key). Only
+  // the first entry of each integer key is fitted. Half a position is kept
+  // for rounding the prediction.
+  const double error = epsilon_ > 0 ? epsilon_ - 0.5 : 0.0;
+  std::string segments;
+  uint32_t num_segments = 0;
+  uint64_t seg_key = 0;
+  uint32_t seg_pos = 0;
+  double min_slope = 0.0;
+  double max_slope = std::numeric_limits<double>::infinity();
+  auto flush_segment = [&]() {
+    const double slope = std::isinf(max_slope) ? 0.0
+                                               : (min_slope + max_slope) / 2;
+    PutFixed64(&segments, seg_key);
+    PutFixed64(&segments, EncodeDouble(slope));
+    PutFixed32(&segments, seg_pos);
+    ++num_segments;
+  };
+  uint64_t prev_key = 0;
+  for (size_t i = 0; i < num_entries; ++i) {
+    const uint64_t key = GetRestartKeyPrefix(key_at(i), skip);
+    const uint32_t pos = static_cast<uint32_t>(i);
+    if (i == 0) {
+      seg_key = key;
+      seg_pos = pos;
+    } else if (key != prev_key) {
+      assert(key > prev_key);
+      const double dx = static_cast<double>(key - seg_key);
+      const double dy = static_cast<double>(pos) - seg_pos;
+      const double lo = std::max(min_slope, (dy - error) / dx);
+      const double hi = std::min(max_slope, (dy + error) / dx);
+      if (lo <= hi) {
+        min_slope = lo;
+        max_slope = hi;
+      } else {
+        flush_segment();
+        seg_key = key;
+        seg_pos = pos;
+        min_slope = 0.0;
+        max_slope = std::numeric_limits<double>::infinity();
+      }
+    }
+    prev_key = key;
+  }
+  flush_segment();
+
+  PutFixed32(buffer, static_cast<uint32_t>(num_entries));
+  PutFixed32(buffer, epsilon_);
+  PutFixed32(buffer, static_cast<uint32_t>(skip));
+  buffer->append(first_key.data(), skip);
+  PutFixed32(buffer, num_segments);
+  buffer->append(segments);
+  return true;
+}
+
+Status LearnedIndexModel::Create(const Slice& contents,
+                                 std::unique_ptr<LearnedIndexModel>* model) {
+  assert(model != nullptr);
+  Slice input = contents;
+  std::unique_ptr<LearnedIndexModel> result(new LearnedIndexModel());
+  uint32_t skip = 0;
+  uint32_t num_segments = 0;
+  if (!GetFixed32(&input, &result->num_entries_) ||
+      !GetFixed32(&input, &result->epsilon_) || !GetFixed32(&input, &skip) ||
+      input.size() < skip) {
+    return Status::Corruption("Corrupted learned index header");
+  }
+  result->prefix_.assign(input.data(), skip);
+  input.remove_prefix(skip);
+  if (!GetFixed32(&input, &num_segments) || num_segments == 0 ||
+      input.size() != uint64_t{num_segments} * kSegmentSize) {
+    return Status::Corruption("Corrupted learned index segments");
+  }
+  result->segments_.reserve(num_segments);
+  for (uint32_t i = 0; i < num_segments; ++i) {
+    Segment segment;
+    segment.first_key = DecodeFixed64(input.data());
+    segment.slope = DecodeDouble(DecodeFixed64(input.data() + 8));
+    segment.first_pos = DecodeFixed32(input.data() + 16);
+    input.remove_prefix(kSegmentSize);
+    if (segment.first_pos >= result->num_entries_ || !(segment.slope >= 0) ||
+        (i > 0 && (segment.first_key <= result->segments_.back().first_key ||
+                   segment.first_pos <= result->segments_.back().first_pos))) {
+      return Status::Corruption("Corrupted learned index segment");
+    }
+    result->segments_.push_back(segment);
+  }
+  *model = std::move(result);
+  return Status::OK();
+}
+
+uint32_t LearnedIndexModel::Predict(const Slice& user_key) const {
+  assert(!segments_.empty());
+  const size_t n = std::min(prefix_.size(), user_key.size());
+  int cmp = memcmp(user_key.data(), prefix_.data(), n);
+  if (cmp == 0 && n < prefix_.size()) {
+    cmp = -1;
+  }
+  if (cmp != 0) {
+    return cmp < 0 ? 0 : num_entries_;
+  }
+
+  const uint64_t key = GetRestartKeyPrefix(user_key, prefix_.size());
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), key,
+      [](uint64_t k, const Segment& segment) { return k < segment.first_key; });
+  if (it == segments_.begin()) {
+    return 0;
+  }
+  // The keys between two segments are predicted by the first one, but not
+  // past the start of the next one
+  const uint32_t limit = it == segments_.end() ? num_entries_ : it->first_pos;
+  --it;
+  const double pos =
+      it->first_pos + it->slope * static_cast<double>(key - it->first_key) +
+      0.5;
+  if (!(pos < limit)) {
+    return limit;
+  }
+  return static_cast<uint32_t>(pos);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,105 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+// A learned index model for the index block of tables written with
+// BlockBasedTableOptions::kLearnedIndexSearch, stored in the
+// "rocksdb.learned.index" meta block.
+//
+// The index block has one restart point per entry, and the model predicts
+// the position of a key among them within a fixed error bound, so that a
+// seek only needs to binary search a small window of the index block. Keys
+// are mapped to integers the same way as restart key prefixes (see
+// restart_key_prefixes.h): the 8 bytes of the user key following the prefix
+// shared by all entries, as a big-endian integer. The model is a sequence of
+// linear segments over these integers (a single-level piecewise geometric
+// model), fitted so that each entry is predicted within EPSILON of its
+// position:
+//
+// LEARNED_INDEX: [NUM_ENTRIES EPSILON SKIP PREFIX NUM_SEGS SEG SEG ... SEG]
+//
+// NUM_ENTRIES: fixed32 number of entries of the index block.
+// EPSILON:     fixed32 maximum error of the prediction for the key of an
+//              entry.
+// SKIP:        fixed32 length of PREFIX.
+// PREFIX:      SKIP bytes shared by the user keys of all entries.
+// NUM_SEGS:    fixed32 number of segments.
+// SEG:         [fixed64 first key, fixed64 slope (IEEE double),
+//               fixed32 position of the first key]
+//
+// The prediction for a key that is not in the index can be anywhere between
+// the positions of its neighbors, so readers check the bounds of the window
+// against the index block and widen it when the model is off.
+//
+// The model is only built for tables using BytewiseComparator(), the only
+// ordering the integers follow.
+
+class LearnedIndexModelBuilder {
+ public:
+  explicit LearnedIndexModelBuilder(uint32_t epsilon = kDefaultEpsilon)
+      : epsilon_(epsilon) {}
+
+  // Adds the user key of the next entry of the index block. Keys must be
+  // added in ascending order.
+  void Add(const Slice& user_key);
+
+  // Fits the model and appends it to buffer. Returns false without touching
+  // buffer if no key was added.
+  bool Finish(std::string* buffer);
+
+  static constexpr uint32_t kDefaultEpsilon = 8;
+
+ private:
+  uint32_t epsilon_;
+  // The user keys added so far, concatenated, and the offset of each
+  std::string keys_;
+  std::vector<size_t> key_offsets_;
+};
+
+class LearnedIndexModel {
+ public:
+  // Parses the contents of a learned index meta block.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<LearnedIndexModel>* model);
+
+  // Returns the predicted number of entries whose key is less than
+  // `user_key`, in [0, num_entries()].
+  uint32_t Predict(const Slice& user_key) const;
+
+  uint32_t num_entries() const { return num_entries_; }
+  uint32_t epsilon() const { return epsilon_; }
+  size_t num_segments() const { return segments_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + prefix_.capacity() +
+           segments_.capacity() * sizeof(Segment);
+  }
+
+ private:
+  struct Segment {
+    uint64_t first_key;
+    double slope;
+    uint32_t first_pos;
+  };
+
+  LearnedIndexModel() = default;
+
+  uint32_t num_entries_ = 0;
+  uint32_t epsilon_ = 0;
+  std::string prefix_;
+  std::vector<Segment> segments_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,51 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include "table/block_based/index_reader_common.h"
+#include "table/block_based/learned_index.h"
+
+namespace ROCKSDB_NAMESPACE {
+// Index that binary searches the index block within the window predicted by
+// a learned model of the positions of its entries, which is kept in memory.
+// Without the model (e.g. the table uses a comparator the model does not
+// support) it is the same as BinarySearchIndexReader.
+class LearnedIndexReader : public BlockBasedTable::IndexReaderCommon {
+ public:
+  static Status Create(const BlockBasedTable* table, const ReadOptions& ro,
+                       FilePrefetchBuffer* prefetch_buffer,
+                       InternalIterator* meta_index_iter, bool use_cache,
+                       bool prefetch, bool pin,
+                       BlockCacheLookupContext* lookup_context,
+                       std::unique_ptr<IndexReader>* index_reader);
+
+  InternalIteratorBase<IndexValue>* NewIterator(
+      const ReadOptions& read_options, bool /* disable_prefix_seek */,
+      IndexBlockIter* iter, GetContext* get_context,
+      BlockCacheLookupContext* lookup_context) override;
+
+  size_t ApproximateMemoryUsage() const override {
+    size_t usage = ApproximateIndexBlockMemoryUsage();
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+    usage += malloc_usable_size(const_cast<LearnedIndexReader*>(this));
+#else
+    usage += sizeof(*this);
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    if (model_) {
+      usage += model_->ApproximateMemoryUsage();
+    }
+    return usage;
+  }
+
+  const LearnedIndexModel* TEST_model() const { return model_.get(); }
+
+ private:
+  LearnedIndexReader(const BlockBasedTable* t,
+                     CachableEntry<Block>&& index_block)
+      : IndexReaderCommon(t, std::move(index_block)) {}
+
+  std::unique_ptr<LearnedIndexModel> model_;
+};
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,225 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/range_filter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "table/block_based/restart_key_prefixes.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Dropping more bits leaves at most 16 distinct values
+const uint32_t kMaxShift = 60;
+const uint32_t kShiftStep = 4;
+}  // namespace
+
+void RangeFilterBuilder::Add(const Slice& user_key) {
+  if (num_keys_++ == 0) {
+    first_key_.assign(user_key.data(), user_key.size());
+    skip_ = first_key_.size();
+    values_.push_back(GetRestartKeyPrefix(user_key, skip_));
+    return;
+  }
+
+  size_t shared = 0;
+  while (shared < skip_ && shared < user_key.size() &&
+         first_key_[shared] == user_key[shared]) {
+    ++shared;
+  }
+  if (shared < skip_) {
+    // The values so far were taken after the longer prefix, which all the
+    // keys so far share with the first key, so prepend its bytes.
+    const size_t num_bytes = skip_ - shared;
+    const uint64_t first_value = GetRestartKeyPrefix(first_key_, shared);
+    if (num_bytes >= sizeof(uint64_t)) {
+      values_.assign(1, first_value);
+    } else {
+      const uint32_t num_bits = static_cast<uint32_t>(num_bytes * 8);
+      const uint64_t high = first_value & ~(~uint64_t{0} >> num_bits);
+      for (uint64_t& value : values_) {
+        value = high | (value >> num_bits);
+      }
+      values_.erase(std::unique(values_.begin(), values_.end()),
+                    values_.end());
+    }
+    skip_ = shared;
+  }
+
+  const uint64_t value = GetRestartKeyPrefix(user_key, skip_);
+  assert(value >= values_.back());
+  if (value != values_.back()) {
+    values_.push_back(value);
+  }
+}
+
+bool RangeFilterBuilder::Finish(std::string* buffer) {
+  if (num_keys_ == 0) {
+    return false;
+  }
+  const double max_bits = bits_per_key_ * static_cast<double>(num_keys_);
+  std::string encoded;
+  Encode(values_, 0 /* shift */, &encoded);
+  // Drop more low bits until the filter fits
+  std::vector<uint64_t> values;
+  for (uint32_t shift = kShiftStep;
+       static_cast<double>(encoded.size()) * 8 > max_bits &&
+       shift <= kMaxShift;
+       shift += kShiftStep) {
+    values.clear();
+    for (uint64_t value : values_) {
+      value >>= shift;
+      if (values.empty() || values.back() != value) {
+        values.push_back(value);
+      }
+    }
+    encoded.clear();
+    Encode(values, shift, &encoded);
+  }
+  buffer->append(encoded);
+  return true;
+}
+
+void RangeFilterBuilder::Encode(const std::vector<uint64_t>& values,
+                                uint32_t shift, std::string* buffer) const {
+  const size_t num_groups = (values.size() + kGroupSize - 1) / kGroupSize;
+  std::string offsets;
+  std::string deltas;
+  for (size_t group = 0; group < num_groups; ++group) {
+    PutFixed32(&offsets, static_cast<uint32_t>(deltas.size()));
+    const size_t end = std::min(values.size(), (group + 1) * kGroupSize);
+    for (size_t i = group * kGroupSize + 1; i < end; ++i) {
+      PutVarint64(&deltas, values[i] - values[i - 1]);
+    }
+  }
+
+  PutFixed32(buffer, static_cast<uint32_t>(skip_));
+  buffer->append(first_key_.data(), skip_);
+  PutFixed32(buffer, shift);
+  PutFixed32(buffer, static_cast<uint32_t>(values.size()));
+  for (size_t group = 0; group < num_groups; ++group) {
+    PutFixed64(buffer, values[group * kGroupSize]);
+  }
+  buffer->append(offsets);
+  buffer->append(deltas);
+}
+
+Status RangeFilter::Create(BlockContents&& contents,
+                           std::unique_ptr<RangeFilter>* filter) {
+  assert(filter != nullptr);
+  std::unique_ptr<RangeFilter> result(new RangeFilter());
+  result->contents_ = std::move(contents);
+  Slice input = result->contents_.data;
+  uint32_t skip = 0;
+  if (!GetFixed32(&input, &skip) || input.size() < skip) {
+    return Status::Corruption("Corrupted range filter prefix");
+  }
+  result->prefix_ = Slice(input.data(), skip);
+  input.remove_prefix(skip);
+  if (!GetFixed32(&input, &result->shift_) ||
+      !GetFixed32(&input, &result->num_values_) ||
+      result->shift_ > kMaxShift || result->num_values_ == 0) {
+    return Status::Corruption("Corrupted range filter header");
+  }
+  result->num_groups_ =
+      (size_t{result->num_values_} + RangeFilterBuilder::kGroupSize - 1) /
+      RangeFilterBuilder::kGroupSize;
+  const size_t groups_size =
+      result->num_groups_ * (sizeof(uint64_t) + sizeof(uint32_t));
+  if (input.size() < groups_size) {
+    return Status::Corruption("Corrupted range filter groups");
+  }
+  result->bases_ = input.data();
+  result->offsets_ = result->bases_ + result->num_groups_ * sizeof(uint64_t);
+  result->deltas_ = input.data() + groups_size;
+  result->limit_ = input.data() + input.size();
+  *filter = std::move(result);
+  return Status::OK();
+}
+
+int RangeFilter::CompareToPrefix(const Slice& user_key) const {
+  const size_t n = std::min(prefix_.size(), user_key.size());
+  const int cmp = memcmp(user_key.data(), prefix_.data(), n);
+  if (cmp == 0 && n < prefix_.size()) {
+    return -1;
+  }
+  return cmp;
+}
+
+bool RangeFilter::MayContainRange(const Slice& start, const Slice& end) const {
+  // All keys start with the prefix, so none is past a bound that is greater,
+  // and the value of one that is less is below all of them
+  const int start_cmp = CompareToPrefix(start);
+  const int end_cmp = CompareToPrefix(end);
+  if (start_cmp > 0 || end_cmp < 0 ||
+      (end_cmp == 0 && end.size() == prefix_.size())) {
+    return false;
+  }
+  const uint64_t lo =
+      start_cmp < 0 ? 0
+                    : GetRestartKeyPrefix(start, prefix_.size()) >> shift_;
+  uint64_t hi = ~uint64_t{0};
+  if (end_cmp == 0) {
+    hi = GetRestartKeyPrefix(end, prefix_.size()) >> shift_;
+    // The bound is exclusive. If the value of end is exact and does not end
+    // with zero bytes, only keys not less than end have that value.
+    if (shift_ == 0 && end.size() - prefix_.size() <= sizeof(uint64_t) &&
+        end[end.size() - 1] != '\0') {
+      --hi;
+    }
+  }
+  if (lo > hi) {
+    // Empty range; leave it to the caller
+    return true;
+  }
+  auto base = [this](size_t group) {
+    return DecodeFixed64(bases_ + group * sizeof(uint64_t));
+  };
+
+  // Find the last group starting at or before lo
+  size_t left = 0, right = num_groups_;
+  while (left < right) {
+    const size_t mid = left + (right - left) / 2;
+    if (base(mid) <= lo) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  if (left == 0) {
+    return base(0) <= hi;
+  }
+  const size_t group = left - 1;
+
+  // Then the first value of the group not below lo
+  uint64_t value = base(group);
+  if (value >= lo) {
+    return value <= hi;
+  }
+  const char* p =
+      deltas_ + DecodeFixed32(offsets_ + group * sizeof(uint32_t));
+  const size_t group_size =
+      std::min(RangeFilterBuilder::kGroupSize,
+               size_t{num_values_} - group * RangeFilterBuilder::kGroupSize);
+  for (size_t i = 1; i < group_size; ++i) {
+    uint64_t delta;
+    p = p < limit_ ? GetVarint64Ptr(p, limit_, &delta) : nullptr;
+    if (p == nullptr) {
+      // Corrupted
+      return true;
+    }
+    value += delta;
+    if (value >= lo) {
+      return value <= hi;
+    }
+  }
+  return group + 1 < num_groups_ && base(group + 1) <= hi;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
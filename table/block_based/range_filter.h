@@ -0,0 +1,104 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+// A range filter answers whether a table may have keys in a range of user
+// keys, so that a bounded seek can skip a table without reading its index or
+// data blocks. It is written to the "rocksdb.range.filter" meta block of
+// tables built with BlockBasedTableOptions::range_filter_bits_per_key > 0
+// and BytewiseComparator().
+//
+// Like restart key prefixes (see restart_key_prefixes.h), a user key is
+// mapped to the 8 bytes following the prefix shared by all keys of the
+// table, as a big-endian integer. The filter stores the distinct values of
+// the keys of the table, with their lowest SHIFT bits dropped so that the
+// filter fits in the configured bits per key (a truncated key set, like
+// SuRF-Base). The mapping preserves order, so if no stored value lies
+// between the values of the bounds of a range, no key does either. Ranges
+// whose bounds fall between keys of the same value are false positives.
+//
+// RANGE_FILTER: [SKIP PREFIX SHIFT NUM_VALUES BASE ... BASE OFF ... OFF
+//                DELTAS]
+//
+// SKIP:       fixed32 length of PREFIX.
+// PREFIX:     SKIP bytes shared by all user keys of the table.
+// SHIFT:      fixed32 number of low bits dropped from the values.
+// NUM_VALUES: fixed32 number of distinct values.
+// BASE:       fixed64 first value of each group of kGroupSize values.
+// OFF:        fixed32 offset in DELTAS of the rest of each group.
+// DELTAS:     the other values of each group, as varint64 differences from
+//             the previous value.
+class RangeFilterBuilder {
+ public:
+  explicit RangeFilterBuilder(double bits_per_key)
+      : bits_per_key_(bits_per_key) {}
+
+  // Adds a user key of the table. Keys must be added in ascending order.
+  void Add(const Slice& user_key);
+
+  // Appends the filter to buffer. Returns false without touching buffer if
+  // no key was added.
+  bool Finish(std::string* buffer);
+
+  static constexpr size_t kGroupSize = 16;
+
+ private:
+  void Encode(const std::vector<uint64_t>& values, uint32_t shift,
+              std::string* buffer) const;
+
+  const double bits_per_key_;
+  uint64_t num_keys_ = 0;
+  std::string first_key_;
+  // Length of the prefix shared by all keys added so far
+  size_t skip_ = 0;
+  // Distinct values of the keys added so far, relative to skip_, ascending
+  std::vector<uint64_t> values_;
+};
+
+class RangeFilter {
+ public:
+  // Parses the contents of a range filter meta block, taking ownership of
+  // them.
+  static Status Create(BlockContents&& contents,
+                       std::unique_ptr<RangeFilter>* filter);
+
+  // Returns false if the table has no user key in [start, end), or true if
+  // it may have some. An empty `start` is before all keys.
+  bool MayContainRange(const Slice& start, const Slice& end) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + contents_.ApproximateMemoryUsage();
+  }
+
+ private:
+  RangeFilter() = default;
+
+  // Returns 0 if user_key starts with the prefix, or the sign of their
+  // comparison otherwise.
+  int CompareToPrefix(const Slice& user_key) const;
+
+  BlockContents contents_;
+  Slice prefix_;
+  uint32_t shift_ = 0;
+  uint32_t num_values_ = 0;
+  size_t num_groups_ = 0;
+  const char* bases_ = nullptr;
+  const char* offsets_ = nullptr;
+  const char* deltas_ = nullptr;
+  const char* limit_ = nullptr;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
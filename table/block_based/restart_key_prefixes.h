@@ -0,0 +1,68 @@
+//  Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "rocksdb/comparator.h"
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+// Blocks of format_version >= 6 tables using BytewiseComparator() store a
+// fixed-width prefix of the user key of every restart point, so that a seek
+// can narrow down the binary search over the restart points by comparing
+// integers, without decoding a key or calling the comparator:
+//
+// BLOCK: [RI RI RI ... RI RESTART_ARRAY RESTART_KEY_PREFIXES HASH_IDX FOOTER]
+//
+// where HASH_IDX is optional and FOOTER has the restart key prefixes flag set
+// (see data_block_footer.h).
+//
+// RESTART_KEY_PREFIXES: [PREFIX PREFIX ... PREFIX SKIP]
+//
+// SKIP:   fixed32 length of the common prefix of the user keys of all
+//         restart points, which is the same as the common prefix of the
+//         first and last of them.
+// PREFIX: fixed64 per restart point, the 8 bytes of its user key following
+//         the first SKIP bytes, padded with zeros, as a big-endian integer.
+//
+// If the prefix of the user key of a restart point is less than that of the
+// target, so is the key, so integer comparisons give the range of restart
+// points whose prefix equals that of the target, and only this range needs
+// to be searched with full key comparisons.
+//
+// Like the hash index flag, the flag is ignored for blocks larger than
+// kMaxBlockSizeSupportedByHashIndex, so larger blocks do not have prefixes.
+
+// Whether blocks of a table should have restart key prefixes.
+inline bool UseRestartKeyPrefixes(uint32_t format_version,
+                                  const Comparator* user_comparator) {
+  // The prefixes are only ordered like the keys with bytewise ordering, and
+  // a timestamp would be compared as part of a short user key.
+  return format_version >= 6 && user_comparator == BytewiseComparator();
+}
+
+inline uint64_t GetRestartKeyPrefix(const Slice& user_key, size_t skip) {
+  assert(skip <= user_key.size());
+  unsigned char buf[sizeof(uint64_t)] = {0};
+  memcpy(buf, user_key.data() + skip,
+         std::min(user_key.size() - skip, sizeof(buf)));
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(buf); ++i) {
+    prefix = (prefix << 8) | buf[i];
+  }
+  return prefix;
+}
+
+inline size_t RestartKeyPrefixesSize(uint32_t num_restarts) {
+  return num_restarts * sizeof(uint64_t) + sizeof(uint32_t);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
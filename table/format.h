@@ -118,7 +118,7 @@ inline uint32_t GetCompressFormatForVersion(uint32_t format_version) {
 }
 
 inline bool BlockBasedTableSupportedVersion(uint32_t version) {
-  return version <= 5;
+  return version <= 6;
 }
 
 // Footer encapsulates the fixed information stored at the tail
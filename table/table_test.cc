@@ -14,6 +14,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -48,6 +49,8 @@
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
 #include "table/block_based/flush_block_policy.h"
+#include "table/block_based/range_filter.h"
+#include "table/block_based/restart_key_prefixes.h"
 #include "table/format.h"
 #include "table/get_context.h"
 #include "table/internal_iterator.h"
@@ -1693,7 +1696,14 @@ TEST_P(BlockBasedTableTest, BasicBlockBasedTableProperties) {
     block_builder.Add(item.first, item.second);
   }
   Slice content = block_builder.Finish();
-  ASSERT_EQ(content.size() + kBlockTrailerSize + diff_internal_user_bytes,
+  size_t restart_key_prefixes_size = 0;
+  if (UseRestartKeyPrefixes(table_options.format_version,
+                            BytewiseComparator())) {
+    restart_key_prefixes_size =
+        RestartKeyPrefixesSize(static_cast<uint32_t>(kvmap.size()));
+  }
+  ASSERT_EQ(content.size() + kBlockTrailerSize + diff_internal_user_bytes +
+                restart_key_prefixes_size,
             props.data_size);
   c.ResetTableReader();
 }
@@ -2193,6 +2203,116 @@ TEST_P(BlockBasedTableTest, SkipPrefixBloomFilter) {
   }
 }
 
+TEST(RangeFilterTest, MayContainRange) {
+  Random rnd(301);
+  for (double bits_per_key : {1.0, 4.0, 16.0, 128.0}) {
+    // Keys of a small alphabet and various lengths, so that the common prefix
+    // of the keys added so far shrinks as they are added
+    std::set<std::string> key_set;
+    for (int i = 0; i < 1000; ++i) {
+      std::string key = "prefix";
+      const int len = static_cast<int>(rnd.Uniform(12));
+      for (int j = 0; j < len; ++j) {
+        key.push_back(static_cast<char>('a' + rnd.Uniform(4)));
+      }
+      key_set.insert(key);
+    }
+    const std::vector<std::string> keys(key_set.begin(), key_set.end());
+
+    RangeFilterBuilder builder(bits_per_key);
+    for (const std::string& key : keys) {
+      builder.Add(key);
+    }
+    std::string buffer;
+    ASSERT_TRUE(builder.Finish(&buffer));
+    if (bits_per_key >= 4.0) {
+      ASSERT_LE(buffer.size() * 8, bits_per_key * keys.size());
+    }
+    std::unique_ptr<RangeFilter> filter;
+    ASSERT_OK(RangeFilter::Create(BlockContents(Slice(buffer)), &filter));
+
+    // No false negatives
+    int num_empty = 0;
+    int num_rejected = 0;
+    for (int i = 0; i < 10000; ++i) {
+      std::string start = rnd.OneIn(10) ? "" : "prefix";
+      std::string end = "prefix";
+      const int len = static_cast<int>(rnd.Uniform(12));
+      for (int j = 0; j < len; ++j) {
+        start.push_back(static_cast<char>('a' + rnd.Uniform(5)));
+        end.push_back(static_cast<char>('a' + rnd.Uniform(5)));
+      }
+      if (rnd.OneIn(20)) {
+        end = "q";
+      }
+      if (start >= end) {
+        continue;
+      }
+      const auto it = key_set.lower_bound(start);
+      const bool has_keys = it != key_set.end() && *it < end;
+      const bool may_match = filter->MayContainRange(start, end);
+      ASSERT_TRUE(may_match || !has_keys) << start << " " << end;
+      num_empty += has_keys ? 0 : 1;
+      num_rejected += may_match ? 0 : 1;
+    }
+    if (bits_per_key >= 16.0) {
+      // Most empty ranges are rejected with enough bits
+      ASSERT_GT(num_rejected * 2, num_empty);
+    }
+
+    // Ranges outside of the keys
+    ASSERT_FALSE(filter->MayContainRange("a", "b"));
+    ASSERT_FALSE(filter->MayContainRange("q", "r"));
+    ASSERT_TRUE(filter->MayContainRange("", "q"));
+  }
+}
+
+TEST_P(BlockBasedTableTest, RangeFilterSeek) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.range_filter_bits_per_key = 64;
+  Options options;
+  options.comparator = BytewiseComparator();
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  options.statistics = CreateDBStatistics();
+
+  TableConstructor c(options.comparator);
+  for (int i = 0; i < 100; i += 10) {
+    InternalKey key("key" + std::to_string(100 + i), 1, kTypeValue);
+    c.Add(key.Encode().ToString(), "v");
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  const InternalKeyComparator internal_comparator(options.comparator);
+  c.Finish(options, ioptions, moptions, table_options, internal_comparator,
+           &keys, &kvmap);
+  auto* reader = c.GetTableReader();
+
+  auto seek = [&](const std::string& target, const std::string& upper_bound) {
+    Slice upper_bound_slice(upper_bound);
+    ReadOptions ro;
+    ro.iterate_upper_bound = &upper_bound_slice;
+    std::unique_ptr<InternalIterator> iter(reader->NewIterator(
+        ro, moptions.prefix_extractor.get(), /*arena=*/nullptr,
+        /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+    InternalKey ikey(target, kMaxSequenceNumber, kValueTypeForSeek);
+    iter->Seek(ikey.Encode());
+    EXPECT_OK(iter->status());
+    return iter->Valid() ? ExtractUserKey(iter->key()).ToString()
+                         : std::string("(invalid)");
+  };
+
+  ASSERT_EQ("key120", seek("key111", "key125"));
+  ASSERT_EQ(1, options.statistics->getTickerCount(RANGE_FILTER_CHECKED));
+  ASSERT_EQ(0, options.statistics->getTickerCount(RANGE_FILTER_USEFUL));
+  ASSERT_EQ("(invalid)", seek("key111", "key119"));
+  ASSERT_EQ(2, options.statistics->getTickerCount(RANGE_FILTER_CHECKED));
+  ASSERT_EQ(1, options.statistics->getTickerCount(RANGE_FILTER_USEFUL));
+  ASSERT_EQ("(invalid)", seek("key191", "key2"));
+  ASSERT_EQ(2, options.statistics->getTickerCount(RANGE_FILTER_USEFUL));
+}
+
 void AddInternalKey(TableConstructor* c, const std::string& prefix,
                     std::string value = "v", int /*suffix_len*/ = 800) {
   static Random rnd(1023);
@@ -2415,6 +2535,12 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, LearnedIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kLearnedIndexSearch;
+  IndexTest(table_options);
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -4822,15 +4948,13 @@ TEST_F(BBTTailPrefetchTest, FilePrefetchBufferMinOffset) {
   ASSERT_EQ(480, buffer.min_offset_read());
 }
 
-TEST_P(BlockBasedTableTest, DataBlockHashIndex) {
+namespace {
+void TestDataBlockIndexPointLookups(
+    const BlockBasedTableOptions& table_options) {
   const int kNumKeys = 500;
   const int kKeySize = 8;
   const int kValSize = 40;
 
-  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
-  table_options.data_block_index_type =
-      BlockBasedTableOptions::kDataBlockBinaryAndHash;
-
   Options options;
   options.comparator = BytewiseComparator();
 
@@ -4919,6 +5043,22 @@ TEST_P(BlockBasedTableTest, DataBlockHashIndex) {
     }
   }
 }
+}  // namespace
+
+TEST_P(BlockBasedTableTest, DataBlockHashIndex) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.data_block_index_type =
+      BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  TestDataBlockIndexPointLookups(table_options);
+}
+
+TEST_P(BlockBasedTableTest, DataBlockCuckooHashIndex) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.format_version = 6;
+  table_options.data_block_index_type =
+      BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash;
+  TestDataBlockIndexPointLookups(table_options);
+}
 
 // BlockBasedTableIterator should invalidate itself and return
 // OutOfBound()=true immediately after Seek(), to allow LevelIterator
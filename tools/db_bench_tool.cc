@@ -632,15 +632,32 @@ DEFINE_int64(prepopulate_block_cache, 0,
              "Pre-populate hot/warm blocks in block cache. 0 to disable and 1 "
              "to insert during flush");
 
+DEFINE_uint32(max_pinned_hot_data_blocks,
+              ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                  .max_pinned_hot_data_blocks,
+              "Number of frequently read data blocks each table reader keeps "
+              "pinned in the block cache. 0 to disable");
+
+DEFINE_double(range_filter_bits_per_key,
+              ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                  .range_filter_bits_per_key,
+              "Bits per key of the range filter of each table, checked by "
+              "seeks with an upper bound. 0 to disable");
+
 DEFINE_bool(use_data_block_hash_index, false,
             "if use kDataBlockBinaryAndHash "
             "instead of kDataBlockBinarySearch. "
             "This is valid if only we use BlockTable");
 
+DEFINE_bool(use_data_block_cuckoo_index, false,
+            "if use kDataBlockBinaryAndCuckooHash "
+            "instead of kDataBlockBinarySearch. Requires format_version >= 6. "
+            "This is valid if only we use BlockTable");
+
 DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "util ratio for data block hash index table. "
-              "This is only valid if use_data_block_hash_index is "
-              "set to true");
+              "This is only valid if use_data_block_hash_index or "
+              "use_data_block_cuckoo_index is set to true");
 
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
@@ -658,6 +675,11 @@ DEFINE_int32(file_opening_threads,
              "If open_files is set to -1, this option set the number of "
              "threads that will be used to open files during DB::Open()");
 
+DEFINE_bool(open_tables_lazily,
+            ROCKSDB_NAMESPACE::Options().open_tables_lazily,
+            "If true, DB::Open() does not open the table files, which are "
+            "opened on first access and warmed up in the background");
+
 DEFINE_bool(new_table_reader_for_compaction_inputs, true,
              "If true, uses a separate file handle for compaction inputs");
 
@@ -988,6 +1010,12 @@ DEFINE_double(blob_garbage_collection_force_threshold,
               "[Integrated BlobDB] The threshold for the ratio of garbage in "
               "the oldest blob files for forcing garbage collection.");
 
+DEFINE_double(blob_garbage_collection_job_threshold,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_garbage_collection_job_threshold,
+              "[Integrated BlobDB] The threshold for the ratio of garbage in "
+              "a blob file for relocating its live blobs in the background.");
+
 #ifndef ROCKSDB_LITE
 
 // Secondary DB instance Options
@@ -1466,6 +1494,9 @@ DEFINE_double(cuckoo_hash_ratio, 0.9, "Hash ratio for Cuckoo SST table.");
 DEFINE_bool(use_hash_search, false, "if use kHashSearch "
             "instead of kBinarySearch. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_learned_index, false,
+            "if use kLearnedIndexSearch instead of kBinarySearch. "
+            "This is valid if only we use BlockTable");
 DEFINE_bool(use_block_based_filter, false, "if use kBlockBasedFilter "
             "instead of kFullFilter for filter block. "
             "This is valid if only we use BlockTable");
@@ -3993,6 +4024,7 @@ class Benchmark {
     }
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
+    options.open_tables_lazily = FLAGS_open_tables_lazily;
     options.new_table_reader_for_compaction_inputs =
         FLAGS_new_table_reader_for_compaction_inputs;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
@@ -4074,6 +4106,9 @@ class Benchmark {
           exit(1);
         }
         block_based_options.index_type = BlockBasedTableOptions::kHashSearch;
+      } else if (FLAGS_use_learned_index) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kLearnedIndexSearch;
       } else {
         block_based_options.index_type = BlockBasedTableOptions::kBinarySearch;
       }
@@ -4159,9 +4194,16 @@ class Benchmark {
           fprintf(stderr, "Unknown prepopulate block cache mode\n");
       }
       block_based_options.prepopulate_block_cache = prepopulate_block_cache;
+      block_based_options.max_pinned_hot_data_blocks =
+          FLAGS_max_pinned_hot_data_blocks;
+      block_based_options.range_filter_bits_per_key =
+          FLAGS_range_filter_bits_per_key;
       if (FLAGS_use_data_block_hash_index) {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+      } else if (FLAGS_use_data_block_cuckoo_index) {
+        block_based_options.data_block_index_type = ROCKSDB_NAMESPACE::
+            BlockBasedTableOptions::kDataBlockBinaryAndCuckooHash;
       } else {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockBinarySearch;
@@ -4342,6 +4384,8 @@ class Benchmark {
         FLAGS_blob_garbage_collection_age_cutoff;
     options.blob_garbage_collection_force_threshold =
         FLAGS_blob_garbage_collection_force_threshold;
+    options.blob_garbage_collection_job_threshold =
+        FLAGS_blob_garbage_collection_job_threshold;
 
 #ifndef ROCKSDB_LITE
     if (FLAGS_readonly && FLAGS_transaction_db) {
@@ -23,6 +23,7 @@ int main() {
 #include "port/jemalloc_helper.h"
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/filter_policy_internal.h"
+#include "table/multiget_context.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/gflags_compat.h"
@@ -345,6 +346,20 @@ class FullBloomTest : public testing::TestWithParam<BloomFilterPolicy::Mode> {
     return bits_reader_->MayMatch(s);
   }
 
+  // Queries all the keys in one batch
+  void MatchesBatch(const std::vector<Slice>& keys, bool* may_match) {
+    if (bits_reader_ == nullptr) {
+      Build();
+    }
+    std::vector<Slice> key_copies(keys);
+    std::vector<Slice*> key_ptrs;
+    for (Slice& key : key_copies) {
+      key_ptrs.push_back(&key);
+    }
+    bits_reader_->MayMatch(static_cast<int>(key_ptrs.size()), key_ptrs.data(),
+                           may_match);
+  }
+
   // Provides a kind of fingerprint on the Bloom filter's
   // behavior, for reasonbly high FP rates.
   uint64_t PackedMatches() {
@@ -521,6 +536,40 @@ TEST_P(FullBloomTest, FullVaryingLengths) {
   EXPECT_LE(mediocre_filters, good_filters / 5);
 }
 
+TEST_P(FullBloomTest, BatchedMayMatch) {
+  for (int length = 1; length <= 10000; length = NextLength(length)) {
+    Reset();
+    std::vector<std::string> keys;
+    for (int i = 0; i < length; i++) {
+      keys.push_back("key" + std::to_string(i));
+      Add(keys.back());
+    }
+    Build();
+
+    // Batches of added keys, keys not added, and a mix of both
+    for (int start = 0; start < 3 * length; start += 7) {
+      std::vector<Slice> batch;
+      std::vector<std::string> batch_keys;
+      for (int i = start;
+           batch_keys.size() < MultiGetContext::MAX_BATCH_SIZE &&
+           i < 3 * length;
+           i += 3) {
+        batch_keys.push_back("key" + std::to_string(i));
+      }
+      for (const std::string& key : batch_keys) {
+        batch.emplace_back(key);
+      }
+      bool may_match[MultiGetContext::MAX_BATCH_SIZE];
+      MatchesBatch(batch, may_match);
+      for (size_t i = 0; i < batch.size(); i++) {
+        // Same as single queries, so no false negatives
+        ASSERT_EQ(Matches(batch[i]), may_match[i])
+            << "Length " << length << "; key " << batch_keys[i];
+      }
+    }
+  }
+}
+
 TEST_P(FullBloomTest, OptimizeForMemory) {
   char buffer[sizeof(int)];
   for (bool offm : {true, false}) {
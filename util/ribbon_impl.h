@@ -841,6 +841,10 @@ class SerializableInterleavedSolution {
     assert(data_ != nullptr);  // suppress clang analyzer report
     return DecodeFixedGeneric<CoeffRow>(data_ + segment_num * sizeof(CoeffRow));
   }
+  const char* GetSegmentData(Index segment_num) const {
+    assert(data_ != nullptr);  // suppress clang analyzer report
+    return data_ + segment_num * sizeof(CoeffRow);
+  }
   void StoreSegment(Index segment_num, CoeffRow val) {
     assert(data_ != nullptr);  // suppress clang analyzer report
     EncodeFixedGeneric(data_ + segment_num * sizeof(CoeffRow), val);
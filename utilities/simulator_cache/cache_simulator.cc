@@ -232,6 +232,14 @@ Status BlockCacheTraceSimulator::InitializeCaches() {
             NewLRUCache(simulate_cache_capacity, config.num_shard_bits,
                         /*strict_capacity_limit=*/false,
                         /*high_pri_pool_ratio=*/0));
+      } else if (cache_name == "lru_tinylfu") {
+        LRUCacheOptions co;
+        co.capacity = simulate_cache_capacity;
+        co.num_shard_bits = config.num_shard_bits;
+        co.high_pri_pool_ratio = 0;
+        co.use_tinylfu_admission = true;
+        sim_cache = std::make_shared<CacheSimulator>(std::move(ghost_cache),
+                                                     NewLRUCache(co));
       } else if (cache_name == "lru_priority") {
         sim_cache = std::make_shared<PrioritizedCacheSimulator>(
             std::move(ghost_cache),